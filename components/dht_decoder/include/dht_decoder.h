@@ -0,0 +1,87 @@
+/*
+ * DHT11/DHT22 pulse train decoder
+ *
+ * Decodes a DHT transaction captured as level/duration pairs, e.g. by the
+ * RMT receiver at 1 MHz. After the host's start pulse the sensor answers
+ * with 80 us low and 80 us high, then sends 40 bits, each 50 us low
+ * followed by 26-28 us high for a 0 or 70 us high for a 1, MSB first.
+ * The bytes are humidity, humidity fraction, temperature, temperature
+ * fraction and a checksum.
+ *
+ * Anything before the response, such as the start pulse itself, is
+ * skipped. The decoder has no hardware dependencies.
+ */
+#ifndef _DHT_DECODER_H_
+#define _DHT_DECODER_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** Number of data bits in a transaction */
+#define DHT_DECODER_BITS    40
+
+/** One captured symbol: a pulse of level0 for duration0 us followed by
+ * one of level1 for duration1 us. Same layout as rmt_symbol_word_t, a
+ * duration of 0 marks the end of the capture. */
+typedef union {
+    struct {
+        uint32_t duration0 : 15;
+        uint32_t level0 : 1;
+        uint32_t duration1 : 15;
+        uint32_t level1 : 1;
+    };
+    uint32_t val;
+} dht_symbol_t;
+
+typedef enum {
+    /** DHT11, whole degrees and percent, bit 7 of the temperature
+     * fraction is the sign on newer parts */
+    DHT_DECODER_DHT11 = 0,
+    /** DHT22/AM2301, tenths as 16 bit values, sign in the MSB */
+    DHT_DECODER_DHT22,
+} dht_decoder_type_t;
+
+typedef enum {
+    DHT_DECODE_OK = 0,
+    /** No 80 us low/80 us high response found */
+    DHT_DECODE_NO_RESPONSE,
+    /** The capture ended before all 40 bits */
+    DHT_DECODE_TRUNCATED,
+    /** A bit pulse outside the protocol's timing */
+    DHT_DECODE_TIMING,
+    /** The checksum does not match */
+    DHT_DECODE_CHECKSUM,
+} dht_decode_result_t;
+
+/** A decoded reading */
+typedef struct {
+    /** Relative humidity, in 0.1 % */
+    int16_t humidity;
+    /** Temperature, in 0.1 degC */
+    int16_t temperature;
+    /** The raw bytes, checksum last */
+    uint8_t data[5];
+} dht_reading_t;
+
+/** Decode a captured transaction
+ *
+ * \param[in] type Sensor type
+ * \param[in] symbols Captured symbols, durations in us
+ * \param[in] count Number of symbols
+ * \param[out] reading The reading, raw bytes filled in as far as decoded
+ *
+ * \return DHT_DECODE_OK or what went wrong
+ */
+dht_decode_result_t dht_decode(dht_decoder_type_t type, const dht_symbol_t *symbols, size_t count,
+                               dht_reading_t *reading);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _DHT_DECODER_H_ */
@@ -0,0 +1,77 @@
+#include <string.h>
+#include <stdbool.h>
+#include <dht_decoder.h>
+
+/* Pulse limits in us, wide enough for the spread between parts and the
+ * RMT's glitch filter eating into short pulses */
+#define RESPONSE_MIN_US     50
+#define RESPONSE_MAX_US     120
+#define BIT_LOW_MIN_US      30
+#define BIT_LOW_MAX_US      90
+#define BIT_HIGH_MIN_US     10
+#define BIT_HIGH_MAX_US     100
+/* Highs longer than this are 1 bits */
+#define BIT_ONE_US          48
+
+static bool in_range(uint32_t value, uint32_t min, uint32_t max)
+{
+    return value >= min && value <= max;
+}
+
+/* The sensor pulls the line low, so a symbol of the response and of each
+ * bit is low first and high second */
+static bool is_response(const dht_symbol_t *symbol)
+{
+    return symbol->level0 == 0 && symbol->level1 == 1 &&
+           in_range(symbol->duration0, RESPONSE_MIN_US, RESPONSE_MAX_US) &&
+           in_range(symbol->duration1, RESPONSE_MIN_US, RESPONSE_MAX_US);
+}
+
+dht_decode_result_t dht_decode(dht_decoder_type_t type, const dht_symbol_t *symbols, size_t count,
+                               dht_reading_t *reading)
+{
+    memset(reading, 0, sizeof(dht_reading_t));
+
+    size_t start = 0;
+    while (start < count && !is_response(&symbols[start])) {
+        start++;
+    }
+    if (start == count) {
+        return DHT_DECODE_NO_RESPONSE;
+    }
+    start++;
+
+    for (int bit = 0; bit < DHT_DECODER_BITS; bit++) {
+        if (start + bit >= count) {
+            return DHT_DECODE_TRUNCATED;
+        }
+        const dht_symbol_t *symbol = &symbols[start + bit];
+        /* A zero duration is the end of the capture */
+        if (symbol->duration0 == 0 || symbol->duration1 == 0) {
+            return DHT_DECODE_TRUNCATED;
+        }
+        if (symbol->level0 != 0 || !in_range(symbol->duration0, BIT_LOW_MIN_US, BIT_LOW_MAX_US) ||
+            !in_range(symbol->duration1, BIT_HIGH_MIN_US, BIT_HIGH_MAX_US)) {
+            return DHT_DECODE_TIMING;
+        }
+        if (symbol->duration1 > BIT_ONE_US) {
+            reading->data[bit / 8] |= 0x80 >> (bit % 8);
+        }
+    }
+
+    const uint8_t *data = reading->data;
+    if ((uint8_t)(data[0] + data[1] + data[2] + data[3]) != data[4]) {
+        return DHT_DECODE_CHECKSUM;
+    }
+
+    if (type == DHT_DECODER_DHT22) {
+        reading->humidity = (int16_t)((data[0] << 8) | data[1]);
+        int16_t temperature = (int16_t)(((data[2] & 0x7f) << 8) | data[3]);
+        reading->temperature = (data[2] & 0x80) ? -temperature : temperature;
+    } else {
+        reading->humidity = data[0] * 10 + (data[1] % 10);
+        int16_t temperature = data[2] * 10 + (data[3] & 0x7f) % 10;
+        reading->temperature = (data[3] & 0x80) ? -temperature : temperature;
+    }
+    return DHT_DECODE_OK;
+}
@@ -0,0 +1,103 @@
+#include <stdio.h>
+#include <string.h>
+#include "dht_decoder.h"
+#include "unity.h"
+
+/* Low for d0 us, then high for d1 us, as captured by the RMT at 1 MHz */
+#define SYM(d0, d1)     { .duration0 = (d0), .level0 = 0, .duration1 = (d1), .level1 = 1 }
+
+#define COUNT(a)        (sizeof(a) / sizeof(a[0]))
+
+/* DHT11 at 55 %, 23.4 degC: the 20 ms start pulse, the response, 40 bits
+ * and the closing low pulse before the line goes idle */
+static const dht_symbol_t s_dht11_capture[] = {
+    SYM(20480, 25), SYM(86, 82), SYM(53, 26), SYM(55, 27),
+    SYM(49, 72), SYM(48, 74), SYM(55, 24), SYM(56, 69),
+    SYM(51, 73), SYM(55, 72), SYM(56, 25), SYM(54, 27),
+    SYM(50, 23), SYM(50, 28), SYM(56, 25), SYM(48, 27),
+    SYM(49, 23), SYM(48, 24), SYM(48, 28), SYM(52, 25),
+    SYM(54, 27), SYM(54, 71), SYM(55, 23), SYM(53, 68),
+    SYM(48, 69), SYM(55, 69), SYM(52, 27), SYM(54, 28),
+    SYM(52, 25), SYM(56, 28), SYM(54, 26), SYM(53, 72),
+    SYM(54, 26), SYM(51, 24), SYM(48, 28), SYM(52, 72),
+    SYM(50, 27), SYM(53, 72), SYM(49, 27), SYM(51, 27),
+    SYM(52, 70), SYM(49, 22), SYM(53, 0),
+};
+
+/* Encode a transaction, without the start pulse */
+static size_t encode(const uint8_t data[5], dht_symbol_t *symbols)
+{
+    size_t n = 0;
+    symbols[n++] = (dht_symbol_t)SYM(80, 80);
+    for (int bit = 0; bit < DHT_DECODER_BITS; bit++) {
+        symbols[n++] = (dht_symbol_t)SYM(50, (data[bit / 8] & (0x80 >> (bit % 8))) ? 70 : 27);
+    }
+    symbols[n++] = (dht_symbol_t)SYM(50, 0);
+    return n;
+}
+
+TEST_CASE("dht decoder decodes a captured DHT11 transaction", "[dht_decoder]")
+{
+    dht_reading_t reading;
+
+    TEST_ASSERT_EQUAL(DHT_DECODE_OK, dht_decode(DHT_DECODER_DHT11, s_dht11_capture,
+                                                COUNT(s_dht11_capture), &reading));
+    TEST_ASSERT_EQUAL(550, reading.humidity);
+    TEST_ASSERT_EQUAL(234, reading.temperature);
+    const uint8_t expected[5] = { 55, 0, 23, 4, 82 };
+    TEST_ASSERT_EQUAL_MEMORY(expected, reading.data, 5);
+
+    /* Also when the capture starts at the response */
+    TEST_ASSERT_EQUAL(DHT_DECODE_OK, dht_decode(DHT_DECODER_DHT11, s_dht11_capture + 1,
+                                                COUNT(s_dht11_capture) - 1, &reading));
+    TEST_ASSERT_EQUAL(234, reading.temperature);
+
+    /* Newer DHT11 parts flag sub-zero temperatures in the fraction byte */
+    dht_symbol_t symbols[48];
+    const uint8_t frost[5] = { 80, 0, 2, 0x85, 0xd7 };
+    TEST_ASSERT_EQUAL(DHT_DECODE_OK, dht_decode(DHT_DECODER_DHT11, symbols, encode(frost, symbols), &reading));
+    TEST_ASSERT_EQUAL(800, reading.humidity);
+    TEST_ASSERT_EQUAL(-25, reading.temperature);
+}
+
+TEST_CASE("dht decoder decodes DHT22 tenths and sign", "[dht_decoder]")
+{
+    dht_symbol_t symbols[48];
+    dht_reading_t reading;
+
+    /* 65.2 %, -10.1 degC */
+    const uint8_t data[5] = { 0x02, 0x8c, 0x80, 0x65, 0x73 };
+    TEST_ASSERT_EQUAL(DHT_DECODE_OK, dht_decode(DHT_DECODER_DHT22, symbols, encode(data, symbols), &reading));
+    TEST_ASSERT_EQUAL(652, reading.humidity);
+    TEST_ASSERT_EQUAL(-101, reading.temperature);
+}
+
+TEST_CASE("dht decoder reports broken captures", "[dht_decoder]")
+{
+    dht_symbol_t symbols[48];
+    dht_reading_t reading;
+
+    /* Only the start pulse, the sensor never answered */
+    TEST_ASSERT_EQUAL(DHT_DECODE_NO_RESPONSE, dht_decode(DHT_DECODER_DHT11, s_dht11_capture, 1, &reading));
+    TEST_ASSERT_EQUAL(DHT_DECODE_NO_RESPONSE, dht_decode(DHT_DECODER_DHT11, s_dht11_capture, 0, &reading));
+
+    /* Capture cut short, by the buffer or by an early idle */
+    TEST_ASSERT_EQUAL(DHT_DECODE_TRUNCATED, dht_decode(DHT_DECODER_DHT11, s_dht11_capture, 30, &reading));
+    memcpy(symbols, s_dht11_capture, sizeof(s_dht11_capture));
+    symbols[20].duration1 = 0;
+    TEST_ASSERT_EQUAL(DHT_DECODE_TRUNCATED, dht_decode(DHT_DECODER_DHT11, symbols, COUNT(s_dht11_capture), &reading));
+
+    /* A bit stretched by preemption of the old bit banging driver, or a
+     * glitch splitting one */
+    memcpy(symbols, s_dht11_capture, sizeof(s_dht11_capture));
+    symbols[10].duration1 = 150;
+    TEST_ASSERT_EQUAL(DHT_DECODE_TIMING, dht_decode(DHT_DECODER_DHT11, symbols, COUNT(s_dht11_capture), &reading));
+    memcpy(symbols, s_dht11_capture, sizeof(s_dht11_capture));
+    symbols[10].duration0 = 5;
+    TEST_ASSERT_EQUAL(DHT_DECODE_TIMING, dht_decode(DHT_DECODER_DHT11, symbols, COUNT(s_dht11_capture), &reading));
+
+    /* One bit flipped */
+    memcpy(symbols, s_dht11_capture, sizeof(s_dht11_capture));
+    symbols[12].duration1 = 70;
+    TEST_ASSERT_EQUAL(DHT_DECODE_CHECKSUM, dht_decode(DHT_DECODER_DHT11, symbols, COUNT(s_dht11_capture), &reading));
+}
@@ -0,0 +1,149 @@
+/*
+ * Zero-copy field scanner for comma separated AT responses and NMEA
+ *
+ * Splits a line such as "+CGPSINFO: 3113.343286,N,,E,..." into slices that
+ * point into the original buffer. Unlike strtok(), the input is not
+ * modified, no state is kept outside the scanner, and empty fields are
+ * reported as empty slices instead of being merged with their neighbours,
+ * so a blank column never shifts the ones after it.
+ *
+ * Numbers are converted directly from the slices, without copying them or
+ * calling atof()/atoi().
+ */
+#ifndef _FIELD_SCANNER_H_
+#define _FIELD_SCANNER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** Pass as len when the input ends at a NULL terminator */
+#define FIELD_NUL_TERMINATED    ((size_t)-1)
+
+/** A field within the scanned line. Not NULL terminated. */
+typedef struct {
+    const char *ptr;
+    size_t len;
+} field_slice_t;
+
+/** Scanner context
+ *
+ * Please do not set/modify any elements.
+ */
+typedef struct {
+    const char *cur;
+    size_t left;
+    char sep;
+    bool done;
+} field_scanner_t;
+
+/** Start scanning a line
+ *
+ * Scanning stops at the end of the line ('\r' or '\n'), at a NULL
+ * terminator or after len bytes, whichever comes first.
+ *
+ * \param[out] scanner Scanner context
+ * \param[in] str Line to scan
+ * \param[in] len Length of str, or FIELD_NUL_TERMINATED
+ * \param[in] sep Field separator, e.g. ','
+ */
+void field_scanner_init(field_scanner_t *scanner, const char *str, size_t len, char sep);
+
+/** Get the next field
+ *
+ * Leading and trailing spaces are stripped from the field. A line with n
+ * separators always has n + 1 fields, any of which may be empty.
+ *
+ * \param[in] scanner Scanner context
+ * \param[out] field Next field
+ *
+ * \return true if a field was found
+ * \return false if the end of the line was reached
+ */
+bool field_scanner_next(field_scanner_t *scanner, field_slice_t *field);
+
+/** Split a line into fields
+ *
+ * \param[in] str Line to split
+ * \param[in] len Length of str, or FIELD_NUL_TERMINATED
+ * \param[in] sep Field separator
+ * \param[out] fields Array to hold the fields
+ * \param[in] max_fields Number of elements in fields
+ *
+ * \return Number of fields in the line. This can be more than max_fields,
+ * in which case only the first max_fields are stored.
+ */
+int field_split(const char *str, size_t len, char sep, field_slice_t *fields, int max_fields);
+
+/** Check whether a field is empty */
+static inline bool field_is_empty(const field_slice_t *field)
+{
+    return field->len == 0;
+}
+
+/** Compare a field with a NULL terminated string
+ *
+ * \return true if the field is exactly str
+ */
+bool field_equals(const field_slice_t *field, const char *str);
+
+/** Copy a field as a NULL terminated string
+ *
+ * \param[in] field Field to copy
+ * \param[out] buf Destination buffer
+ * \param[in] size Size of buf. The field is truncated to size - 1 bytes.
+ *
+ * \return Number of bytes copied, excluding the NULL terminator
+ */
+size_t field_copy(const field_slice_t *field, char *buf, size_t size);
+
+/** Convert a field to an integer
+ *
+ * \param[in] field Field holding [+-]digits
+ * \param[out] val Value
+ *
+ * \return true on success
+ * \return false if the field is empty, not an integer or out of range
+ */
+bool field_to_int(const field_slice_t *field, int32_t *val);
+
+/** Convert a decimal field to fixed point
+ *
+ * Eg. "31.2304165" with decimals 7 gives 312304165. Digits beyond decimals
+ * are rounded half away from zero.
+ *
+ * \param[in] field Field holding [+-]digits[.digits]
+ * \param[in] decimals Number of decimal places of the result, 0 to 18
+ * \param[out] val Value
+ *
+ * \return true on success
+ * \return false if the field is empty, not a number or out of range
+ */
+bool field_to_fixed(const field_slice_t *field, int decimals, int64_t *val);
+
+/** Convert a decimal field to double
+ *
+ * Up to 18 significant digits are used. The result is correctly rounded
+ * for values with up to 15 significant digits.
+ *
+ * \param[in] field Field holding [+-]digits[.digits]
+ * \param[out] val Value
+ *
+ * \return true on success
+ * \return false if the field is empty or not a number
+ */
+bool field_to_double(const field_slice_t *field, double *val);
+
+/** Convert a decimal field to float, see field_to_double() */
+bool field_to_float(const field_slice_t *field, float *val);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _FIELD_SCANNER_H_ */
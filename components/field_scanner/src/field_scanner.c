@@ -0,0 +1,212 @@
+#include <string.h>
+#include <field_scanner.h>
+
+/* Digits kept in the mantissa, so that it never overflows int64_t */
+#define FIELD_MAX_DIGITS    18
+
+static const int64_t s_pow10[FIELD_MAX_DIGITS + 1] = {
+    1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL, 10000000LL,
+    100000000LL, 1000000000LL, 10000000000LL, 100000000000LL,
+    1000000000000LL, 10000000000000LL, 100000000000000LL,
+    1000000000000000LL, 10000000000000000LL, 100000000000000000LL,
+    1000000000000000000LL,
+};
+
+/* A decimal number as mantissa * 10^-decimals */
+typedef struct {
+    int64_t mantissa;
+    int decimals;
+    bool negative;
+    /* Fraction digits were dropped to fit FIELD_MAX_DIGITS */
+    bool truncated;
+    /* First dropped digit, for rounding */
+    int next_digit;
+} field_number_t;
+
+static bool field_is_end(char c)
+{
+    return c == '\0' || c == '\r' || c == '\n';
+}
+
+void field_scanner_init(field_scanner_t *scanner, const char *str, size_t len, char sep)
+{
+    scanner->cur = str;
+    scanner->left = len;
+    scanner->sep = sep;
+    scanner->done = (str == NULL);
+}
+
+bool field_scanner_next(field_scanner_t *scanner, field_slice_t *field)
+{
+    if (scanner->done) {
+        return false;
+    }
+
+    const char *p = scanner->cur;
+    size_t left = scanner->left;
+    while (left && *p == ' ') {
+        p++;
+        left--;
+    }
+    const char *start = p;
+    while (left && *p != scanner->sep && !field_is_end(*p)) {
+        p++;
+        left--;
+    }
+    const char *end = p;
+    while (end > start && end[-1] == ' ') {
+        end--;
+    }
+    field->ptr = start;
+    field->len = end - start;
+
+    if (left && *p == scanner->sep) {
+        scanner->cur = p + 1;
+        scanner->left = left - 1;
+    } else {
+        scanner->done = true;
+    }
+    return true;
+}
+
+int field_split(const char *str, size_t len, char sep, field_slice_t *fields, int max_fields)
+{
+    field_scanner_t scanner;
+    field_slice_t field;
+    int count = 0;
+
+    field_scanner_init(&scanner, str, len, sep);
+    while (field_scanner_next(&scanner, &field)) {
+        if (count < max_fields) {
+            fields[count] = field;
+        }
+        count++;
+    }
+    return count;
+}
+
+bool field_equals(const field_slice_t *field, const char *str)
+{
+    size_t len = strlen(str);
+    return field->len == len && memcmp(field->ptr, str, len) == 0;
+}
+
+size_t field_copy(const field_slice_t *field, char *buf, size_t size)
+{
+    if (size == 0) {
+        return 0;
+    }
+    size_t len = field->len < size - 1 ? field->len : size - 1;
+    memcpy(buf, field->ptr, len);
+    buf[len] = '\0';
+    return len;
+}
+
+static bool field_parse_number(const field_slice_t *field, field_number_t *num)
+{
+    const char *p = field->ptr;
+    const char *end = field->ptr + field->len;
+    int digits = 0;
+    bool seen_digit = false;
+
+    memset(num, 0, sizeof(field_number_t));
+    if (p < end && (*p == '-' || *p == '+')) {
+        num->negative = (*p == '-');
+        p++;
+    }
+    for (; p < end && *p >= '0' && *p <= '9'; p++) {
+        seen_digit = true;
+        if (num->mantissa == 0 && *p == '0') {
+            continue;
+        }
+        if (digits == FIELD_MAX_DIGITS) {
+            return false;
+        }
+        num->mantissa = num->mantissa * 10 + (*p - '0');
+        digits++;
+    }
+    if (p < end && *p == '.') {
+        p++;
+        for (; p < end && *p >= '0' && *p <= '9'; p++) {
+            seen_digit = true;
+            if (digits == FIELD_MAX_DIGITS || num->decimals == FIELD_MAX_DIGITS) {
+                if (!num->truncated) {
+                    num->truncated = true;
+                    num->next_digit = *p - '0';
+                }
+                continue;
+            }
+            num->mantissa = num->mantissa * 10 + (*p - '0');
+            num->decimals++;
+            if (num->mantissa != 0) {
+                digits++;
+            }
+        }
+    }
+    return seen_digit && p == end;
+}
+
+bool field_to_int(const field_slice_t *field, int32_t *val)
+{
+    field_number_t num;
+    if (!field_parse_number(field, &num) || num.decimals != 0 || num.truncated ||
+        memchr(field->ptr, '.', field->len) != NULL) {
+        return false;
+    }
+    int64_t v = num.negative ? -num.mantissa : num.mantissa;
+    if (v < INT32_MIN || v > INT32_MAX) {
+        return false;
+    }
+    *val = (int32_t)v;
+    return true;
+}
+
+bool field_to_fixed(const field_slice_t *field, int decimals, int64_t *val)
+{
+    field_number_t num;
+    if (decimals < 0 || decimals > FIELD_MAX_DIGITS || !field_parse_number(field, &num)) {
+        return false;
+    }
+    int64_t v = num.mantissa;
+    if (num.decimals > decimals) {
+        int64_t scale = s_pow10[num.decimals - decimals];
+        int64_t rem = v % scale;
+        v /= scale;
+        if (rem * 2 >= scale) {
+            v++;
+        }
+    } else {
+        int64_t scale = s_pow10[decimals - num.decimals];
+        if (v > INT64_MAX / scale) {
+            return false;
+        }
+        v *= scale;
+        if (num.truncated && num.decimals == decimals && num.next_digit >= 5) {
+            v++;
+        }
+    }
+    *val = num.negative ? -v : v;
+    return true;
+}
+
+bool field_to_double(const field_slice_t *field, double *val)
+{
+    field_number_t num;
+    if (!field_parse_number(field, &num)) {
+        return false;
+    }
+    /* Both operands are exact below 2^53 and 10^22, so this rounds once */
+    double v = (double)num.mantissa / (double)s_pow10[num.decimals];
+    *val = num.negative ? -v : v;
+    return true;
+}
+
+bool field_to_float(const field_slice_t *field, float *val)
+{
+    double v;
+    if (!field_to_double(field, &v)) {
+        return false;
+    }
+    *val = (float)v;
+    return true;
+}
@@ -0,0 +1,305 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "field_scanner.h"
+#include "unity.h"
+
+#define FUZZ_COUNT          20000
+#define NUMBER_FUZZ_COUNT   20000
+#define BENCH_COUNT         20000
+#define MAX_FIELDS          16
+
+/* Responses seen from the module, plus malformed variants of them */
+static const char *const corpus[] = {
+    "+CGPSINFO: 3113.343286,N,12121.234064,E,250311,072809.3,44.1,0.0,0",
+    "+CGPSINFO: 3113.343286,N,12121.234064,E,250311,072809.3,44.1,0.0,0\r\n\r\nOK\r\n",
+    "+CGPSINFO: ,,,,,,,,",
+    "+CGPSINFO: 3113.343286,N,12121.234064,E,250311,072809.3,,0.0,0",
+    "+CGPSINFO: 3113.343286,N,12121.234064,E,250311,072809.3,44.1,,",
+    "+CGPSINFO: 3113.343286,N,12121.234064,E,250311,072809.3",
+    "+CGPSINFO: 3113.343286,N,12121.234064,E,250311,072809.3,44.1,0.0,0,extra",
+    "+CGPSINFO: 3113.3432x6,N,12121.234064,E,250311,072809.3,44.1,0.0,0",
+    "+CGPSINFO: -3113.343286,S,-12121.234064,W,250311,072809.3,-12.5,0.0,0",
+    "+CGPSINFO: 3113.,N,.5,E,250311,072809.3,1e3,0.0,0",
+    "+CGPSINFO:",
+    "+CLBS: 0,31.230416,121.473701,550,2025/01/01,08:00:00",
+    "+CLBS: 0,31.230416,121.473701,550,2025/01/01,08:00:00\r\nOK",
+    "+CLBS: 2",
+    "+CLBS: 0,,121.473701,550,,",
+    "+CLBS: 0,-33.868820,151.209290,30,2025/12/31,23:59:59",
+    "+CLBS: 0,31.2304160000000000000001,121.473701,550,2025/01/01,08:00:00",
+    "+CLBS: 0 , 31.230416 ,121.473701, 550,2025/01/01,08:00:00",
+    ",",
+    ",,",
+    "",
+    "\r\n",
+    "    ",
+    "99999999999999999999999,-,+,.,-.,+.5,0.0000000000000000000001",
+};
+
+/* Simple deterministic generator so that failures can be reproduced */
+static uint32_t test_rand(uint32_t *state)
+{
+    *state = *state * 1664525 + 1013904223;
+    return *state;
+}
+
+static int64_t test_time_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/* Straightforward reference: find the line end, then split at every separator */
+static int ref_split(const char *str, size_t len, char sep, field_slice_t *fields, int max_fields)
+{
+    size_t line_len = 0;
+    while (line_len < len && str[line_len] != '\0' && str[line_len] != '\r' && str[line_len] != '\n') {
+        line_len++;
+    }
+    int count = 0;
+    size_t start = 0;
+    for (size_t i = 0; i <= line_len; i++) {
+        if (i == line_len || str[i] == sep) {
+            size_t s = start, e = i;
+            while (s < e && str[s] == ' ') {
+                s++;
+            }
+            while (e > s && str[e - 1] == ' ') {
+                e--;
+            }
+            if (count < max_fields) {
+                fields[count].ptr = str + s;
+                fields[count].len = e - s;
+            }
+            count++;
+            start = i + 1;
+        }
+    }
+    return count;
+}
+
+static void check_split(const char *str, size_t len)
+{
+    field_slice_t fields[MAX_FIELDS], ref[MAX_FIELDS];
+    size_t bound = (len == FIELD_NUL_TERMINATED) ? strlen(str) : len;
+    int n = field_split(str, len, ',', fields, MAX_FIELDS);
+    int n_ref = ref_split(str, bound, ',', ref, MAX_FIELDS);
+    TEST_ASSERT_EQUAL_INT(n_ref, n);
+    for (int i = 0; i < n && i < MAX_FIELDS; i++) {
+        TEST_ASSERT_TRUE(fields[i].ptr == ref[i].ptr);
+        TEST_ASSERT_EQUAL_INT(ref[i].len, fields[i].len);
+        TEST_ASSERT_TRUE(fields[i].ptr >= str && fields[i].ptr + fields[i].len <= str + bound);
+    }
+}
+
+TEST_CASE("field_split keeps empty fields", "[field_scanner]")
+{
+    field_slice_t f[MAX_FIELDS];
+    int n = field_split(" 3113.343286,N,,E,250311,072809.3,,0.0,0\r\nOK", FIELD_NUL_TERMINATED, ',', f, MAX_FIELDS);
+    TEST_ASSERT_EQUAL_INT(9, n);
+    TEST_ASSERT_TRUE(field_equals(&f[0], "3113.343286"));
+    TEST_ASSERT_TRUE(field_equals(&f[1], "N"));
+    TEST_ASSERT_TRUE(field_is_empty(&f[2]));
+    TEST_ASSERT_TRUE(field_equals(&f[3], "E"));
+    TEST_ASSERT_TRUE(field_is_empty(&f[6]));
+    TEST_ASSERT_TRUE(field_equals(&f[8], "0"));
+
+    TEST_ASSERT_EQUAL_INT(9, field_split(" ,,,,,,,,", FIELD_NUL_TERMINATED, ',', f, MAX_FIELDS));
+    for (int i = 0; i < 9; i++) {
+        TEST_ASSERT_TRUE(field_is_empty(&f[i]));
+    }
+    TEST_ASSERT_EQUAL_INT(1, field_split("", FIELD_NUL_TERMINATED, ',', f, MAX_FIELDS));
+    TEST_ASSERT_EQUAL_INT(2, field_split("a,", FIELD_NUL_TERMINATED, ',', f, MAX_FIELDS));
+    TEST_ASSERT_EQUAL_INT(0, field_split(NULL, 0, ',', f, MAX_FIELDS));
+
+    /* Bounded by len, not by the NULL terminator */
+    TEST_ASSERT_EQUAL_INT(2, field_split("1,2,3", 3, ',', f, MAX_FIELDS));
+    TEST_ASSERT_TRUE(field_equals(&f[1], "2"));
+
+    /* More fields than room: all are counted, the first ones stored */
+    TEST_ASSERT_EQUAL_INT(5, field_split("1,2,3,4,5", FIELD_NUL_TERMINATED, ',', f, 2));
+    TEST_ASSERT_TRUE(field_equals(&f[1], "2"));
+}
+
+TEST_CASE("field number conversion", "[field_scanner]")
+{
+    field_slice_t f;
+    int32_t i;
+    int64_t fixed;
+    double d;
+    float fl;
+
+#define SLICE(s) (f.ptr = (s), f.len = strlen(s), &f)
+    TEST_ASSERT_TRUE(field_to_int(SLICE("0"), &i));
+    TEST_ASSERT_EQUAL_INT(0, i);
+    TEST_ASSERT_TRUE(field_to_int(SLICE("-2147483648"), &i));
+    TEST_ASSERT_EQUAL_INT(INT32_MIN, i);
+    TEST_ASSERT_FALSE(field_to_int(SLICE("2147483648"), &i));
+    TEST_ASSERT_FALSE(field_to_int(SLICE("1.5"), &i));
+    TEST_ASSERT_FALSE(field_to_int(SLICE("1."), &i));
+    TEST_ASSERT_FALSE(field_to_int(SLICE(""), &i));
+    TEST_ASSERT_FALSE(field_to_int(SLICE("-"), &i));
+    TEST_ASSERT_FALSE(field_to_int(SLICE("12a"), &i));
+
+    TEST_ASSERT_TRUE(field_to_double(SLICE("3113.343286"), &d));
+    TEST_ASSERT_TRUE(d == 3113.343286);
+    TEST_ASSERT_TRUE(field_to_double(SLICE("-0.5"), &d));
+    TEST_ASSERT_TRUE(d == -0.5);
+    TEST_ASSERT_TRUE(field_to_double(SLICE(".5"), &d));
+    TEST_ASSERT_TRUE(d == 0.5);
+    TEST_ASSERT_TRUE(field_to_double(SLICE("5."), &d));
+    TEST_ASSERT_TRUE(d == 5.0);
+    TEST_ASSERT_TRUE(field_to_double(SLICE("0.0000000000000000000001"), &d));
+    TEST_ASSERT_TRUE(d == 0.0);
+    TEST_ASSERT_FALSE(field_to_double(SLICE("."), &d));
+    TEST_ASSERT_FALSE(field_to_double(SLICE("1e3"), &d));
+    TEST_ASSERT_FALSE(field_to_double(SLICE("1.2.3"), &d));
+    TEST_ASSERT_FALSE(field_to_double(SLICE("99999999999999999999"), &d));
+    TEST_ASSERT_TRUE(field_to_float(SLICE("44.1"), &fl));
+    TEST_ASSERT_TRUE(fl == 44.1f);
+
+    TEST_ASSERT_TRUE(field_to_fixed(SLICE("31.2304165"), 7, &fixed));
+    TEST_ASSERT_EQUAL_INT64(312304165LL, fixed);
+    TEST_ASSERT_TRUE(field_to_fixed(SLICE("31.23041655"), 7, &fixed));
+    TEST_ASSERT_EQUAL_INT64(312304166LL, fixed);
+    TEST_ASSERT_TRUE(field_to_fixed(SLICE("-121.47370149"), 7, &fixed));
+    TEST_ASSERT_EQUAL_INT64(-1214737015LL, fixed);
+    TEST_ASSERT_TRUE(field_to_fixed(SLICE("31"), 7, &fixed));
+    TEST_ASSERT_EQUAL_INT64(310000000LL, fixed);
+    TEST_ASSERT_FALSE(field_to_fixed(SLICE("31"), 19, &fixed));
+#undef SLICE
+}
+
+TEST_CASE("field scanner corpus matches reference split", "[field_scanner]")
+{
+    for (int i = 0; i < sizeof(corpus) / sizeof(corpus[0]); i++) {
+        check_split(corpus[i], FIELD_NUL_TERMINATED);
+        /* Every prefix, as when a line is cut short by the UART read */
+        size_t len = strlen(corpus[i]);
+        for (size_t l = 0; l <= len; l++) {
+            check_split(corpus[i], l);
+        }
+    }
+}
+
+TEST_CASE("field scanner fuzz", "[field_scanner]")
+{
+    static const char alphabet[] = "0123456789,,,,.-+ NSEW\r\n:/";
+    uint32_t seed = 0x5eed;
+    char buf[96];
+
+    for (int i = 0; i < FUZZ_COUNT; i++) {
+        /* Mutate a corpus entry, or generate from scratch */
+        const char *src = corpus[test_rand(&seed) % (sizeof(corpus) / sizeof(corpus[0]))];
+        size_t len = strlen(src);
+        if (len >= sizeof(buf)) {
+            len = sizeof(buf) - 1;
+        }
+        memcpy(buf, src, len);
+        if (test_rand(&seed) & 1) {
+            len = test_rand(&seed) % (sizeof(buf) - 1);
+            for (size_t j = 0; j < len; j++) {
+                buf[j] = alphabet[test_rand(&seed) % (sizeof(alphabet) - 1)];
+            }
+        } else {
+            int mutations = 1 + test_rand(&seed) % 4;
+            for (int m = 0; m < mutations && len; m++) {
+                buf[test_rand(&seed) % len] = alphabet[test_rand(&seed) % (sizeof(alphabet) - 1)];
+            }
+        }
+        buf[len] = '\0';
+        check_split(buf, FIELD_NUL_TERMINATED);
+
+        /* Conversions must never read outside the field */
+        field_slice_t fields[MAX_FIELDS];
+        int n = field_split(buf, FIELD_NUL_TERMINATED, ',', fields, MAX_FIELDS);
+        for (int j = 0; j < n && j < MAX_FIELDS; j++) {
+            double d;
+            int64_t fixed;
+            int32_t v;
+            char c = ((char *)fields[j].ptr)[fields[j].len];
+            ((char *)fields[j].ptr)[fields[j].len] = '5';
+            bool ok_d = field_to_double(&fields[j], &d);
+            bool ok_f = field_to_fixed(&fields[j], 6, &fixed);
+            field_to_int(&fields[j], &v);
+            ((char *)fields[j].ptr)[fields[j].len] = c;
+            if (ok_d && fields[j].len < 12) {
+                TEST_ASSERT_TRUE(ok_f);
+            }
+        }
+    }
+}
+
+TEST_CASE("field_to_double matches strtod", "[field_scanner]")
+{
+    uint32_t seed = 42;
+    char buf[32];
+    field_slice_t f;
+    double d;
+
+    for (int i = 0; i < NUMBER_FUZZ_COUNT; i++) {
+        /* Up to 15 significant digits, as in coordinates and AT responses */
+        int int_digits = test_rand(&seed) % 8;
+        int frac_digits = test_rand(&seed) % (16 - int_digits);
+        int len = 0;
+        if (test_rand(&seed) & 1) {
+            buf[len++] = '-';
+        }
+        for (int j = 0; j < int_digits; j++) {
+            buf[len++] = '0' + test_rand(&seed) % 10;
+        }
+        if (int_digits == 0 || frac_digits) {
+            buf[len++] = '.';
+            for (int j = 0; j < frac_digits || (int_digits == 0 && j == 0); j++) {
+                buf[len++] = '0' + test_rand(&seed) % 10;
+            }
+        }
+        buf[len] = '\0';
+        f.ptr = buf;
+        f.len = len;
+        TEST_ASSERT_TRUE(field_to_double(&f, &d));
+        if (d != strtod(buf, NULL)) {
+            TEST_FAIL_MESSAGE(buf);
+        }
+    }
+}
+
+TEST_CASE("field scanner throughput", "[field_scanner]")
+{
+    const char *line = corpus[0];
+    size_t len = strlen(line);
+    field_slice_t fields[MAX_FIELDS];
+    volatile double sink = 0;
+
+    int64_t start = test_time_ns();
+    for (int i = 0; i < BENCH_COUNT; i++) {
+        int n = field_split(line + 10, FIELD_NUL_TERMINATED, ',', fields, MAX_FIELDS);
+        double d;
+        for (int j = 0; j < n; j++) {
+            if (field_to_double(&fields[j], &d)) {
+                sink += d;
+            }
+        }
+    }
+    int64_t scanner_ns = test_time_ns() - start;
+
+    start = test_time_ns();
+    for (int i = 0; i < BENCH_COUNT; i++) {
+        char buf[128];
+        strncpy(buf, line + 10, sizeof(buf) - 1);
+        buf[sizeof(buf) - 1] = '\0';
+        char *save = NULL;
+        for (char *tok = strtok_r(buf, ",", &save); tok; tok = strtok_r(NULL, ",", &save)) {
+            sink += atof(tok);
+        }
+    }
+    int64_t strtok_ns = test_time_ns() - start;
+
+    printf("+CGPSINFO split and convert: scanner %.1f MB/s (%lld ns/line), strtok+atof %.1f MB/s (%lld ns/line)\n",
+           (double)len * BENCH_COUNT * 1000.0 / scanner_ns, (long long)(scanner_ns / BENCH_COUNT),
+           (double)len * BENCH_COUNT * 1000.0 / strtok_ns, (long long)(strtok_ns / BENCH_COUNT));
+}
@@ -0,0 +1,216 @@
+/*
+ * Geofence engine
+ *
+ * Circles and polygons are kept in fixed point, 1e-7 degrees, with a
+ * uniform grid over their bounding boxes, and tested in integers. Each fix is only tested against
+ * the fences whose box overlaps its grid cell, plus the ones it was inside
+ * before, so the cost per fix depends on the local fence density rather
+ * than on the number of fences.
+ *
+ * Enter and exit are reported on the first fix that changes the state, and
+ * dwell once per visit after the fence's dwell time.
+ *
+ * Polygons must not cross the antimeridian or contain a pole.
+ */
+#ifndef _GEOFENCE_H_
+#define _GEOFENCE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** Grid cells per side */
+#define GEOFENCE_GRID_DIM       64
+/** Fewest vertices of a polygon */
+#define GEOFENCE_MIN_VERTICES   3
+
+/** A position, in degrees x 1e7, north and east positive */
+typedef struct {
+    int32_t lat_e7;
+    int32_t lon_e7;
+} geofence_point_t;
+
+typedef enum {
+    GEOFENCE_ENTER = 0,
+    GEOFENCE_EXIT,
+    GEOFENCE_DWELL,
+} geofence_event_type_t;
+
+/** Event passed to the handler */
+typedef struct {
+    uint32_t id;
+    geofence_event_type_t type;
+    /** Time of the fix that caused the event */
+    int64_t time_ms;
+    geofence_point_t position;
+} geofence_event_t;
+
+/** Event handler, called from geofence_update()
+ *
+ * \param[in] event The event, only valid during the call
+ * \param[in] priv Private data passed to geofence_init()
+ */
+typedef void (*geofence_handler_t)(const geofence_event_t *event, void *priv);
+
+/** One fence
+ *
+ * Please do not set/modify any elements.
+ */
+typedef struct {
+    uint32_t id;
+    uint32_t dwell_ms;
+    /** Bounding box */
+    geofence_point_t min;
+    geofence_point_t max;
+    /** Circle centre and radius, or first vertex and vertex count */
+    geofence_point_t center;
+    float radius_m;
+    /** Radius in 1e-7 degrees of latitude */
+    uint32_t radius_e7;
+    /** Cosine of the centre latitude, Q30, scales longitude to latitude */
+    uint32_t lon_scale_q30;
+    uint32_t first_vertex;
+    uint16_t vertex_count;
+    bool inside;
+    bool dwell_reported;
+    int64_t enter_ms;
+    /** Last update the fence contained the fix in */
+    uint32_t seen;
+} geofence_fence_t;
+
+/** Engine context
+ *
+ * Please do not set/modify any elements.
+ */
+typedef struct {
+    geofence_fence_t *fences;
+    uint16_t fence_count;
+    uint16_t max_fences;
+    geofence_point_t *vertices;
+    uint32_t vertex_count;
+    uint32_t max_vertices;
+    /** Fences the last fix was inside */
+    uint16_t *inside;
+    uint16_t inside_count;
+    /** Grid, cell c holds cell_fences[cell_start[c] .. cell_start[c + 1]) */
+    bool index_dirty;
+    bool index_valid;
+    geofence_point_t grid_min;
+    int32_t cell_lat_e7;
+    int32_t cell_lon_e7;
+    uint32_t *cell_start;
+    uint16_t *cell_fences;
+    uint32_t cell_fences_size;
+    uint32_t update;
+    geofence_handler_t handler;
+    void *priv;
+} geofence_t;
+
+/** Initialise an engine
+ *
+ * \param[out] gf Engine context
+ * \param[in] max_fences Largest number of fences, at most 65535
+ * \param[in] max_vertices Largest number of polygon vertices over all fences
+ * \param[in] handler Event handler
+ * \param[in] priv Private data passed to the handler
+ *
+ * \return 0 on success
+ * \return -1 if an argument is invalid or out of memory
+ */
+int geofence_init(geofence_t *gf, uint16_t max_fences, uint32_t max_vertices,
+                  geofence_handler_t handler, void *priv);
+
+/** Free the memory of an engine
+ *
+ * \param[in] gf Engine context
+ */
+void geofence_deinit(geofence_t *gf);
+
+/** Add a circle, replacing any fence with the same id. A replaced fence
+ * keeps its state, so reloading it reports no new enter or dwell.
+ *
+ * \param[in] gf Engine context
+ * \param[in] id Fence id
+ * \param[in] center Centre
+ * \param[in] radius_m Radius in metres
+ * \param[in] dwell_ms Time inside before a dwell event, 0 for none
+ *
+ * \return 0 on success
+ * \return -1 if an argument is invalid
+ * \return -2 if the engine is full
+ */
+int geofence_add_circle(geofence_t *gf, uint32_t id, geofence_point_t center, float radius_m,
+                        uint32_t dwell_ms);
+
+/** Add a polygon, replacing any fence with the same id, see
+ * geofence_add_circle()
+ *
+ * \param[in] gf Engine context
+ * \param[in] id Fence id
+ * \param[in] vertices Vertices in order, without repeating the first one
+ * \param[in] count Number of vertices, at least GEOFENCE_MIN_VERTICES
+ * \param[in] dwell_ms Time inside before a dwell event, 0 for none
+ *
+ * \return 0 on success
+ * \return -1 if an argument is invalid
+ * \return -2 if the engine is full
+ */
+int geofence_add_polygon(geofence_t *gf, uint32_t id, const geofence_point_t *vertices,
+                         uint16_t count, uint32_t dwell_ms);
+
+/** Remove a fence. No exit event is reported for it.
+ *
+ * \param[in] gf Engine context
+ * \param[in] id Fence id
+ *
+ * \return 0 on success
+ * \return -1 if there is no such fence
+ */
+int geofence_remove(geofence_t *gf, uint32_t id);
+
+/** Remove all fences
+ *
+ * \param[in] gf Engine context
+ */
+void geofence_clear(geofence_t *gf);
+
+/** Rebuild the grid
+ *
+ * Called by geofence_update() after fences were changed. Call it directly
+ * to keep the rebuild out of the first update.
+ *
+ * \param[in] gf Engine context
+ *
+ * \return 0 on success
+ * \return -1 if out of memory, updates then test every fence
+ */
+int geofence_build_index(geofence_t *gf);
+
+/** Evaluate a fix and report the events it causes
+ *
+ * \param[in] gf Engine context
+ * \param[in] time_ms Time of the fix
+ * \param[in] position The fix
+ *
+ * \return Number of fences the fix is inside
+ */
+int geofence_update(geofence_t *gf, int64_t time_ms, geofence_point_t position);
+
+/** Whether a fence contains a position, without changing any state
+ *
+ * \param[in] gf Engine context
+ * \param[in] fence The fence
+ * \param[in] position The position
+ */
+bool geofence_contains(const geofence_t *gf, const geofence_fence_t *fence, geofence_point_t position);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _GEOFENCE_H_ */
@@ -0,0 +1,387 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <geofence.h>
+
+/* Metres per 1e-7 degree of latitude, mean earth radius */
+#define M_PER_E7                (6371008.8 * M_PI / 180.0 / 1e7)
+#define LAT_MAX_E7              900000000
+#define LON_MAX_E7              1800000000
+#define GRID_CELLS              (GEOFENCE_GRID_DIM * GEOFENCE_GRID_DIM)
+
+static bool point_is_valid(geofence_point_t p)
+{
+    return p.lat_e7 >= -LAT_MAX_E7 && p.lat_e7 <= LAT_MAX_E7 &&
+           p.lon_e7 >= -LON_MAX_E7 && p.lon_e7 <= LON_MAX_E7;
+}
+
+static int32_t clamp_e7(int64_t value, int32_t limit)
+{
+    return value < -limit ? -limit : value > limit ? limit : (int32_t)value;
+}
+
+int geofence_init(geofence_t *gf, uint16_t max_fences, uint32_t max_vertices,
+                  geofence_handler_t handler, void *priv)
+{
+    if (!gf || max_fences == 0 || !handler) {
+        return -1;
+    }
+    memset(gf, 0, sizeof(geofence_t));
+    gf->fences = calloc(max_fences, sizeof(geofence_fence_t));
+    gf->inside = calloc(max_fences, sizeof(uint16_t));
+    gf->cell_start = calloc(GRID_CELLS + 1, sizeof(uint32_t));
+    gf->vertices = max_vertices ? calloc(max_vertices, sizeof(geofence_point_t)) : NULL;
+    if (!gf->fences || !gf->inside || !gf->cell_start || (max_vertices && !gf->vertices)) {
+        geofence_deinit(gf);
+        return -1;
+    }
+    gf->max_fences = max_fences;
+    gf->max_vertices = max_vertices;
+    gf->handler = handler;
+    gf->priv = priv;
+    gf->index_dirty = true;
+    return 0;
+}
+
+void geofence_deinit(geofence_t *gf)
+{
+    free(gf->fences);
+    free(gf->inside);
+    free(gf->cell_start);
+    free(gf->cell_fences);
+    free(gf->vertices);
+    memset(gf, 0, sizeof(geofence_t));
+}
+
+static int geofence_find(const geofence_t *gf, uint32_t id)
+{
+    for (int i = 0; i < gf->fence_count; i++) {
+        if (gf->fences[i].id == id) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int geofence_remove(geofence_t *gf, uint32_t id)
+{
+    int index = geofence_find(gf, id);
+    if (index < 0) {
+        return -1;
+    }
+
+    /* Close the gap in the vertex pool */
+    geofence_fence_t *fence = &gf->fences[index];
+    uint32_t first = fence->first_vertex;
+    uint32_t count = fence->vertex_count;
+    if (count) {
+        memmove(&gf->vertices[first], &gf->vertices[first + count],
+                (gf->vertex_count - first - count) * sizeof(geofence_point_t));
+        gf->vertex_count -= count;
+        for (int i = 0; i < gf->fence_count; i++) {
+            if (gf->fences[i].vertex_count && gf->fences[i].first_vertex > first) {
+                gf->fences[i].first_vertex -= count;
+            }
+        }
+    }
+
+    memmove(&gf->fences[index], &gf->fences[index + 1],
+            (gf->fence_count - index - 1) * sizeof(geofence_fence_t));
+    gf->fence_count--;
+
+    /* Renumber the fences the last fix was inside */
+    uint16_t kept = 0;
+    for (int i = 0; i < gf->inside_count; i++) {
+        if (gf->inside[i] != index) {
+            gf->inside[kept++] = gf->inside[i] > index ? gf->inside[i] - 1 : gf->inside[i];
+        }
+    }
+    gf->inside_count = kept;
+    gf->index_dirty = true;
+    return 0;
+}
+
+void geofence_clear(geofence_t *gf)
+{
+    gf->fence_count = 0;
+    gf->vertex_count = 0;
+    gf->inside_count = 0;
+    gf->index_dirty = true;
+}
+
+/* Make room for a fence, replacing an old one with the same id. The old
+ * fence's state is kept, so reloading a fence does not report it again. */
+static geofence_fence_t *geofence_new(geofence_t *gf, uint32_t id, uint32_t vertex_count)
+{
+    int old = geofence_find(gf, id);
+    uint32_t old_vertices = old >= 0 ? gf->fences[old].vertex_count : 0;
+    if ((old < 0 && gf->fence_count >= gf->max_fences) ||
+        gf->vertex_count - old_vertices + vertex_count > gf->max_vertices) {
+        return NULL;
+    }
+    geofence_fence_t state = { 0 };
+    if (old >= 0) {
+        state = gf->fences[old];
+        geofence_remove(gf, id);
+    }
+
+    uint16_t index = gf->fence_count++;
+    geofence_fence_t *fence = &gf->fences[index];
+    memset(fence, 0, sizeof(geofence_fence_t));
+    fence->id = id;
+    if (state.inside) {
+        fence->inside = true;
+        fence->dwell_reported = state.dwell_reported;
+        fence->enter_ms = state.enter_ms;
+        gf->inside[gf->inside_count++] = index;
+    }
+    gf->index_dirty = true;
+    return fence;
+}
+
+int geofence_add_circle(geofence_t *gf, uint32_t id, geofence_point_t center, float radius_m,
+                        uint32_t dwell_ms)
+{
+    if (!point_is_valid(center) || !(radius_m > 0) || !isfinite(radius_m)) {
+        return -1;
+    }
+    geofence_fence_t *fence = geofence_new(gf, id, 0);
+    if (!fence) {
+        return -2;
+    }
+
+    double m_per_lon_e7 = M_PER_E7 * cos(center.lat_e7 / 1e7 * M_PI / 180.0);
+    int64_t dlat = (int64_t)ceil(radius_m / M_PER_E7);
+    /* Near the poles the circle spans every longitude */
+    int64_t dlon = LON_MAX_E7;
+    if (m_per_lon_e7 > radius_m / (double)LON_MAX_E7) {
+        dlon = (int64_t)ceil(radius_m / m_per_lon_e7);
+    }
+    fence->dwell_ms = dwell_ms;
+    fence->center = center;
+    fence->radius_m = radius_m;
+    double radius_e7 = round(radius_m / M_PER_E7);
+    fence->radius_e7 = radius_e7 < UINT32_MAX ? (uint32_t)radius_e7 : UINT32_MAX;
+    fence->lon_scale_q30 = (uint32_t)lround(m_per_lon_e7 / M_PER_E7 * (1 << 30));
+    fence->min.lat_e7 = clamp_e7(center.lat_e7 - dlat, LAT_MAX_E7);
+    fence->max.lat_e7 = clamp_e7(center.lat_e7 + dlat, LAT_MAX_E7);
+    fence->min.lon_e7 = clamp_e7(center.lon_e7 - dlon, LON_MAX_E7);
+    fence->max.lon_e7 = clamp_e7(center.lon_e7 + dlon, LON_MAX_E7);
+    return 0;
+}
+
+int geofence_add_polygon(geofence_t *gf, uint32_t id, const geofence_point_t *vertices,
+                         uint16_t count, uint32_t dwell_ms)
+{
+    if (!vertices || count < GEOFENCE_MIN_VERTICES) {
+        return -1;
+    }
+    for (int i = 0; i < count; i++) {
+        if (!point_is_valid(vertices[i])) {
+            return -1;
+        }
+    }
+    geofence_fence_t *fence = geofence_new(gf, id, count);
+    if (!fence) {
+        return -2;
+    }
+
+    fence->dwell_ms = dwell_ms;
+    fence->first_vertex = gf->vertex_count;
+    fence->vertex_count = count;
+    fence->min = vertices[0];
+    fence->max = vertices[0];
+    for (int i = 0; i < count; i++) {
+        gf->vertices[gf->vertex_count++] = vertices[i];
+        fence->min.lat_e7 = vertices[i].lat_e7 < fence->min.lat_e7 ? vertices[i].lat_e7 : fence->min.lat_e7;
+        fence->min.lon_e7 = vertices[i].lon_e7 < fence->min.lon_e7 ? vertices[i].lon_e7 : fence->min.lon_e7;
+        fence->max.lat_e7 = vertices[i].lat_e7 > fence->max.lat_e7 ? vertices[i].lat_e7 : fence->max.lat_e7;
+        fence->max.lon_e7 = vertices[i].lon_e7 > fence->max.lon_e7 ? vertices[i].lon_e7 : fence->max.lon_e7;
+    }
+    return 0;
+}
+
+/* Crossing number, exact in integers */
+static bool polygon_contains(const geofence_point_t *v, int n, geofence_point_t p)
+{
+    bool inside = false;
+    for (int i = 0, j = n - 1; i < n; j = i++) {
+        if ((v[i].lat_e7 > p.lat_e7) != (v[j].lat_e7 > p.lat_e7)) {
+            /* Is p west of the edge where it crosses p's latitude? */
+            int64_t lhs = ((int64_t)p.lon_e7 - v[i].lon_e7) * ((int64_t)v[j].lat_e7 - v[i].lat_e7);
+            int64_t rhs = ((int64_t)v[j].lon_e7 - v[i].lon_e7) * ((int64_t)p.lat_e7 - v[i].lat_e7);
+            if (v[j].lat_e7 > v[i].lat_e7 ? lhs < rhs : lhs > rhs) {
+                inside = !inside;
+            }
+        }
+    }
+    return inside;
+}
+
+bool geofence_contains(const geofence_t *gf, const geofence_fence_t *fence, geofence_point_t position)
+{
+    if (position.lat_e7 < fence->min.lat_e7 || position.lat_e7 > fence->max.lat_e7 ||
+        position.lon_e7 < fence->min.lon_e7 || position.lon_e7 > fence->max.lon_e7) {
+        return false;
+    }
+    if (fence->vertex_count) {
+        return polygon_contains(&gf->vertices[fence->first_vertex], fence->vertex_count, position);
+    }
+    /* In 1e-7 degrees of latitude, the squares fit in 64 bits anywhere on earth */
+    uint64_t dn = llabs((int64_t)position.lat_e7 - fence->center.lat_e7);
+    uint64_t dlon = llabs((int64_t)position.lon_e7 - fence->center.lon_e7);
+    uint64_t de = (dlon * fence->lon_scale_q30 + (1u << 29)) >> 30;
+    return dn * dn + de * de <= (uint64_t)fence->radius_e7 * fence->radius_e7;
+}
+
+/* Grid cell range covered by [min, max] on one axis */
+static int grid_index(int32_t value, int32_t origin, int32_t cell)
+{
+    int64_t i = ((int64_t)value - origin) / cell;
+    return i < 0 ? 0 : i >= GEOFENCE_GRID_DIM ? GEOFENCE_GRID_DIM - 1 : (int)i;
+}
+
+int geofence_build_index(geofence_t *gf)
+{
+    gf->index_dirty = false;
+    gf->index_valid = false;
+    memset(gf->cell_start, 0, (GRID_CELLS + 1) * sizeof(uint32_t));
+    if (gf->fence_count == 0) {
+        gf->index_valid = true;
+        return 0;
+    }
+
+    geofence_point_t min = gf->fences[0].min;
+    geofence_point_t max = gf->fences[0].max;
+    for (int i = 1; i < gf->fence_count; i++) {
+        const geofence_fence_t *f = &gf->fences[i];
+        min.lat_e7 = f->min.lat_e7 < min.lat_e7 ? f->min.lat_e7 : min.lat_e7;
+        min.lon_e7 = f->min.lon_e7 < min.lon_e7 ? f->min.lon_e7 : min.lon_e7;
+        max.lat_e7 = f->max.lat_e7 > max.lat_e7 ? f->max.lat_e7 : max.lat_e7;
+        max.lon_e7 = f->max.lon_e7 > max.lon_e7 ? f->max.lon_e7 : max.lon_e7;
+    }
+    gf->grid_min = min;
+    gf->cell_lat_e7 = (int32_t)(((int64_t)max.lat_e7 - min.lat_e7) / GEOFENCE_GRID_DIM + 1);
+    gf->cell_lon_e7 = (int32_t)(((int64_t)max.lon_e7 - min.lon_e7) / GEOFENCE_GRID_DIM + 1);
+
+    /* Count the fences per cell, then turn the counts into start offsets */
+    uint32_t total = 0;
+    for (int pass = 0; pass < 2; pass++) {
+        for (int i = 0; i < gf->fence_count; i++) {
+            const geofence_fence_t *f = &gf->fences[i];
+            int r0 = grid_index(f->min.lat_e7, min.lat_e7, gf->cell_lat_e7);
+            int r1 = grid_index(f->max.lat_e7, min.lat_e7, gf->cell_lat_e7);
+            int c0 = grid_index(f->min.lon_e7, min.lon_e7, gf->cell_lon_e7);
+            int c1 = grid_index(f->max.lon_e7, min.lon_e7, gf->cell_lon_e7);
+            for (int r = r0; r <= r1; r++) {
+                for (int c = c0; c <= c1; c++) {
+                    int cell = r * GEOFENCE_GRID_DIM + c;
+                    if (pass == 0) {
+                        gf->cell_start[cell + 1]++;
+                    } else {
+                        /* cell_start[cell + 1] is the fill position of cell */
+                        gf->cell_fences[gf->cell_start[cell + 1]++] = i;
+                    }
+                }
+            }
+        }
+        if (pass == 0) {
+            for (int c = 0; c < GRID_CELLS; c++) {
+                uint32_t count = gf->cell_start[c + 1];
+                gf->cell_start[c + 1] = total;
+                total += count;
+            }
+            if (total > gf->cell_fences_size) {
+                uint16_t *cell_fences = realloc(gf->cell_fences, total * sizeof(uint16_t));
+                if (!cell_fences) {
+                    return -1;
+                }
+                gf->cell_fences = cell_fences;
+                gf->cell_fences_size = total;
+            }
+        }
+    }
+    gf->index_valid = true;
+    return 0;
+}
+
+static void geofence_report(geofence_t *gf, const geofence_fence_t *fence, geofence_event_type_t type,
+                            int64_t time_ms, geofence_point_t position)
+{
+    geofence_event_t event = {
+        .id = fence->id,
+        .type = type,
+        .time_ms = time_ms,
+        .position = position,
+    };
+    gf->handler(&event, gf->priv);
+}
+
+static void geofence_check_dwell(geofence_t *gf, geofence_fence_t *fence, int64_t time_ms,
+                                 geofence_point_t position)
+{
+    if (fence->dwell_ms && !fence->dwell_reported && time_ms - fence->enter_ms >= fence->dwell_ms) {
+        fence->dwell_reported = true;
+        geofence_report(gf, fence, GEOFENCE_DWELL, time_ms, position);
+    }
+}
+
+int geofence_update(geofence_t *gf, int64_t time_ms, geofence_point_t position)
+{
+    if (gf->index_dirty) {
+        geofence_build_index(gf);
+    }
+
+    /* Candidates: the fences of the fix's cell, or every fence without a grid */
+    const uint16_t *candidates = NULL;
+    uint32_t count = 0;
+    bool all = !gf->index_valid;
+    if (all) {
+        count = gf->fence_count;
+    } else if (gf->fence_count &&
+               position.lat_e7 >= gf->grid_min.lat_e7 && position.lon_e7 >= gf->grid_min.lon_e7 &&
+               ((int64_t)position.lat_e7 - gf->grid_min.lat_e7) / gf->cell_lat_e7 < GEOFENCE_GRID_DIM &&
+               ((int64_t)position.lon_e7 - gf->grid_min.lon_e7) / gf->cell_lon_e7 < GEOFENCE_GRID_DIM) {
+        int cell = grid_index(position.lat_e7, gf->grid_min.lat_e7, gf->cell_lat_e7) * GEOFENCE_GRID_DIM +
+                   grid_index(position.lon_e7, gf->grid_min.lon_e7, gf->cell_lon_e7);
+        candidates = &gf->cell_fences[gf->cell_start[cell]];
+        count = gf->cell_start[cell + 1] - gf->cell_start[cell];
+    }
+
+    uint32_t update = ++gf->update;
+    for (uint32_t i = 0; i < count; i++) {
+        geofence_fence_t *fence = &gf->fences[all ? i : candidates[i]];
+        if (geofence_contains(gf, fence, position)) {
+            fence->seen = update;
+        }
+    }
+
+    /* Exits, and dwell in the fences still inside */
+    uint16_t kept = 0;
+    for (int i = 0; i < gf->inside_count; i++) {
+        geofence_fence_t *fence = &gf->fences[gf->inside[i]];
+        if (fence->seen == update) {
+            gf->inside[kept++] = gf->inside[i];
+            geofence_check_dwell(gf, fence, time_ms, position);
+        } else {
+            fence->inside = false;
+            geofence_report(gf, fence, GEOFENCE_EXIT, time_ms, position);
+        }
+    }
+    gf->inside_count = kept;
+
+    /* Entries */
+    for (uint32_t i = 0; i < count; i++) {
+        uint16_t index = all ? i : candidates[i];
+        geofence_fence_t *fence = &gf->fences[index];
+        if (fence->seen == update && !fence->inside) {
+            fence->inside = true;
+            fence->dwell_reported = false;
+            fence->enter_ms = time_ms;
+            gf->inside[gf->inside_count++] = index;
+            geofence_report(gf, fence, GEOFENCE_ENTER, time_ms, position);
+            geofence_check_dwell(gf, fence, time_ms, position);
+        }
+    }
+    return gf->inside_count;
+}
@@ -0,0 +1,203 @@
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "geofence.h"
+#include "unity.h"
+
+#define M_PER_E7        (6371008.8 * M_PI / 180.0 / 1e7)
+#define MAX_EVENTS      16
+
+static geofence_event_t s_events[MAX_EVENTS];
+static int s_event_count;
+
+static void record_event(const geofence_event_t *event, void *priv)
+{
+    if (s_event_count < MAX_EVENTS) {
+        s_events[s_event_count] = *event;
+    }
+    s_event_count++;
+}
+
+static uint32_t s_seed;
+
+static uint32_t rnd(uint32_t n)
+{
+    s_seed = s_seed * 1664525 + 1013904223;
+    return (s_seed >> 8) % n;
+}
+
+/* A point dx, dy metres from a base point */
+static geofence_point_t offset(geofence_point_t base, double east_m, double north_m)
+{
+    double m_per_lon = M_PER_E7 * cos(base.lat_e7 / 1e7 * M_PI / 180);
+    geofence_point_t p = {
+        .lat_e7 = base.lat_e7 + (int32_t)lround(north_m / M_PER_E7),
+        .lon_e7 = base.lon_e7 + (int32_t)lround(east_m / m_per_lon),
+    };
+    return p;
+}
+
+/* Reference test in floating point, on the local plane */
+static bool reference_contains(const geofence_t *gf, const geofence_fence_t *f, geofence_point_t p)
+{
+    if (!f->vertex_count) {
+        double m_per_lon = M_PER_E7 * cos(f->center.lat_e7 / 1e7 * M_PI / 180);
+        double dn = ((double)p.lat_e7 - f->center.lat_e7) * M_PER_E7;
+        double de = ((double)p.lon_e7 - f->center.lon_e7) * m_per_lon;
+        return sqrt(dn * dn + de * de) <= f->radius_m;
+    }
+    const geofence_point_t *v = &gf->vertices[f->first_vertex];
+    bool inside = false;
+    for (int i = 0, j = f->vertex_count - 1; i < f->vertex_count; j = i++) {
+        double yi = v[i].lat_e7, yj = v[j].lat_e7, xi = v[i].lon_e7, xj = v[j].lon_e7;
+        if ((yi > p.lat_e7) != (yj > p.lat_e7) &&
+            p.lon_e7 < xi + (p.lat_e7 - yi) * (xj - xi) / (yj - yi)) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+TEST_CASE("geofence index finds the same fences as a full scan", "[geofence]")
+{
+    static const geofence_point_t base = { 312304160, 1214737010 };
+    geofence_t gf;
+    geofence_point_t star[10];
+
+    s_seed = 7;
+    TEST_ASSERT_EQUAL(0, geofence_init(&gf, 1000, 6000, record_event, NULL));
+    /* Circles and concave star polygons over 20 x 20 km */
+    for (int i = 0; i < 1000; i++) {
+        geofence_point_t c = offset(base, rnd(20000), rnd(20000));
+        if (i % 2) {
+            TEST_ASSERT_EQUAL(0, geofence_add_circle(&gf, i, c, 20 + rnd(500), 0));
+        } else {
+            double r = 50 + rnd(500);
+            for (int k = 0; k < 10; k++) {
+                double a = k * M_PI / 5;
+                double rk = (k % 2) ? r / 2 : r;
+                star[k] = offset(c, rk * sin(a), rk * cos(a));
+            }
+            TEST_ASSERT_EQUAL(0, geofence_add_polygon(&gf, i, star, 10, 0));
+        }
+    }
+    TEST_ASSERT_EQUAL(0, geofence_build_index(&gf));
+
+    int inside_total = 0;
+    for (int n = 0; n < 20000; n++) {
+        geofence_point_t p = offset(base, (int)rnd(22000) - 1000, (int)rnd(22000) - 1000);
+        int inside = geofence_update(&gf, n * 1000LL, p);
+        int expected = 0;
+        for (int i = 0; i < gf.fence_count; i++) {
+            bool in = geofence_contains(&gf, &gf.fences[i], p);
+            TEST_ASSERT_EQUAL(in, gf.fences[i].inside);
+            /* The integer test agrees with floating point away from the edges */
+            if (in != reference_contains(&gf, &gf.fences[i], p)) {
+                TEST_ASSERT_TRUE(!gf.fences[i].vertex_count);
+                double m_per_lon = M_PER_E7 * cos(gf.fences[i].center.lat_e7 / 1e7 * M_PI / 180);
+                double dn = ((double)p.lat_e7 - gf.fences[i].center.lat_e7) * M_PER_E7;
+                double de = ((double)p.lon_e7 - gf.fences[i].center.lon_e7) * m_per_lon;
+                TEST_ASSERT_TRUE(fabs(sqrt(dn * dn + de * de) - gf.fences[i].radius_m) < 0.01);
+            }
+            expected += in;
+        }
+        TEST_ASSERT_EQUAL(expected, inside);
+        inside_total += inside;
+    }
+    /* The fixes did land in fences */
+    TEST_ASSERT_TRUE(inside_total > 1000);
+    geofence_deinit(&gf);
+}
+
+TEST_CASE("geofence reports enter, dwell and exit", "[geofence]")
+{
+    static const geofence_point_t center = { 312304160, 1214737010 };
+    geofence_t gf;
+
+    TEST_ASSERT_EQUAL(0, geofence_init(&gf, 4, 0, record_event, NULL));
+    TEST_ASSERT_EQUAL(0, geofence_add_circle(&gf, 42, center, 100, 60000));
+
+    s_event_count = 0;
+    TEST_ASSERT_EQUAL(0, geofence_update(&gf, 0, offset(center, 150, 0)));
+    TEST_ASSERT_EQUAL(1, geofence_update(&gf, 1000, offset(center, 90, 0)));
+    TEST_ASSERT_EQUAL(1, s_event_count);
+    TEST_ASSERT_EQUAL(GEOFENCE_ENTER, s_events[0].type);
+    TEST_ASSERT_EQUAL(42, s_events[0].id);
+    TEST_ASSERT_EQUAL(1000, s_events[0].time_ms);
+
+    geofence_update(&gf, 60000, center);
+    TEST_ASSERT_EQUAL(1, s_event_count);
+    geofence_update(&gf, 61000, center);
+    geofence_update(&gf, 62000, center);
+    TEST_ASSERT_EQUAL(2, s_event_count);
+    TEST_ASSERT_EQUAL(GEOFENCE_DWELL, s_events[1].type);
+    TEST_ASSERT_EQUAL(61000, s_events[1].time_ms);
+
+    /* Leaving, also through a fix outside the grid */
+    TEST_ASSERT_EQUAL(0, geofence_update(&gf, 63000, offset(center, 0, -5000)));
+    TEST_ASSERT_EQUAL(3, s_event_count);
+    TEST_ASSERT_EQUAL(GEOFENCE_EXIT, s_events[2].type);
+
+    /* A new visit starts its own dwell time */
+    geofence_update(&gf, 70000, center);
+    geofence_update(&gf, 129000, center);
+    TEST_ASSERT_EQUAL(4, s_event_count);
+    geofence_update(&gf, 130000, center);
+    TEST_ASSERT_EQUAL(5, s_event_count);
+    TEST_ASSERT_EQUAL(GEOFENCE_DWELL, s_events[4].type);
+    geofence_deinit(&gf);
+}
+
+TEST_CASE("geofence keeps state when fences are reloaded", "[geofence]")
+{
+    static const geofence_point_t center = { -338688000, 1512093000 };
+    /* U shape, the fix in the notch is outside */
+    geofence_point_t u[8] = {
+        offset(center, -100, -100), offset(center, 100, -100), offset(center, 100, 100),
+        offset(center, 50, 100), offset(center, 50, -50), offset(center, -50, -50),
+        offset(center, -50, 100), offset(center, -100, 100),
+    };
+    geofence_t gf;
+
+    TEST_ASSERT_EQUAL(0, geofence_init(&gf, 2, 10, record_event, NULL));
+    TEST_ASSERT_EQUAL(0, geofence_add_polygon(&gf, 1, u, 8, 0));
+    TEST_ASSERT_EQUAL(0, geofence_add_circle(&gf, 2, center, 30, 0));
+    s_event_count = 0;
+    TEST_ASSERT_EQUAL(1, geofence_update(&gf, 0, center));
+    TEST_ASSERT_EQUAL(2, s_events[0].id);
+    TEST_ASSERT_EQUAL(1, geofence_update(&gf, 1000, offset(center, 75, 50)));
+    TEST_ASSERT_EQUAL(3, s_event_count);
+
+    /* Same polygon again, nothing to report */
+    TEST_ASSERT_EQUAL(0, geofence_add_polygon(&gf, 1, u, 8, 0));
+    TEST_ASSERT_EQUAL(1, geofence_update(&gf, 2000, offset(center, 75, 50)));
+    TEST_ASSERT_EQUAL(3, s_event_count);
+
+    /* Moved away from the fix, which is then left */
+    geofence_point_t far = offset(center, 1000, 0);
+    TEST_ASSERT_EQUAL(0, geofence_add_circle(&gf, 1, far, 30, 0));
+    TEST_ASSERT_EQUAL(0, geofence_update(&gf, 3000, offset(center, 75, 50)));
+    TEST_ASSERT_EQUAL(4, s_event_count);
+    TEST_ASSERT_EQUAL(GEOFENCE_EXIT, s_events[3].type);
+    TEST_ASSERT_EQUAL(0, gf.vertex_count);
+
+    /* Removal is silent */
+    geofence_update(&gf, 4000, far);
+    TEST_ASSERT_EQUAL(5, s_event_count);
+    TEST_ASSERT_EQUAL(0, geofence_remove(&gf, 1));
+    TEST_ASSERT_EQUAL(-1, geofence_remove(&gf, 1));
+    TEST_ASSERT_EQUAL(0, geofence_update(&gf, 5000, far));
+    TEST_ASSERT_EQUAL(5, s_event_count);
+
+    /* Limits */
+    TEST_ASSERT_EQUAL(0, geofence_add_polygon(&gf, 3, u, 8, 0));
+    TEST_ASSERT_EQUAL(-2, geofence_add_circle(&gf, 4, center, 30, 0));
+    TEST_ASSERT_EQUAL(-2, geofence_add_polygon(&gf, 2, u, 8, 0));
+    TEST_ASSERT_EQUAL(-1, geofence_add_polygon(&gf, 2, u, 2, 0));
+    TEST_ASSERT_EQUAL(-1, geofence_add_circle(&gf, 2, center, 0, 0));
+    geofence_point_t bad = { 900000001, 0 };
+    TEST_ASSERT_EQUAL(-1, geofence_add_circle(&gf, 2, bad, 10, 0));
+    geofence_clear(&gf);
+    TEST_ASSERT_EQUAL(0, geofence_update(&gf, 6000, center));
+    geofence_deinit(&gf);
+}
@@ -0,0 +1,172 @@
+/*
+ * GNSS/LBS position fusion
+ *
+ * A constant velocity Kalman filter in a local East-North-Up frame. Each
+ * position fix, whether from GNSS or cell (LBS) positioning, is weighted by
+ * its accuracy, so a 500 m cell fix nudges the estimate while a 5 m GNSS fix
+ * pulls it in. Fixes that are statistically inconsistent with the current
+ * estimate are rejected as outliers.
+ *
+ * Positions go in and out as fixed point, 1e-7 degrees. Offsets from the
+ * frame origin are taken in integers, so no precision is lost to large
+ * floating point coordinates.
+ *
+ * East and north are filtered independently. With isotropic measurement
+ * noise and per-axis process noise this is exactly equivalent to the full
+ * four state filter, at a fraction of the cost.
+ */
+#ifndef _GNSS_FUSION_H_
+#define _GNSS_FUSION_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** Filter tuning */
+typedef struct {
+    /** Acceleration noise spectral density, in m^2/s^3 */
+    float accel_noise;
+    /** Initial velocity standard deviation per axis, in m/s */
+    float init_speed_sigma;
+    /** Time constant, in s, with which the velocity decays towards zero
+     * once no fix has arrived for coast_time. An estimate coasting through a
+     * GNSS outage then comes to rest instead of running away on cell fixes,
+     * which say little about velocity. 0 gives a pure constant velocity
+     * model. */
+    float speed_tau;
+    /** Time, in s, for which the velocity is held without decay, longer
+     * than the normal fix interval */
+    float coast_time;
+    /** Squared Mahalanobis distance above which a fix is an outlier.
+     * 13.8 is the 99.9% point of the chi-square distribution with 2 degrees
+     * of freedom. */
+    float gate;
+    /** Consecutive rejected fixes after which the filter restarts at the
+     * latest fix, so that a genuine jump is eventually accepted */
+    uint8_t max_rejects;
+    /** Gap between fixes, in ms, after which the filter restarts */
+    uint32_t max_gap_ms;
+} gnss_fusion_config_t;
+
+#define GNSS_FUSION_CONFIG_DEFAULT()    \
+    {                                   \
+        .accel_noise = 1.0f,            \
+        .init_speed_sigma = 10.0f,      \
+        .speed_tau = 30.0f,             \
+        .coast_time = 5.0f,             \
+        .gate = 13.8f,                  \
+        .max_rejects = 3,               \
+        .max_gap_ms = 300000,           \
+    }
+
+/** A position fix */
+typedef struct {
+    /** Monotonic time of the fix, in ms */
+    int64_t time_ms;
+    /** Degrees x 1e7, north and east positive */
+    int32_t lat_e7;
+    int32_t lon_e7;
+    /** Horizontal accuracy as a 1 sigma radius (DRMS), in metres */
+    float accuracy;
+} gnss_fusion_fix_t;
+
+/** Fused estimate */
+typedef struct {
+    /** Degrees x 1e7, north and east positive */
+    int32_t lat_e7;
+    int32_t lon_e7;
+    /** Uncertainty radius (DRMS), in metres */
+    float accuracy;
+    /** Estimated ground speed, in m/s */
+    float speed;
+    /** Estimated course over ground, degrees clockwise from north */
+    float course;
+} gnss_fusion_estimate_t;
+
+/** Outcome of gnss_fusion_update() */
+typedef enum {
+    /** The fix was merged into the estimate */
+    GNSS_FUSION_ACCEPTED = 0,
+    /** The filter (re)started at the fix */
+    GNSS_FUSION_RESET,
+    /** The fix was rejected as an outlier, the estimate is unchanged */
+    GNSS_FUSION_REJECTED,
+    /** The fix had invalid coordinates or accuracy */
+    GNSS_FUSION_INVALID,
+} gnss_fusion_result_t;
+
+/** State of one axis: position, velocity and their covariance */
+typedef struct {
+    double pos;
+    double vel;
+    double p_pp;
+    double p_pv;
+    double p_vv;
+} gnss_fusion_axis_t;
+
+/** Filter context
+ *
+ * Please do not set/modify any elements.
+ */
+typedef struct {
+    gnss_fusion_config_t config;
+    bool initialized;
+    uint8_t rejects;
+    int64_t time_ms;
+    /* ENU origin, and metres per 1e-7 degree at the origin */
+    int32_t origin_lat_e7;
+    int32_t origin_lon_e7;
+    double m_per_lat_e7;
+    double m_per_lon_e7;
+    gnss_fusion_axis_t east;
+    gnss_fusion_axis_t north;
+    /** Counters since gnss_fusion_init() */
+    uint32_t accepted;
+    uint32_t rejected;
+    uint32_t resets;
+} gnss_fusion_t;
+
+/** Initialise a filter
+ *
+ * \param[out] fusion Filter context
+ * \param[in] config Tuning, or NULL for GNSS_FUSION_CONFIG_DEFAULT()
+ */
+void gnss_fusion_init(gnss_fusion_t *fusion, const gnss_fusion_config_t *config);
+
+/** Merge a fix
+ *
+ * Fixes must be given in time order. A fix older than the last one is
+ * treated as simultaneous with it.
+ *
+ * \param[in] fusion Filter context
+ * \param[in] fix Position fix
+ *
+ * \return See gnss_fusion_result_t
+ */
+gnss_fusion_result_t gnss_fusion_update(gnss_fusion_t *fusion, const gnss_fusion_fix_t *fix);
+
+/** Get the estimate
+ *
+ * \param[in] fusion Filter context
+ * \param[in] time_ms Time to predict the estimate to. Pass the time of the
+ * last fix to get the filtered estimate itself.
+ * \param[out] estimate Estimate
+ *
+ * \return true on success
+ * \return false if no fix has been accepted yet
+ */
+bool gnss_fusion_get_estimate(const gnss_fusion_t *fusion, int64_t time_ms,
+                              gnss_fusion_estimate_t *estimate);
+
+/** Forget the estimate, e.g. after the device was moved while off */
+void gnss_fusion_reset(gnss_fusion_t *fusion);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _GNSS_FUSION_H_ */
@@ -0,0 +1,219 @@
+#include <string.h>
+#include <math.h>
+#include <gnss_fusion.h>
+
+/* Mean earth radius, the local frame is only used over a few km */
+#define EARTH_RADIUS_M          6371008.8
+#define DEG_TO_RAD              (M_PI / 180.0)
+/* Move the ENU origin once the estimate is this far from it, to keep the
+ * flat earth error well below GNSS accuracy */
+#define REANCHOR_DISTANCE_M     10000.0
+#define LAT_MAX_E7              900000000LL
+#define LON_MAX_E7              1800000000LL
+
+static void fusion_set_origin(gnss_fusion_t *fusion, int32_t lat_e7, int32_t lon_e7)
+{
+    fusion->origin_lat_e7 = lat_e7;
+    fusion->origin_lon_e7 = lon_e7;
+    fusion->m_per_lat_e7 = EARTH_RADIUS_M * DEG_TO_RAD / 1e7;
+    fusion->m_per_lon_e7 = fusion->m_per_lat_e7 * cos(lat_e7 / 1e7 * DEG_TO_RAD);
+}
+
+static void fusion_to_enu(const gnss_fusion_t *fusion, int32_t lat_e7, int32_t lon_e7,
+                          double *east, double *north)
+{
+    int64_t dlon = (int64_t)lon_e7 - fusion->origin_lon_e7;
+    /* Take the short way round at the antimeridian */
+    if (dlon > LON_MAX_E7) {
+        dlon -= 2 * LON_MAX_E7;
+    } else if (dlon < -LON_MAX_E7) {
+        dlon += 2 * LON_MAX_E7;
+    }
+    *east = dlon * fusion->m_per_lon_e7;
+    *north = ((int64_t)lat_e7 - fusion->origin_lat_e7) * fusion->m_per_lat_e7;
+}
+
+static void fusion_from_enu(const gnss_fusion_t *fusion, double east, double north,
+                            int32_t *lat_e7, int32_t *lon_e7)
+{
+    int64_t lat = fusion->origin_lat_e7 + llround(north / fusion->m_per_lat_e7);
+    int64_t lon = fusion->origin_lon_e7 + llround(east / fusion->m_per_lon_e7);
+    if (lon > LON_MAX_E7) {
+        lon -= 2 * LON_MAX_E7;
+    } else if (lon < -LON_MAX_E7) {
+        lon += 2 * LON_MAX_E7;
+    }
+    *lat_e7 = (int32_t)(lat > LAT_MAX_E7 ? LAT_MAX_E7 : lat < -LAT_MAX_E7 ? -LAT_MAX_E7 : lat);
+    *lon_e7 = (int32_t)lon;
+}
+
+static void axis_start(gnss_fusion_axis_t *axis, double pos, double var, double speed_sigma)
+{
+    axis->pos = pos;
+    axis->vel = 0;
+    axis->p_pp = var;
+    axis->p_pv = 0;
+    axis->p_vv = speed_sigma * speed_sigma;
+}
+
+/* x = F x, P = F P F' + Q, with F = [1 b; 0 a] */
+static void axis_transition(gnss_fusion_axis_t *axis, double a, double b, double dt, double q)
+{
+    double dt2 = dt * dt;
+    axis->pos += b * axis->vel;
+    axis->vel *= a;
+    axis->p_pp += 2 * b * axis->p_pv + b * b * axis->p_vv + q * dt2 * dt / 3;
+    axis->p_pv = a * axis->p_pv + a * b * axis->p_vv + q * dt2 / 2;
+    axis->p_vv = a * a * axis->p_vv + q * dt;
+}
+
+/* Constant velocity for up to coast_time, then the velocity decays as
+ * exp(-t / speed_tau). The process noise is that of the constant velocity
+ * model throughout. */
+static void axis_predict(gnss_fusion_axis_t *axis, double dt, const gnss_fusion_config_t *config)
+{
+    double q = config->accel_noise;
+    double tau = config->speed_tau;
+    double coast = config->coast_time;
+
+    if (tau <= 0 || dt <= coast) {
+        axis_transition(axis, 1, dt, dt, q);
+        return;
+    }
+    if (coast > 0) {
+        axis_transition(axis, 1, coast, coast, q);
+        dt -= coast;
+    }
+    double a = exp(-dt / tau);
+    axis_transition(axis, a, tau * (1 - a), dt, q);
+}
+
+static void axis_update(gnss_fusion_axis_t *axis, double z, double r)
+{
+    double s = axis->p_pp + r;
+    double k_p = axis->p_pp / s;
+    double k_v = axis->p_pv / s;
+    double y = z - axis->pos;
+
+    axis->pos += k_p * y;
+    axis->vel += k_v * y;
+    axis->p_vv -= k_v * axis->p_pv;
+    axis->p_pp *= 1 - k_p;
+    axis->p_pv *= 1 - k_p;
+}
+
+static void fusion_start(gnss_fusion_t *fusion, const gnss_fusion_fix_t *fix, double r)
+{
+    fusion_set_origin(fusion, fix->lat_e7, fix->lon_e7);
+    axis_start(&fusion->east, 0, r, fusion->config.init_speed_sigma);
+    axis_start(&fusion->north, 0, r, fusion->config.init_speed_sigma);
+    fusion->time_ms = fix->time_ms;
+    fusion->rejects = 0;
+    fusion->initialized = true;
+    fusion->resets++;
+}
+
+/* Keep the estimate near the origin, the velocity is unaffected */
+static void fusion_reanchor(gnss_fusion_t *fusion)
+{
+    if (fabs(fusion->east.pos) < REANCHOR_DISTANCE_M && fabs(fusion->north.pos) < REANCHOR_DISTANCE_M) {
+        return;
+    }
+    int32_t lat_e7;
+    int32_t lon_e7;
+    fusion_from_enu(fusion, fusion->east.pos, fusion->north.pos, &lat_e7, &lon_e7);
+    fusion_set_origin(fusion, lat_e7, lon_e7);
+    fusion->east.pos = 0;
+    fusion->north.pos = 0;
+}
+
+void gnss_fusion_init(gnss_fusion_t *fusion, const gnss_fusion_config_t *config)
+{
+    static const gnss_fusion_config_t default_config = GNSS_FUSION_CONFIG_DEFAULT();
+
+    memset(fusion, 0, sizeof(gnss_fusion_t));
+    fusion->config = config ? *config : default_config;
+}
+
+void gnss_fusion_reset(gnss_fusion_t *fusion)
+{
+    fusion->initialized = false;
+    fusion->rejects = 0;
+}
+
+gnss_fusion_result_t gnss_fusion_update(gnss_fusion_t *fusion, const gnss_fusion_fix_t *fix)
+{
+    if (!(fix->accuracy > 0) || !isfinite(fix->accuracy) ||
+        fix->lat_e7 < -LAT_MAX_E7 || fix->lat_e7 > LAT_MAX_E7 ||
+        fix->lon_e7 < -LON_MAX_E7 || fix->lon_e7 > LON_MAX_E7) {
+        return GNSS_FUSION_INVALID;
+    }
+
+    /* Accuracy is a 2D radius, split it evenly between the axes */
+    double r = (double)fix->accuracy * fix->accuracy / 2;
+    int64_t gap_ms = fix->time_ms - fusion->time_ms;
+    if (!fusion->initialized || gap_ms > (int64_t)fusion->config.max_gap_ms) {
+        fusion_start(fusion, fix, r);
+        return GNSS_FUSION_RESET;
+    }
+
+    gnss_fusion_axis_t east = fusion->east;
+    gnss_fusion_axis_t north = fusion->north;
+    if (gap_ms > 0) {
+        double dt = gap_ms / 1000.0;
+        axis_predict(&east, dt, &fusion->config);
+        axis_predict(&north, dt, &fusion->config);
+    }
+
+    double z_east;
+    double z_north;
+    fusion_to_enu(fusion, fix->lat_e7, fix->lon_e7, &z_east, &z_north);
+
+    /* Normalised innovation squared, chi-square with 2 degrees of freedom */
+    double y_east = z_east - east.pos;
+    double y_north = z_north - north.pos;
+    double d2 = y_east * y_east / (east.p_pp + r) + y_north * y_north / (north.p_pp + r);
+    if (d2 > fusion->config.gate) {
+        fusion->rejected++;
+        if (++fusion->rejects >= fusion->config.max_rejects) {
+            fusion_start(fusion, fix, r);
+            return GNSS_FUSION_RESET;
+        }
+        return GNSS_FUSION_REJECTED;
+    }
+
+    axis_update(&east, z_east, r);
+    axis_update(&north, z_north, r);
+    fusion->east = east;
+    fusion->north = north;
+    if (gap_ms > 0) {
+        fusion->time_ms = fix->time_ms;
+    }
+    fusion->rejects = 0;
+    fusion->accepted++;
+    fusion_reanchor(fusion);
+    return GNSS_FUSION_ACCEPTED;
+}
+
+bool gnss_fusion_get_estimate(const gnss_fusion_t *fusion, int64_t time_ms,
+                              gnss_fusion_estimate_t *estimate)
+{
+    if (!fusion->initialized) {
+        return false;
+    }
+
+    gnss_fusion_axis_t east = fusion->east;
+    gnss_fusion_axis_t north = fusion->north;
+    if (time_ms > fusion->time_ms) {
+        double dt = (time_ms - fusion->time_ms) / 1000.0;
+        axis_predict(&east, dt, &fusion->config);
+        axis_predict(&north, dt, &fusion->config);
+    }
+
+    fusion_from_enu(fusion, east.pos, north.pos, &estimate->lat_e7, &estimate->lon_e7);
+    estimate->accuracy = sqrt(east.p_pp + north.p_pp);
+    estimate->speed = sqrt(east.vel * east.vel + north.vel * north.vel);
+    double course = atan2(east.vel, north.vel) / DEG_TO_RAD;
+    estimate->course = course < 0 ? course + 360.0 : course;
+    return true;
+}
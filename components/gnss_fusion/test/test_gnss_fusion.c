@@ -0,0 +1,204 @@
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "gnss_fusion.h"
+#include "trace_drive_indoor.h"
+#include "unity.h"
+
+#define TRACE_LEN   (sizeof(trace_drive_indoor) / sizeof(trace_drive_indoor[0]))
+
+/* Equirectangular distance, plenty for the few km of the traces */
+static double distance_m(double lat1, double lon1, double lat2, double lon2)
+{
+    double m_per_deg = 6371008.8 * M_PI / 180;
+    double dlon = lon1 - lon2;
+    if (dlon > 180) {
+        dlon -= 360;
+    } else if (dlon < -180) {
+        dlon += 360;
+    }
+    double dn = (lat1 - lat2) * m_per_deg;
+    double de = dlon * m_per_deg * cos(lat1 * M_PI / 180);
+    return sqrt(dn * dn + de * de);
+}
+
+static gnss_fusion_result_t feed(gnss_fusion_t *fusion, int64_t time_ms, double lat, double lon, float accuracy)
+{
+    gnss_fusion_fix_t fix = {
+        .time_ms = time_ms,
+        .lat_e7 = (int32_t)lround(lat * 1e7),
+        .lon_e7 = (int32_t)lround(lon * 1e7),
+        .accuracy = accuracy,
+    };
+    return gnss_fusion_update(fusion, &fix);
+}
+
+TEST_CASE("gnss fusion replays drive and indoor trace", "[gnss_fusion]")
+{
+    gnss_fusion_t fusion;
+    gnss_fusion_estimate_t est;
+    double gnss_raw_sq = 0, gnss_fused_sq = 0;
+    double lbs_raw = 0, lbs_fused = 0;
+    int gnss_count = 0, lbs_count = 0, covered = 0;
+    double prev_lat = 0, prev_lon = 0;
+
+    gnss_fusion_init(&fusion, NULL);
+    for (int i = 0; i < (int)TRACE_LEN; i++) {
+        const trace_fix_t *t = &trace_drive_indoor[i];
+        gnss_fusion_result_t result = feed(&fusion, t->time_ms, t->latitude, t->longitude, t->accuracy);
+        TEST_ASSERT_TRUE(gnss_fusion_get_estimate(&fusion, t->time_ms, &est));
+
+        double raw = distance_m(t->latitude, t->longitude, t->true_latitude, t->true_longitude);
+        double fused = distance_m(est.lat_e7 / 1e7, est.lon_e7 / 1e7, t->true_latitude, t->true_longitude);
+        int64_t second = t->time_ms / 1000;
+
+        /* Multipath spikes and the far cell fix are outliers, nothing else */
+        if (second == 120 || second == 121 || second == 210 || second == 435) {
+            TEST_ASSERT_EQUAL(GNSS_FUSION_REJECTED, result);
+        } else if (i == 0) {
+            TEST_ASSERT_EQUAL(GNSS_FUSION_RESET, result);
+        } else {
+            TEST_ASSERT_EQUAL(GNSS_FUSION_ACCEPTED, result);
+        }
+
+        if (second == 435) {
+            /* The estimate did not follow the 4.2 km outlier */
+            TEST_ASSERT_TRUE(distance_m(est.lat_e7 / 1e7, est.lon_e7 / 1e7, prev_lat, prev_lon) < 50);
+        } else if (t->source == 0) {
+            gnss_raw_sq += raw * raw;
+            gnss_fused_sq += fused * fused;
+            gnss_count++;
+        } else {
+            lbs_raw += raw;
+            lbs_fused += fused;
+            lbs_count++;
+        }
+        /* Two seconds after GNSS is back the cell error is gone */
+        if (second >= 602 && second < 620) {
+            TEST_ASSERT_TRUE(fused < 15);
+        }
+        if (fused <= 2 * est.accuracy) {
+            covered++;
+        }
+        prev_lat = est.lat_e7 / 1e7;
+        prev_lon = est.lon_e7 / 1e7;
+    }
+
+    double gnss_raw_rms = sqrt(gnss_raw_sq / gnss_count);
+    double gnss_fused_rms = sqrt(gnss_fused_sq / gnss_count);
+    printf("GNSS RMS error raw %.1f m fused %.1f m, LBS mean error raw %.1f m fused %.1f m, "
+           "%d/%d within 2x accuracy\n", gnss_raw_rms, gnss_fused_rms,
+           lbs_raw / lbs_count, lbs_fused / lbs_count, covered, (int)TRACE_LEN);
+    TEST_ASSERT_TRUE(gnss_fused_rms < 0.6 * gnss_raw_rms);
+    TEST_ASSERT_TRUE(lbs_fused < 0.6 * lbs_raw);
+    /* The reported radius is honest */
+    TEST_ASSERT_TRUE(covered >= 0.95 * TRACE_LEN);
+    TEST_ASSERT_EQUAL(4, fusion.rejected);
+    TEST_ASSERT_EQUAL(1, fusion.resets);
+}
+
+TEST_CASE("gnss fusion smooths the GNSS to LBS hand-over", "[gnss_fusion]")
+{
+    gnss_fusion_t fusion;
+    gnss_fusion_estimate_t before, after;
+
+    gnss_fusion_init(&fusion, NULL);
+    for (int i = 0; i < 60; i++) {
+        feed(&fusion, i * 1000, 31.2304, 121.4737, 5);
+    }
+    gnss_fusion_get_estimate(&fusion, 59000, &before);
+    TEST_ASSERT_TRUE(before.accuracy < 5);
+
+    /* A 400 m off cell fix moves a 5 m estimate only a little */
+    TEST_ASSERT_EQUAL(GNSS_FUSION_ACCEPTED, feed(&fusion, 74000, 31.2304 + 0.0036, 121.4737, 550));
+    gnss_fusion_get_estimate(&fusion, 74000, &after);
+    TEST_ASSERT_TRUE(distance_m(before.lat_e7 / 1e7, before.lon_e7 / 1e7,
+                                after.lat_e7 / 1e7, after.lon_e7 / 1e7) < 10);
+    TEST_ASSERT_TRUE(after.accuracy > before.accuracy);
+}
+
+TEST_CASE("gnss fusion follows a genuine jump after repeated rejects", "[gnss_fusion]")
+{
+    gnss_fusion_t fusion;
+    gnss_fusion_estimate_t est;
+
+    gnss_fusion_init(&fusion, NULL);
+    for (int i = 0; i < 10; i++) {
+        feed(&fusion, i * 1000, 31.2304, 121.4737, 5);
+    }
+    /* The device really is 2 km away, e.g. a stale first fix */
+    TEST_ASSERT_EQUAL(GNSS_FUSION_REJECTED, feed(&fusion, 10000, 31.2484, 121.4737, 5));
+    TEST_ASSERT_EQUAL(GNSS_FUSION_REJECTED, feed(&fusion, 11000, 31.2484, 121.4737, 5));
+    TEST_ASSERT_EQUAL(GNSS_FUSION_RESET, feed(&fusion, 12000, 31.2484, 121.4737, 5));
+    gnss_fusion_get_estimate(&fusion, 12000, &est);
+    TEST_ASSERT_TRUE(distance_m(est.lat_e7 / 1e7, est.lon_e7 / 1e7, 31.2484, 121.4737) < 1);
+
+    /* A rejected fix in between accepted ones does not count towards a reset */
+    feed(&fusion, 13000, 31.2484, 121.4737, 5);
+    TEST_ASSERT_EQUAL(GNSS_FUSION_REJECTED, feed(&fusion, 14000, 31.2304, 121.4737, 5));
+    TEST_ASSERT_EQUAL(GNSS_FUSION_ACCEPTED, feed(&fusion, 15000, 31.2484, 121.4737, 5));
+    TEST_ASSERT_EQUAL(GNSS_FUSION_REJECTED, feed(&fusion, 16000, 31.2304, 121.4737, 5));
+    TEST_ASSERT_EQUAL(GNSS_FUSION_REJECTED, feed(&fusion, 17000, 31.2304, 121.4737, 5));
+    TEST_ASSERT_EQUAL(GNSS_FUSION_RESET, feed(&fusion, 18000, 31.2304, 121.4737, 5));
+}
+
+TEST_CASE("gnss fusion tracks constant velocity over long distances", "[gnss_fusion]")
+{
+    gnss_fusion_t fusion;
+    gnss_fusion_estimate_t est;
+    const double lat = 60.0;
+    const double m_per_deg_lon = 6371008.8 * M_PI / 180 * cos(lat * M_PI / 180);
+    double max_error = 0;
+
+    /* 30 m/s east for an hour, 108 km, across the frame re-anchoring and
+     * the antimeridian */
+    gnss_fusion_init(&fusion, NULL);
+    for (int i = 0; i <= 3600; i++) {
+        double lon = 179.5 + 30.0 * i / m_per_deg_lon;
+        if (lon > 180) {
+            lon -= 360;
+        }
+        feed(&fusion, i * 1000LL, lat, lon, 3);
+        gnss_fusion_get_estimate(&fusion, i * 1000LL, &est);
+        if (i >= 30) {
+            double err = distance_m(est.lat_e7 / 1e7, est.lon_e7 / 1e7, lat, lon);
+            max_error = err > max_error ? err : max_error;
+        }
+    }
+    TEST_ASSERT_TRUE(max_error < 1);
+    TEST_ASSERT_TRUE(fabs(est.speed - 30) < 0.5);
+    TEST_ASSERT_TRUE(fabs(est.course - 90) < 1);
+    TEST_ASSERT_EQUAL(1, fusion.resets);
+    TEST_ASSERT_EQUAL(0, fusion.rejected);
+
+    /* Prediction without a fix carries on along the track */
+    gnss_fusion_get_estimate(&fusion, 3605 * 1000LL, &est);
+    double lon = 179.5 + 30.0 * 3605 / m_per_deg_lon - 360;
+    TEST_ASSERT_TRUE(distance_m(est.lat_e7 / 1e7, est.lon_e7 / 1e7, lat, lon) < 20);
+}
+
+TEST_CASE("gnss fusion rejects invalid fixes and restarts after a gap", "[gnss_fusion]")
+{
+    gnss_fusion_t fusion;
+    gnss_fusion_estimate_t est;
+    gnss_fusion_config_t config = GNSS_FUSION_CONFIG_DEFAULT();
+
+    config.max_gap_ms = 60000;
+    gnss_fusion_init(&fusion, &config);
+    TEST_ASSERT_FALSE(gnss_fusion_get_estimate(&fusion, 0, &est));
+    TEST_ASSERT_EQUAL(GNSS_FUSION_INVALID, feed(&fusion, 0, 31.2, 121.4, 0));
+    TEST_ASSERT_EQUAL(GNSS_FUSION_INVALID, feed(&fusion, 0, 31.2, 121.4, NAN));
+    TEST_ASSERT_EQUAL(GNSS_FUSION_INVALID, feed(&fusion, 0, 91, 121.4, 5));
+    TEST_ASSERT_EQUAL(GNSS_FUSION_INVALID, feed(&fusion, 0, 31.2, -180.5, 5));
+    TEST_ASSERT_FALSE(gnss_fusion_get_estimate(&fusion, 0, &est));
+
+    TEST_ASSERT_EQUAL(GNSS_FUSION_RESET, feed(&fusion, 0, 31.2, 121.4, 5));
+    TEST_ASSERT_EQUAL(GNSS_FUSION_ACCEPTED, feed(&fusion, 60000, 31.2, 121.4, 5));
+    TEST_ASSERT_EQUAL(GNSS_FUSION_RESET, feed(&fusion, 120001, 31.2, 121.4, 5));
+    /* Out of order fixes are merged as if simultaneous */
+    TEST_ASSERT_EQUAL(GNSS_FUSION_ACCEPTED, feed(&fusion, 100000, 31.2, 121.4, 5));
+    TEST_ASSERT_EQUAL(120001, fusion.time_ms);
+
+    gnss_fusion_reset(&fusion);
+    TEST_ASSERT_FALSE(gnss_fusion_get_estimate(&fusion, 120001, &est));
+}
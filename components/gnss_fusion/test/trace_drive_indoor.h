@@ -0,0 +1,444 @@
+/*
+ * Replay trace: a 5 minute drive on GNSS, 5 minutes parked indoors on cell
+ * (LBS) positioning only, then GNSS again and a slow drive north.
+ *
+ * GNSS fixes are 1 Hz with the accuracy the GPS task derives from HDOP,
+ * LBS fixes are 15 s apart with the <acc> reported by +CLBS. The trace
+ * contains multipath spikes at 120 s, 121 s and 210 s and a 4.2 km cell
+ * outlier at 435 s. Ground truth is included for scoring.
+ */
+#pragma once
+
+#include <stdint.h>
+
+typedef struct {
+    int64_t time_ms;
+    double latitude;
+    double longitude;
+    float accuracy;
+    uint8_t source;         /* 0 = GNSS, 1 = LBS */
+    double true_latitude;
+    double true_longitude;
+} trace_fix_t;
+
+static const trace_fix_t trace_drive_indoor[] = {
+    { 0, 31.2304389, 121.4736450, 6.5f, 0, 31.2304160, 121.4737010 },
+    { 1000, 31.2303950, 121.4737042, 4.5f, 0, 31.2304160, 121.4737126 },
+    { 2000, 31.2304426, 121.4737623, 6.5f, 0, 31.2304160, 121.4737452 },
+    { 3000, 31.2304520, 121.4737759, 5.0f, 0, 31.2304160, 121.4737988 },
+    { 4000, 31.2304066, 121.4739194, 6.0f, 0, 31.2304160, 121.4738735 },
+    { 5000, 31.2303957, 121.4739299, 5.0f, 0, 31.2304160, 121.4739576 },
+    { 6000, 31.2304154, 121.4740377, 4.5f, 0, 31.2304160, 121.4740418 },
+    { 7000, 31.2304063, 121.4740774, 5.5f, 0, 31.2304160, 121.4741259 },
+    { 8000, 31.2304100, 121.4742021, 8.0f, 0, 31.2304160, 121.4742100 },
+    { 9000, 31.2304666, 121.4742941, 6.0f, 0, 31.2304160, 121.4742942 },
+    { 10000, 31.2304500, 121.4744439, 7.5f, 0, 31.2304160, 121.4743783 },
+    { 11000, 31.2304415, 121.4744758, 5.0f, 0, 31.2304160, 121.4744625 },
+    { 12000, 31.2304373, 121.4745406, 5.5f, 0, 31.2304160, 121.4745466 },
+    { 13000, 31.2304005, 121.4746235, 5.5f, 0, 31.2304160, 121.4746307 },
+    { 14000, 31.2304611, 121.4747184, 5.5f, 0, 31.2304160, 121.4747149 },
+    { 15000, 31.2304099, 121.4747985, 5.0f, 0, 31.2304160, 121.4747990 },
+    { 16000, 31.2304550, 121.4747896, 7.5f, 0, 31.2304160, 121.4748831 },
+    { 17000, 31.2304086, 121.4749729, 7.0f, 0, 31.2304160, 121.4749673 },
+    { 18000, 31.2304042, 121.4749657, 7.0f, 0, 31.2304160, 121.4750514 },
+    { 19000, 31.2304747, 121.4750875, 6.5f, 0, 31.2304160, 121.4751356 },
+    { 20000, 31.2304385, 121.4752246, 8.0f, 0, 31.2304160, 121.4752197 },
+    { 21000, 31.2304009, 121.4752922, 6.0f, 0, 31.2304160, 121.4753038 },
+    { 22000, 31.2304002, 121.4753212, 6.5f, 0, 31.2304160, 121.4753880 },
+    { 23000, 31.2304374, 121.4754927, 4.5f, 0, 31.2304160, 121.4754721 },
+    { 24000, 31.2303855, 121.4754976, 7.0f, 0, 31.2304160, 121.4755562 },
+    { 25000, 31.2304240, 121.4756849, 5.0f, 0, 31.2304160, 121.4756404 },
+    { 26000, 31.2304184, 121.4757407, 6.5f, 0, 31.2304160, 121.4757245 },
+    { 27000, 31.2303949, 121.4757944, 7.0f, 0, 31.2304160, 121.4758087 },
+    { 28000, 31.2304186, 121.4758875, 5.0f, 0, 31.2304160, 121.4758928 },
+    { 29000, 31.2304234, 121.4759775, 5.0f, 0, 31.2304160, 121.4759769 },
+    { 30000, 31.2304116, 121.4760745, 6.0f, 0, 31.2304160, 121.4760611 },
+    { 31000, 31.2303968, 121.4761195, 7.0f, 0, 31.2304160, 121.4761452 },
+    { 32000, 31.2303906, 121.4762337, 6.5f, 0, 31.2304160, 121.4762294 },
+    { 33000, 31.2303944, 121.4762889, 5.5f, 0, 31.2304160, 121.4763135 },
+    { 34000, 31.2304366, 121.4763630, 4.5f, 0, 31.2304160, 121.4763976 },
+    { 35000, 31.2304400, 121.4764677, 6.5f, 0, 31.2304160, 121.4764818 },
+    { 36000, 31.2303816, 121.4765427, 4.5f, 0, 31.2304160, 121.4765659 },
+    { 37000, 31.2304094, 121.4766419, 5.0f, 0, 31.2304160, 121.4766500 },
+    { 38000, 31.2304039, 121.4767128, 4.5f, 0, 31.2304160, 121.4767342 },
+    { 39000, 31.2304273, 121.4768549, 5.5f, 0, 31.2304160, 121.4768183 },
+    { 40000, 31.2304585, 121.4769090, 6.0f, 0, 31.2304160, 121.4769025 },
+    { 41000, 31.2304256, 121.4769780, 5.0f, 0, 31.2304160, 121.4769866 },
+    { 42000, 31.2303866, 121.4769810, 7.5f, 0, 31.2304160, 121.4770707 },
+    { 43000, 31.2303750, 121.4771628, 5.5f, 0, 31.2304160, 121.4771549 },
+    { 44000, 31.2304045, 121.4772639, 4.0f, 0, 31.2304160, 121.4772390 },
+    { 45000, 31.2304323, 121.4773049, 5.5f, 0, 31.2304160, 121.4773231 },
+    { 46000, 31.2304303, 121.4773674, 7.0f, 0, 31.2304160, 121.4774073 },
+    { 47000, 31.2303786, 121.4774732, 6.0f, 0, 31.2304160, 121.4774914 },
+    { 48000, 31.2303843, 121.4775071, 5.0f, 0, 31.2304160, 121.4775756 },
+    { 49000, 31.2303740, 121.4776981, 5.5f, 0, 31.2304160, 121.4776597 },
+    { 50000, 31.2304124, 121.4777706, 6.0f, 0, 31.2304160, 121.4777438 },
+    { 51000, 31.2304230, 121.4778156, 5.0f, 0, 31.2304160, 121.4778280 },
+    { 52000, 31.2304373, 121.4778939, 4.5f, 0, 31.2304160, 121.4779121 },
+    { 53000, 31.2303862, 121.4780321, 6.5f, 0, 31.2304160, 121.4779963 },
+    { 54000, 31.2304160, 121.4780839, 6.0f, 0, 31.2304160, 121.4780804 },
+    { 55000, 31.2305204, 121.4781543, 6.0f, 0, 31.2304160, 121.4781645 },
+    { 56000, 31.2304248, 121.4782569, 7.5f, 0, 31.2304160, 121.4782487 },
+    { 57000, 31.2304043, 121.4784047, 7.5f, 0, 31.2304160, 121.4783328 },
+    { 58000, 31.2303953, 121.4784498, 4.5f, 0, 31.2304160, 121.4784169 },
+    { 59000, 31.2303681, 121.4784627, 7.5f, 0, 31.2304160, 121.4785011 },
+    { 60000, 31.2304280, 121.4785613, 7.5f, 0, 31.2304160, 121.4785852 },
+    { 61000, 31.2304577, 121.4786459, 4.5f, 0, 31.2304281, 121.4786796 },
+    { 62000, 31.2304762, 121.4787491, 7.5f, 0, 31.2304635, 121.4787760 },
+    { 63000, 31.2305623, 121.4788440, 4.5f, 0, 31.2305190, 121.4788583 },
+    { 64000, 31.2305541, 121.4788799, 4.0f, 0, 31.2305909, 121.4789211 },
+    { 65000, 31.2306661, 121.4789579, 6.0f, 0, 31.2306742, 121.4789599 },
+    { 66000, 31.2307471, 121.4789661, 6.0f, 0, 31.2307632, 121.4789723 },
+    { 67000, 31.2308553, 121.4789161, 5.0f, 0, 31.2308531, 121.4789723 },
+    { 68000, 31.2309154, 121.4789378, 6.5f, 0, 31.2309431, 121.4789723 },
+    { 69000, 31.2310219, 121.4790201, 5.0f, 0, 31.2310330, 121.4789723 },
+    { 70000, 31.2311213, 121.4790134, 4.0f, 0, 31.2311229, 121.4789723 },
+    { 71000, 31.2311505, 121.4789789, 4.5f, 0, 31.2312129, 121.4789723 },
+    { 72000, 31.2312939, 121.4789595, 5.5f, 0, 31.2313028, 121.4789723 },
+    { 73000, 31.2314082, 121.4789779, 5.0f, 0, 31.2313927, 121.4789723 },
+    { 74000, 31.2315167, 121.4789743, 5.0f, 0, 31.2314827, 121.4789723 },
+    { 75000, 31.2315671, 121.4791048, 7.0f, 0, 31.2315726, 121.4789723 },
+    { 76000, 31.2316493, 121.4789838, 4.0f, 0, 31.2316625, 121.4789723 },
+    { 77000, 31.2317481, 121.4789910, 5.5f, 0, 31.2317525, 121.4789723 },
+    { 78000, 31.2319433, 121.4789419, 8.0f, 0, 31.2318424, 121.4789723 },
+    { 79000, 31.2319318, 121.4789648, 5.0f, 0, 31.2319323, 121.4789723 },
+    { 80000, 31.2319949, 121.4789824, 7.0f, 0, 31.2320223, 121.4789723 },
+    { 81000, 31.2320549, 121.4789982, 7.0f, 0, 31.2321122, 121.4789723 },
+    { 82000, 31.2321946, 121.4789951, 4.5f, 0, 31.2322021, 121.4789723 },
+    { 83000, 31.2323104, 121.4790301, 4.5f, 0, 31.2322921, 121.4789723 },
+    { 84000, 31.2324261, 121.4790149, 5.5f, 0, 31.2323820, 121.4789723 },
+    { 85000, 31.2325012, 121.4789823, 4.5f, 0, 31.2324719, 121.4789723 },
+    { 86000, 31.2325585, 121.4789794, 4.5f, 0, 31.2325619, 121.4789723 },
+    { 87000, 31.2326579, 121.4790173, 6.0f, 0, 31.2326518, 121.4789723 },
+    { 88000, 31.2327620, 121.4790556, 7.5f, 0, 31.2327417, 121.4789723 },
+    { 89000, 31.2327976, 121.4790035, 7.5f, 0, 31.2328317, 121.4789723 },
+    { 90000, 31.2329945, 121.4789786, 7.5f, 0, 31.2329216, 121.4789723 },
+    { 91000, 31.2330112, 121.4789898, 6.0f, 0, 31.2330115, 121.4789723 },
+    { 92000, 31.2330789, 121.4789750, 8.0f, 0, 31.2331015, 121.4789723 },
+    { 93000, 31.2331968, 121.4789683, 6.5f, 0, 31.2331914, 121.4789723 },
+    { 94000, 31.2332772, 121.4789812, 6.0f, 0, 31.2332813, 121.4789723 },
+    { 95000, 31.2333828, 121.4791173, 7.0f, 0, 31.2333712, 121.4789723 },
+    { 96000, 31.2334575, 121.4790057, 6.5f, 0, 31.2334612, 121.4789723 },
+    { 97000, 31.2335638, 121.4788862, 7.5f, 0, 31.2335511, 121.4789723 },
+    { 98000, 31.2336455, 121.4788852, 6.5f, 0, 31.2336410, 121.4789723 },
+    { 99000, 31.2337473, 121.4789388, 5.0f, 0, 31.2337310, 121.4789723 },
+    { 100000, 31.2337950, 121.4789643, 7.0f, 0, 31.2338209, 121.4789723 },
+    { 101000, 31.2338448, 121.4789899, 6.0f, 0, 31.2339194, 121.4789894 },
+    { 102000, 31.2340170, 121.4790287, 6.0f, 0, 31.2340182, 121.4790391 },
+    { 103000, 31.2340734, 121.4791261, 5.5f, 0, 31.2341027, 121.4791170 },
+    { 104000, 31.2341721, 121.4792158, 4.0f, 0, 31.2341791, 121.4792063 },
+    { 105000, 31.2342413, 121.4793424, 4.5f, 0, 31.2342554, 121.4792955 },
+    { 106000, 31.2343378, 121.4794137, 5.5f, 0, 31.2343317, 121.4793847 },
+    { 107000, 31.2344429, 121.4794492, 5.0f, 0, 31.2344080, 121.4794740 },
+    { 108000, 31.2344861, 121.4795601, 7.0f, 0, 31.2344843, 121.4795632 },
+    { 109000, 31.2344998, 121.4796459, 7.0f, 0, 31.2345606, 121.4796525 },
+    { 110000, 31.2346324, 121.4797531, 5.0f, 0, 31.2346369, 121.4797417 },
+    { 111000, 31.2347398, 121.4798230, 6.0f, 0, 31.2347132, 121.4798309 },
+    { 112000, 31.2347842, 121.4798539, 5.0f, 0, 31.2347895, 121.4799202 },
+    { 113000, 31.2348563, 121.4801073, 8.0f, 0, 31.2348658, 121.4800094 },
+    { 114000, 31.2349130, 121.4801304, 5.5f, 0, 31.2349422, 121.4800987 },
+    { 115000, 31.2350151, 121.4802120, 7.5f, 0, 31.2350185, 121.4801879 },
+    { 116000, 31.2351375, 121.4803061, 5.0f, 0, 31.2350948, 121.4802772 },
+    { 117000, 31.2351837, 121.4803835, 4.5f, 0, 31.2351711, 121.4803664 },
+    { 118000, 31.2352831, 121.4804678, 7.5f, 0, 31.2352474, 121.4804556 },
+    { 119000, 31.2352870, 121.4805547, 5.0f, 0, 31.2353237, 121.4805449 },
+    { 120000, 31.2348363, 121.4813520, 7.5f, 0, 31.2354000, 121.4806341 },
+    { 121000, 31.2349771, 121.4814680, 5.5f, 0, 31.2354763, 121.4807234 },
+    { 122000, 31.2355470, 121.4808515, 4.0f, 0, 31.2355526, 121.4808126 },
+    { 123000, 31.2356095, 121.4808934, 4.0f, 0, 31.2356289, 121.4809018 },
+    { 124000, 31.2357385, 121.4809635, 4.5f, 0, 31.2357053, 121.4809911 },
+    { 125000, 31.2357658, 121.4810714, 5.5f, 0, 31.2357816, 121.4810803 },
+    { 126000, 31.2358402, 121.4812092, 7.0f, 0, 31.2358579, 121.4811696 },
+    { 127000, 31.2358944, 121.4812897, 7.5f, 0, 31.2359342, 121.4812588 },
+    { 128000, 31.2360375, 121.4813042, 7.5f, 0, 31.2360105, 121.4813481 },
+    { 129000, 31.2360696, 121.4814482, 6.0f, 0, 31.2360868, 121.4814373 },
+    { 130000, 31.2361314, 121.4815240, 6.5f, 0, 31.2361631, 121.4815265 },
+    { 131000, 31.2362839, 121.4816281, 5.5f, 0, 31.2362394, 121.4816158 },
+    { 132000, 31.2362983, 121.4816931, 4.0f, 0, 31.2363157, 121.4817050 },
+    { 133000, 31.2363922, 121.4817886, 5.0f, 0, 31.2363920, 121.4817943 },
+    { 134000, 31.2364901, 121.4818239, 6.5f, 0, 31.2364684, 121.4818835 },
+    { 135000, 31.2365089, 121.4820020, 4.5f, 0, 31.2365447, 121.4819728 },
+    { 136000, 31.2365854, 121.4820471, 7.5f, 0, 31.2366210, 121.4820620 },
+    { 137000, 31.2366641, 121.4821009, 6.0f, 0, 31.2366973, 121.4821512 },
+    { 138000, 31.2367518, 121.4822185, 7.5f, 0, 31.2367736, 121.4822405 },
+    { 139000, 31.2368423, 121.4823252, 6.0f, 0, 31.2368499, 121.4823297 },
+    { 140000, 31.2369570, 121.4824334, 7.5f, 0, 31.2369262, 121.4824190 },
+    { 141000, 31.2370193, 121.4825011, 6.0f, 0, 31.2370025, 121.4825082 },
+    { 142000, 31.2370661, 121.4825556, 5.5f, 0, 31.2370788, 121.4825974 },
+    { 143000, 31.2371595, 121.4826439, 6.0f, 0, 31.2371551, 121.4826867 },
+    { 144000, 31.2372281, 121.4828105, 5.0f, 0, 31.2372315, 121.4827759 },
+    { 145000, 31.2373288, 121.4828594, 6.5f, 0, 31.2373078, 121.4828652 },
+    { 146000, 31.2374050, 121.4829984, 7.0f, 0, 31.2373841, 121.4829544 },
+    { 147000, 31.2374172, 121.4830966, 6.0f, 0, 31.2374604, 121.4830437 },
+    { 148000, 31.2375052, 121.4831118, 5.5f, 0, 31.2375367, 121.4831329 },
+    { 149000, 31.2376426, 121.4831775, 5.5f, 0, 31.2376130, 121.4832221 },
+    { 150000, 31.2376848, 121.4833148, 5.5f, 0, 31.2376893, 121.4833114 },
+    { 151000, 31.2376943, 121.4834500, 6.0f, 0, 31.2377656, 121.4834006 },
+    { 152000, 31.2377707, 121.4834927, 7.0f, 0, 31.2378419, 121.4834899 },
+    { 153000, 31.2379036, 121.4836306, 5.5f, 0, 31.2379182, 121.4835791 },
+    { 154000, 31.2379880, 121.4836754, 6.5f, 0, 31.2379946, 121.4836683 },
+    { 155000, 31.2380742, 121.4837773, 4.0f, 0, 31.2380709, 121.4837576 },
+    { 156000, 31.2381340, 121.4838974, 7.5f, 0, 31.2381472, 121.4838468 },
+    { 157000, 31.2382265, 121.4839486, 7.0f, 0, 31.2382235, 121.4839361 },
+    { 158000, 31.2382764, 121.4840772, 4.5f, 0, 31.2382998, 121.4840253 },
+    { 159000, 31.2383446, 121.4840678, 7.0f, 0, 31.2383761, 121.4841146 },
+    { 160000, 31.2384311, 121.4841856, 5.0f, 0, 31.2384524, 121.4842038 },
+    { 161000, 31.2385560, 121.4844168, 5.5f, 0, 31.2385287, 121.4842930 },
+    { 162000, 31.2386178, 121.4843764, 5.5f, 0, 31.2386050, 121.4843823 },
+    { 163000, 31.2386864, 121.4844995, 5.0f, 0, 31.2386813, 121.4844715 },
+    { 164000, 31.2387664, 121.4845453, 4.5f, 0, 31.2387577, 121.4845608 },
+    { 165000, 31.2388729, 121.4846501, 4.5f, 0, 31.2388340, 121.4846500 },
+    { 166000, 31.2389073, 121.4847577, 4.5f, 0, 31.2389103, 121.4847393 },
+    { 167000, 31.2389958, 121.4848458, 7.0f, 0, 31.2389866, 121.4848285 },
+    { 168000, 31.2390264, 121.4849333, 5.0f, 0, 31.2390629, 121.4849177 },
+    { 169000, 31.2391302, 121.4850250, 4.0f, 0, 31.2391392, 121.4850070 },
+    { 170000, 31.2393124, 121.4850464, 8.0f, 0, 31.2392155, 121.4850962 },
+    { 171000, 31.2392740, 121.4851730, 5.0f, 0, 31.2392918, 121.4851855 },
+    { 172000, 31.2393323, 121.4852693, 7.0f, 0, 31.2393681, 121.4852747 },
+    { 173000, 31.2394027, 121.4853888, 5.5f, 0, 31.2394444, 121.4853639 },
+    { 174000, 31.2395185, 121.4854835, 7.5f, 0, 31.2395207, 121.4854532 },
+    { 175000, 31.2395166, 121.4855574, 6.5f, 0, 31.2395971, 121.4855424 },
+    { 176000, 31.2397034, 121.4856459, 7.5f, 0, 31.2396734, 121.4856317 },
+    { 177000, 31.2397263, 121.4857741, 4.0f, 0, 31.2397497, 121.4857209 },
+    { 178000, 31.2398271, 121.4857805, 5.5f, 0, 31.2398260, 121.4858102 },
+    { 179000, 31.2398952, 121.4858724, 4.5f, 0, 31.2399023, 121.4858994 },
+    { 180000, 31.2399908, 121.4859482, 6.5f, 0, 31.2399786, 121.4859886 },
+    { 181000, 31.2400236, 121.4860855, 6.0f, 0, 31.2400374, 121.4860800 },
+    { 182000, 31.2400631, 121.4861504, 5.0f, 0, 31.2400673, 121.4861665 },
+    { 183000, 31.2400852, 121.4862899, 4.5f, 0, 31.2400750, 121.4862383 },
+    { 184000, 31.2401145, 121.4862976, 8.0f, 0, 31.2400673, 121.4863006 },
+    { 185000, 31.2400421, 121.4863736, 5.0f, 0, 31.2400460, 121.4863584 },
+    { 186000, 31.2399719, 121.4864335, 7.0f, 0, 31.2400127, 121.4864078 },
+    { 187000, 31.2399536, 121.4864486, 7.0f, 0, 31.2399696, 121.4864455 },
+    { 188000, 31.2399263, 121.4864825, 7.0f, 0, 31.2399196, 121.4864688 },
+    { 189000, 31.2399041, 121.4864883, 4.0f, 0, 31.2398662, 121.4864762 },
+    { 190000, 31.2397901, 121.4864658, 8.0f, 0, 31.2398122, 121.4864762 },
+    { 191000, 31.2397007, 121.4864402, 7.0f, 0, 31.2397583, 121.4864762 },
+    { 192000, 31.2396984, 121.4865124, 4.5f, 0, 31.2397043, 121.4864762 },
+    { 193000, 31.2396584, 121.4864587, 6.0f, 0, 31.2396504, 121.4864762 },
+    { 194000, 31.2395755, 121.4865285, 8.0f, 0, 31.2395964, 121.4864762 },
+    { 195000, 31.2395070, 121.4864688, 4.5f, 0, 31.2395424, 121.4864762 },
+    { 196000, 31.2394559, 121.4865484, 7.5f, 0, 31.2394885, 121.4864762 },
+    { 197000, 31.2394128, 121.4865045, 6.5f, 0, 31.2394345, 121.4864762 },
+    { 198000, 31.2394171, 121.4864611, 4.0f, 0, 31.2393806, 121.4864762 },
+    { 199000, 31.2392700, 121.4864488, 7.5f, 0, 31.2393266, 121.4864762 },
+    { 200000, 31.2392912, 121.4865013, 4.0f, 0, 31.2392727, 121.4864762 },
+    { 201000, 31.2392161, 121.4864137, 7.5f, 0, 31.2392187, 121.4864762 },
+    { 202000, 31.2392005, 121.4864315, 6.5f, 0, 31.2391647, 121.4864762 },
+    { 203000, 31.2390751, 121.4865110, 5.5f, 0, 31.2391108, 121.4864762 },
+    { 204000, 31.2389921, 121.4865048, 7.0f, 0, 31.2390568, 121.4864762 },
+    { 205000, 31.2390090, 121.4864333, 7.0f, 0, 31.2390029, 121.4864762 },
+    { 206000, 31.2389130, 121.4864762, 5.0f, 0, 31.2389489, 121.4864762 },
+    { 207000, 31.2388944, 121.4865553, 7.0f, 0, 31.2388949, 121.4864762 },
+    { 208000, 31.2388948, 121.4864464, 6.5f, 0, 31.2388410, 121.4864762 },
+    { 209000, 31.2387760, 121.4864699, 5.5f, 0, 31.2387870, 121.4864762 },
+    { 210000, 31.2382277, 121.4871964, 4.0f, 0, 31.2387331, 121.4864762 },
+    { 211000, 31.2386136, 121.4865030, 7.0f, 0, 31.2386791, 121.4864762 },
+    { 212000, 31.2386057, 121.4864668, 4.0f, 0, 31.2386251, 121.4864762 },
+    { 213000, 31.2385396, 121.4864707, 5.0f, 0, 31.2385712, 121.4864762 },
+    { 214000, 31.2384966, 121.4864779, 5.0f, 0, 31.2385172, 121.4864762 },
+    { 215000, 31.2384931, 121.4864574, 6.0f, 0, 31.2384633, 121.4864762 },
+    { 216000, 31.2383819, 121.4865087, 5.0f, 0, 31.2384093, 121.4864762 },
+    { 217000, 31.2383740, 121.4865368, 5.5f, 0, 31.2383553, 121.4864762 },
+    { 218000, 31.2382954, 121.4864882, 6.0f, 0, 31.2383014, 121.4864762 },
+    { 219000, 31.2382081, 121.4864714, 5.5f, 0, 31.2382474, 121.4864762 },
+    { 220000, 31.2381789, 121.4864185, 8.0f, 0, 31.2381935, 121.4864762 },
+    { 221000, 31.2381551, 121.4863847, 7.0f, 0, 31.2381395, 121.4864762 },
+    { 222000, 31.2381148, 121.4864729, 5.5f, 0, 31.2380855, 121.4864762 },
+    { 223000, 31.2380274, 121.4865299, 7.0f, 0, 31.2380316, 121.4864762 },
+    { 224000, 31.2380389, 121.4864487, 6.0f, 0, 31.2379776, 121.4864762 },
+    { 225000, 31.2379022, 121.4864969, 4.0f, 0, 31.2379237, 121.4864762 },
+    { 226000, 31.2378419, 121.4865042, 7.0f, 0, 31.2378697, 121.4864762 },
+    { 227000, 31.2378146, 121.4864425, 5.5f, 0, 31.2378158, 121.4864762 },
+    { 228000, 31.2377504, 121.4864292, 6.5f, 0, 31.2377618, 121.4864762 },
+    { 229000, 31.2377550, 121.4864978, 6.5f, 0, 31.2377078, 121.4864762 },
+    { 230000, 31.2376926, 121.4864712, 5.0f, 0, 31.2376539, 121.4864762 },
+    { 231000, 31.2375145, 121.4864238, 7.5f, 0, 31.2375909, 121.4864650 },
+    { 232000, 31.2375882, 121.4865139, 7.5f, 0, 31.2375161, 121.4864269 },
+    { 233000, 31.2374443, 121.4864467, 7.0f, 0, 31.2374457, 121.4863620 },
+    { 234000, 31.2374257, 121.4862430, 7.5f, 0, 31.2373920, 121.4862780 },
+    { 235000, 31.2373882, 121.4861863, 5.0f, 0, 31.2373588, 121.4861806 },
+    { 236000, 31.2373568, 121.4860325, 7.0f, 0, 31.2373482, 121.4860764 },
+    { 237000, 31.2372768, 121.4860744, 6.0f, 0, 31.2373482, 121.4859713 },
+    { 238000, 31.2373130, 121.4858732, 6.0f, 0, 31.2373482, 121.4858661 },
+    { 239000, 31.2373500, 121.4857237, 5.5f, 0, 31.2373482, 121.4857609 },
+    { 240000, 31.2373707, 121.4856662, 7.5f, 0, 31.2373482, 121.4856557 },
+    { 241000, 31.2373359, 121.4855076, 7.5f, 0, 31.2373482, 121.4855506 },
+    { 242000, 31.2373331, 121.4854805, 6.0f, 0, 31.2373482, 121.4854454 },
+    { 243000, 31.2373518, 121.4853099, 4.0f, 0, 31.2373482, 121.4853402 },
+    { 244000, 31.2373493, 121.4851946, 5.0f, 0, 31.2373482, 121.4852350 },
+    { 245000, 31.2372906, 121.4852185, 8.0f, 0, 31.2373482, 121.4851299 },
+    { 246000, 31.2373596, 121.4850251, 5.5f, 0, 31.2373482, 121.4850247 },
+    { 247000, 31.2372535, 121.4849317, 7.5f, 0, 31.2373482, 121.4849195 },
+    { 248000, 31.2372976, 121.4848963, 7.5f, 0, 31.2373482, 121.4848144 },
+    { 249000, 31.2373749, 121.4847275, 7.5f, 0, 31.2373482, 121.4847092 },
+    { 250000, 31.2373692, 121.4845947, 5.0f, 0, 31.2373482, 121.4846040 },
+    { 251000, 31.2373617, 121.4844364, 5.5f, 0, 31.2373482, 121.4844988 },
+    { 252000, 31.2373279, 121.4844364, 5.0f, 0, 31.2373482, 121.4843937 },
+    { 253000, 31.2373455, 121.4842803, 5.0f, 0, 31.2373482, 121.4842885 },
+    { 254000, 31.2373413, 121.4841423, 5.5f, 0, 31.2373482, 121.4841833 },
+    { 255000, 31.2373865, 121.4840882, 4.5f, 0, 31.2373482, 121.4840781 },
+    { 256000, 31.2373322, 121.4839454, 7.0f, 0, 31.2373482, 121.4839730 },
+    { 257000, 31.2373790, 121.4839033, 4.5f, 0, 31.2373482, 121.4838678 },
+    { 258000, 31.2373902, 121.4837336, 6.0f, 0, 31.2373482, 121.4837626 },
+    { 259000, 31.2373484, 121.4836557, 4.0f, 0, 31.2373482, 121.4836575 },
+    { 260000, 31.2373024, 121.4835072, 4.5f, 0, 31.2373482, 121.4835523 },
+    { 261000, 31.2373221, 121.4834074, 7.0f, 0, 31.2373482, 121.4834471 },
+    { 262000, 31.2373156, 121.4833339, 4.0f, 0, 31.2373482, 121.4833419 },
+    { 263000, 31.2373736, 121.4832259, 7.0f, 0, 31.2373482, 121.4832368 },
+    { 264000, 31.2372668, 121.4830457, 7.5f, 0, 31.2373482, 121.4831316 },
+    { 265000, 31.2373670, 121.4830562, 5.5f, 0, 31.2373482, 121.4830264 },
+    { 266000, 31.2373424, 121.4828842, 7.5f, 0, 31.2373482, 121.4829212 },
+    { 267000, 31.2373272, 121.4828086, 4.5f, 0, 31.2373482, 121.4828161 },
+    { 268000, 31.2373878, 121.4827624, 7.5f, 0, 31.2373482, 121.4827109 },
+    { 269000, 31.2373575, 121.4825546, 5.5f, 0, 31.2373482, 121.4826057 },
+    { 270000, 31.2373056, 121.4825497, 8.0f, 0, 31.2373482, 121.4825006 },
+    { 271000, 31.2373382, 121.4824454, 5.5f, 0, 31.2373482, 121.4823954 },
+    { 272000, 31.2373503, 121.4822663, 4.0f, 0, 31.2373482, 121.4822902 },
+    { 273000, 31.2373974, 121.4822315, 6.5f, 0, 31.2373482, 121.4821850 },
+    { 274000, 31.2373213, 121.4820957, 7.5f, 0, 31.2373482, 121.4820799 },
+    { 275000, 31.2373947, 121.4819390, 7.0f, 0, 31.2373482, 121.4819747 },
+    { 276000, 31.2373516, 121.4818983, 6.0f, 0, 31.2373482, 121.4818695 },
+    { 277000, 31.2374005, 121.4817489, 6.5f, 0, 31.2373482, 121.4817643 },
+    { 278000, 31.2373266, 121.4816045, 7.0f, 0, 31.2373482, 121.4816592 },
+    { 279000, 31.2373201, 121.4815884, 6.5f, 0, 31.2373482, 121.4815540 },
+    { 280000, 31.2372903, 121.4814191, 6.0f, 0, 31.2373482, 121.4814488 },
+    { 281000, 31.2373114, 121.4813482, 8.0f, 0, 31.2373482, 121.4813437 },
+    { 282000, 31.2373311, 121.4812214, 5.0f, 0, 31.2373482, 121.4812385 },
+    { 283000, 31.2373098, 121.4811702, 7.5f, 0, 31.2373482, 121.4811333 },
+    { 284000, 31.2373168, 121.4810010, 8.0f, 0, 31.2373482, 121.4810281 },
+    { 285000, 31.2373588, 121.4809636, 6.5f, 0, 31.2373482, 121.4809230 },
+    { 286000, 31.2373423, 121.4808239, 4.5f, 0, 31.2373482, 121.4808178 },
+    { 287000, 31.2373452, 121.4807034, 4.5f, 0, 31.2373482, 121.4807126 },
+    { 288000, 31.2373701, 121.4806277, 6.5f, 0, 31.2373482, 121.4806074 },
+    { 289000, 31.2373577, 121.4805358, 6.5f, 0, 31.2373482, 121.4805023 },
+    { 290000, 31.2373243, 121.4804325, 4.0f, 0, 31.2373482, 121.4803971 },
+    { 291000, 31.2373231, 121.4803107, 6.5f, 0, 31.2373482, 121.4802919 },
+    { 292000, 31.2372795, 121.4801570, 8.0f, 0, 31.2373482, 121.4801868 },
+    { 293000, 31.2373414, 121.4800671, 4.5f, 0, 31.2373482, 121.4800816 },
+    { 294000, 31.2373509, 121.4799736, 4.5f, 0, 31.2373482, 121.4799764 },
+    { 295000, 31.2373291, 121.4798944, 7.0f, 0, 31.2373482, 121.4798712 },
+    { 296000, 31.2372878, 121.4797594, 5.5f, 0, 31.2373482, 121.4797776 },
+    { 297000, 31.2373350, 121.4796654, 4.5f, 0, 31.2373482, 121.4797051 },
+    { 298000, 31.2373570, 121.4796225, 5.5f, 0, 31.2373482, 121.4796535 },
+    { 299000, 31.2373727, 121.4795903, 7.0f, 0, 31.2373482, 121.4796230 },
+    { 315000, 31.2355580, 121.4829783, 450.0f, 1, 31.2373482, 121.4796136 },
+    { 330000, 31.2379953, 121.4801692, 800.0f, 1, 31.2373482, 121.4796136 },
+    { 345000, 31.2369425, 121.4786437, 600.0f, 1, 31.2373482, 121.4796136 },
+    { 360000, 31.2340418, 121.4771898, 550.0f, 1, 31.2373482, 121.4796136 },
+    { 375000, 31.2356177, 121.4788395, 450.0f, 1, 31.2373482, 121.4796136 },
+    { 390000, 31.2376711, 121.4814115, 800.0f, 1, 31.2373482, 121.4796136 },
+    { 405000, 31.2406163, 121.4805570, 550.0f, 1, 31.2373482, 121.4796136 },
+    { 420000, 31.2366981, 121.4799155, 800.0f, 1, 31.2373482, 121.4796136 },
+    { 435000, 31.2142178, 121.5145348, 800.0f, 1, 31.2373482, 121.4796136 },
+    { 450000, 31.2371465, 121.4797031, 600.0f, 1, 31.2373482, 121.4796136 },
+    { 465000, 31.2359960, 121.4748230, 450.0f, 1, 31.2373482, 121.4796136 },
+    { 480000, 31.2387927, 121.4811034, 600.0f, 1, 31.2373482, 121.4796136 },
+    { 495000, 31.2409866, 121.4818655, 600.0f, 1, 31.2373482, 121.4796136 },
+    { 510000, 31.2390847, 121.4776727, 600.0f, 1, 31.2373482, 121.4796136 },
+    { 525000, 31.2375463, 121.4785725, 550.0f, 1, 31.2373482, 121.4796136 },
+    { 540000, 31.2372806, 121.4807201, 550.0f, 1, 31.2373482, 121.4796136 },
+    { 555000, 31.2400678, 121.4763145, 600.0f, 1, 31.2373482, 121.4796136 },
+    { 570000, 31.2384319, 121.4842367, 550.0f, 1, 31.2373482, 121.4796136 },
+    { 585000, 31.2374874, 121.4806701, 450.0f, 1, 31.2373482, 121.4796136 },
+    { 600000, 31.2373728, 121.4795987, 5.5f, 0, 31.2373482, 121.4796136 },
+    { 601000, 31.2373130, 121.4796100, 5.0f, 0, 31.2373482, 121.4796136 },
+    { 602000, 31.2373941, 121.4795226, 10.0f, 0, 31.2373482, 121.4796136 },
+    { 603000, 31.2374670, 121.4796709, 12.0f, 0, 31.2373482, 121.4796136 },
+    { 604000, 31.2374121, 121.4796675, 9.0f, 0, 31.2373482, 121.4796136 },
+    { 605000, 31.2372705, 121.4796203, 5.0f, 0, 31.2373482, 121.4796136 },
+    { 606000, 31.2373723, 121.4796340, 12.5f, 0, 31.2373482, 121.4796136 },
+    { 607000, 31.2373676, 121.4795334, 11.5f, 0, 31.2373482, 121.4796136 },
+    { 608000, 31.2373523, 121.4796031, 5.5f, 0, 31.2373482, 121.4796136 },
+    { 609000, 31.2373208, 121.4796929, 8.5f, 0, 31.2373482, 121.4796136 },
+    { 610000, 31.2373802, 121.4796146, 12.5f, 0, 31.2373482, 121.4796136 },
+    { 611000, 31.2372491, 121.4796215, 11.5f, 0, 31.2373482, 121.4796136 },
+    { 612000, 31.2373834, 121.4796539, 9.5f, 0, 31.2373482, 121.4796136 },
+    { 613000, 31.2374115, 121.4796178, 9.5f, 0, 31.2373482, 121.4796136 },
+    { 614000, 31.2373153, 121.4795770, 6.5f, 0, 31.2373482, 121.4796136 },
+    { 615000, 31.2373366, 121.4795956, 5.5f, 0, 31.2373482, 121.4796136 },
+    { 616000, 31.2373970, 121.4794745, 12.0f, 0, 31.2373482, 121.4796136 },
+    { 617000, 31.2373583, 121.4795869, 8.5f, 0, 31.2373482, 121.4796136 },
+    { 618000, 31.2372858, 121.4796478, 10.5f, 0, 31.2373482, 121.4796136 },
+    { 619000, 31.2372984, 121.4795687, 10.5f, 0, 31.2373482, 121.4796136 },
+    { 620000, 31.2373877, 121.4796252, 7.5f, 0, 31.2373482, 121.4796136 },
+    { 621000, 31.2373950, 121.4795603, 11.0f, 0, 31.2373932, 121.4796136 },
+    { 622000, 31.2374228, 121.4795970, 11.0f, 0, 31.2374382, 121.4796136 },
+    { 623000, 31.2374390, 121.4796933, 8.5f, 0, 31.2374831, 121.4796136 },
+    { 624000, 31.2375314, 121.4796597, 8.5f, 0, 31.2375281, 121.4796136 },
+    { 625000, 31.2375290, 121.4796310, 8.5f, 0, 31.2375731, 121.4796136 },
+    { 626000, 31.2376237, 121.4795722, 9.5f, 0, 31.2376180, 121.4796136 },
+    { 627000, 31.2376802, 121.4796170, 5.0f, 0, 31.2376630, 121.4796136 },
+    { 628000, 31.2377128, 121.4796270, 11.0f, 0, 31.2377080, 121.4796136 },
+    { 629000, 31.2377216, 121.4795365, 11.5f, 0, 31.2377529, 121.4796136 },
+    { 630000, 31.2377377, 121.4795916, 7.5f, 0, 31.2377979, 121.4796136 },
+    { 631000, 31.2377949, 121.4796472, 6.5f, 0, 31.2378429, 121.4796136 },
+    { 632000, 31.2378592, 121.4796117, 6.0f, 0, 31.2378878, 121.4796136 },
+    { 633000, 31.2378820, 121.4796945, 9.5f, 0, 31.2379328, 121.4796136 },
+    { 634000, 31.2380043, 121.4795413, 11.0f, 0, 31.2379778, 121.4796136 },
+    { 635000, 31.2380601, 121.4796765, 10.0f, 0, 31.2380227, 121.4796136 },
+    { 636000, 31.2380221, 121.4796028, 9.5f, 0, 31.2380677, 121.4796136 },
+    { 637000, 31.2380954, 121.4795633, 12.0f, 0, 31.2381127, 121.4796136 },
+    { 638000, 31.2381326, 121.4796595, 10.0f, 0, 31.2381576, 121.4796136 },
+    { 639000, 31.2381979, 121.4795817, 5.0f, 0, 31.2382026, 121.4796136 },
+    { 640000, 31.2382708, 121.4795985, 11.0f, 0, 31.2382476, 121.4796136 },
+    { 641000, 31.2383529, 121.4797153, 9.5f, 0, 31.2382925, 121.4796136 },
+    { 642000, 31.2383657, 121.4794922, 10.5f, 0, 31.2383375, 121.4796136 },
+    { 643000, 31.2383691, 121.4796484, 5.5f, 0, 31.2383825, 121.4796136 },
+    { 644000, 31.2384357, 121.4797477, 9.0f, 0, 31.2384274, 121.4796136 },
+    { 645000, 31.2384501, 121.4796244, 6.5f, 0, 31.2384724, 121.4796136 },
+    { 646000, 31.2385669, 121.4796338, 11.0f, 0, 31.2385174, 121.4796136 },
+    { 647000, 31.2385255, 121.4796488, 5.5f, 0, 31.2385623, 121.4796136 },
+    { 648000, 31.2386115, 121.4794974, 9.0f, 0, 31.2386073, 121.4796136 },
+    { 649000, 31.2385973, 121.4796662, 7.5f, 0, 31.2386523, 121.4796136 },
+    { 650000, 31.2386922, 121.4796279, 5.5f, 0, 31.2386972, 121.4796136 },
+    { 651000, 31.2387351, 121.4796321, 7.5f, 0, 31.2387422, 121.4796136 },
+    { 652000, 31.2387680, 121.4796378, 8.5f, 0, 31.2387872, 121.4796136 },
+    { 653000, 31.2388659, 121.4796131, 10.5f, 0, 31.2388321, 121.4796136 },
+    { 654000, 31.2389534, 121.4795622, 11.5f, 0, 31.2388771, 121.4796136 },
+    { 655000, 31.2389642, 121.4795086, 9.5f, 0, 31.2389220, 121.4796136 },
+    { 656000, 31.2389890, 121.4796126, 7.0f, 0, 31.2389670, 121.4796136 },
+    { 657000, 31.2390557, 121.4796066, 9.5f, 0, 31.2390120, 121.4796136 },
+    { 658000, 31.2391302, 121.4796661, 7.0f, 0, 31.2390569, 121.4796136 },
+    { 659000, 31.2390772, 121.4795620, 9.5f, 0, 31.2391019, 121.4796136 },
+    { 660000, 31.2392348, 121.4795790, 8.0f, 0, 31.2391469, 121.4796136 },
+    { 661000, 31.2391993, 121.4796138, 6.0f, 0, 31.2391918, 121.4796136 },
+    { 662000, 31.2392340, 121.4796348, 5.5f, 0, 31.2392368, 121.4796136 },
+    { 663000, 31.2392465, 121.4796356, 8.0f, 0, 31.2392818, 121.4796136 },
+    { 664000, 31.2392695, 121.4796838, 10.0f, 0, 31.2393267, 121.4796136 },
+    { 665000, 31.2393343, 121.4795600, 11.0f, 0, 31.2393717, 121.4796136 },
+    { 666000, 31.2393512, 121.4795618, 12.5f, 0, 31.2394167, 121.4796136 },
+    { 667000, 31.2394638, 121.4796534, 6.5f, 0, 31.2394616, 121.4796136 },
+    { 668000, 31.2394703, 121.4796521, 7.0f, 0, 31.2395066, 121.4796136 },
+    { 669000, 31.2395581, 121.4795989, 6.5f, 0, 31.2395516, 121.4796136 },
+    { 670000, 31.2395667, 121.4795665, 9.0f, 0, 31.2395965, 121.4796136 },
+    { 671000, 31.2397161, 121.4797095, 10.0f, 0, 31.2396415, 121.4796136 },
+    { 672000, 31.2397458, 121.4795919, 8.5f, 0, 31.2396865, 121.4796136 },
+    { 673000, 31.2397827, 121.4796478, 8.5f, 0, 31.2397314, 121.4796136 },
+    { 674000, 31.2398117, 121.4796212, 11.5f, 0, 31.2397764, 121.4796136 },
+    { 675000, 31.2398116, 121.4796353, 6.0f, 0, 31.2398214, 121.4796136 },
+    { 676000, 31.2397586, 121.4797112, 11.5f, 0, 31.2398663, 121.4796136 },
+    { 677000, 31.2398900, 121.4796258, 6.0f, 0, 31.2399113, 121.4796136 },
+    { 678000, 31.2399596, 121.4797719, 12.5f, 0, 31.2399563, 121.4796136 },
+    { 679000, 31.2399799, 121.4796116, 9.0f, 0, 31.2400012, 121.4796136 },
+    { 680000, 31.2400197, 121.4796503, 8.5f, 0, 31.2400462, 121.4796136 },
+    { 681000, 31.2400873, 121.4794895, 12.0f, 0, 31.2400912, 121.4796136 },
+    { 682000, 31.2400877, 121.4794969, 11.0f, 0, 31.2401361, 121.4796136 },
+    { 683000, 31.2401018, 121.4796724, 12.0f, 0, 31.2401811, 121.4796136 },
+    { 684000, 31.2402205, 121.4795771, 8.5f, 0, 31.2402261, 121.4796136 },
+    { 685000, 31.2403044, 121.4796024, 9.5f, 0, 31.2402710, 121.4796136 },
+    { 686000, 31.2402666, 121.4796833, 6.0f, 0, 31.2403160, 121.4796136 },
+    { 687000, 31.2403515, 121.4795778, 7.0f, 0, 31.2403610, 121.4796136 },
+    { 688000, 31.2403925, 121.4796654, 9.0f, 0, 31.2404059, 121.4796136 },
+    { 689000, 31.2403994, 121.4796001, 9.5f, 0, 31.2404509, 121.4796136 },
+    { 690000, 31.2404912, 121.4796367, 7.0f, 0, 31.2404959, 121.4796136 },
+    { 691000, 31.2406225, 121.4796373, 10.0f, 0, 31.2405408, 121.4796136 },
+    { 692000, 31.2405568, 121.4796564, 9.5f, 0, 31.2405858, 121.4796136 },
+    { 693000, 31.2406380, 121.4795347, 12.5f, 0, 31.2406308, 121.4796136 },
+    { 694000, 31.2406685, 121.4796992, 11.0f, 0, 31.2406757, 121.4796136 },
+    { 695000, 31.2407833, 121.4795612, 8.0f, 0, 31.2407207, 121.4796136 },
+    { 696000, 31.2407830, 121.4796217, 10.5f, 0, 31.2407657, 121.4796136 },
+    { 697000, 31.2407726, 121.4796447, 8.5f, 0, 31.2408106, 121.4796136 },
+    { 698000, 31.2407729, 121.4796912, 12.0f, 0, 31.2408556, 121.4796136 },
+    { 699000, 31.2408507, 121.4795984, 10.0f, 0, 31.2409006, 121.4796136 },
+};
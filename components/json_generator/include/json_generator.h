@@ -38,6 +38,9 @@ extern "C"
 #define JSON_FLOAT_PRECISION 5
 #endif
 
+/** Minimum size of the buffer passed to json_gen_double_to_str() */
+#define JSON_GEN_MAX_FLOAT_STR 64
+
 /** JSON string flush callback prototype
  *
  * This is a prototype of the function that needs to be passed to
@@ -297,6 +300,26 @@ int json_gen_obj_set_bool(json_gen_str_t *jstr, const char *name, bool val);
  */
 int json_gen_obj_set_int(json_gen_str_t *jstr, const char *name, int val);
 
+/** Add a 64-bit integer element to an object
+ *
+ * Same as json_gen_obj_set_int() for values that do not fit in an int,
+ * e.g. millisecond timestamps. Eg. "time":1700000000123
+ *
+ * \note This must be called between json_gen_start_object()/json_gen_push_object()
+ * and json_gen_end_object()/json_gen_pop_object()
+ *
+ * \param[in] jstr Pointer to the \ref json_gen_str_t structure initialised by
+ * json_gen_str_start()
+ * \param[in] name Name of the element
+ * \param[in] val Integer value of the element
+ *
+ * \return 0 on Success
+ * \return -1 if buffer is out of space (possible only if no callback function
+ * is passed to json_gen_str_start(). Else, buffer will be flushed out and new data
+ * added after that
+ */
+int json_gen_obj_set_int64(json_gen_str_t *jstr, const char *name, int64_t val);
+
 /** Add a float element to an object
  *
  * This adds a float element to an object. Eg. "float_val":23.8
@@ -316,10 +339,60 @@ int json_gen_obj_set_int(json_gen_str_t *jstr, const char *name, int val);
  */
 int json_gen_obj_set_float(json_gen_str_t *jstr, const char *name, float val);
 
+/** Add a float element with a given precision to an object
+ *
+ * This adds a float element to an object with the given number of digits
+ * after the decimal point. Eg. json_gen_obj_set_float_prec(jstr, "temp", 23.84, 1)
+ * adds "temp":23.8
+ *
+ * The value is formatted without using printf. NaN and infinity are added
+ * as null since JSON cannot represent them.
+ *
+ * \note This must be called between json_gen_start_object()/json_gen_push_object()
+ * and json_gen_end_object()/json_gen_pop_object()
+ *
+ * \param[in] jstr Pointer to the \ref json_gen_str_t structure initialised by
+ * json_gen_str_start()
+ * \param[in] name Name of the element
+ * \param[in] val Float value of the element
+ * \param[in] precision Number of digits after the decimal point
+ *
+ * \return 0 on Success
+ * \return -1 if buffer is out of space (possible only if no callback function
+ * is passed to json_gen_str_start(). Else, buffer will be flushed out and new data
+ * added after that
+ */
+int json_gen_obj_set_float_prec(json_gen_str_t *jstr, const char *name, float val, int precision);
+
+/** Add a fixed point number to an object
+ *
+ * This adds val / 10^decimals with exactly the given number of digits after
+ * the decimal point, using only integer arithmetic. Eg.
+ * json_gen_obj_set_fixed(jstr, "lat", 312304160, 7) adds "lat":31.2304160
+ *
+ * \note This must be called between json_gen_start_object()/json_gen_push_object()
+ * and json_gen_end_object()/json_gen_pop_object()
+ *
+ * \param[in] jstr Pointer to the \ref json_gen_str_t structure initialised by
+ * json_gen_str_start()
+ * \param[in] name Name of the element
+ * \param[in] val Value scaled by 10^decimals
+ * \param[in] decimals Number of digits after the decimal point, 0 to 9
+ *
+ * \return 0 on Success
+ * \return -1 if buffer is out of space (possible only if no callback function
+ * is passed to json_gen_str_start(). Else, buffer will be flushed out and new data
+ * added after that
+ */
+int json_gen_obj_set_fixed(json_gen_str_t *jstr, const char *name, int64_t val, int decimals);
+
 /** Add a string element to an object
  *
  * This adds a string element to an object. Eg. "string_val":"my_string"
  *
+ * \note Quotes, backslashes and control characters in the value are escaped.
+ * The name is added as is.
+ *
  * \note This must be called between json_gen_start_object()/json_gen_push_object()
  * and json_gen_end_object()/json_gen_pop_object()
  *
@@ -335,6 +408,27 @@ int json_gen_obj_set_float(json_gen_str_t *jstr, const char *name, float val);
  */
 int json_gen_obj_set_string(json_gen_str_t *jstr, const char *name, const char *val);
 
+/** Add a string element of known length to an object
+ *
+ * Same as json_gen_obj_set_string(), but the value does not need to be
+ * NULL terminated. Eg. a slice of a larger buffer.
+ *
+ * \note This must be called between json_gen_start_object()/json_gen_push_object()
+ * and json_gen_end_object()/json_gen_pop_object()
+ *
+ * \param[in] jstr Pointer to the \ref json_gen_str_t structure initialised by
+ * json_gen_str_start()
+ * \param[in] name Name of the element
+ * \param[in] val String value of the element
+ * \param[in] len Number of bytes of val to add
+ *
+ * \return 0 on Success
+ * \return -1 if buffer is out of space (possible only if no callback function
+ * is passed to json_gen_str_start(). Else, buffer will be flushed out and new data
+ * added after that
+ */
+int json_gen_obj_set_string_len(json_gen_str_t *jstr, const char *name, const char *val, int len);
+
 /** Add a NULL element to an object
  *
  * This adds a NULL element to an object. Eg. "null_val":null
@@ -401,6 +495,23 @@ int json_gen_arr_set_int(json_gen_str_t *jstr, int val);
  */
 int json_gen_arr_set_float(json_gen_str_t *jstr, float val);
 
+/** Add a float element with a given precision to an array
+ *
+ * \note This must be called between json_gen_start_array()/json_gen_push_array()
+ * and json_gen_end_array()/json_gen_pop_array()
+ *
+ * \param[in] jstr Pointer to the \ref json_gen_str_t structure initialised by
+ * json_gen_str_start()
+ * \param[in] val Float value of the element
+ * \param[in] precision Number of digits after the decimal point
+ *
+ * \return 0 on Success
+ * \return -1 if buffer is out of space (possible only if no callback function
+ * is passed to json_gen_str_start(). Else, buffer will be flushed out and new data
+ * added after that
+ */
+int json_gen_arr_set_float_prec(json_gen_str_t *jstr, float val, int precision);
+
 /** Add a string element to an array
  *
  * \note This must be called between json_gen_start_array()/json_gen_push_array()
@@ -417,6 +528,26 @@ int json_gen_arr_set_float(json_gen_str_t *jstr, float val);
  */
 int json_gen_arr_set_string(json_gen_str_t *jstr, const char *val);
 
+/** Add a string element of known length to an array
+ *
+ * Same as json_gen_arr_set_string(), but the value does not need to be
+ * NULL terminated.
+ *
+ * \note This must be called between json_gen_start_array()/json_gen_push_array()
+ * and json_gen_end_array()/json_gen_pop_array()
+ *
+ * \param[in] jstr Pointer to the \ref json_gen_str_t structure initialised by
+ * json_gen_str_start()
+ * \param[in] val String value of the element
+ * \param[in] len Number of bytes of val to add
+ *
+ * \return 0 on Success
+ * \return -1 if buffer is out of space (possible only if no callback function
+ * is passed to json_gen_str_start(). Else, buffer will be flushed out and new data
+ * added after that
+ */
+int json_gen_arr_set_string_len(json_gen_str_t *jstr, const char *val, int len);
+
 /** Add a NULL element to an array
  *
  * \note This must be called between json_gen_start_array()/json_gen_push_array()
@@ -481,6 +612,8 @@ int json_gen_arr_start_long_string(json_gen_str_t *jstr, const char *val);
  * json_gen_arr_start_long_string(). After the entire string is created, it should be terminated
  * with json_gen_end_long_string().
  *
+ * \note As with json_gen_obj_set_string(), the value is escaped.
+ *
  * \param[in] jstr Pointer to the \ref json_gen_str_t structure initialised by json_gen_str_start()
  * \param[in] val Null terminated extending part of the string value.
  *
@@ -505,6 +638,60 @@ int json_gen_add_to_long_string(json_gen_str_t *jstr, const char *val);
  * added after that
  */
 int json_gen_end_long_string(json_gen_str_t *jstr);
+
+/** Reserve space for an element value to be filled in later
+ *
+ * This adds the name of an element followed by width spaces. The
+ * caller can later overwrite the spaces in the final buffer with a value
+ * of at most width characters, leaving any unused spaces as JSON
+ * whitespace. Eg. "val":"    " can later become "val":23.8
+ *
+ * This is meant for templates of fixed-shape JSON documents, where the
+ * skeleton is generated once and only the values are patched later.
+ * The returned offset is valid only if the buffer was not flushed.
+ *
+ * \note This must be called between json_gen_start_object()/json_gen_push_object()
+ * and json_gen_end_object()/json_gen_pop_object()
+ *
+ * \param[in] jstr Pointer to the \ref json_gen_str_t structure initialised by
+ * json_gen_str_start()
+ * \param[in] name Name of the element
+ * \param[in] width Number of characters to reserve for the value
+ *
+ * \return Offset of the reserved value from the start of the buffer on Success
+ * \return -1 if buffer is out of space or it has been flushed
+ */
+int json_gen_obj_reserve(json_gen_str_t *jstr, const char *name, int width);
+
+/** Format a number with a fixed number of digits after the decimal point
+ *
+ * This is equivalent to snprintf(str, size, "%.*f", precision, val), but
+ * does not use printf for the common cases. NaN and infinity are written
+ * as null since JSON cannot represent them. This is the formatter used by
+ * json_gen_obj_set_float_prec() and can be used to fill in values
+ * reserved by json_gen_obj_reserve().
+ *
+ * \param[out] str Buffer of at least \ref JSON_GEN_MAX_FLOAT_STR bytes
+ * \param[in] val Value to format
+ * \param[in] precision Number of digits after the decimal point
+ *
+ * \return Length of the NULL terminated string written to str
+ */
+int json_gen_double_to_str(char *str, double val, int precision);
+
+/** Format a fixed point number
+ *
+ * Writes val / 10^decimals with exactly the given number of digits after
+ * the decimal point, eg. (312304160, 7) gives "31.2304160". This is the
+ * formatter used by json_gen_obj_set_fixed().
+ *
+ * \param[out] str Buffer of at least \ref JSON_GEN_MAX_FLOAT_STR bytes
+ * \param[in] val Value scaled by 10^decimals
+ * \param[in] decimals Number of digits after the decimal point, 0 to 9
+ *
+ * \return Length of the NULL terminated string written to str
+ */
+int json_gen_fixed_to_str(char *str, int64_t val, int decimals);
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,609 @@
+/*
+ *    Copyright 2020 Piyush Shah <shahpiyushv@gmail.com>
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+
+#include <json_generator.h>
+
+#define MAX_INT_IN_STR      24
+#define MAX_FLOAT_IN_STR    JSON_GEN_MAX_FLOAT_STR
+
+/* Largest precision handled by the integer formatter below */
+#define MAX_FAST_FLOAT_PRECISION    9
+
+static const uint32_t json_gen_pow10[MAX_FAST_FLOAT_PRECISION + 1] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+static inline int json_gen_get_empty_len(json_gen_str_t *jstr)
+{
+    return (jstr->buf_size - (jstr->free_ptr - jstr->buf) - 1);
+}
+
+/* This will add the incoming string of the given length to the JSON string
+ * buffer and flush it out if the buffer is full. Note that the data being
+ * flushed out will always be equal to the size of the buffer unless
+ * this is the last chunk being flushed out on json_gen_end_str()
+ */
+static int json_gen_add_to_str_len(json_gen_str_t *jstr, const char *str, int len)
+{
+    jstr->total_len += len;
+    if (jstr->buf == NULL) {
+        return 0;
+    }
+    /* Fast path: the whole fragment fits in the remaining space */
+    if (len <= json_gen_get_empty_len(jstr)) {
+        memcpy(jstr->free_ptr, str, len);
+        jstr->free_ptr += len;
+        return 0;
+    }
+    const char *cur_ptr = str;
+    while (1) {
+        int len_remaining = json_gen_get_empty_len(jstr);
+        int copy_len = len_remaining > len ? len : len_remaining;
+        memmove(jstr->free_ptr, cur_ptr, copy_len);
+        cur_ptr += copy_len;
+        jstr->free_ptr += copy_len;
+        len -= copy_len;
+        if (len) {
+            *jstr->free_ptr = '\0';
+            /* Report error if the buffer is full and no flush callback
+             * is registered
+             */
+            if (!jstr->flush_cb) {
+                return -1;
+            }
+            jstr->flush_cb(jstr->buf, jstr->priv);
+            jstr->free_ptr = jstr->buf;
+        } else {
+            break;
+        }
+    }
+    return 0;
+}
+
+static int json_gen_add_to_str(json_gen_str_t *jstr, const char *str)
+{
+    if (!str) {
+        return 0;
+    }
+    return json_gen_add_to_str_len(jstr, str, strlen(str));
+}
+
+/* Add a string literal. The length is known at compile time */
+#define json_gen_add_const(jstr, str)   json_gen_add_to_str_len(jstr, str, sizeof(str) - 1)
+
+/* Word-at-a-time helpers for finding bytes that must be escaped in a string
+ * value: '"', '\\' and control characters below 0x20. Each test is exact for
+ * "is there such a byte anywhere in the word", which is all the scan needs.
+ */
+typedef size_t json_gen_word_t;
+#define JSON_GEN_WORD_ONES      ((json_gen_word_t)-1 / 0xFF)
+#define JSON_GEN_WORD_HIGHS     (JSON_GEN_WORD_ONES * 0x80)
+#define JSON_GEN_WORD_HAS_LESS(x, n)    (((x) - JSON_GEN_WORD_ONES * (n)) & ~(x) & JSON_GEN_WORD_HIGHS)
+#define JSON_GEN_WORD_HAS_ZERO(x)       JSON_GEN_WORD_HAS_LESS(x, 1)
+#define JSON_GEN_WORD_HAS_BYTE(x, c)    JSON_GEN_WORD_HAS_ZERO((x) ^ (JSON_GEN_WORD_ONES * (c)))
+
+static inline bool json_gen_needs_escape(char c)
+{
+    return c == '"' || c == '\\' || (uint8_t)c < 0x20;
+}
+
+/* Returns the length of the leading run of str which can be copied as is */
+static int json_gen_escape_scan(const char *str, int len)
+{
+    int i = 0;
+    for (; i + (int)sizeof(json_gen_word_t) <= len; i += sizeof(json_gen_word_t)) {
+        json_gen_word_t w;
+        memcpy(&w, str + i, sizeof(w));
+        if (JSON_GEN_WORD_HAS_LESS(w, 0x20) | JSON_GEN_WORD_HAS_BYTE(w, '"')
+                | JSON_GEN_WORD_HAS_BYTE(w, '\\')) {
+            break;
+        }
+    }
+    for (; i < len; i++) {
+        if (json_gen_needs_escape(str[i])) {
+            break;
+        }
+    }
+    return i;
+}
+
+/* Add a string value, escaping it as required by RFC 8259. Clean runs are
+ * copied in bulk, so a string without special characters costs one scan
+ * and one copy.
+ */
+static int json_gen_add_escaped_len(json_gen_str_t *jstr, const char *str, int len)
+{
+    static const char hex[] = "0123456789abcdef";
+    int ret = 0;
+    while (len > 0) {
+        int run = json_gen_escape_scan(str, len);
+        if (run) {
+            ret = json_gen_add_to_str_len(jstr, str, run);
+            str += run;
+            len -= run;
+        }
+        if (len == 0) {
+            break;
+        }
+        char esc[6] = { '\\', *str };
+        int esc_len = 2;
+        switch (*str) {
+        case '"':
+        case '\\':
+            break;
+        case '\b': esc[1] = 'b'; break;
+        case '\f': esc[1] = 'f'; break;
+        case '\n': esc[1] = 'n'; break;
+        case '\r': esc[1] = 'r'; break;
+        case '\t': esc[1] = 't'; break;
+        default:
+            esc[1] = 'u';
+            esc[2] = '0';
+            esc[3] = '0';
+            esc[4] = hex[(uint8_t)*str >> 4];
+            esc[5] = hex[*str & 0xF];
+            esc_len = 6;
+            break;
+        }
+        ret = json_gen_add_to_str_len(jstr, esc, esc_len);
+        str++;
+        len--;
+    }
+    return ret;
+}
+
+static int json_gen_add_escaped(json_gen_str_t *jstr, const char *str)
+{
+    if (!str) {
+        return 0;
+    }
+    return json_gen_add_escaped_len(jstr, str, strlen(str));
+}
+
+
+void json_gen_str_start(json_gen_str_t *jstr, char *buf, int buf_size,
+                        json_gen_flush_cb_t flush_cb, void *priv)
+{
+    memset(jstr, 0, sizeof(json_gen_str_t));
+    jstr->buf = buf;
+    jstr->buf_size = buf_size;
+    jstr->flush_cb = flush_cb;
+    jstr->free_ptr = buf;
+    jstr->priv = priv;
+}
+
+int json_gen_str_end(json_gen_str_t *jstr)
+{
+    int total_len = jstr->total_len;
+    if (jstr->buf) {
+        *jstr->free_ptr = '\0';
+        if (jstr->flush_cb) {
+            jstr->flush_cb(jstr->buf, jstr->priv);
+        }
+    }
+    memset(jstr, 0, sizeof(json_gen_str_t));
+    return total_len + 1; /* +1 for the NULL termination */
+}
+
+static inline void json_gen_handle_comma(json_gen_str_t *jstr)
+{
+    if (jstr->comma_req) {
+        json_gen_add_const(jstr, ",");
+    }
+}
+
+
+static int json_gen_handle_name(json_gen_str_t *jstr, const char *name)
+{
+    int len = name ? strlen(name) : 0;
+    /* Write "name": in one go if it fits */
+    if (jstr->buf && (len + 3) <= json_gen_get_empty_len(jstr)) {
+        char *p = jstr->free_ptr;
+        *p++ = '"';
+        if (len) {
+            memcpy(p, name, len);
+            p += len;
+        }
+        *p++ = '"';
+        *p++ = ':';
+        jstr->free_ptr = p;
+        jstr->total_len += len + 3;
+        return 0;
+    }
+    json_gen_add_const(jstr, "\"");
+    json_gen_add_to_str_len(jstr, name, len);
+    return json_gen_add_const(jstr, "\":");
+}
+
+
+int json_gen_start_object(json_gen_str_t *jstr)
+{
+    json_gen_handle_comma(jstr);
+    jstr->comma_req = false;
+    return json_gen_add_const(jstr, "{");
+}
+
+int json_gen_end_object(json_gen_str_t *jstr)
+{
+    jstr->comma_req = true;
+    return json_gen_add_const(jstr, "}");
+}
+
+
+int json_gen_start_array(json_gen_str_t *jstr)
+{
+    json_gen_handle_comma(jstr);
+    jstr->comma_req = false;
+    return json_gen_add_const(jstr, "[");
+}
+
+int json_gen_end_array(json_gen_str_t *jstr)
+{
+    jstr->comma_req = true;
+    return json_gen_add_const(jstr, "]");
+}
+
+int json_gen_push_object(json_gen_str_t *jstr, const char *name)
+{
+    json_gen_handle_comma(jstr);
+    json_gen_handle_name(jstr, name);
+    jstr->comma_req = false;
+    return json_gen_add_const(jstr, "{");
+}
+
+int json_gen_pop_object(json_gen_str_t *jstr)
+{
+    jstr->comma_req = true;
+    return json_gen_add_const(jstr, "}");
+}
+
+int json_gen_push_object_str(json_gen_str_t *jstr, const char *name, const char *object_str)
+{
+    json_gen_handle_comma(jstr);
+    json_gen_handle_name(jstr, name);
+    jstr->comma_req = true;
+    return json_gen_add_to_str(jstr, object_str);
+}
+
+int json_gen_push_array(json_gen_str_t *jstr, const char *name)
+{
+    json_gen_handle_comma(jstr);
+    json_gen_handle_name(jstr, name);
+    jstr->comma_req = false;
+    return json_gen_add_const(jstr, "[");
+}
+int json_gen_pop_array(json_gen_str_t *jstr)
+{
+    jstr->comma_req = true;
+    return json_gen_add_const(jstr, "]");
+}
+
+int json_gen_push_array_str(json_gen_str_t *jstr, const char *name, const char *array_str)
+{
+    json_gen_handle_comma(jstr);
+    json_gen_handle_name(jstr, name);
+    jstr->comma_req = true;
+    return json_gen_add_to_str(jstr, array_str);
+}
+
+static int json_gen_set_bool(json_gen_str_t *jstr, bool val)
+{
+    jstr->comma_req = true;
+    if (val) {
+        return json_gen_add_const(jstr, "true");
+    } else {
+        return json_gen_add_const(jstr, "false");
+    }
+}
+int json_gen_obj_set_bool(json_gen_str_t *jstr, const char *name, bool val)
+{
+    json_gen_handle_comma(jstr);
+    json_gen_handle_name(jstr, name);
+    return json_gen_set_bool(jstr, val);
+}
+
+int json_gen_arr_set_bool(json_gen_str_t *jstr, bool val)
+{
+    json_gen_handle_comma(jstr);
+    return json_gen_set_bool(jstr, val);
+}
+
+static int json_gen_set_int(json_gen_str_t *jstr, int val)
+{
+    jstr->comma_req = true;
+    char str[MAX_INT_IN_STR];
+    int len = snprintf(str, MAX_INT_IN_STR, "%d", val);
+    return json_gen_add_to_str_len(jstr, str, len);
+}
+
+int json_gen_obj_set_int(json_gen_str_t *jstr, const char *name, int val)
+{
+    json_gen_handle_comma(jstr);
+    json_gen_handle_name(jstr, name);
+    return json_gen_set_int(jstr, val);
+}
+
+int json_gen_obj_set_int64(json_gen_str_t *jstr, const char *name, int64_t val)
+{
+    json_gen_handle_comma(jstr);
+    json_gen_handle_name(jstr, name);
+    jstr->comma_req = true;
+    char str[MAX_INT_IN_STR];
+    int len = snprintf(str, MAX_INT_IN_STR, "%lld", (long long)val);
+    return json_gen_add_to_str_len(jstr, str, len);
+}
+
+int json_gen_arr_set_int(json_gen_str_t *jstr, int val)
+{
+    json_gen_handle_comma(jstr);
+    return json_gen_set_int(jstr, val);
+}
+
+
+/* Write int_part.frac_part, with frac_part zero padded to precision digits */
+static int json_gen_write_fixed(char *str, bool negative, uint64_t int_part, uint32_t frac_part,
+                                int precision)
+{
+    char *p = str;
+    if (negative) {
+        *p++ = '-';
+    }
+    char digits[20];
+    int n = 0;
+    if (int_part <= UINT32_MAX) {
+        uint32_t i32 = (uint32_t)int_part;
+        do {
+            digits[n++] = '0' + (i32 % 10);
+            i32 /= 10;
+        } while (i32);
+    } else {
+        do {
+            digits[n++] = '0' + (int_part % 10);
+            int_part /= 10;
+        } while (int_part);
+    }
+    while (n) {
+        *p++ = digits[--n];
+    }
+    if (precision) {
+        *p++ = '.';
+        for (int i = precision - 1; i >= 0; i--) {
+            p[i] = '0' + (frac_part % 10);
+            frac_part /= 10;
+        }
+        p += precision;
+    }
+    *p = '\0';
+    return p - str;
+}
+
+/* Equivalent to "%.*f" but without going through the printf machinery.
+ * The value is scaled once, after which only integer arithmetic is used.
+ * The scaled product can be off from the exact one by half an ulp, so
+ * values that close to a rounding tie are left to snprintf(), which rounds
+ * the exact decimal expansion. So are scaled magnitudes of 2^53 and above,
+ * where the product is no longer exact to the unit, and precisions above
+ * MAX_FAST_FLOAT_PRECISION.
+ */
+int json_gen_double_to_str(char *str, double val, int precision)
+{
+    if (isnan(val) || isinf(val)) {
+        memcpy(str, "null", sizeof("null"));
+        return sizeof("null") - 1;
+    }
+    if (precision < 0) {
+        precision = 0;
+    }
+    if (precision > MAX_FAST_FLOAT_PRECISION) {
+        return snprintf(str, MAX_FLOAT_IN_STR, "%.*f", precision, val);
+    }
+    double d = val;
+    bool negative = signbit(d);
+    if (negative) {
+        d = -d;
+    }
+    uint32_t scale = json_gen_pow10[precision];
+    double scaled = d * scale;
+    if (scaled >= 9007199254740992.0) {
+        return snprintf(str, MAX_FLOAT_IN_STR, "%.*f", precision, val);
+    }
+    double whole = floor(scaled);
+    double rem = scaled - whole;
+    if (fabs(rem - 0.5) <= scaled * DBL_EPSILON) {
+        return snprintf(str, MAX_FLOAT_IN_STR, "%.*f", precision, val);
+    }
+    uint64_t fixed = (uint64_t)whole + (rem > 0.5);
+    uint64_t int_part = fixed / scale;
+    uint32_t frac_part = (uint32_t)(fixed - int_part * scale);
+
+    return json_gen_write_fixed(str, negative, int_part, frac_part, precision);
+}
+
+int json_gen_fixed_to_str(char *str, int64_t val, int decimals)
+{
+    if (decimals < 0) {
+        decimals = 0;
+    } else if (decimals > MAX_FAST_FLOAT_PRECISION) {
+        decimals = MAX_FAST_FLOAT_PRECISION;
+    }
+    bool negative = val < 0;
+    uint64_t mag = negative ? -(uint64_t)val : (uint64_t)val;
+    uint32_t scale = json_gen_pow10[decimals];
+    uint64_t int_part = mag / scale;
+    return json_gen_write_fixed(str, negative, int_part, (uint32_t)(mag - int_part * scale), decimals);
+}
+
+static int json_gen_set_float(json_gen_str_t *jstr, float val, int precision)
+{
+    jstr->comma_req = true;
+    char str[MAX_FLOAT_IN_STR];
+    int len = json_gen_double_to_str(str, val, precision);
+    return json_gen_add_to_str_len(jstr, str, len);
+}
+int json_gen_obj_set_float(json_gen_str_t *jstr, const char *name, float val)
+{
+    json_gen_handle_comma(jstr);
+    json_gen_handle_name(jstr, name);
+    return json_gen_set_float(jstr, val, JSON_FLOAT_PRECISION);
+}
+int json_gen_arr_set_float(json_gen_str_t *jstr, float val)
+{
+    json_gen_handle_comma(jstr);
+    return json_gen_set_float(jstr, val, JSON_FLOAT_PRECISION);
+}
+int json_gen_obj_set_float_prec(json_gen_str_t *jstr, const char *name, float val, int precision)
+{
+    json_gen_handle_comma(jstr);
+    json_gen_handle_name(jstr, name);
+    return json_gen_set_float(jstr, val, precision);
+}
+int json_gen_arr_set_float_prec(json_gen_str_t *jstr, float val, int precision)
+{
+    json_gen_handle_comma(jstr);
+    return json_gen_set_float(jstr, val, precision);
+}
+int json_gen_obj_set_fixed(json_gen_str_t *jstr, const char *name, int64_t val, int decimals)
+{
+    json_gen_handle_comma(jstr);
+    json_gen_handle_name(jstr, name);
+    jstr->comma_req = true;
+    char str[MAX_INT_IN_STR];
+    int len = json_gen_fixed_to_str(str, val, decimals);
+    return json_gen_add_to_str_len(jstr, str, len);
+}
+
+static int json_gen_set_string_len(json_gen_str_t *jstr, const char *val, int len)
+{
+    jstr->comma_req = true;
+    int run = json_gen_escape_scan(val, len);
+    /* Fast path: nothing to escape and the quoted value fits */
+    if (run == len && jstr->buf && (len + 2) <= json_gen_get_empty_len(jstr)) {
+        char *p = jstr->free_ptr;
+        *p++ = '"';
+        memcpy(p, val, len);
+        p += len;
+        *p++ = '"';
+        jstr->free_ptr = p;
+        jstr->total_len += len + 2;
+        return 0;
+    }
+    json_gen_add_const(jstr, "\"");
+    json_gen_add_to_str_len(jstr, val, run);
+    json_gen_add_escaped_len(jstr, val + run, len - run);
+    return json_gen_add_const(jstr, "\"");
+}
+
+static int json_gen_set_string(json_gen_str_t *jstr, const char *val)
+{
+    return json_gen_set_string_len(jstr, val, val ? strlen(val) : 0);
+}
+
+int json_gen_obj_set_string(json_gen_str_t *jstr, const char *name, const char *val)
+{
+    json_gen_handle_comma(jstr);
+    json_gen_handle_name(jstr, name);
+    return json_gen_set_string(jstr, val);
+}
+
+int json_gen_arr_set_string(json_gen_str_t *jstr, const char *val)
+{
+    json_gen_handle_comma(jstr);
+    return json_gen_set_string(jstr, val);
+}
+
+int json_gen_obj_set_string_len(json_gen_str_t *jstr, const char *name, const char *val, int len)
+{
+    json_gen_handle_comma(jstr);
+    json_gen_handle_name(jstr, name);
+    return json_gen_set_string_len(jstr, val, len);
+}
+
+int json_gen_arr_set_string_len(json_gen_str_t *jstr, const char *val, int len)
+{
+    json_gen_handle_comma(jstr);
+    return json_gen_set_string_len(jstr, val, len);
+}
+
+static int json_gen_set_long_string(json_gen_str_t *jstr, const char *val)
+{
+    jstr->comma_req = true;
+    json_gen_add_const(jstr, "\"");
+    return json_gen_add_escaped(jstr, val);
+}
+
+int json_gen_obj_start_long_string(json_gen_str_t *jstr, const char *name, const char *val)
+{
+    json_gen_handle_comma(jstr);
+    json_gen_handle_name(jstr, name);
+    return json_gen_set_long_string(jstr, val);
+}
+
+int json_gen_arr_start_long_string(json_gen_str_t *jstr, const char *val)
+{
+    json_gen_handle_comma(jstr);
+    return json_gen_set_long_string(jstr, val);
+}
+
+int json_gen_add_to_long_string(json_gen_str_t *jstr, const char *val)
+{
+    return json_gen_add_escaped(jstr, val);
+}
+
+int json_gen_end_long_string(json_gen_str_t *jstr)
+{
+    return json_gen_add_const(jstr, "\"");
+}
+static int json_gen_set_null(json_gen_str_t *jstr)
+{
+    jstr->comma_req = true;
+    return json_gen_add_const(jstr, "null");
+}
+int json_gen_obj_set_null(json_gen_str_t *jstr, const char *name)
+{
+    json_gen_handle_comma(jstr);
+    json_gen_handle_name(jstr, name);
+    return json_gen_set_null(jstr);
+}
+
+int json_gen_arr_set_null(json_gen_str_t *jstr)
+{
+    json_gen_handle_comma(jstr);
+    return json_gen_set_null(jstr);
+}
+
+int json_gen_obj_reserve(json_gen_str_t *jstr, const char *name, int width)
+{
+    json_gen_handle_comma(jstr);
+    json_gen_handle_name(jstr, name);
+    jstr->comma_req = true;
+    /* The offset is only meaningful if nothing has been flushed so far */
+    if (!jstr->buf || jstr->total_len != (jstr->free_ptr - jstr->buf)
+            || width > json_gen_get_empty_len(jstr)) {
+        return -1;
+    }
+    int offset = jstr->free_ptr - jstr->buf;
+    memset(jstr->free_ptr, ' ', width);
+    jstr->free_ptr += width;
+    jstr->total_len += width;
+    return offset;
+}
@@ -0,0 +1,459 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "json_generator.h"
+#include "unity.h"
+
+#define FLOAT_TEST_COUNT    10000
+#define FLOAT_BENCH_COUNT   2000
+#define DOC_BENCH_COUNT     2000
+#define STRING_FUZZ_COUNT   10000
+
+/* Simple deterministic generator so that failures can be reproduced */
+static uint32_t test_rand(uint32_t *state)
+{
+    *state = *state * 1664525 + 1013904223;
+    return *state;
+}
+
+static float test_rand_float(uint32_t *state)
+{
+    /* Cover the magnitudes seen in telemetry: sensor values, coordinates, lux */
+    float mantissa = (float)(test_rand(state) & 0xFFFFFF) / (float)0xFFFFFF;
+    int exponent = (int)(test_rand(state) % 12) - 4;
+    float val = mantissa * powf(10.0f, exponent);
+    return (test_rand(state) & 1) ? -val : val;
+}
+
+static int64_t test_time_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void gen_float(char *buf, int size, float val, int precision)
+{
+    json_gen_str_t jstr;
+    json_gen_str_start(&jstr, buf, size, NULL, NULL);
+    json_gen_start_array(&jstr);
+    json_gen_arr_set_float_prec(&jstr, val, precision);
+    json_gen_end_array(&jstr);
+    json_gen_str_end(&jstr);
+}
+
+TEST_CASE("json_generator float formatting matches printf", "[json_generator]")
+{
+    char buf[80];
+    char expected[80];
+    uint32_t seed = 0x12345678;
+
+    for (int i = 0; i < FLOAT_TEST_COUNT; i++) {
+        float val = test_rand_float(&seed);
+        int precision = test_rand(&seed) % 7;
+        gen_float(buf, sizeof(buf), val, precision);
+
+        /* Strip the array brackets and read the number back */
+        size_t len = strlen(buf);
+        TEST_ASSERT_EQUAL_CHAR('[', buf[0]);
+        TEST_ASSERT_EQUAL_CHAR(']', buf[len - 1]);
+        buf[len - 1] = '\0';
+        double parsed = strtod(buf + 1, NULL);
+
+        /* Round trip: within half a unit of the last printed digit */
+        double tolerance = 0.5 * pow(10.0, -precision) + fabs(val) * 1e-15;
+        TEST_ASSERT_TRUE(fabs(parsed - (double)val) <= tolerance);
+
+        /* Exactly the digits printf produces */
+        snprintf(expected, sizeof(expected), "%.*f", precision, val);
+        TEST_ASSERT_EQUAL_STRING(expected, buf + 1);
+    }
+}
+
+TEST_CASE("json_generator float formatting rounds ties like printf", "[json_generator]")
+{
+    /* Values on or next to a rounding tie, and products past 2^53 */
+    static const struct {
+        double val;
+        int precision;
+    } cases[] = {
+        { 0.045, 2 }, { 0.125, 2 }, { 0.375, 2 }, { 2.5, 0 }, { 3.5, 0 },
+        { -2.5, 0 }, { 1.005, 2 }, { 1.015, 2 }, { 0.5, 0 }, { 1.5, 0 },
+        { 123.4565, 3 }, { 0.0000005, 6 }, { 12345678.123456789, 9 },
+        { 9007199254.7409925, 6 }, { 1e15, 1 }, { -1e-9, 9 },
+    };
+    char num[JSON_GEN_MAX_FLOAT_STR];
+    char expected[80];
+
+    for (int i = 0; i < (int)(sizeof(cases) / sizeof(cases[0])); i++) {
+        int len = json_gen_double_to_str(num, cases[i].val, cases[i].precision);
+        snprintf(expected, sizeof(expected), "%.*f", cases[i].precision, cases[i].val);
+        TEST_ASSERT_EQUAL_STRING(expected, num);
+        TEST_ASSERT_EQUAL(strlen(expected), len);
+    }
+
+    /* Every value with up to four decimals, at the precisions below it */
+    for (int i = 0; i <= 20000; i++) {
+        double val = i / 10000.0;
+        for (int precision = 0; precision < 4; precision++) {
+            json_gen_double_to_str(num, val, precision);
+            snprintf(expected, sizeof(expected), "%.*f", precision, val);
+            TEST_ASSERT_EQUAL_STRING(expected, num);
+        }
+    }
+}
+
+TEST_CASE("json_generator float special values", "[json_generator]")
+{
+    char buf[64];
+    json_gen_str_t jstr;
+
+    json_gen_str_start(&jstr, buf, sizeof(buf), NULL, NULL);
+    json_gen_start_object(&jstr);
+    json_gen_obj_set_float_prec(&jstr, "a", 23.84f, 1);
+    json_gen_obj_set_float_prec(&jstr, "b", -0.004f, 2);
+    json_gen_obj_set_float_prec(&jstr, "c", 9.995f, 0);
+    json_gen_obj_set_float_prec(&jstr, "d", NAN, 2);
+    json_gen_end_object(&jstr);
+    json_gen_str_end(&jstr);
+    TEST_ASSERT_EQUAL_STRING("{\"a\":23.8,\"b\":-0.00,\"c\":10,\"d\":null}", buf);
+
+    json_gen_str_start(&jstr, buf, sizeof(buf), NULL, NULL);
+    json_gen_start_array(&jstr);
+    json_gen_arr_set_float(&jstr, 2.0f);
+    json_gen_end_array(&jstr);
+    json_gen_str_end(&jstr);
+    TEST_ASSERT_EQUAL_STRING("[2.00000]", buf);
+}
+
+TEST_CASE("json_generator float formatting benchmark", "[json_generator][perf]")
+{
+    char buf[64];
+    float values[64];
+    uint32_t seed = 0xCAFEF00D;
+    for (int i = 0; i < 64; i++) {
+        values[i] = test_rand_float(&seed);
+    }
+
+    int64_t start = test_time_ns();
+    for (int i = 0; i < FLOAT_BENCH_COUNT; i++) {
+        snprintf(buf, sizeof(buf), "%.*f", JSON_FLOAT_PRECISION, values[i & 63]);
+    }
+    int64_t printf_ns = test_time_ns() - start;
+
+    start = test_time_ns();
+    for (int i = 0; i < FLOAT_BENCH_COUNT; i++) {
+        gen_float(buf, sizeof(buf), values[i & 63], JSON_FLOAT_PRECISION);
+    }
+    int64_t gen_ns = test_time_ns() - start;
+
+    printf("snprintf(\"%%.*f\"): %lld ns/op\n", (long long)(printf_ns / FLOAT_BENCH_COUNT));
+    printf("json_gen_arr_set_float_prec (incl. generator overhead): %lld ns/op\n",
+           (long long)(gen_ns / FLOAT_BENCH_COUNT));
+}
+
+/* Same shape as the telemetry document published over MQTT */
+static int gen_telemetry(char *buf, int size, json_gen_flush_cb_t flush_cb, void *priv)
+{
+    json_gen_str_t jstr;
+    json_gen_str_start(&jstr, buf, size, flush_cb, priv);
+    json_gen_start_object(&jstr);
+    json_gen_obj_set_string(&jstr, "device_id", "ESP32_A1B2C3D4E5F6");
+    json_gen_obj_set_int(&jstr, "timestamp", 1718000000);
+    json_gen_push_object(&jstr, "sensors");
+    json_gen_obj_set_float_prec(&jstr, "temperature", 23.5f, 1);
+    json_gen_obj_set_float_prec(&jstr, "humidity", 61.0f, 1);
+    json_gen_obj_set_float_prec(&jstr, "light_intensity", 312.5f, 1);
+    json_gen_obj_set_bool(&jstr, "valid", true);
+    json_gen_pop_object(&jstr);
+    json_gen_push_object(&jstr, "gps");
+    json_gen_obj_set_float_prec(&jstr, "latitude", 31.230416f, 6);
+    json_gen_obj_set_float_prec(&jstr, "longitude", 121.473701f, 6);
+    json_gen_obj_set_string_len(&jstr, "lat_display", "31.230416N-extra", 10);
+    json_gen_obj_set_float_prec(&jstr, "altitude", 12.3f, 1);
+    json_gen_obj_set_float_prec(&jstr, "speed", 0.52f, 2);
+    json_gen_obj_set_float_prec(&jstr, "course", 87.0f, 1);
+    json_gen_obj_set_string(&jstr, "data_source", "GNSS");
+    json_gen_obj_set_bool(&jstr, "valid", true);
+    json_gen_pop_object(&jstr);
+    json_gen_end_object(&jstr);
+    return json_gen_str_end(&jstr);
+}
+
+typedef struct {
+    char out[512];
+    int len;
+} flush_ctx_t;
+
+static void test_flush_cb(char *buf, void *priv)
+{
+    flush_ctx_t *ctx = (flush_ctx_t *)priv;
+    int len = strlen(buf);
+    memcpy(ctx->out + ctx->len, buf, len);
+    ctx->len += len;
+    ctx->out[ctx->len] = '\0';
+}
+
+TEST_CASE("json_generator string with explicit length", "[json_generator]")
+{
+    char buf[64];
+    json_gen_str_t jstr;
+
+    json_gen_str_start(&jstr, buf, sizeof(buf), NULL, NULL);
+    json_gen_start_object(&jstr);
+    json_gen_obj_set_string_len(&jstr, "a", "hello world", 5);
+    json_gen_obj_set_string_len(&jstr, "b", "", 0);
+    json_gen_push_array(&jstr, "c");
+    json_gen_arr_set_string_len(&jstr, "xyz", 2);
+    json_gen_pop_array(&jstr);
+    json_gen_end_object(&jstr);
+    json_gen_str_end(&jstr);
+    TEST_ASSERT_EQUAL_STRING("{\"a\":\"hello\",\"b\":\"\",\"c\":[\"xy\"]}", buf);
+}
+
+TEST_CASE("json_generator output is identical with small flushed buffers", "[json_generator]")
+{
+    char full[512];
+    int full_len = gen_telemetry(full, sizeof(full), NULL, NULL);
+    TEST_ASSERT_EQUAL_INT((int)strlen(full) + 1, full_len);
+
+    /* Length-only pass, as used to size a buffer before generating */
+    TEST_ASSERT_EQUAL_INT(full_len, gen_telemetry(NULL, 0, NULL, NULL));
+
+    /* Every buffer size must exercise both the fast and the chunked path */
+    for (int size = 2; size <= 40; size++) {
+        char small[40];
+        flush_ctx_t ctx = { .len = 0 };
+        gen_telemetry(small, size, test_flush_cb, &ctx);
+        TEST_ASSERT_EQUAL_STRING(full, ctx.out);
+    }
+
+    /* Without a flush callback a full buffer is an error */
+    char tiny[16];
+    json_gen_str_t jstr;
+    json_gen_str_start(&jstr, tiny, sizeof(tiny), NULL, NULL);
+    json_gen_start_object(&jstr);
+    TEST_ASSERT_EQUAL_INT(-1, json_gen_obj_set_string(&jstr, "device_id", "ESP32_A1B2C3D4E5F6"));
+}
+
+TEST_CASE("json_generator telemetry document benchmark", "[json_generator][perf]")
+{
+    char buf[512];
+    int len = 0;
+
+    int64_t start = test_time_ns();
+    for (int i = 0; i < DOC_BENCH_COUNT; i++) {
+        len = gen_telemetry(buf, sizeof(buf), NULL, NULL);
+    }
+    int64_t gen_ns = test_time_ns() - start;
+
+    printf("telemetry document (%d bytes): %lld ns/op\n", len,
+           (long long)(gen_ns / DOC_BENCH_COUNT));
+}
+
+TEST_CASE("json_generator reserved values can be patched", "[json_generator]")
+{
+    char buf[64];
+    char num[JSON_GEN_MAX_FLOAT_STR];
+    json_gen_str_t jstr;
+
+    json_gen_str_start(&jstr, buf, sizeof(buf), NULL, NULL);
+    json_gen_start_object(&jstr);
+    int a = json_gen_obj_reserve(&jstr, "a", 6);
+    json_gen_obj_set_int(&jstr, "b", 1);
+    int c = json_gen_obj_reserve(&jstr, "c", 4);
+    json_gen_end_object(&jstr);
+    json_gen_str_end(&jstr);
+    TEST_ASSERT_EQUAL_STRING("{\"a\":      ,\"b\":1,\"c\":    }", buf);
+
+    int len = json_gen_double_to_str(num, 23.84, 1);
+    memcpy(buf + a, num, len);
+    len = json_gen_double_to_str(num, NAN, 1);
+    memcpy(buf + c, num, len);
+    TEST_ASSERT_EQUAL_STRING("{\"a\":23.8  ,\"b\":1,\"c\":null}", buf);
+
+    /* Offsets are meaningless once part of the document has been flushed */
+    flush_ctx_t ctx = { .len = 0 };
+    json_gen_str_start(&jstr, buf, 8, test_flush_cb, &ctx);
+    json_gen_start_object(&jstr);
+    json_gen_obj_set_string(&jstr, "name", "value");
+    TEST_ASSERT_EQUAL_INT(-1, json_gen_obj_reserve(&jstr, "a", 2));
+}
+
+TEST_CASE("json_generator 64-bit integers", "[json_generator]")
+{
+    char buf[96];
+    json_gen_str_t jstr;
+
+    json_gen_str_start(&jstr, buf, sizeof(buf), NULL, NULL);
+    json_gen_start_object(&jstr);
+    json_gen_obj_set_int64(&jstr, "time", 1700000000123LL);
+    json_gen_obj_set_int64(&jstr, "min", INT64_MIN);
+    json_gen_obj_set_int(&jstr, "b", 1);
+    json_gen_end_object(&jstr);
+    json_gen_str_end(&jstr);
+    TEST_ASSERT_EQUAL_STRING("{\"time\":1700000000123,\"min\":-9223372036854775808,\"b\":1}", buf);
+}
+
+TEST_CASE("json_generator fixed point numbers", "[json_generator]")
+{
+    static const struct {
+        int64_t val;
+        int decimals;
+        const char *str;
+    } cases[] = {
+        { 312304160, 7, "31.2304160" },
+        { -1214737010, 7, "-121.4737010" },
+        { -5, 7, "-0.0000005" },
+        { 0, 7, "0.0000000" },
+        { 1800000000, 7, "180.0000000" },
+        { 42, 0, "42" },
+        { INT64_MIN, 9, "-9223372036.854775808" },
+    };
+    char str[JSON_GEN_MAX_FLOAT_STR];
+
+    for (int i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        TEST_ASSERT_EQUAL(strlen(cases[i].str), json_gen_fixed_to_str(str, cases[i].val, cases[i].decimals));
+        TEST_ASSERT_EQUAL_STRING(cases[i].str, str);
+    }
+
+    char buf[64];
+    json_gen_str_t jstr;
+    json_gen_str_start(&jstr, buf, sizeof(buf), NULL, NULL);
+    json_gen_start_object(&jstr);
+    json_gen_obj_set_fixed(&jstr, "lat", 312304160, 7);
+    json_gen_obj_set_fixed(&jstr, "lon", -1214737010, 7);
+    json_gen_end_object(&jstr);
+    json_gen_str_end(&jstr);
+    TEST_ASSERT_EQUAL_STRING("{\"lat\":31.2304160,\"lon\":-121.4737010}", buf);
+}
+
+/* Byte at a time escaper to check the generator against */
+static int ref_escape(char *out, const char *str, int len)
+{
+    int n = 0;
+    for (int i = 0; i < len; i++) {
+        uint8_t c = str[i];
+        switch (c) {
+        case '"': n += sprintf(out + n, "\\\""); break;
+        case '\\': n += sprintf(out + n, "\\\\"); break;
+        case '\b': n += sprintf(out + n, "\\b"); break;
+        case '\f': n += sprintf(out + n, "\\f"); break;
+        case '\n': n += sprintf(out + n, "\\n"); break;
+        case '\r': n += sprintf(out + n, "\\r"); break;
+        case '\t': n += sprintf(out + n, "\\t"); break;
+        default:
+            if (c < 0x20) {
+                n += sprintf(out + n, "\\u%04x", c);
+            } else {
+                out[n++] = c;
+            }
+            break;
+        }
+    }
+    out[n] = '\0';
+    return n;
+}
+
+TEST_CASE("json_generator string escaping", "[json_generator]")
+{
+    char buf[128];
+    json_gen_str_t jstr;
+
+    json_gen_str_start(&jstr, buf, sizeof(buf), NULL, NULL);
+    json_gen_start_object(&jstr);
+    json_gen_obj_set_string(&jstr, "name", "Tom's \"phone\"\\\x01");
+    json_gen_obj_set_string_len(&jstr, "ssid", "a\0b\n", 4);
+    json_gen_obj_start_long_string(&jstr, "long", "\xe4\xb8\xad\t");
+    json_gen_add_to_long_string(&jstr, "\x1f\x7f");
+    json_gen_end_long_string(&jstr);
+    json_gen_end_object(&jstr);
+    json_gen_str_end(&jstr);
+    TEST_ASSERT_EQUAL_STRING("{\"name\":\"Tom's \\\"phone\\\"\\\\\\u0001\","
+                             "\"ssid\":\"a\\u0000b\\n\",\"long\":\"\xe4\xb8\xad\\t\\u001f\x7f\"}", buf);
+}
+
+TEST_CASE("json_generator string escaping fuzz", "[json_generator]")
+{
+    /* Bias towards the bytes that matter, at every alignment */
+    static const char special[] = { '"', '\\', '\0', '\n', '\x1f', ' ', '\x7f', '\x80', '\xff', '!', '#', '[', ']' };
+    char src[80];
+    char expected[512];
+    char buf[512];
+    uint32_t seed = 0xC0FFEE;
+
+    for (int i = 0; i < STRING_FUZZ_COUNT; i++) {
+        int offset = test_rand(&seed) % 8;
+        int len = test_rand(&seed) % (sizeof(src) - 8 - 1);
+        for (int j = 0; j < len; j++) {
+            uint32_t r = test_rand(&seed);
+            if ((r & 0xF) == 0) {
+                src[offset + j] = special[(r >> 8) % sizeof(special)];
+            } else if ((r & 0xF) == 1) {
+                src[offset + j] = (char)(r >> 8);
+            } else {
+                src[offset + j] = 'a' + (r >> 8) % 26;
+            }
+        }
+        int n = sprintf(expected, "[\"");
+        n += ref_escape(expected + n, src + offset, len);
+        sprintf(expected + n, "\"]");
+
+        /* A small buffer with a flush callback also covers escapes split across flushes */
+        int size = 8 + test_rand(&seed) % 64;
+        flush_ctx_t ctx = { .len = 0 };
+        json_gen_str_t jstr;
+        json_gen_str_start(&jstr, buf, size, test_flush_cb, &ctx);
+        json_gen_start_array(&jstr);
+        json_gen_arr_set_string_len(&jstr, src + offset, len);
+        json_gen_end_array(&jstr);
+        int total = json_gen_str_end(&jstr);
+        TEST_ASSERT_EQUAL_STRING(expected, ctx.out);
+        TEST_ASSERT_EQUAL_INT(strlen(expected) + 1, total);
+    }
+}
+
+TEST_CASE("json_generator string escaping benchmark", "[json_generator][perf]")
+{
+    /* Typical values: nothing to escape */
+    static const char *values[] = { "ESP32_A1B2C3D4E5F6", "1.0.3", "my-home-wifi", "device/telemetry/up",
+                                    "mqtt://broker.example.com:1883", "31.230416N" };
+    static const char *quoted[] = { "\"ESP32_A1B2C3D4E5F6\"", "\"1.0.3\"", "\"my-home-wifi\"",
+                                    "\"device/telemetry/up\"", "\"mqtt://broker.example.com:1883\"",
+                                    "\"31.230416N\"" };
+    const int num_values = sizeof(values) / sizeof(values[0]);
+    char escaped[256];
+    char raw[256];
+    json_gen_str_t jstr;
+
+    int64_t start = test_time_ns();
+    for (int i = 0; i < DOC_BENCH_COUNT; i++) {
+        json_gen_str_start(&jstr, escaped, sizeof(escaped), NULL, NULL);
+        json_gen_start_object(&jstr);
+        for (int j = 0; j < num_values; j++) {
+            json_gen_obj_set_string(&jstr, "v", values[j]);
+        }
+        json_gen_end_object(&jstr);
+        json_gen_str_end(&jstr);
+    }
+    int64_t escaped_ns = test_time_ns() - start;
+
+    /* Same document with the values added as pre-quoted, unescaped text */
+    start = test_time_ns();
+    for (int i = 0; i < DOC_BENCH_COUNT; i++) {
+        json_gen_str_start(&jstr, raw, sizeof(raw), NULL, NULL);
+        json_gen_start_object(&jstr);
+        for (int j = 0; j < num_values; j++) {
+            json_gen_push_object_str(&jstr, "v", quoted[j]);
+        }
+        json_gen_end_object(&jstr);
+        json_gen_str_end(&jstr);
+    }
+    int64_t raw_ns = test_time_ns() - start;
+
+    TEST_ASSERT_EQUAL_STRING(raw, escaped);
+    printf("%d string values: %lld ns/op escaped, %lld ns/op unescaped\n", num_values,
+           (long long)(escaped_ns / DOC_BENCH_COUNT), (long long)(raw_ns / DOC_BENCH_COUNT));
+}
@@ -33,14 +33,48 @@ extern "C"
 typedef jsmn_parser json_parser_t;
 typedef jsmntok_t json_tok_t;
 
+/* Number of slots in an object key index. Must be a power of 2.
+ * Objects with more than 3/4 of this many keys are searched linearly.
+ */
+#ifndef JSON_OBJ_INDEX_SIZE
+#define JSON_OBJ_INDEX_SIZE 32
+#endif
+
+/* Open addressing hash of the keys of one object, see json_obj_set_index() */
+typedef struct {
+    const json_tok_t *obj;
+    bool usable;
+    uint8_t hash[JSON_OBJ_INDEX_SIZE];
+    int16_t key[JSON_OBJ_INDEX_SIZE];
+} json_obj_index_t;
+
 typedef struct {
     json_parser_t parser;
     const char *js;
     json_tok_t *tokens;
     json_tok_t *cur;
     int num_tokens;
+    json_obj_index_t *index;
 } jparse_ctx_t;
 
+typedef enum {
+    JSON_FIELD_BOOL,
+    JSON_FIELD_INT,
+    JSON_FIELD_INT64,
+    JSON_FIELD_FLOAT,
+    JSON_FIELD_STRING,
+} json_field_type_t;
+
+/* One entry of a json_obj_get_fields() spec. val points to a bool, int,
+ * int64_t, float or char array of size bytes, as per type.
+ */
+typedef struct {
+    const char *name;
+    json_field_type_t type;
+    void *val;
+    int size;
+} json_field_t;
+
 int json_parse_start(jparse_ctx_t *jctx, const char *js, int len);
 int json_parse_end(jparse_ctx_t *jctx);
 int json_parse_start_static(jparse_ctx_t *jctx, const char *js, int len, json_tok_t *buffer_tokens, int buffer_tokens_max_count);
@@ -72,6 +106,27 @@ int json_arr_get_float(jparse_ctx_t *jctx, uint32_t index, float *val);
 int json_arr_get_string(jparse_ctx_t *jctx, uint32_t index, char *val, int size);
 int json_arr_get_strlen(jparse_ctx_t *jctx, uint32_t index, int *strlen);
 
+/* Decode the escape sequences of a string returned by json_obj_get_string()
+ * or json_arr_get_string() in place. \uXXXX sequences are written as UTF-8.
+ * Returns the new length, or -OS_FAIL for an invalid escape sequence.
+ */
+int json_unescape_string(char *str);
+
+/* Use a key index for lookups in the current object. The index is built in
+ * one pass over the object on the first lookup after entering it, so reading
+ * N fields costs O(N) token scans instead of O(N^2). It must remain valid
+ * until json_parse_end(). Pass NULL to go back to linear search.
+ */
+void json_obj_set_index(jparse_ctx_t *jctx, json_obj_index_t *index);
+
+/* Read several fields of the current object in a single pass. Fields that
+ * are missing or of a different type are left untouched, so defaults can be
+ * set beforehand. At most 32 fields.
+ * Returns the number of fields read, or -OS_FAIL if the current element is
+ * not an object.
+ */
+int json_obj_get_fields(jparse_ctx_t *jctx, const json_field_t *fields, int num_fields);
+
 #ifdef __cplusplus
 }
 #endif
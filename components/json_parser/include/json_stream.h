@@ -0,0 +1,171 @@
+/*
+ *    Copyright 2020 Piyush Shah <shahpiyushv@gmail.com>
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+/*
+ * Streaming JSON Parser
+ *
+ * Unlike json_parse_start(), this does not need the whole document in
+ * memory. The document is fed in chunks of any size as it arrives and a
+ * callback is invoked for every value found. Memory use is fixed by
+ * JSON_STREAM_MAX_DEPTH, JSON_STREAM_MAX_KEY_LEN and JSON_STREAM_MAX_VALUE_LEN,
+ * independent of the document size.
+ */
+#ifndef _JSON_STREAM_H_
+#define _JSON_STREAM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <json_parser.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** Maximum nesting of objects/arrays */
+#ifndef JSON_STREAM_MAX_DEPTH
+#define JSON_STREAM_MAX_DEPTH       8
+#endif
+
+/** Maximum length of an object key, including the NULL termination */
+#ifndef JSON_STREAM_MAX_KEY_LEN
+#define JSON_STREAM_MAX_KEY_LEN     32
+#endif
+
+/** Maximum length of a scalar value, including the NULL termination */
+#ifndef JSON_STREAM_MAX_VALUE_LEN
+#define JSON_STREAM_MAX_VALUE_LEN   256
+#endif
+
+/** Type of a streaming parser event */
+typedef enum {
+    JSON_STREAM_OBJECT_START,
+    JSON_STREAM_OBJECT_END,
+    JSON_STREAM_ARRAY_START,
+    JSON_STREAM_ARRAY_END,
+    JSON_STREAM_STRING,
+    JSON_STREAM_NUMBER,
+    JSON_STREAM_BOOL,
+    JSON_STREAM_NULL,
+} json_stream_type_t;
+
+/** Streaming parser event
+ *
+ * All pointers are valid only for the duration of the callback.
+ */
+typedef struct {
+    /** Type of the value */
+    json_stream_type_t type;
+    /** Key of the value if it is a member of an object, else NULL */
+    const char *key;
+    /** Index of the value if it is an element of an array, else -1 */
+    int index;
+    /** Number of objects/arrays enclosing the value. 0 for the root */
+    int depth;
+    /** NULL terminated value for strings, numbers, booleans and null.
+     * As with json_obj_get_string(), escape sequences are not decoded.
+     * NULL for object/array events.
+     */
+    const char *value;
+    /** Length of value */
+    int value_len;
+} json_stream_event_t;
+
+/** Streaming parser callback
+ *
+ * \param[in] event The value found
+ * \param[in] priv Private data passed to json_stream_init()
+ *
+ * \return 0 to continue parsing, any other value to abort
+ */
+typedef int (*json_stream_cb_t)(const json_stream_event_t *event, void *priv);
+
+/** (For Internal use only) An open object or array */
+typedef struct {
+    bool is_array;
+    int index;
+    char key[JSON_STREAM_MAX_KEY_LEN];
+} json_stream_frame_t;
+
+/** Streaming parser context
+ *
+ * Please do not set/modify any elements.
+ */
+typedef struct {
+    json_stream_cb_t cb;
+    void *priv;
+    json_stream_frame_t stack[JSON_STREAM_MAX_DEPTH];
+    int depth;
+    uint8_t state;
+    bool in_key;
+    uint8_t esc;
+    char buf[JSON_STREAM_MAX_VALUE_LEN];
+    int buf_len;
+    /** Number of bytes consumed. On error, offset of the offending byte */
+    size_t offset;
+} json_stream_t;
+
+/** Start a streaming parse
+ *
+ * \param[out] js Parser context
+ * \param[in] cb Callback to invoke for every value
+ * \param[in] priv Private data to pass to the callback
+ */
+void json_stream_init(json_stream_t *js, json_stream_cb_t cb, void *priv);
+
+/** Feed the next chunk of the document
+ *
+ * \param[in] js Parser context initialised by json_stream_init()
+ * \param[in] buf Chunk of the document
+ * \param[in] len Length of the chunk
+ *
+ * \return OS_SUCCESS on success
+ * \return -OS_FAIL if the document is invalid, exceeds the configured
+ * limits or the callback aborted. All subsequent calls will fail.
+ */
+int json_stream_feed(json_stream_t *js, const char *buf, int len);
+
+/** End a streaming parse
+ *
+ * Must be called after the last chunk so that a trailing root number
+ * is reported and truncated documents are detected.
+ *
+ * \param[in] js Parser context initialised by json_stream_init()
+ *
+ * \return OS_SUCCESS if exactly one complete value was parsed
+ * \return -OS_FAIL otherwise
+ */
+int json_stream_end(json_stream_t *js);
+
+/** Get the key of an enclosing object member
+ *
+ * Can be used within the callback to find the path of a value.
+ * Eg. for {"wifi":{"ssid":"x"}}, when "ssid" is reported with depth 2,
+ * json_stream_get_key(js, 1) returns "wifi".
+ *
+ * \param[in] js Parser context
+ * \param[in] depth Depth of the object member, 1 to event depth
+ *
+ * \return Key, or NULL if the member at that depth is not in an object
+ */
+const char *json_stream_get_key(const json_stream_t *js, int depth);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _JSON_STREAM_H_ */
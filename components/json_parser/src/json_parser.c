@@ -102,6 +102,73 @@ static int json_tok_to_string(jparse_ctx_t *jctx, json_tok_t *tok, char *val, in
     return OS_SUCCESS;
 }
 
+/* FNV-1a */
+static uint32_t json_key_hash(const char *key, int len)
+{
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < len; i++) {
+        hash ^= (uint8_t)key[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+#define JSON_OBJ_INDEX_MASK     (JSON_OBJ_INDEX_SIZE - 1)
+#define JSON_OBJ_INDEX_EMPTY    -1
+
+static void json_obj_index_build(jparse_ctx_t *jctx, json_obj_index_t *index, const json_tok_t *obj)
+{
+    index->obj = obj;
+    index->usable = false;
+    /* Keep the load factor low enough that probe sequences stay short */
+    if (obj->size > JSON_OBJ_INDEX_SIZE * 3 / 4 || jctx->num_tokens > INT16_MAX) {
+        return;
+    }
+    memset(index->key, 0xff, sizeof(index->key));
+
+    json_tok_t *tok = (json_tok_t *)obj;
+    int size = obj->size;
+    while (size--) {
+        tok++;
+        int len = tok->end - tok->start;
+        uint32_t hash = json_key_hash(jctx->js + tok->start, len);
+        int slot = hash & JSON_OBJ_INDEX_MASK;
+        bool duplicate = false;
+        while (index->key[slot] != JSON_OBJ_INDEX_EMPTY) {
+            json_tok_t *other = &jctx->tokens[index->key[slot]];
+            /* As with a linear search, the first of duplicate keys wins */
+            if (other->end - other->start == len
+                    && memcmp(jctx->js + other->start, jctx->js + tok->start, len) == 0) {
+                duplicate = true;
+                break;
+            }
+            slot = (slot + 1) & JSON_OBJ_INDEX_MASK;
+        }
+        if (!duplicate) {
+            index->key[slot] = tok - jctx->tokens;
+            index->hash[slot] = hash >> 24;
+        }
+        tok = json_skip_elem(tok);
+    }
+    index->usable = true;
+}
+
+static json_tok_t *json_obj_index_search(jparse_ctx_t *jctx, json_obj_index_t *index, const char *key)
+{
+    int len = strlen(key);
+    uint32_t hash = json_key_hash(key, len);
+    int slot = hash & JSON_OBJ_INDEX_MASK;
+    while (index->key[slot] != JSON_OBJ_INDEX_EMPTY) {
+        json_tok_t *tok = &jctx->tokens[index->key[slot]];
+        if (index->hash[slot] == (uint8_t)(hash >> 24) && tok->end - tok->start == len
+                && memcmp(jctx->js + tok->start, key, len) == 0) {
+            return tok;
+        }
+        slot = (slot + 1) & JSON_OBJ_INDEX_MASK;
+    }
+    return NULL;
+}
+
 static json_tok_t *json_obj_search(jparse_ctx_t *jctx, const char *key)
 {
     json_tok_t *tok = jctx->cur;
@@ -113,6 +180,15 @@ static json_tok_t *json_obj_search(jparse_ctx_t *jctx, const char *key)
         return NULL;
     }
 
+    if (jctx->index) {
+        if (jctx->index->obj != tok) {
+            json_obj_index_build(jctx, jctx->index, tok);
+        }
+        if (jctx->index->usable) {
+            return json_obj_index_search(jctx, jctx->index, key);
+        }
+    }
+
     while (size--) {
         tok++;
         if (token_matches_str(jctx, tok, key)) {
@@ -439,29 +515,20 @@ int json_parse_end(jparse_ctx_t *jctx)
 
 int json_parse_start_static(jparse_ctx_t *jctx, const char *js, int len, json_tok_t *buffer_tokens, int buffer_tokens_max_count)
 {
-    // Init
-    memset(buffer_tokens, 0, buffer_tokens_max_count * sizeof(json_tok_t));
     memset(jctx, 0, sizeof(jparse_ctx_t));
 
-    // Check fit
+    /* The token pool is provided by the caller, so a single pass is enough.
+     * jsmn reports JSMN_ERROR_NOMEM if the pool is too small.
+     */
     jsmn_init(&jctx->parser);
-    int num_tokens = jsmn_parse(&jctx->parser, js, len, NULL, 0);
-    if (num_tokens <= 0 || num_tokens > buffer_tokens_max_count) {
+    int num_tokens = jsmn_parse(&jctx->parser, js, len, buffer_tokens, buffer_tokens_max_count);
+    if (num_tokens <= 0) {
+        memset(jctx, 0, sizeof(jparse_ctx_t));
         return -OS_FAIL;
     }
-
-    // Set struct
     jctx->num_tokens = num_tokens;
     jctx->tokens = buffer_tokens;
     jctx->js = js;
-
-    // Parse
-    jsmn_init(&jctx->parser);
-    int ret = jsmn_parse(&jctx->parser, js, len, jctx->tokens, jctx->num_tokens);
-    if (ret <= 0) {
-        memset(jctx, 0, sizeof(jparse_ctx_t));
-        return -OS_FAIL;
-    }
     jctx->cur = jctx->tokens;
     return OS_SUCCESS;
 }
@@ -472,3 +539,161 @@ int json_parse_end_static(jparse_ctx_t *jctx)
     return OS_SUCCESS;
 }
 
+void json_obj_set_index(jparse_ctx_t *jctx, json_obj_index_t *index)
+{
+    if (index) {
+        index->obj = NULL;
+    }
+    jctx->index = index;
+}
+
+static int json_tok_to_field(jparse_ctx_t *jctx, json_tok_t *tok, const json_field_t *field)
+{
+    if (field->type == JSON_FIELD_STRING) {
+        if (tok->type != JSMN_STRING) {
+            return -OS_FAIL;
+        }
+        return json_tok_to_string(jctx, tok, field->val, field->size);
+    }
+    if (tok->type != JSMN_PRIMITIVE) {
+        return -OS_FAIL;
+    }
+    switch (field->type) {
+    case JSON_FIELD_BOOL:
+        return json_tok_to_bool(jctx, tok, field->val);
+    case JSON_FIELD_INT:
+        return json_tok_to_int(jctx, tok, field->val);
+    case JSON_FIELD_INT64:
+        return json_tok_to_int64(jctx, tok, field->val);
+    case JSON_FIELD_FLOAT:
+        return json_tok_to_float(jctx, tok, field->val);
+    default:
+        return -OS_FAIL;
+    }
+}
+
+int json_obj_get_fields(jparse_ctx_t *jctx, const json_field_t *fields, int num_fields)
+{
+    json_tok_t *tok = jctx->cur;
+    if (tok->type != JSMN_OBJECT || num_fields < 0 || num_fields > 32) {
+        return -OS_FAIL;
+    }
+
+    int name_len[32];
+    for (int i = 0; i < num_fields; i++) {
+        name_len[i] = strlen(fields[i].name);
+    }
+
+    uint32_t pending = (num_fields == 32) ? UINT32_MAX : ((1u << num_fields) - 1);
+    int found = 0;
+    int size = tok->size;
+    while (size-- && pending) {
+        tok++;
+        int len = tok->end - tok->start;
+        for (int i = 0; i < num_fields; i++) {
+            if ((pending & (1u << i)) && name_len[i] == len
+                    && memcmp(jctx->js + tok->start, fields[i].name, len) == 0) {
+                /* As with json_obj_get_*(), only the first of duplicate keys is used */
+                pending &= ~(1u << i);
+                if (json_tok_to_field(jctx, tok + 1, &fields[i]) == OS_SUCCESS) {
+                    found++;
+                }
+                break;
+            }
+        }
+        tok = json_skip_elem(tok);
+    }
+    return found;
+}
+
+static int json_hex4(const char *s, uint32_t *val)
+{
+    uint32_t v = 0;
+    for (int i = 0; i < 4; i++) {
+        char c = s[i];
+        v <<= 4;
+        if (c >= '0' && c <= '9') {
+            v |= c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            v |= c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            v |= c - 'A' + 10;
+        } else {
+            return -OS_FAIL;
+        }
+    }
+    *val = v;
+    return OS_SUCCESS;
+}
+
+static int json_utf8_encode(char *out, uint32_t cp)
+{
+    if (cp < 0x80) {
+        out[0] = cp;
+        return 1;
+    } else if (cp < 0x800) {
+        out[0] = 0xC0 | (cp >> 6);
+        out[1] = 0x80 | (cp & 0x3F);
+        return 2;
+    } else if (cp < 0x10000) {
+        out[0] = 0xE0 | (cp >> 12);
+        out[1] = 0x80 | ((cp >> 6) & 0x3F);
+        out[2] = 0x80 | (cp & 0x3F);
+        return 3;
+    }
+    out[0] = 0xF0 | (cp >> 18);
+    out[1] = 0x80 | ((cp >> 12) & 0x3F);
+    out[2] = 0x80 | ((cp >> 6) & 0x3F);
+    out[3] = 0x80 | (cp & 0x3F);
+    return 4;
+}
+
+int json_unescape_string(char *str)
+{
+    char *in = str;
+    char *out = str;
+    while (*in) {
+        if (*in != '\\') {
+            *out++ = *in++;
+            continue;
+        }
+        in++;
+        switch (*in) {
+        case '"': *out++ = '"'; break;
+        case '\\': *out++ = '\\'; break;
+        case '/': *out++ = '/'; break;
+        case 'b': *out++ = '\b'; break;
+        case 'f': *out++ = '\f'; break;
+        case 'n': *out++ = '\n'; break;
+        case 'r': *out++ = '\r'; break;
+        case 't': *out++ = '\t'; break;
+        case 'u': {
+            uint32_t cp;
+            if (json_hex4(in + 1, &cp) != OS_SUCCESS) {
+                return -OS_FAIL;
+            }
+            in += 4;
+            /* Surrogate pair for code points above the BMP */
+            if (cp >= 0xD800 && cp <= 0xDBFF) {
+                uint32_t low;
+                if (in[1] != '\\' || in[2] != 'u' || json_hex4(in + 3, &low) != OS_SUCCESS
+                        || low < 0xDC00 || low > 0xDFFF) {
+                    return -OS_FAIL;
+                }
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                in += 6;
+            } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+                return -OS_FAIL;
+            }
+            /* The UTF-8 encoding is never longer than the escape sequence */
+            out += json_utf8_encode(out, cp);
+            break;
+        }
+        default:
+            return -OS_FAIL;
+        }
+        in++;
+    }
+    *out = '\0';
+    return out - str;
+}
@@ -0,0 +1,377 @@
+/*
+ *    Copyright 2020 Piyush Shah <shahpiyushv@gmail.com>
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <json_stream.h>
+
+/* Parser states. Strings and literals (numbers, true, false, null) are
+ * accumulated in js->buf, so a token may be split across any number of
+ * chunks.
+ */
+enum {
+    JS_STATE_VALUE,             /* Expecting a value */
+    JS_STATE_VALUE_OR_END,      /* After '[' */
+    JS_STATE_KEY,               /* After ',' in an object */
+    JS_STATE_KEY_OR_END,        /* After '{' */
+    JS_STATE_COLON,             /* After a key */
+    JS_STATE_COMMA_OR_END,      /* After a value */
+    JS_STATE_STRING,            /* Inside a key or string value */
+    JS_STATE_LITERAL,           /* Inside a number, true, false or null */
+    JS_STATE_DONE,              /* Root value complete */
+    JS_STATE_ERROR,
+};
+
+/* Escape states within a string */
+#define JS_ESC_NONE     0
+#define JS_ESC_START    1
+/* JS_ESC_HEX + n: n hex digits of a \uXXXX sequence still expected */
+#define JS_ESC_HEX      1
+
+static bool json_stream_is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static bool json_stream_is_hex(char c)
+{
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+static bool json_stream_is_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+/* Strict JSON number: -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)? */
+static bool json_stream_is_number(const char *s, int len)
+{
+    int i = 0;
+    if (i < len && s[i] == '-') {
+        i++;
+    }
+    if (i < len && s[i] == '0') {
+        i++;
+    } else if (i < len && s[i] >= '1' && s[i] <= '9') {
+        while (i < len && json_stream_is_digit(s[i])) {
+            i++;
+        }
+    } else {
+        return false;
+    }
+    if (i < len && s[i] == '.') {
+        i++;
+        if (i >= len || !json_stream_is_digit(s[i])) {
+            return false;
+        }
+        while (i < len && json_stream_is_digit(s[i])) {
+            i++;
+        }
+    }
+    if (i < len && (s[i] == 'e' || s[i] == 'E')) {
+        i++;
+        if (i < len && (s[i] == '+' || s[i] == '-')) {
+            i++;
+        }
+        if (i >= len || !json_stream_is_digit(s[i])) {
+            return false;
+        }
+        while (i < len && json_stream_is_digit(s[i])) {
+            i++;
+        }
+    }
+    return i == len;
+}
+
+static bool json_stream_is_literal_char(char c)
+{
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')
+           || c == '-' || c == '+' || c == '.';
+}
+
+void json_stream_init(json_stream_t *js, json_stream_cb_t cb, void *priv)
+{
+    memset(js, 0, sizeof(json_stream_t));
+    js->cb = cb;
+    js->priv = priv;
+    js->state = JS_STATE_VALUE;
+}
+
+const char *json_stream_get_key(const json_stream_t *js, int depth)
+{
+    if (depth < 1 || depth > js->depth || js->stack[depth - 1].is_array) {
+        return NULL;
+    }
+    return js->stack[depth - 1].key;
+}
+
+static int json_stream_emit(json_stream_t *js, json_stream_type_t type, const char *value, int value_len)
+{
+    json_stream_event_t event = {
+        .type = type,
+        .key = json_stream_get_key(js, js->depth),
+        .index = -1,
+        .depth = js->depth,
+        .value = value,
+        .value_len = value_len,
+    };
+    if (js->depth && js->stack[js->depth - 1].is_array) {
+        event.index = js->stack[js->depth - 1].index;
+    }
+    if (js->cb && js->cb(&event, js->priv) != 0) {
+        return -OS_FAIL;
+    }
+    return OS_SUCCESS;
+}
+
+/* A value at the current depth is complete */
+static void json_stream_value_done(json_stream_t *js)
+{
+    if (js->depth == 0) {
+        js->state = JS_STATE_DONE;
+        return;
+    }
+    if (js->stack[js->depth - 1].is_array) {
+        js->stack[js->depth - 1].index++;
+    }
+    js->state = JS_STATE_COMMA_OR_END;
+}
+
+static int json_stream_push(json_stream_t *js, bool is_array)
+{
+    if (js->depth >= JSON_STREAM_MAX_DEPTH) {
+        return -OS_FAIL;
+    }
+    if (json_stream_emit(js, is_array ? JSON_STREAM_ARRAY_START : JSON_STREAM_OBJECT_START,
+                         NULL, 0) != OS_SUCCESS) {
+        return -OS_FAIL;
+    }
+    json_stream_frame_t *frame = &js->stack[js->depth++];
+    frame->is_array = is_array;
+    frame->index = 0;
+    frame->key[0] = '\0';
+    js->state = is_array ? JS_STATE_VALUE_OR_END : JS_STATE_KEY_OR_END;
+    return OS_SUCCESS;
+}
+
+static int json_stream_pop(json_stream_t *js, bool is_array)
+{
+    if (js->depth == 0 || js->stack[js->depth - 1].is_array != is_array) {
+        return -OS_FAIL;
+    }
+    js->depth--;
+    if (json_stream_emit(js, is_array ? JSON_STREAM_ARRAY_END : JSON_STREAM_OBJECT_END,
+                         NULL, 0) != OS_SUCCESS) {
+        return -OS_FAIL;
+    }
+    json_stream_value_done(js);
+    return OS_SUCCESS;
+}
+
+static int json_stream_literal_done(json_stream_t *js)
+{
+    json_stream_type_t type;
+    const char *s = js->buf;
+    int len = js->buf_len;
+
+    if (len == 4 && memcmp(s, "true", 4) == 0) {
+        type = JSON_STREAM_BOOL;
+    } else if (len == 5 && memcmp(s, "false", 5) == 0) {
+        type = JSON_STREAM_BOOL;
+    } else if (len == 4 && memcmp(s, "null", 4) == 0) {
+        type = JSON_STREAM_NULL;
+    } else if (json_stream_is_number(s, len)) {
+        type = JSON_STREAM_NUMBER;
+    } else {
+        return -OS_FAIL;
+    }
+    js->buf[len] = '\0';
+    if (json_stream_emit(js, type, js->buf, len) != OS_SUCCESS) {
+        return -OS_FAIL;
+    }
+    json_stream_value_done(js);
+    return OS_SUCCESS;
+}
+
+static int json_stream_string_done(json_stream_t *js)
+{
+    js->buf[js->buf_len] = '\0';
+    if (js->in_key) {
+        if (js->buf_len >= JSON_STREAM_MAX_KEY_LEN) {
+            return -OS_FAIL;
+        }
+        memcpy(js->stack[js->depth - 1].key, js->buf, js->buf_len + 1);
+        js->state = JS_STATE_COLON;
+        return OS_SUCCESS;
+    }
+    if (json_stream_emit(js, JSON_STREAM_STRING, js->buf, js->buf_len) != OS_SUCCESS) {
+        return -OS_FAIL;
+    }
+    json_stream_value_done(js);
+    return OS_SUCCESS;
+}
+
+static int json_stream_string_char(json_stream_t *js, char c)
+{
+    if (js->esc == JS_ESC_START) {
+        if (c == 'u') {
+            js->esc = JS_ESC_HEX + 4;
+        } else if (c != '\0' && strchr("\"\\/bfnrt", c)) {
+            js->esc = JS_ESC_NONE;
+        } else {
+            return -OS_FAIL;
+        }
+    } else if (js->esc > JS_ESC_HEX) {
+        if (!json_stream_is_hex(c)) {
+            return -OS_FAIL;
+        }
+        js->esc = (js->esc == JS_ESC_HEX + 1) ? JS_ESC_NONE : js->esc - 1;
+    } else if (c == '\\') {
+        js->esc = JS_ESC_START;
+    } else if (c == '"') {
+        return json_stream_string_done(js);
+    } else if ((uint8_t)c < 0x20) {
+        return -OS_FAIL;
+    }
+    if (js->buf_len >= JSON_STREAM_MAX_VALUE_LEN - 1) {
+        return -OS_FAIL;
+    }
+    js->buf[js->buf_len++] = c;
+    return OS_SUCCESS;
+}
+
+static int json_stream_value_start(json_stream_t *js, char c)
+{
+    if (c == '{') {
+        return json_stream_push(js, false);
+    } else if (c == '[') {
+        return json_stream_push(js, true);
+    } else if (c == '"') {
+        js->in_key = false;
+        js->esc = JS_ESC_NONE;
+        js->buf_len = 0;
+        js->state = JS_STATE_STRING;
+        return OS_SUCCESS;
+    } else if (json_stream_is_literal_char(c)) {
+        js->buf[0] = c;
+        js->buf_len = 1;
+        js->state = JS_STATE_LITERAL;
+        return OS_SUCCESS;
+    }
+    return -OS_FAIL;
+}
+
+static int json_stream_key_start(json_stream_t *js, char c)
+{
+    if (c != '"') {
+        return -OS_FAIL;
+    }
+    js->in_key = true;
+    js->esc = JS_ESC_NONE;
+    js->buf_len = 0;
+    js->state = JS_STATE_STRING;
+    return OS_SUCCESS;
+}
+
+static int json_stream_char(json_stream_t *js, char c)
+{
+    switch (js->state) {
+    case JS_STATE_STRING:
+        return json_stream_string_char(js, c);
+    case JS_STATE_LITERAL:
+        if (json_stream_is_literal_char(c)) {
+            if (js->buf_len >= JSON_STREAM_MAX_VALUE_LEN - 1) {
+                return -OS_FAIL;
+            }
+            js->buf[js->buf_len++] = c;
+            return OS_SUCCESS;
+        }
+        if (json_stream_literal_done(js) != OS_SUCCESS) {
+            return -OS_FAIL;
+        }
+        /* The delimiter belongs to the next state */
+        return json_stream_char(js, c);
+    default:
+        break;
+    }
+
+    if (json_stream_is_space(c)) {
+        return OS_SUCCESS;
+    }
+
+    switch (js->state) {
+    case JS_STATE_VALUE:
+        return json_stream_value_start(js, c);
+    case JS_STATE_VALUE_OR_END:
+        if (c == ']') {
+            return json_stream_pop(js, true);
+        }
+        return json_stream_value_start(js, c);
+    case JS_STATE_KEY:
+        return json_stream_key_start(js, c);
+    case JS_STATE_KEY_OR_END:
+        if (c == '}') {
+            return json_stream_pop(js, false);
+        }
+        return json_stream_key_start(js, c);
+    case JS_STATE_COLON:
+        if (c != ':') {
+            return -OS_FAIL;
+        }
+        js->state = JS_STATE_VALUE;
+        return OS_SUCCESS;
+    case JS_STATE_COMMA_OR_END: {
+        bool is_array = js->stack[js->depth - 1].is_array;
+        if (c == ',') {
+            js->state = is_array ? JS_STATE_VALUE : JS_STATE_KEY;
+            return OS_SUCCESS;
+        }
+        if (c == (is_array ? ']' : '}')) {
+            return json_stream_pop(js, is_array);
+        }
+        return -OS_FAIL;
+    }
+    default:
+        /* Nothing but whitespace is allowed after the root value */
+        return -OS_FAIL;
+    }
+}
+
+int json_stream_feed(json_stream_t *js, const char *buf, int len)
+{
+    if (js->state == JS_STATE_ERROR) {
+        return -OS_FAIL;
+    }
+    for (int i = 0; i < len; i++) {
+        if (json_stream_char(js, buf[i]) != OS_SUCCESS) {
+            js->state = JS_STATE_ERROR;
+            return -OS_FAIL;
+        }
+        js->offset++;
+    }
+    return OS_SUCCESS;
+}
+
+int json_stream_end(json_stream_t *js)
+{
+    if (js->state == JS_STATE_LITERAL && js->depth == 0) {
+        if (json_stream_literal_done(js) != OS_SUCCESS) {
+            js->state = JS_STATE_ERROR;
+            return -OS_FAIL;
+        }
+    }
+    return (js->state == JS_STATE_DONE) ? OS_SUCCESS : -OS_FAIL;
+}
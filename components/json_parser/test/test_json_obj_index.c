@@ -0,0 +1,276 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "json_parser.h"
+#include "unity.h"
+
+#define INDEX_BENCH_COUNT   2000
+
+/* Body of POST /api/mqtt/settings */
+static const char settings_str[] =
+    "{\"broker\":\"mqtt://broker.example.com:1883\",\"username\":\"device01\","
+    "\"password\":\"s3cr3t\\/pass\"}";
+
+/* Device shadow style update: desired state of every configurable field */
+static const char shadow_str[] =
+    "{\"state\":{\"desired\":{"
+    "\"report_interval\":30,\"gps_interval\":5,\"lbs_interval\":300,"
+    "\"sensor_interval\":10,\"temp_offset\":-0.5,\"hum_offset\":1.25,"
+    "\"light_gain\":1.0,\"low_power\":false,\"led\":true,"
+    "\"timezone\":\"CST-8\",\"ntp_server\":\"pool.ntp.org\","
+    "\"apn\":\"cmnet\",\"ota_check\":true,\"version\":42}},"
+    "\"version\":42,\"timestamp\":1700000000123}";
+
+typedef struct {
+    int report_interval;
+    int gps_interval;
+    int lbs_interval;
+    int sensor_interval;
+    float temp_offset;
+    float hum_offset;
+    float light_gain;
+    bool low_power;
+    bool led;
+    char timezone[16];
+    char ntp_server[32];
+    char apn[16];
+    bool ota_check;
+    int version;
+} shadow_desired_t;
+
+static int64_t test_time_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static int shadow_get_each(jparse_ctx_t *jctx, shadow_desired_t *d)
+{
+    int ret = 0;
+    ret |= json_obj_get_int(jctx, "report_interval", &d->report_interval);
+    ret |= json_obj_get_int(jctx, "gps_interval", &d->gps_interval);
+    ret |= json_obj_get_int(jctx, "lbs_interval", &d->lbs_interval);
+    ret |= json_obj_get_int(jctx, "sensor_interval", &d->sensor_interval);
+    ret |= json_obj_get_float(jctx, "temp_offset", &d->temp_offset);
+    ret |= json_obj_get_float(jctx, "hum_offset", &d->hum_offset);
+    ret |= json_obj_get_float(jctx, "light_gain", &d->light_gain);
+    ret |= json_obj_get_bool(jctx, "low_power", &d->low_power);
+    ret |= json_obj_get_bool(jctx, "led", &d->led);
+    ret |= json_obj_get_string(jctx, "timezone", d->timezone, sizeof(d->timezone));
+    ret |= json_obj_get_string(jctx, "ntp_server", d->ntp_server, sizeof(d->ntp_server));
+    ret |= json_obj_get_string(jctx, "apn", d->apn, sizeof(d->apn));
+    ret |= json_obj_get_bool(jctx, "ota_check", &d->ota_check);
+    ret |= json_obj_get_int(jctx, "version", &d->version);
+    return ret;
+}
+
+static int shadow_get_fields(jparse_ctx_t *jctx, shadow_desired_t *d)
+{
+    const json_field_t fields[] = {
+        { "report_interval", JSON_FIELD_INT, &d->report_interval },
+        { "gps_interval", JSON_FIELD_INT, &d->gps_interval },
+        { "lbs_interval", JSON_FIELD_INT, &d->lbs_interval },
+        { "sensor_interval", JSON_FIELD_INT, &d->sensor_interval },
+        { "temp_offset", JSON_FIELD_FLOAT, &d->temp_offset },
+        { "hum_offset", JSON_FIELD_FLOAT, &d->hum_offset },
+        { "light_gain", JSON_FIELD_FLOAT, &d->light_gain },
+        { "low_power", JSON_FIELD_BOOL, &d->low_power },
+        { "led", JSON_FIELD_BOOL, &d->led },
+        { "timezone", JSON_FIELD_STRING, d->timezone, sizeof(d->timezone) },
+        { "ntp_server", JSON_FIELD_STRING, d->ntp_server, sizeof(d->ntp_server) },
+        { "apn", JSON_FIELD_STRING, d->apn, sizeof(d->apn) },
+        { "ota_check", JSON_FIELD_BOOL, &d->ota_check },
+        { "version", JSON_FIELD_INT, &d->version },
+    };
+    return json_obj_get_fields(jctx, fields, sizeof(fields) / sizeof(fields[0]));
+}
+
+static void check_shadow(const shadow_desired_t *d)
+{
+    TEST_ASSERT_EQUAL_INT(30, d->report_interval);
+    TEST_ASSERT_EQUAL_INT(5, d->gps_interval);
+    TEST_ASSERT_EQUAL_INT(300, d->lbs_interval);
+    TEST_ASSERT_EQUAL_INT(10, d->sensor_interval);
+    TEST_ASSERT(d->temp_offset == -0.5f);
+    TEST_ASSERT(d->hum_offset == 1.25f);
+    TEST_ASSERT(d->light_gain == 1.0f);
+    TEST_ASSERT_EQUAL(false, d->low_power);
+    TEST_ASSERT_EQUAL(true, d->led);
+    TEST_ASSERT_EQUAL_STRING("CST-8", d->timezone);
+    TEST_ASSERT_EQUAL_STRING("pool.ntp.org", d->ntp_server);
+    TEST_ASSERT_EQUAL_STRING("cmnet", d->apn);
+    TEST_ASSERT_EQUAL(true, d->ota_check);
+    TEST_ASSERT_EQUAL_INT(42, d->version);
+}
+
+TEST_CASE("json_parser key index lookup", "[json_parser]")
+{
+    jparse_ctx_t jctx;
+    json_tok_t tokens[64];
+    json_obj_index_t index;
+    shadow_desired_t d;
+    int64_t val;
+
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_parse_start_static(&jctx, shadow_str, strlen(shadow_str), tokens, 64));
+    json_obj_set_index(&jctx, &index);
+
+    /* The index follows the current object in and out of nesting */
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_obj_get_object(&jctx, "state"));
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_obj_get_object(&jctx, "desired"));
+    memset(&d, 0, sizeof(d));
+    TEST_ASSERT_EQUAL(OS_SUCCESS, shadow_get_each(&jctx, &d));
+    check_shadow(&d);
+    TEST_ASSERT_EQUAL(-OS_FAIL, json_obj_get_int(&jctx, "timestamp", &d.version));
+    TEST_ASSERT_EQUAL(-OS_FAIL, json_obj_get_int(&jctx, "led", &d.version));
+    json_obj_leave_object(&jctx);
+    json_obj_leave_object(&jctx);
+
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_obj_get_int64(&jctx, "timestamp", &val));
+    TEST_ASSERT(val == 1700000000123LL);
+    TEST_ASSERT_EQUAL(-OS_FAIL, json_obj_get_int(&jctx, "report_interval", &d.version));
+    json_parse_end_static(&jctx);
+
+    /* First of duplicate keys wins, as with linear search */
+    const char *dup = "{\"a\":1,\"b\":2,\"a\":3}";
+    int a;
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_parse_start_static(&jctx, dup, strlen(dup), tokens, 64));
+    json_obj_set_index(&jctx, &index);
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_obj_get_int(&jctx, "a", &a));
+    TEST_ASSERT_EQUAL_INT(1, a);
+    json_parse_end_static(&jctx);
+}
+
+TEST_CASE("json_parser key index falls back for large objects", "[json_parser]")
+{
+    char js[512];
+    int len = 0;
+    json_tok_t tokens[128];
+    jparse_ctx_t jctx;
+    json_obj_index_t index;
+    int num_keys = JSON_OBJ_INDEX_SIZE;
+
+    js[len++] = '{';
+    for (int i = 0; i < num_keys; i++) {
+        len += sprintf(js + len, "%s\"k%d\":%d", i ? "," : "", i, i * 7);
+    }
+    js[len++] = '}';
+    js[len] = '\0';
+
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_parse_start_static(&jctx, js, len, tokens, 128));
+    json_obj_set_index(&jctx, &index);
+    for (int i = num_keys - 1; i >= 0; i--) {
+        char key[8];
+        int val;
+        sprintf(key, "k%d", i);
+        TEST_ASSERT_EQUAL(OS_SUCCESS, json_obj_get_int(&jctx, key, &val));
+        TEST_ASSERT_EQUAL_INT(i * 7, val);
+    }
+    TEST_ASSERT_EQUAL(false, index.usable);
+    json_parse_end_static(&jctx);
+}
+
+TEST_CASE("json_parser get fields", "[json_parser]")
+{
+    jparse_ctx_t jctx;
+    json_tok_t tokens[64];
+    shadow_desired_t d;
+
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_parse_start_static(&jctx, shadow_str, strlen(shadow_str), tokens, 64));
+    TEST_ASSERT_EQUAL(-OS_FAIL, shadow_get_fields(&jctx, &d));
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_obj_get_object(&jctx, "state"));
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_obj_get_object(&jctx, "desired"));
+    memset(&d, 0, sizeof(d));
+    TEST_ASSERT_EQUAL_INT(14, shadow_get_fields(&jctx, &d));
+    check_shadow(&d);
+    json_parse_end_static(&jctx);
+
+    /* Missing fields and type mismatches leave the defaults in place */
+    char broker[64] = "default";
+    char user[64] = "";
+    int port = 1883;
+    bool tls = true;
+    const json_field_t fields[] = {
+        { "broker", JSON_FIELD_STRING, broker, sizeof(broker) },
+        { "username", JSON_FIELD_STRING, user, 4 },
+        { "port", JSON_FIELD_INT, &port },
+        { "password", JSON_FIELD_BOOL, &tls },
+    };
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_parse_start_static(&jctx, settings_str, strlen(settings_str), tokens, 64));
+    TEST_ASSERT_EQUAL_INT(1, json_obj_get_fields(&jctx, fields, 4));
+    TEST_ASSERT_EQUAL_STRING("mqtt://broker.example.com:1883", broker);
+    TEST_ASSERT_EQUAL_STRING("", user);
+    TEST_ASSERT_EQUAL_INT(1883, port);
+    TEST_ASSERT_EQUAL(true, tls);
+    json_parse_end_static(&jctx);
+}
+
+TEST_CASE("json_parser key lookup benchmark", "[json_parser][perf]")
+{
+    jparse_ctx_t jctx;
+    json_tok_t tokens[64];
+    json_obj_index_t index;
+    shadow_desired_t d;
+    char broker[64], username[64], password[64];
+    int64_t t0, linear_ns, index_ns, fields_ns;
+
+    /* Settings: three reads from a flat object */
+    const json_field_t settings_fields[] = {
+        { "broker", JSON_FIELD_STRING, broker, sizeof(broker) },
+        { "username", JSON_FIELD_STRING, username, sizeof(username) },
+        { "password", JSON_FIELD_STRING, password, sizeof(password) },
+    };
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_parse_start_static(&jctx, settings_str, strlen(settings_str), tokens, 64));
+    t0 = test_time_ns();
+    for (int i = 0; i < INDEX_BENCH_COUNT; i++) {
+        json_obj_get_string(&jctx, "broker", broker, sizeof(broker));
+        json_obj_get_string(&jctx, "username", username, sizeof(username));
+        json_obj_get_string(&jctx, "password", password, sizeof(password));
+    }
+    linear_ns = test_time_ns() - t0;
+    t0 = test_time_ns();
+    for (int i = 0; i < INDEX_BENCH_COUNT; i++) {
+        json_obj_set_index(&jctx, &index);
+        json_obj_get_string(&jctx, "broker", broker, sizeof(broker));
+        json_obj_get_string(&jctx, "username", username, sizeof(username));
+        json_obj_get_string(&jctx, "password", password, sizeof(password));
+    }
+    index_ns = test_time_ns() - t0;
+    json_obj_set_index(&jctx, NULL);
+    t0 = test_time_ns();
+    for (int i = 0; i < INDEX_BENCH_COUNT; i++) {
+        json_obj_get_fields(&jctx, settings_fields, 3);
+    }
+    fields_ns = test_time_ns() - t0;
+    json_parse_end_static(&jctx);
+    printf("settings: linear %lld ns, index %lld ns, fields %lld ns\n",
+           (long long)(linear_ns / INDEX_BENCH_COUNT), (long long)(index_ns / INDEX_BENCH_COUNT),
+           (long long)(fields_ns / INDEX_BENCH_COUNT));
+
+    /* Shadow: fourteen reads from a nested object */
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_parse_start_static(&jctx, shadow_str, strlen(shadow_str), tokens, 64));
+    json_obj_get_object(&jctx, "state");
+    json_obj_get_object(&jctx, "desired");
+    t0 = test_time_ns();
+    for (int i = 0; i < INDEX_BENCH_COUNT; i++) {
+        shadow_get_each(&jctx, &d);
+    }
+    linear_ns = test_time_ns() - t0;
+    t0 = test_time_ns();
+    for (int i = 0; i < INDEX_BENCH_COUNT; i++) {
+        json_obj_set_index(&jctx, &index);
+        shadow_get_each(&jctx, &d);
+    }
+    index_ns = test_time_ns() - t0;
+    json_obj_set_index(&jctx, NULL);
+    t0 = test_time_ns();
+    for (int i = 0; i < INDEX_BENCH_COUNT; i++) {
+        shadow_get_fields(&jctx, &d);
+    }
+    fields_ns = test_time_ns() - t0;
+    check_shadow(&d);
+    json_parse_end_static(&jctx);
+    printf("shadow: linear %lld ns, index %lld ns, fields %lld ns\n",
+           (long long)(linear_ns / INDEX_BENCH_COUNT), (long long)(index_ns / INDEX_BENCH_COUNT),
+           (long long)(fields_ns / INDEX_BENCH_COUNT));
+}
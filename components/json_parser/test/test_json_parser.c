@@ -58,4 +58,45 @@ TEST_CASE("json_parser basic tests", "[json_parser]")
     TEST_ASSERT(int64_val == 109174583252);
 
     json_parse_end(&jctx);
-}
\ No newline at end of file
+}
+TEST_CASE("json_parser static token pool", "[json_parser]")
+{
+    jparse_ctx_t jctx;
+    json_tok_t tokens[32];
+    char str_val[64];
+
+    /* The test document needs 25 tokens */
+    TEST_ASSERT_EQUAL(-OS_FAIL, json_parse_start_static(&jctx, json_test_str, strlen(json_test_str), tokens, 24));
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_parse_start_static(&jctx, json_test_str, strlen(json_test_str), tokens, 32));
+    TEST_ASSERT_EQUAL_INT(25, jctx.num_tokens);
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_obj_get_object(&jctx, "features"));
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_obj_get_string(&jctx, "arrays", str_val, sizeof(str_val)));
+    TEST_ASSERT_EQUAL_STRING("yes", str_val);
+    json_obj_leave_object(&jctx);
+    json_parse_end_static(&jctx);
+
+    TEST_ASSERT_EQUAL(-OS_FAIL, json_parse_start_static(&jctx, "{\"a\":", 5, tokens, 32));
+}
+
+TEST_CASE("json_parser unescape string", "[json_parser]")
+{
+    char str[64];
+
+    strcpy(str, "http:\\/\\/host\\/fw.bin");
+    TEST_ASSERT_EQUAL_INT(18, json_unescape_string(str));
+    TEST_ASSERT_EQUAL_STRING("http://host/fw.bin", str);
+
+    strcpy(str, "a\\\"b\\\\c\\n\\t");
+    json_unescape_string(str);
+    TEST_ASSERT_EQUAL_STRING("a\"b\\c\n\t", str);
+
+    strcpy(str, "\\u0041\\u00e9\\u4e2d\\ud83d\\ude00");
+    json_unescape_string(str);
+    TEST_ASSERT_EQUAL_STRING("A\xc3\xa9\xe4\xb8\xad\xf0\x9f\x98\x80", str);
+
+    const char *invalid[] = { "\\x", "\\u12", "\\u12g4", "\\ud83d", "\\ude00", "\\ud83d\\u0041", "end\\" };
+    for (int i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        strcpy(str, invalid[i]);
+        TEST_ASSERT_EQUAL(-OS_FAIL, json_unescape_string(str));
+    }
+}
@@ -0,0 +1,178 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "json_stream.h"
+#include "unity.h"
+
+#define json_test_str   "{\n\"str_val\" :    \"JSON Parser\",\n" \
+            "\t\"float_val\" : 2.0,\n" \
+            "\"int_val\" : 2017,\n" \
+            "\"bool_val\" : false,\n" \
+            "\"supported_el\" :\t [\"bool\",\"int\","\
+            "\"float\",\"str\"" \
+            ",\"object\",\"array\"],\n" \
+            "\"features\" : { \"objects\":true, "\
+            "\"arrays\":\"yes\"},\n"\
+            "\"esc\":\"a\\\"b\\u00e9\",\n"\
+            "\"empty\":{},\"nothing\":null,\"nested\":[[1,-2.5e3],[]],\n"\
+            "\"int_64\":109174583252}"
+
+#define json_test_events \
+    "0{ 1:str_val=JSON Parser 1:float_val=2.0 1:int_val=2017 1:bool_val=false " \
+    "1:supported_el[ 2#0=bool 2#1=int 2#2=float 2#3=str 2#4=object 2#5=array 1:supported_el] " \
+    "1:features{ 2:objects=true 2:arrays=yes 1:features} " \
+    "1:esc=a\\\"b\\u00e9 1:empty{ 1:empty} 1:nothing=null " \
+    "1:nested[ 2#0[ 3#0=1 3#1=-2.5e3 2#0] 2#1[ 2#1] 1:nested] " \
+    "1:int_64=109174583252 0} "
+
+/* Records every event as text, so that runs with different chunk sizes
+ * can be compared
+ */
+typedef struct {
+    char log[1024];
+    int len;
+    int abort_at;
+} stream_log_t;
+
+static int stream_log_cb(const json_stream_event_t *event, void *priv)
+{
+    stream_log_t *log = (stream_log_t *)priv;
+    char prefix[48];
+    if (event->key) {
+        snprintf(prefix, sizeof(prefix), "%d:%s", event->depth, event->key);
+    } else if (event->index >= 0) {
+        snprintf(prefix, sizeof(prefix), "%d#%d", event->depth, event->index);
+    } else {
+        snprintf(prefix, sizeof(prefix), "%d", event->depth);
+    }
+    const char *suffix = "";
+    switch (event->type) {
+    case JSON_STREAM_OBJECT_START: suffix = "{"; break;
+    case JSON_STREAM_OBJECT_END: suffix = "}"; break;
+    case JSON_STREAM_ARRAY_START: suffix = "["; break;
+    case JSON_STREAM_ARRAY_END: suffix = "]"; break;
+    default: break;
+    }
+    log->len += snprintf(log->log + log->len, sizeof(log->log) - log->len, "%s%s%s%s ",
+                         prefix, suffix, event->value ? "=" : "", event->value ? event->value : "");
+    if (log->abort_at && --log->abort_at == 0) {
+        return -1;
+    }
+    return 0;
+}
+
+static int stream_parse(const char *doc, int chunk, stream_log_t *log)
+{
+    json_stream_t js;
+    memset(log, 0, sizeof(*log));
+    json_stream_init(&js, stream_log_cb, log);
+    int len = strlen(doc);
+    for (int i = 0; i < len; i += chunk) {
+        int n = (len - i) < chunk ? (len - i) : chunk;
+        if (json_stream_feed(&js, doc + i, n) != OS_SUCCESS) {
+            return -OS_FAIL;
+        }
+    }
+    return json_stream_end(&js);
+}
+
+TEST_CASE("json_stream reports all values for any chunk size", "[json_parser]")
+{
+    stream_log_t log;
+    for (int chunk = 1; chunk <= (int)strlen(json_test_str); chunk++) {
+        TEST_ASSERT_EQUAL(OS_SUCCESS, stream_parse(json_test_str, chunk, &log));
+        TEST_ASSERT_EQUAL_STRING(json_test_events, log.log);
+    }
+}
+
+TEST_CASE("json_stream root scalars", "[json_parser]")
+{
+    stream_log_t log;
+    TEST_ASSERT_EQUAL(OS_SUCCESS, stream_parse(" 42 ", 1, &log));
+    TEST_ASSERT_EQUAL_STRING("0=42 ", log.log);
+    /* A root number is only complete once the end is known */
+    TEST_ASSERT_EQUAL(OS_SUCCESS, stream_parse("-0.5", 2, &log));
+    TEST_ASSERT_EQUAL_STRING("0=-0.5 ", log.log);
+    TEST_ASSERT_EQUAL(OS_SUCCESS, stream_parse("\"x\"", 1, &log));
+    TEST_ASSERT_EQUAL_STRING("0=x ", log.log);
+}
+
+TEST_CASE("json_stream rejects invalid documents", "[json_parser]")
+{
+    const char *invalid[] = {
+        "",
+        "{",
+        "{\"a\" 1}",
+        "{\"a\":1,}",
+        "[1,]",
+        "[1 2]",
+        "{\"a\":tru}",
+        "{\"a\":01}",
+        "{\"a\":1.}",
+        "{\"a\":-}",
+        "{\"a\":\"\\x\"}",
+        "{\"a\":\"\\u12g4\"}",
+        "{\"a\":\"line\nbreak\"}",
+        "{\"a\":1]",
+        "[1}",
+        "{1:2}",
+        "{} {}",
+        "\"unterminated",
+        "[[[[[[[[[1]]]]]]]]]",
+        "{\"this_key_is_much_longer_than_thirty_two_bytes\":1}",
+    };
+    stream_log_t log;
+    for (int i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        for (int chunk = 1; chunk <= 3; chunk++) {
+            TEST_ASSERT_EQUAL_MESSAGE(-OS_FAIL, stream_parse(invalid[i], chunk, &log), invalid[i]);
+        }
+    }
+    /* Maximum nesting is still accepted */
+    TEST_ASSERT_EQUAL(OS_SUCCESS, stream_parse("[[[[[[[[1]]]]]]]]", 1, &log));
+}
+
+TEST_CASE("json_stream callback can abort", "[json_parser]")
+{
+    stream_log_t log;
+    json_stream_t js;
+    memset(&log, 0, sizeof(log));
+    log.abort_at = 3;
+    json_stream_init(&js, stream_log_cb, &log);
+    TEST_ASSERT_EQUAL(-OS_FAIL, json_stream_feed(&js, json_test_str, strlen(json_test_str)));
+    TEST_ASSERT_EQUAL_STRING("0{ 1:str_val=JSON Parser 1:float_val=2.0 ", log.log);
+    /* Further input is refused after an error */
+    TEST_ASSERT_EQUAL(-OS_FAIL, json_stream_feed(&js, " ", 1));
+    TEST_ASSERT_EQUAL(-OS_FAIL, json_stream_end(&js));
+}
+
+typedef struct {
+    json_stream_t *js;
+    char ssid[33];
+    int port;
+} stream_path_t;
+
+static int stream_path_cb(const json_stream_event_t *event, void *priv)
+{
+    stream_path_t *path = (stream_path_t *)priv;
+    const char *parent = json_stream_get_key(path->js, 1);
+    if (event->depth == 2 && parent && event->key) {
+        if (strcmp(parent, "wifi") == 0 && strcmp(event->key, "ssid") == 0) {
+            strncpy(path->ssid, event->value, sizeof(path->ssid) - 1);
+        } else if (strcmp(parent, "mqtt") == 0 && strcmp(event->key, "port") == 0) {
+            path->port = atoi(event->value);
+        }
+    }
+    return 0;
+}
+
+TEST_CASE("json_stream key path lookup", "[json_parser]")
+{
+    const char *doc = "{\"mqtt\":{\"ssid\":\"no\",\"port\":8883},\"wifi\":{\"port\":1,\"ssid\":\"home\"}}";
+    json_stream_t js;
+    stream_path_t path = { .js = &js };
+    json_stream_init(&js, stream_path_cb, &path);
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_stream_feed(&js, doc, strlen(doc)));
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_stream_end(&js));
+    TEST_ASSERT_EQUAL_STRING("home", path.ssid);
+    TEST_ASSERT_EQUAL_INT(8883, path.port);
+}
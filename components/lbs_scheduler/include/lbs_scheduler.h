@@ -0,0 +1,164 @@
+/*
+ * Cell (LBS) positioning query scheduler
+ *
+ * Cell positioning costs cellular data and modem time, and while the serving
+ * cell does not change it keeps returning much the same answer. The
+ * scheduler decides, each time GNSS reports no fix, whether to query, to
+ * reuse a cached result or to wait:
+ *
+ * - Queries in the same cell back off exponentially, from base_interval_ms
+ *   up to max_interval_ms. The backoff is kept per cell, so returning to a
+ *   cell resumes where it left off.
+ * - The last result for each cell is cached. Entering a cell with a fresh
+ *   cached result publishes it without a query.
+ * - Nothing is queried while GNSS has a fix.
+ *
+ * The scheduler has no timers of its own, the caller passes a monotonic
+ * time in ms to every call.
+ */
+#ifndef _LBS_SCHEDULER_H_
+#define _LBS_SCHEDULER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** Cells remembered */
+#define LBS_SCHED_CACHE_SIZE    8
+/** Minute buckets for the queries per hour metric */
+#define LBS_SCHED_BUCKETS       60
+
+/** Serving cell not known, e.g. no service. Results for it are never
+ * reused, but queries still back off. */
+#define LBS_CELL_UNKNOWN        0
+
+/** Scheduler tuning */
+typedef struct {
+    /** Interval after the first query in a cell */
+    uint32_t base_interval_ms;
+    /** Longest interval between queries in the same cell */
+    uint32_t max_interval_ms;
+    /** Age after which a cached result is no longer used */
+    uint32_t cache_ttl_ms;
+    /** Time to wait for a query result before treating it as failed */
+    uint32_t query_timeout_ms;
+} lbs_sched_config_t;
+
+#define LBS_SCHED_CONFIG_DEFAULT()              \
+    {                                           \
+        .base_interval_ms = 15000,              \
+        .max_interval_ms = 30 * 60 * 1000,      \
+        .cache_ttl_ms = 24 * 60 * 60 * 1000,    \
+        .query_timeout_ms = 30000,              \
+    }
+
+/** A cell positioning result */
+typedef struct {
+    /** Degrees x 1e7, north and east positive */
+    int32_t lat_e7;
+    int32_t lon_e7;
+    /** Accuracy reported with the result, in metres, 0 if unknown */
+    float accuracy;
+} lbs_position_t;
+
+/** What to do about a missing GNSS fix */
+typedef enum {
+    /** Nothing, the last result is still current */
+    LBS_SCHED_WAIT = 0,
+    /** Send a query and report the outcome with lbs_sched_on_result() */
+    LBS_SCHED_QUERY,
+    /** Publish the cached result for the current cell */
+    LBS_SCHED_USE_CACHE,
+} lbs_sched_action_t;
+
+/** Cached result and backoff state of one cell */
+typedef struct {
+    uint64_t cell;
+    /** Time of the last successful query */
+    int64_t time_ms;
+    /** Interval until the next query in this cell */
+    uint32_t interval_ms;
+    lbs_position_t position;
+    bool used;
+} lbs_sched_entry_t;
+
+/** Scheduler context
+ *
+ * Please do not set/modify any elements.
+ */
+typedef struct {
+    lbs_sched_config_t config;
+    /** Cell whose position was last published since GNSS was lost */
+    uint64_t published_cell;
+    bool published;
+    /** Query in flight */
+    bool pending;
+    uint64_t pending_cell;
+    int64_t pending_ms;
+    /** No query before this time after a failure */
+    int64_t retry_ms;
+    uint32_t retry_interval_ms;
+    lbs_sched_entry_t cache[LBS_SCHED_CACHE_SIZE];
+    /** Queries per minute, with the minute each bucket was last used in */
+    uint16_t bucket_count[LBS_SCHED_BUCKETS];
+    int64_t bucket_minute[LBS_SCHED_BUCKETS];
+    /** Totals since lbs_sched_init() */
+    uint32_t queries;
+    uint32_t failures;
+    uint32_t cache_hits;
+} lbs_sched_t;
+
+/** Initialise a scheduler
+ *
+ * \param[out] sched Scheduler context
+ * \param[in] config Tuning, or NULL for LBS_SCHED_CONFIG_DEFAULT()
+ */
+void lbs_sched_init(lbs_sched_t *sched, const lbs_sched_config_t *config);
+
+/** GNSS has no fix
+ *
+ * \param[in] sched Scheduler context
+ * \param[in] now_ms Current time
+ * \param[in] cell Serving cell, see lbs_sched_cell_key(), or LBS_CELL_UNKNOWN
+ * \param[out] position Cached result, set for LBS_SCHED_USE_CACHE
+ *
+ * \return What to do, see lbs_sched_action_t. LBS_SCHED_QUERY is counted
+ * as a query straight away.
+ */
+lbs_sched_action_t lbs_sched_on_no_fix(lbs_sched_t *sched, int64_t now_ms, uint64_t cell,
+                                       lbs_position_t *position);
+
+/** Report the outcome of a query
+ *
+ * \param[in] sched Scheduler context
+ * \param[in] now_ms Current time
+ * \param[in] position Result, or NULL if the query failed
+ */
+void lbs_sched_on_result(lbs_sched_t *sched, int64_t now_ms, const lbs_position_t *position);
+
+/** GNSS has a fix, stop querying until it is lost again */
+void lbs_sched_on_gnss_fix(lbs_sched_t *sched);
+
+/** Number of queries in the last hour */
+uint32_t lbs_sched_queries_last_hour(const lbs_sched_t *sched, int64_t now_ms);
+
+/** Build a cell key
+ *
+ * \param[in] mcc Mobile country code
+ * \param[in] mnc Mobile network code
+ * \param[in] lac Location or tracking area code
+ * \param[in] cell_id Cell identity, up to 28 bits
+ *
+ * \return Key, never LBS_CELL_UNKNOWN
+ */
+uint64_t lbs_sched_cell_key(uint16_t mcc, uint16_t mnc, uint16_t lac, uint32_t cell_id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _LBS_SCHEDULER_H_ */
@@ -0,0 +1,171 @@
+#include <string.h>
+#include <lbs_scheduler.h>
+
+#define MS_PER_MINUTE   60000
+
+void lbs_sched_init(lbs_sched_t *sched, const lbs_sched_config_t *config)
+{
+    static const lbs_sched_config_t default_config = LBS_SCHED_CONFIG_DEFAULT();
+
+    memset(sched, 0, sizeof(lbs_sched_t));
+    sched->config = config ? *config : default_config;
+    for (int i = 0; i < LBS_SCHED_BUCKETS; i++) {
+        sched->bucket_minute[i] = -1;
+    }
+}
+
+static lbs_sched_entry_t *lbs_sched_find(lbs_sched_t *sched, uint64_t cell)
+{
+    for (int i = 0; i < LBS_SCHED_CACHE_SIZE; i++) {
+        if (sched->cache[i].used && sched->cache[i].cell == cell) {
+            return &sched->cache[i];
+        }
+    }
+    return NULL;
+}
+
+/* A free entry, or else the one queried longest ago */
+static lbs_sched_entry_t *lbs_sched_alloc(lbs_sched_t *sched, uint64_t cell)
+{
+    lbs_sched_entry_t *oldest = &sched->cache[0];
+    for (int i = 0; i < LBS_SCHED_CACHE_SIZE; i++) {
+        if (!sched->cache[i].used) {
+            oldest = &sched->cache[i];
+            break;
+        }
+        if (sched->cache[i].time_ms < oldest->time_ms) {
+            oldest = &sched->cache[i];
+        }
+    }
+    memset(oldest, 0, sizeof(lbs_sched_entry_t));
+    oldest->cell = cell;
+    oldest->used = true;
+    return oldest;
+}
+
+static bool lbs_sched_is_fresh(const lbs_sched_t *sched, const lbs_sched_entry_t *entry, int64_t now_ms)
+{
+    return entry && now_ms - entry->time_ms < (int64_t)sched->config.cache_ttl_ms;
+}
+
+static void lbs_sched_count_query(lbs_sched_t *sched, int64_t now_ms)
+{
+    int64_t minute = now_ms / MS_PER_MINUTE;
+    int i = minute % LBS_SCHED_BUCKETS;
+    if (sched->bucket_minute[i] != minute) {
+        sched->bucket_minute[i] = minute;
+        sched->bucket_count[i] = 0;
+    }
+    if (sched->bucket_count[i] < UINT16_MAX) {
+        sched->bucket_count[i]++;
+    }
+    sched->queries++;
+}
+
+static void lbs_sched_fail(lbs_sched_t *sched, int64_t now_ms)
+{
+    uint32_t interval = sched->retry_interval_ms;
+    sched->pending = false;
+    sched->failures++;
+    if (interval < sched->config.base_interval_ms) {
+        interval = sched->config.base_interval_ms;
+    }
+    sched->retry_ms = now_ms + interval;
+    interval *= 2;
+    sched->retry_interval_ms = interval < sched->config.max_interval_ms ? interval : sched->config.max_interval_ms;
+}
+
+lbs_sched_action_t lbs_sched_on_no_fix(lbs_sched_t *sched, int64_t now_ms, uint64_t cell,
+                                       lbs_position_t *position)
+{
+    lbs_sched_entry_t *entry = lbs_sched_find(sched, cell);
+    bool fresh = lbs_sched_is_fresh(sched, entry, now_ms);
+
+    if (sched->pending) {
+        if (now_ms - sched->pending_ms < (int64_t)sched->config.query_timeout_ms) {
+            return LBS_SCHED_WAIT;
+        }
+        lbs_sched_fail(sched, now_ms);
+    }
+
+    /* A known cell's position is published once per cell change */
+    if (fresh && cell != LBS_CELL_UNKNOWN && (!sched->published || sched->published_cell != cell)) {
+        sched->published = true;
+        sched->published_cell = cell;
+        sched->cache_hits++;
+        if (position) {
+            *position = entry->position;
+        }
+        return LBS_SCHED_USE_CACHE;
+    }
+
+    if (now_ms < sched->retry_ms) {
+        return LBS_SCHED_WAIT;
+    }
+    if (fresh && now_ms - entry->time_ms < (int64_t)entry->interval_ms) {
+        return LBS_SCHED_WAIT;
+    }
+
+    sched->pending = true;
+    sched->pending_cell = cell;
+    sched->pending_ms = now_ms;
+    lbs_sched_count_query(sched, now_ms);
+    return LBS_SCHED_QUERY;
+}
+
+void lbs_sched_on_result(lbs_sched_t *sched, int64_t now_ms, const lbs_position_t *position)
+{
+    if (!sched->pending) {
+        return;
+    }
+    if (!position) {
+        lbs_sched_fail(sched, now_ms);
+        return;
+    }
+
+    lbs_sched_entry_t *entry = lbs_sched_find(sched, sched->pending_cell);
+    uint32_t interval = sched->config.base_interval_ms;
+    if (lbs_sched_is_fresh(sched, entry, now_ms)) {
+        /* Same cell queried again, back off further */
+        interval = entry->interval_ms * 2;
+        if (interval > sched->config.max_interval_ms || interval < entry->interval_ms) {
+            interval = sched->config.max_interval_ms;
+        }
+    } else if (!entry) {
+        entry = lbs_sched_alloc(sched, sched->pending_cell);
+    }
+    entry->time_ms = now_ms;
+    entry->interval_ms = interval;
+    entry->position = *position;
+
+    sched->pending = false;
+    sched->retry_ms = 0;
+    sched->retry_interval_ms = 0;
+    sched->published = true;
+    sched->published_cell = sched->pending_cell;
+}
+
+void lbs_sched_on_gnss_fix(lbs_sched_t *sched)
+{
+    sched->pending = false;
+    sched->published = false;
+}
+
+uint32_t lbs_sched_queries_last_hour(const lbs_sched_t *sched, int64_t now_ms)
+{
+    int64_t minute = now_ms / MS_PER_MINUTE;
+    uint32_t count = 0;
+    for (int i = 0; i < LBS_SCHED_BUCKETS; i++) {
+        if (sched->bucket_minute[i] > minute - LBS_SCHED_BUCKETS && sched->bucket_minute[i] <= minute) {
+            count += sched->bucket_count[i];
+        }
+    }
+    return count;
+}
+
+uint64_t lbs_sched_cell_key(uint16_t mcc, uint16_t mnc, uint16_t lac, uint32_t cell_id)
+{
+    uint64_t key = ((uint64_t)(mcc & 0x3ff) << 54) | ((uint64_t)(mnc & 0x3ff) << 44) |
+                   ((uint64_t)lac << 28) | (cell_id & 0xfffffff);
+    return key != LBS_CELL_UNKNOWN ? key : 1;
+}
@@ -0,0 +1,169 @@
+#include <stdio.h>
+#include <string.h>
+#include "lbs_scheduler.h"
+#include "unity.h"
+
+/* GNSS no-fix reports come every 15 s with AT+CGPSINFO=15 */
+#define REPORT_MS   15000
+
+static const lbs_position_t s_pos_a = { 312304160, 1214737010, 550 };
+static const lbs_position_t s_pos_b = { 312400000, 1214800000, 800 };
+
+/* Answer every query at once with pos */
+static lbs_sched_action_t no_fix(lbs_sched_t *sched, int64_t now_ms, uint64_t cell,
+                                 const lbs_position_t *pos, lbs_position_t *out)
+{
+    lbs_sched_action_t action = lbs_sched_on_no_fix(sched, now_ms, cell, out);
+    if (action == LBS_SCHED_QUERY) {
+        lbs_sched_on_result(sched, now_ms + 1000, pos);
+    }
+    return action;
+}
+
+TEST_CASE("lbs scheduler backs off in an unchanged cell", "[lbs_scheduler]")
+{
+    lbs_sched_t sched;
+    uint64_t cell = lbs_sched_cell_key(460, 0, 0x1816, 27873299);
+    int64_t queried[16];
+    int count = 0;
+
+    lbs_sched_init(&sched, NULL);
+    /* Two hours indoors in one cell */
+    for (int64_t t = 0; t <= 2 * 3600 * 1000LL; t += REPORT_MS) {
+        if (no_fix(&sched, t, cell, &s_pos_a, NULL) == LBS_SCHED_QUERY) {
+            TEST_ASSERT_TRUE(count < 16);
+            queried[count++] = t / 1000;
+        }
+    }
+
+    /* 15 s, then doubling up to 30 min. Intervals count from the result,
+     * which arrives 1 s after the query. */
+    static const int64_t expected[] = { 0, 30, 75, 150, 285, 540, 1035, 2010, 3825, 5640 };
+    TEST_ASSERT_EQUAL(sizeof(expected) / sizeof(expected[0]), count);
+    for (int i = 0; i < count; i++) {
+        TEST_ASSERT_EQUAL_INT64(expected[i], queried[i]);
+    }
+    /* Instead of 240 an hour */
+    TEST_ASSERT_EQUAL(8, lbs_sched_queries_last_hour(&sched, 3600 * 1000LL - 1));
+    TEST_ASSERT_EQUAL(2, lbs_sched_queries_last_hour(&sched, 2 * 3600 * 1000LL));
+    TEST_ASSERT_EQUAL(10, sched.queries);
+    TEST_ASSERT_EQUAL(0, sched.cache_hits);
+}
+
+TEST_CASE("lbs scheduler reuses cached results per cell", "[lbs_scheduler]")
+{
+    lbs_sched_t sched;
+    lbs_position_t pos;
+    uint64_t cell_a = lbs_sched_cell_key(460, 0, 0x1816, 1001);
+    uint64_t cell_b = lbs_sched_cell_key(460, 0, 0x1816, 1002);
+
+    lbs_sched_init(&sched, NULL);
+    TEST_ASSERT_EQUAL(LBS_SCHED_QUERY, no_fix(&sched, 0, cell_a, &s_pos_a, &pos));
+    TEST_ASSERT_EQUAL(LBS_SCHED_WAIT, no_fix(&sched, 15000, cell_a, &s_pos_a, &pos));
+
+    /* A new cell is queried straight away, whatever the backoff in the last */
+    TEST_ASSERT_EQUAL(LBS_SCHED_QUERY, no_fix(&sched, 20000, cell_b, &s_pos_b, &pos));
+    TEST_ASSERT_EQUAL(LBS_SCHED_WAIT, no_fix(&sched, 25000, cell_b, &s_pos_b, &pos));
+
+    /* Back in cell A: its result is published without a query, once */
+    memset(&pos, 0, sizeof(pos));
+    TEST_ASSERT_EQUAL(LBS_SCHED_USE_CACHE, no_fix(&sched, 30000, cell_a, &s_pos_a, &pos));
+    TEST_ASSERT_EQUAL(0, memcmp(&pos, &s_pos_a, sizeof(pos)));
+    /* Cell A's own backoff resumes, 15 s after its result at 1 s */
+    TEST_ASSERT_EQUAL(LBS_SCHED_QUERY, no_fix(&sched, 31000, cell_a, &s_pos_a, &pos));
+    TEST_ASSERT_EQUAL(LBS_SCHED_WAIT, no_fix(&sched, 45000, cell_a, &s_pos_a, &pos));
+    TEST_ASSERT_EQUAL(1, sched.cache_hits);
+}
+
+TEST_CASE("lbs scheduler stops while GNSS has a fix", "[lbs_scheduler]")
+{
+    lbs_sched_t sched;
+    lbs_position_t pos;
+    uint64_t cell = lbs_sched_cell_key(460, 1, 0x2001, 7);
+
+    lbs_sched_init(&sched, NULL);
+    TEST_ASSERT_EQUAL(LBS_SCHED_QUERY, lbs_sched_on_no_fix(&sched, 0, cell, &pos));
+    /* GNSS comes back before the answer, which is then not cached */
+    lbs_sched_on_gnss_fix(&sched);
+    lbs_sched_on_result(&sched, 2000, &s_pos_a);
+    TEST_ASSERT_EQUAL(LBS_SCHED_QUERY, no_fix(&sched, 600000, cell, &s_pos_a, &pos));
+
+    /* Lost again in the same cell: the cached result is published at once,
+     * the next query waits for the cell's backoff */
+    lbs_sched_on_gnss_fix(&sched);
+    TEST_ASSERT_EQUAL(LBS_SCHED_USE_CACHE, lbs_sched_on_no_fix(&sched, 605000, cell, &pos));
+    TEST_ASSERT_EQUAL(LBS_SCHED_WAIT, lbs_sched_on_no_fix(&sched, 610000, cell, &pos));
+    TEST_ASSERT_EQUAL(LBS_SCHED_QUERY, lbs_sched_on_no_fix(&sched, 616000, cell, &pos));
+    TEST_ASSERT_EQUAL(3, sched.queries);
+}
+
+TEST_CASE("lbs scheduler backs off after failures and timeouts", "[lbs_scheduler]")
+{
+    lbs_sched_t sched;
+    lbs_position_t pos;
+    uint64_t cell = lbs_sched_cell_key(460, 0, 1, 1);
+
+    lbs_sched_init(&sched, NULL);
+    TEST_ASSERT_EQUAL(LBS_SCHED_QUERY, lbs_sched_on_no_fix(&sched, 0, cell, &pos));
+    lbs_sched_on_result(&sched, 1000, NULL);
+    TEST_ASSERT_EQUAL(LBS_SCHED_WAIT, lbs_sched_on_no_fix(&sched, 15000, cell, &pos));
+    TEST_ASSERT_EQUAL(LBS_SCHED_QUERY, lbs_sched_on_no_fix(&sched, 16000, cell, &pos));
+
+    /* No answer at all: the query times out and counts as a failure */
+    TEST_ASSERT_EQUAL(LBS_SCHED_WAIT, lbs_sched_on_no_fix(&sched, 45000, cell, &pos));
+    TEST_ASSERT_EQUAL(LBS_SCHED_WAIT, lbs_sched_on_no_fix(&sched, 46000, cell, &pos));
+    TEST_ASSERT_EQUAL(LBS_SCHED_WAIT, lbs_sched_on_no_fix(&sched, 75000, cell, &pos));
+    TEST_ASSERT_EQUAL(LBS_SCHED_QUERY, lbs_sched_on_no_fix(&sched, 76000, cell, &pos));
+    TEST_ASSERT_EQUAL(2, sched.failures);
+
+    /* A late answer after the timeout is ignored */
+    lbs_sched_on_result(&sched, 77000, &s_pos_a);
+    TEST_ASSERT_EQUAL(LBS_SCHED_WAIT, lbs_sched_on_no_fix(&sched, 80000, cell, &pos));
+    TEST_ASSERT_EQUAL(LBS_SCHED_QUERY, lbs_sched_on_no_fix(&sched, 92000, cell, &pos));
+    lbs_sched_on_result(&sched, 93000, &s_pos_a);
+    TEST_ASSERT_EQUAL(0, sched.retry_ms);
+}
+
+TEST_CASE("lbs scheduler never reuses results for an unknown cell", "[lbs_scheduler]")
+{
+    lbs_sched_t sched;
+    lbs_position_t pos;
+    uint64_t cell = lbs_sched_cell_key(460, 0, 1, 1);
+
+    lbs_sched_init(&sched, NULL);
+    TEST_ASSERT_EQUAL(LBS_SCHED_QUERY, no_fix(&sched, 0, LBS_CELL_UNKNOWN, &s_pos_a, &pos));
+    /* Still backs off */
+    TEST_ASSERT_EQUAL(LBS_SCHED_WAIT, no_fix(&sched, 10000, LBS_CELL_UNKNOWN, &s_pos_a, &pos));
+    TEST_ASSERT_EQUAL(LBS_SCHED_QUERY, no_fix(&sched, 16000, LBS_CELL_UNKNOWN, &s_pos_a, &pos));
+    TEST_ASSERT_EQUAL(LBS_SCHED_QUERY, no_fix(&sched, 35000, cell, &s_pos_a, &pos));
+    /* Coming back from a known cell does not publish the unknown cell's result */
+    TEST_ASSERT_EQUAL(LBS_SCHED_WAIT, no_fix(&sched, 40000, LBS_CELL_UNKNOWN, &s_pos_a, &pos));
+    TEST_ASSERT_EQUAL(0, sched.cache_hits);
+
+    TEST_ASSERT_TRUE(lbs_sched_cell_key(0, 0, 0, 0) != LBS_CELL_UNKNOWN);
+    TEST_ASSERT_TRUE(lbs_sched_cell_key(460, 0, 0x1816, 1) != lbs_sched_cell_key(460, 1, 0x1816, 1));
+    TEST_ASSERT_TRUE(lbs_sched_cell_key(460, 0, 0x1816, 1) != lbs_sched_cell_key(460, 0, 0x1817, 1));
+}
+
+TEST_CASE("lbs scheduler evicts the oldest cell and expires results", "[lbs_scheduler]")
+{
+    lbs_sched_t sched;
+    lbs_position_t pos;
+    lbs_sched_config_t config = LBS_SCHED_CONFIG_DEFAULT();
+
+    config.cache_ttl_ms = 3600 * 1000;
+    lbs_sched_init(&sched, &config);
+    for (int i = 0; i <= LBS_SCHED_CACHE_SIZE; i++) {
+        uint64_t cell = lbs_sched_cell_key(460, 0, 1, 100 + i);
+        TEST_ASSERT_EQUAL(LBS_SCHED_QUERY, no_fix(&sched, i * 60000LL, cell, &s_pos_a, &pos));
+    }
+    /* The first cell made room for the last */
+    TEST_ASSERT_EQUAL(LBS_SCHED_QUERY, no_fix(&sched, 600000, lbs_sched_cell_key(460, 0, 1, 100), &s_pos_a, &pos));
+    TEST_ASSERT_EQUAL(LBS_SCHED_USE_CACHE, no_fix(&sched, 601000, lbs_sched_cell_key(460, 0, 1, 102), &s_pos_a, &pos));
+
+    /* An expired result is queried again, starting from the base interval */
+    uint64_t cell = lbs_sched_cell_key(460, 0, 1, 103);
+    TEST_ASSERT_EQUAL(LBS_SCHED_QUERY, no_fix(&sched, 3 * 60000 + 3601 * 1000LL, cell, &s_pos_b, &pos));
+    TEST_ASSERT_EQUAL(LBS_SCHED_WAIT, no_fix(&sched, 3 * 60000 + 3610 * 1000LL, cell, &s_pos_b, &pos));
+    TEST_ASSERT_EQUAL(LBS_SCHED_QUERY, no_fix(&sched, 3 * 60000 + 3617 * 1000LL, cell, &s_pos_b, &pos));
+}
@@ -0,0 +1,100 @@
+/*
+ * Automatic range selection for the BH1750 ambient light sensor
+ *
+ * The BH1750 counts light into a 16 bit result. Its resolution mode (H,
+ * H2 at half the step, L at four times the step but 7.5 times faster) and
+ * its measurement time register MTreg (31 to 254, 69 nominal) trade range
+ * against resolution and conversion time. No single setting covers both
+ * a dark room, where 1 lx steps are coarse, and sunlight above 54612 lx,
+ * where the nominal setting saturates.
+ *
+ * The ranger picks one of three settings for the next one-shot measurement
+ * from the count of the last one:
+ *
+ * - Dark: H2, MTreg 254, 0.14 lx steps up to 7417 lx, up to 663 ms
+ * - Normal: H, MTreg 69, 1 lx steps up to 54612 lx, up to 180 ms
+ * - Bright: L, MTreg 31, 8.9 lx steps up to 121557 lx, up to 11 ms
+ *
+ * It moves to a wider range once the light exceeds 80 % of the current
+ * range, or the count saturates, and back to a finer one once the light is
+ * below 40 % of that range, so it does not flip between two ranges.
+ */
+#ifndef _LIGHT_RANGING_H_
+#define _LIGHT_RANGING_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** Resolution mode of a measurement */
+typedef enum {
+    LIGHT_MODE_H = 0,
+    LIGHT_MODE_H2,
+    LIGHT_MODE_L,
+} light_mode_t;
+
+typedef enum {
+    LIGHT_RANGE_DARK = 0,
+    LIGHT_RANGE_NORMAL,
+    LIGHT_RANGE_BRIGHT,
+    LIGHT_RANGE_MAX,
+} light_range_t;
+
+/** Sensor setting of a range */
+typedef struct {
+    light_mode_t mode;
+    uint8_t mtreg;
+} light_setting_t;
+
+/** Ranger context
+ *
+ * Please do not set/modify any elements.
+ */
+typedef struct {
+    /** Range of the next measurement */
+    light_range_t range;
+    /** Measurements taken in each range */
+    uint32_t measurements[LIGHT_RANGE_MAX];
+    uint32_t saturated;
+} light_ranging_t;
+
+/** Initialise a ranger, starting in LIGHT_RANGE_NORMAL
+ *
+ * \param[out] lr Ranger context
+ */
+void light_ranging_init(light_ranging_t *lr);
+
+/** Sensor setting for the next measurement
+ *
+ * \param[in] lr Ranger context
+ */
+const light_setting_t *light_ranging_setting(const light_ranging_t *lr);
+
+/** Longest conversion time of a setting, from the datasheet maximum
+ *
+ * \param[in] setting Sensor setting
+ *
+ * \return Time in ms from the measurement command to a valid result
+ */
+uint32_t light_ranging_conversion_ms(const light_setting_t *setting);
+
+/** Take the result of a measurement made with light_ranging_setting()
+ *
+ * Converts it and selects the range of the next measurement.
+ *
+ * \param[in] lr Ranger context
+ * \param[in] count Raw 16 bit result
+ *
+ * \return Illuminance in lx. A saturated count gives the top of the range.
+ */
+float light_ranging_update(light_ranging_t *lr, uint16_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _LIGHT_RANGING_H_ */
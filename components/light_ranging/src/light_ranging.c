@@ -0,0 +1,68 @@
+#include <string.h>
+#include <light_ranging.h>
+
+/* Counts per lx in mode H at the nominal MTreg */
+#define COUNTS_PER_LX       1.2f
+#define MTREG_NOMINAL       69
+#define COUNT_MAX           65535
+/* Datasheet maximum conversion times at the nominal MTreg */
+#define H_CONVERSION_MS     180
+#define L_CONVERSION_MS     24
+
+#define RANGE_UP_FRACTION   0.8f
+#define RANGE_DOWN_FRACTION 0.4f
+
+static const light_setting_t s_settings[LIGHT_RANGE_MAX] = {
+    [LIGHT_RANGE_DARK] = { .mode = LIGHT_MODE_H2, .mtreg = 254 },
+    [LIGHT_RANGE_NORMAL] = { .mode = LIGHT_MODE_H, .mtreg = MTREG_NOMINAL },
+    [LIGHT_RANGE_BRIGHT] = { .mode = LIGHT_MODE_L, .mtreg = 31 },
+};
+
+void light_ranging_init(light_ranging_t *lr)
+{
+    memset(lr, 0, sizeof(light_ranging_t));
+    lr->range = LIGHT_RANGE_NORMAL;
+}
+
+const light_setting_t *light_ranging_setting(const light_ranging_t *lr)
+{
+    return &s_settings[lr->range];
+}
+
+uint32_t light_ranging_conversion_ms(const light_setting_t *setting)
+{
+    uint32_t nominal_ms = setting->mode == LIGHT_MODE_L ? L_CONVERSION_MS : H_CONVERSION_MS;
+    return (nominal_ms * setting->mtreg + MTREG_NOMINAL - 1) / MTREG_NOMINAL;
+}
+
+static float lux_per_count(const light_setting_t *setting)
+{
+    float lx = (float)MTREG_NOMINAL / (COUNTS_PER_LX * setting->mtreg);
+    return setting->mode == LIGHT_MODE_H2 ? lx / 2 : lx;
+}
+
+static float full_scale_lux(light_range_t range)
+{
+    return COUNT_MAX * lux_per_count(&s_settings[range]);
+}
+
+float light_ranging_update(light_ranging_t *lr, uint16_t count)
+{
+    float lux = count * lux_per_count(&s_settings[lr->range]);
+
+    lr->measurements[lr->range]++;
+    if (count == COUNT_MAX) {
+        lr->saturated++;
+        if (lr->range + 1 < LIGHT_RANGE_MAX) {
+            lr->range++;
+        }
+        return lux;
+    }
+    while (lr->range + 1 < LIGHT_RANGE_MAX && lux > RANGE_UP_FRACTION * full_scale_lux(lr->range)) {
+        lr->range++;
+    }
+    while (lr->range > 0 && lux < RANGE_DOWN_FRACTION * full_scale_lux(lr->range - 1)) {
+        lr->range--;
+    }
+    return lux;
+}
@@ -0,0 +1,71 @@
+#include <stdio.h>
+#include "light_ranging.h"
+#include "unity.h"
+
+TEST_CASE("light ranging scales counts by mode and MTreg", "[light_ranging]")
+{
+    light_ranging_t lr;
+
+    light_ranging_init(&lr);
+    TEST_ASSERT_EQUAL(LIGHT_RANGE_NORMAL, lr.range);
+    TEST_ASSERT_EQUAL(LIGHT_MODE_H, light_ranging_setting(&lr)->mode);
+    TEST_ASSERT_EQUAL(69, light_ranging_setting(&lr)->mtreg);
+    TEST_ASSERT_EQUAL(180, light_ranging_conversion_ms(light_ranging_setting(&lr)));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1000.0f, light_ranging_update(&lr, 1200));
+
+    /* Conversion times follow MTreg, rounded up */
+    light_setting_t dark = { .mode = LIGHT_MODE_H2, .mtreg = 254 };
+    light_setting_t bright = { .mode = LIGHT_MODE_L, .mtreg = 31 };
+    TEST_ASSERT_EQUAL(663, light_ranging_conversion_ms(&dark));
+    TEST_ASSERT_EQUAL(11, light_ranging_conversion_ms(&bright));
+
+    /* Dark range: half the step of H and 254/69 the count */
+    lr.range = LIGHT_RANGE_DARK;
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 11.32f, light_ranging_update(&lr, 100));
+    lr.range = LIGHT_RANGE_BRIGHT;
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 92742.0f, light_ranging_update(&lr, 50000));
+}
+
+TEST_CASE("light ranging follows the light between darkness and sunlight", "[light_ranging]")
+{
+    light_ranging_t lr;
+
+    light_ranging_init(&lr);
+    /* 50000 lx is above 80 % of the normal range */
+    light_ranging_update(&lr, 60000);
+    TEST_ASSERT_EQUAL(LIGHT_RANGE_BRIGHT, lr.range);
+    TEST_ASSERT_EQUAL(LIGHT_MODE_L, light_ranging_setting(&lr)->mode);
+    TEST_ASSERT_EQUAL(31, light_ranging_setting(&lr)->mtreg);
+
+    /* Lights off, straight down to the dark range */
+    light_ranging_update(&lr, 1000);
+    TEST_ASSERT_EQUAL(LIGHT_RANGE_DARK, lr.range);
+    light_ranging_update(&lr, 100);
+    TEST_ASSERT_EQUAL(LIGHT_RANGE_DARK, lr.range);
+
+    /* Saturated, the count gives no level so widen by one */
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, 7417.0f, light_ranging_update(&lr, 65535));
+    TEST_ASSERT_EQUAL(LIGHT_RANGE_NORMAL, lr.range);
+    TEST_ASSERT_EQUAL(1, lr.saturated);
+    TEST_ASSERT_EQUAL(2, lr.measurements[LIGHT_RANGE_DARK]);
+    TEST_ASSERT_EQUAL(1, lr.measurements[LIGHT_RANGE_NORMAL]);
+    TEST_ASSERT_EQUAL(1, lr.measurements[LIGHT_RANGE_BRIGHT]);
+}
+
+TEST_CASE("light ranging does not flip between ranges", "[light_ranging]")
+{
+    light_ranging_t lr;
+
+    light_ranging_init(&lr);
+    /* Down below 40 % of the dark range, 2967 lx */
+    light_ranging_update(&lr, 4000);
+    TEST_ASSERT_EQUAL(LIGHT_RANGE_NORMAL, lr.range);
+    light_ranging_update(&lr, 3500);
+    TEST_ASSERT_EQUAL(LIGHT_RANGE_DARK, lr.range);
+
+    /* Back up only above 80 % of it, 5933 lx */
+    light_ranging_update(&lr, 50000);
+    TEST_ASSERT_EQUAL(LIGHT_RANGE_DARK, lr.range);
+    light_ranging_update(&lr, 53000);
+    TEST_ASSERT_EQUAL(LIGHT_RANGE_NORMAL, lr.range);
+}
@@ -0,0 +1,117 @@
+/*
+ * Line assembler for UART byte streams
+ *
+ * Bytes are fed in whatever chunks uart_read_bytes() returns. Every complete
+ * line is handed exactly once to the handler whose prefix it starts with, no
+ * matter how it was split across reads or how many lines a read contained.
+ * Only the unfinished tail of the stream is kept between calls.
+ *
+ * Lines longer than the buffer are dropped as a whole and counted, instead
+ * of being delivered truncated.
+ */
+#ifndef _LINE_ASSEMBLER_H_
+#define _LINE_ASSEMBLER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** Line handler
+ *
+ * \param[in] line The line, without "\r\n" and NULL terminated. Only valid
+ * during the call.
+ * \param[in] len Length of line
+ * \param[in] priv Private data passed to line_assembler_init()
+ */
+typedef void (*line_handler_t)(const char *line, size_t len, void *priv);
+
+/** Dispatch table entry */
+typedef struct {
+    /** Lines starting with this string go to handler */
+    const char *prefix;
+    line_handler_t handler;
+} line_dispatch_t;
+
+/** Counters, all cumulative since line_assembler_init() */
+typedef struct {
+    /** Complete, non empty lines seen */
+    uint32_t lines;
+    /** Lines that matched no prefix */
+    uint32_t unhandled_lines;
+    /** Lines that were too long or discarded by line_assembler_reset() */
+    uint32_t dropped_lines;
+    /** Bytes of the dropped lines, plus bytes reported lost to line_assembler_reset() */
+    uint32_t dropped_bytes;
+} line_assembler_stats_t;
+
+/** Line assembler context
+ *
+ * Please do not set/modify any elements.
+ */
+typedef struct {
+    char *buf;
+    size_t size;
+    size_t len;
+    bool overflow;
+    const line_dispatch_t *table;
+    size_t table_len;
+    void *priv;
+    line_assembler_stats_t stats;
+} line_assembler_t;
+
+/** Initialise a line assembler
+ *
+ * \param[out] la Line assembler context
+ * \param[in] buf Buffer for the unfinished line. Lines of up to size - 1
+ * bytes, excluding "\r\n", can be assembled.
+ * \param[in] size Size of buf, at least 2
+ * \param[in] table Dispatch table. The first matching entry is used, so
+ * longer prefixes should come before shorter ones. Must stay valid while
+ * the assembler is in use.
+ * \param[in] table_len Number of entries in table
+ * \param[in] priv Private data passed to the handlers
+ *
+ * \return 0 on success
+ * \return -1 if an argument is invalid
+ */
+int line_assembler_init(line_assembler_t *la, char *buf, size_t size,
+                        const line_dispatch_t *table, size_t table_len, void *priv);
+
+/** Feed received bytes
+ *
+ * The handlers for all lines completed by data are called before this
+ * returns.
+ *
+ * \param[in] la Line assembler context
+ * \param[in] data Received bytes
+ * \param[in] len Number of bytes
+ */
+void line_assembler_feed(line_assembler_t *la, const char *data, size_t len);
+
+/** Discard the unfinished line
+ *
+ * Use this when the stream has lost data, e.g. after a UART FIFO overflow,
+ * so the next bytes are not joined to a stale partial line.
+ *
+ * \param[in] la Line assembler context
+ * \param[in] lost_bytes Bytes that were lost before reaching the assembler,
+ * added to dropped_bytes
+ */
+void line_assembler_reset(line_assembler_t *la, size_t lost_bytes);
+
+/** Get the counters */
+static inline const line_assembler_stats_t *line_assembler_get_stats(const line_assembler_t *la)
+{
+    return &la->stats;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _LINE_ASSEMBLER_H_ */
@@ -0,0 +1,85 @@
+#include <string.h>
+#include <line_assembler.h>
+
+int line_assembler_init(line_assembler_t *la, char *buf, size_t size,
+                        const line_dispatch_t *table, size_t table_len, void *priv)
+{
+    if (!la || !buf || size < 2 || (!table && table_len)) {
+        return -1;
+    }
+    memset(la, 0, sizeof(line_assembler_t));
+    la->buf = buf;
+    la->size = size;
+    la->table = table;
+    la->table_len = table_len;
+    la->priv = priv;
+    return 0;
+}
+
+static void line_assembler_dispatch(line_assembler_t *la)
+{
+    size_t len = la->len;
+    if (len && la->buf[len - 1] == '\r') {
+        len--;
+    }
+    la->buf[len] = '\0';
+    la->len = 0;
+    if (len == 0) {
+        return;
+    }
+
+    la->stats.lines++;
+    for (size_t i = 0; i < la->table_len; i++) {
+        const line_dispatch_t *entry = &la->table[i];
+        size_t prefix_len = strlen(entry->prefix);
+        if (prefix_len <= len && memcmp(la->buf, entry->prefix, prefix_len) == 0) {
+            entry->handler(la->buf, len, la->priv);
+            return;
+        }
+    }
+    la->stats.unhandled_lines++;
+}
+
+void line_assembler_feed(line_assembler_t *la, const char *data, size_t len)
+{
+    while (len) {
+        const char *nl = memchr(data, '\n', len);
+        size_t chunk = nl ? (size_t)(nl - data) : len;
+
+        if (la->overflow) {
+            la->stats.dropped_bytes += chunk;
+        } else if (chunk > la->size - 1 - la->len) {
+            /* Drop the whole line rather than deliver part of it */
+            la->stats.dropped_bytes += la->len + chunk;
+            la->len = 0;
+            la->overflow = true;
+        } else {
+            memcpy(la->buf + la->len, data, chunk);
+            la->len += chunk;
+        }
+
+        if (!nl) {
+            return;
+        }
+        if (la->overflow) {
+            la->stats.dropped_bytes++;
+            la->stats.dropped_lines++;
+            la->overflow = false;
+        } else {
+            line_assembler_dispatch(la);
+        }
+        data = nl + 1;
+        len -= chunk + 1;
+    }
+}
+
+void line_assembler_reset(line_assembler_t *la, size_t lost_bytes)
+{
+    if (la->len || la->overflow) {
+        la->stats.dropped_lines++;
+        la->stats.dropped_bytes += la->len;
+    }
+    la->stats.dropped_bytes += lost_bytes;
+    la->len = 0;
+    la->overflow = false;
+}
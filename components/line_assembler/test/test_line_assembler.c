@@ -0,0 +1,254 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "line_assembler.h"
+#include "unity.h"
+
+#define LINE_BUF_SIZE       96
+#define MAX_LINES           64
+#define FUZZ_COUNT          2000
+
+/* What the handlers received, in order */
+typedef struct {
+    char lines[MAX_LINES][LINE_BUF_SIZE];
+    int handler[MAX_LINES];
+    int count;
+} received_t;
+
+static void record(received_t *rx, int handler, const char *line, size_t len)
+{
+    TEST_ASSERT_TRUE(rx->count < MAX_LINES);
+    TEST_ASSERT_EQUAL(strlen(line), len);
+    TEST_ASSERT_TRUE(len < LINE_BUF_SIZE);
+    memcpy(rx->lines[rx->count], line, len + 1);
+    rx->handler[rx->count] = handler;
+    rx->count++;
+}
+
+static void on_cgpsinfo(const char *line, size_t len, void *priv)
+{
+    record(priv, 0, line, len);
+}
+
+static void on_clbs(const char *line, size_t len, void *priv)
+{
+    record(priv, 1, line, len);
+}
+
+static void on_nmea(const char *line, size_t len, void *priv)
+{
+    record(priv, 2, line, len);
+}
+
+static const line_dispatch_t table[] = {
+    { "+CGPSINFO:", on_cgpsinfo },
+    { "+CLBS:", on_clbs },
+    { "$", on_nmea },
+};
+
+#define TABLE_LEN   (sizeof(table) / sizeof(table[0]))
+
+/* A burst as the module sends it: echo, responses and NMEA interleaved */
+static const char stream[] =
+    "AT+CLBS=4,,,,2\r\r\n"
+    "OK\r\n"
+    "\r\n"
+    "+CGPSINFO: 3113.343286,N,12121.234064,E,250311,072809.3,44.1,0.0,0\r\n"
+    "$GNRMC,072809.30,A,3113.343286,N,12121.234064,E,0.0,0.0,250311,,,A*6E\r\n"
+    "+CLBS: 0,31.230416,121.473701,550,2025/01/01,08:00:00\n"
+    "+CGPSINFO: ,,,,,,,,\r\n";
+
+static const struct {
+    int handler;
+    const char *line;
+} expected[] = {
+    { 0, "+CGPSINFO: 3113.343286,N,12121.234064,E,250311,072809.3,44.1,0.0,0" },
+    { 2, "$GNRMC,072809.30,A,3113.343286,N,12121.234064,E,0.0,0.0,250311,,,A*6E" },
+    { 1, "+CLBS: 0,31.230416,121.473701,550,2025/01/01,08:00:00" },
+    { 0, "+CGPSINFO: ,,,,,,,," },
+};
+
+#define EXPECTED_LEN    (sizeof(expected) / sizeof(expected[0]))
+
+static void check_expected(const line_assembler_t *la, const received_t *rx)
+{
+    const line_assembler_stats_t *stats = line_assembler_get_stats(la);
+    TEST_ASSERT_EQUAL(EXPECTED_LEN, rx->count);
+    for (int i = 0; i < (int)EXPECTED_LEN; i++) {
+        TEST_ASSERT_EQUAL(expected[i].handler, rx->handler[i]);
+        TEST_ASSERT_EQUAL_STRING(expected[i].line, rx->lines[i]);
+    }
+    /* The echo and "OK" match no prefix, the blank line is not counted */
+    TEST_ASSERT_EQUAL(EXPECTED_LEN + 2, stats->lines);
+    TEST_ASSERT_EQUAL(2, stats->unhandled_lines);
+    TEST_ASSERT_EQUAL(0, stats->dropped_lines);
+    TEST_ASSERT_EQUAL(0, stats->dropped_bytes);
+}
+
+TEST_CASE("line assembler delivers each line once for any two way split", "[line_assembler]")
+{
+    static char buf[LINE_BUF_SIZE];
+    static received_t rx;
+    line_assembler_t la;
+    size_t len = strlen(stream);
+
+    for (size_t cut = 0; cut <= len; cut++) {
+        memset(&rx, 0, sizeof(rx));
+        TEST_ASSERT_EQUAL(0, line_assembler_init(&la, buf, sizeof(buf), table, TABLE_LEN, &rx));
+        line_assembler_feed(&la, stream, cut);
+        line_assembler_feed(&la, stream + cut, len - cut);
+        check_expected(&la, &rx);
+    }
+}
+
+TEST_CASE("line assembler delivers each line once when fed byte by byte", "[line_assembler]")
+{
+    static char buf[LINE_BUF_SIZE];
+    static received_t rx;
+    line_assembler_t la;
+
+    memset(&rx, 0, sizeof(rx));
+    line_assembler_init(&la, buf, sizeof(buf), table, TABLE_LEN, &rx);
+    for (size_t i = 0; i < strlen(stream); i++) {
+        line_assembler_feed(&la, &stream[i], 1);
+    }
+    check_expected(&la, &rx);
+}
+
+TEST_CASE("line assembler drops overlong lines whole and counts them", "[line_assembler]")
+{
+    static char buf[16];
+    static received_t rx;
+    line_assembler_t la;
+    const line_assembler_stats_t *stats;
+
+    memset(&rx, 0, sizeof(rx));
+    line_assembler_init(&la, buf, sizeof(buf), table, TABLE_LEN, &rx);
+
+    /* 15 bytes fit, 16 do not */
+    line_assembler_feed(&la, "$23456789012345\n", 16);
+    line_assembler_feed(&la, "$234567890123456\n", 17);
+    line_assembler_feed(&la, "$2345678", 8);
+    line_assembler_feed(&la, "901234567\r\n$ok\n", 15);
+    stats = line_assembler_get_stats(&la);
+    TEST_ASSERT_EQUAL(2, rx.count);
+    TEST_ASSERT_EQUAL_STRING("$23456789012345", rx.lines[0]);
+    TEST_ASSERT_EQUAL_STRING("$ok", rx.lines[1]);
+    TEST_ASSERT_EQUAL(2, stats->dropped_lines);
+    TEST_ASSERT_EQUAL(17 + 19, stats->dropped_bytes);
+    TEST_ASSERT_EQUAL(2, stats->lines);
+}
+
+TEST_CASE("line assembler reset discards the partial line", "[line_assembler]")
+{
+    static char buf[LINE_BUF_SIZE];
+    static received_t rx;
+    line_assembler_t la;
+    const line_assembler_stats_t *stats;
+
+    memset(&rx, 0, sizeof(rx));
+    line_assembler_init(&la, buf, sizeof(buf), table, TABLE_LEN, &rx);
+    line_assembler_feed(&la, "+CGPSINFO: 3113.3", 17);
+    line_assembler_reset(&la, 100);
+    line_assembler_feed(&la, "43286,N\r\n+CLBS: 2\r\n", 19);
+    stats = line_assembler_get_stats(&la);
+    TEST_ASSERT_EQUAL(1, rx.count);
+    TEST_ASSERT_EQUAL_STRING("+CLBS: 2", rx.lines[0]);
+    TEST_ASSERT_EQUAL(1, stats->dropped_lines);
+    TEST_ASSERT_EQUAL(117, stats->dropped_bytes);
+    TEST_ASSERT_EQUAL(1, stats->unhandled_lines);
+
+    /* Nothing pending, only the lost bytes count */
+    line_assembler_reset(&la, 5);
+    TEST_ASSERT_EQUAL(1, stats->dropped_lines);
+    TEST_ASSERT_EQUAL(122, stats->dropped_bytes);
+}
+
+TEST_CASE("line assembler matches the first prefix in table order", "[line_assembler]")
+{
+    static char buf[LINE_BUF_SIZE];
+    static received_t rx;
+    static const line_dispatch_t ordered[] = {
+        { "+CLBS: 0", on_cgpsinfo },
+        { "+CLBS:", on_clbs },
+    };
+    line_assembler_t la;
+
+    memset(&rx, 0, sizeof(rx));
+    line_assembler_init(&la, buf, sizeof(buf), ordered, 2, &rx);
+    line_assembler_feed(&la, "+CLBS: 0,1,2\r\n+CLBS: 2\r\n+CLBS\r\n", 31);
+    TEST_ASSERT_EQUAL(2, rx.count);
+    TEST_ASSERT_EQUAL(0, rx.handler[0]);
+    TEST_ASSERT_EQUAL(1, rx.handler[1]);
+    TEST_ASSERT_EQUAL(1, line_assembler_get_stats(&la)->unhandled_lines);
+
+    TEST_ASSERT_EQUAL(-1, line_assembler_init(&la, buf, 1, table, TABLE_LEN, NULL));
+    TEST_ASSERT_EQUAL(-1, line_assembler_init(&la, NULL, sizeof(buf), table, TABLE_LEN, NULL));
+}
+
+TEST_CASE("line assembler fuzz with random lines and chunk sizes", "[line_assembler]")
+{
+    static char buf[LINE_BUF_SIZE];
+    static received_t rx;
+    static char input[MAX_LINES * (LINE_BUF_SIZE + 8)];
+    static char want[MAX_LINES][LINE_BUF_SIZE];
+    line_assembler_t la;
+
+    srand(37);
+    for (int iter = 0; iter < FUZZ_COUNT; iter++) {
+        int lines = rand() % MAX_LINES;
+        int want_count = 0;
+        uint32_t dropped_lines = 0;
+        uint32_t dropped_bytes = 0;
+        size_t len = 0;
+
+        for (int i = 0; i < lines; i++) {
+            /* Some lines are longer than the buffer */
+            size_t body = rand() % (LINE_BUF_SIZE + 16);
+            bool cr = rand() % 2;
+            char *line = &input[len];
+
+            line[0] = '$';
+            for (size_t j = 1; j < body; j++) {
+                line[j] = ' ' + rand() % 95;
+            }
+            if (body == 0) {
+                body = 1;
+            }
+            len += body;
+            if (cr) {
+                input[len++] = '\r';
+            }
+            input[len++] = '\n';
+
+            if (body + cr > LINE_BUF_SIZE - 1) {
+                dropped_lines++;
+                dropped_bytes += body + cr + 1;
+            } else {
+                memcpy(want[want_count], line, body);
+                want[want_count][body] = '\0';
+                want_count++;
+            }
+        }
+
+        memset(&rx, 0, sizeof(rx));
+        line_assembler_init(&la, buf, sizeof(buf), table, TABLE_LEN, &rx);
+        for (size_t pos = 0; pos < len;) {
+            size_t chunk = 1 + rand() % 200;
+            if (chunk > len - pos) {
+                chunk = len - pos;
+            }
+            line_assembler_feed(&la, &input[pos], chunk);
+            pos += chunk;
+        }
+
+        const line_assembler_stats_t *stats = line_assembler_get_stats(&la);
+        TEST_ASSERT_EQUAL(want_count, rx.count);
+        for (int i = 0; i < want_count; i++) {
+            TEST_ASSERT_EQUAL_STRING(want[i], rx.lines[i]);
+        }
+        TEST_ASSERT_EQUAL(want_count, stats->lines);
+        TEST_ASSERT_EQUAL(dropped_lines, stats->dropped_lines);
+        TEST_ASSERT_EQUAL(dropped_bytes, stats->dropped_bytes);
+    }
+}
@@ -0,0 +1,147 @@
+/*
+ * Motion state detector
+ *
+ * Classifies an asset as moving, stationary or parked from its fused
+ * position fixes, and gives the fix interval that suits each state.
+ *
+ * Moving is left once the fixes of the last stop_time_ms have stayed below
+ * start_speed, averaged less than stop_speed and scattered by no more than
+ * still_radius (DRMS about their mean), which tells a stop apart from a
+ * crawl in traffic. The estimated speed of a standing asset is noise that
+ * now and then exceeds stop_speed, hence the mean. After park_time_ms
+ * stationary the asset is parked. Either way it is moving again as soon as
+ * the speed reaches start_speed or a fix lands further from the stop than
+ * still_radius plus the fix accuracy.
+ *
+ * The caller passes a monotonic time in ms with every fix. Feed GNSS fixes
+ * only, the scatter of cell fixes is far larger than any still_radius.
+ */
+#ifndef _MOTION_DETECTOR_H_
+#define _MOTION_DETECTOR_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef enum {
+    MOTION_MOVING = 0,
+    MOTION_STATIONARY,
+    MOTION_PARKED,
+    MOTION_STATE_MAX,
+} motion_state_t;
+
+/** Detector tuning */
+typedef struct {
+    /** Speed, in m/s, at or above which the asset is moving */
+    float start_speed;
+    /** Mean speed, in m/s, below which a moving asset may be stopping */
+    float stop_speed;
+    /** Largest scatter of the fixes of a stopped asset, in metres */
+    float still_radius;
+    /** Time, in ms, the asset must look stopped before it is stationary */
+    uint32_t stop_time_ms;
+    /** Time, in ms, stationary before the asset is parked */
+    uint32_t park_time_ms;
+    /** Fix interval for each state, in s */
+    uint16_t interval_s[MOTION_STATE_MAX];
+} motion_detector_config_t;
+
+#define MOTION_DETECTOR_CONFIG_DEFAULT()    \
+    {                                       \
+        .start_speed = 2.5f,                \
+        .stop_speed = 1.0f,                 \
+        .still_radius = 25.0f,              \
+        .stop_time_ms = 60 * 1000,          \
+        .park_time_ms = 10 * 60 * 1000,     \
+        .interval_s = { 5, 30, 120 },       \
+    }
+
+/** A fused position fix */
+typedef struct {
+    /** Monotonic time of the fix, in ms */
+    int64_t time_ms;
+    /** Degrees x 1e7, north and east positive */
+    int32_t lat_e7;
+    int32_t lon_e7;
+    /** Ground speed, in m/s */
+    float speed;
+    /** Horizontal accuracy, in metres */
+    float accuracy;
+} motion_fix_t;
+
+/** Detector context
+ *
+ * Please do not set/modify any elements.
+ */
+typedef struct {
+    motion_detector_config_t config;
+    motion_state_t state;
+    /** Monotonic time the current state was entered */
+    int64_t state_since_ms;
+    /** Fixes below start_speed since still_since_ms, in metres from the
+     * first of them. Running mean and sum of squared deviations, and the
+     * sum of their speeds. */
+    uint32_t still_count;
+    int64_t still_since_ms;
+    int32_t anchor_lat_e7;
+    int32_t anchor_lon_e7;
+    double m_per_lon_e7;
+    double mean_east;
+    double mean_north;
+    double m2;
+    float speed_sum;
+    /** State changes since motion_detector_init() */
+    uint32_t transitions;
+} motion_detector_t;
+
+/** Initialise a detector, the asset starts out moving
+ *
+ * \param[out] md Detector context
+ * \param[in] config Tuning, NULL for MOTION_DETECTOR_CONFIG_DEFAULT()
+ */
+void motion_detector_init(motion_detector_t *md, const motion_detector_config_t *config);
+
+/** Feed a fix
+ *
+ * \param[in] md Detector context
+ * \param[in] fix The fix, fixes with a negative or NaN speed or accuracy
+ * are ignored
+ *
+ * \return true if the state changed
+ */
+bool motion_detector_update(motion_detector_t *md, const motion_fix_t *fix);
+
+/** Scatter of the fixes since the asset last slowed down, DRMS in metres,
+ * 0 while fewer than two of them
+ *
+ * \param[in] md Detector context
+ */
+float motion_detector_spread(const motion_detector_t *md);
+
+/** Current state
+ *
+ * \param[in] md Detector context
+ */
+static inline motion_state_t motion_detector_state(const motion_detector_t *md)
+{
+    return md->state;
+}
+
+/** Fix interval for the current state, in s
+ *
+ * \param[in] md Detector context
+ */
+static inline uint16_t motion_detector_interval_s(const motion_detector_t *md)
+{
+    return md->config.interval_s[md->state];
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _MOTION_DETECTOR_H_ */
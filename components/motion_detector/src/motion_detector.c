@@ -0,0 +1,118 @@
+#include <string.h>
+#include <math.h>
+#include <motion_detector.h>
+
+/* Mean earth radius, the fixes of a stop are metres apart */
+#define EARTH_RADIUS_M          6371008.8
+#define DEG_TO_RAD              (M_PI / 180.0)
+#define M_PER_LAT_E7            (EARTH_RADIUS_M * DEG_TO_RAD / 1e7)
+#define LON_MAX_E7              1800000000LL
+
+void motion_detector_init(motion_detector_t *md, const motion_detector_config_t *config)
+{
+    static const motion_detector_config_t default_config = MOTION_DETECTOR_CONFIG_DEFAULT();
+
+    memset(md, 0, sizeof(motion_detector_t));
+    md->config = config ? *config : default_config;
+    md->state = MOTION_MOVING;
+}
+
+static void still_offset(const motion_detector_t *md, const motion_fix_t *fix, double *east, double *north)
+{
+    int64_t dlon = (int64_t)fix->lon_e7 - md->anchor_lon_e7;
+    /* Take the short way round at the antimeridian */
+    if (dlon > LON_MAX_E7) {
+        dlon -= 2 * LON_MAX_E7;
+    } else if (dlon < -LON_MAX_E7) {
+        dlon += 2 * LON_MAX_E7;
+    }
+    *east = dlon * md->m_per_lon_e7;
+    *north = ((int64_t)fix->lat_e7 - md->anchor_lat_e7) * M_PER_LAT_E7;
+}
+
+static void still_add(motion_detector_t *md, const motion_fix_t *fix)
+{
+    if (md->still_count == 0) {
+        md->still_since_ms = fix->time_ms;
+        md->anchor_lat_e7 = fix->lat_e7;
+        md->anchor_lon_e7 = fix->lon_e7;
+        md->m_per_lon_e7 = M_PER_LAT_E7 * cos(fix->lat_e7 / 1e7 * DEG_TO_RAD);
+        md->mean_east = 0;
+        md->mean_north = 0;
+        md->m2 = 0;
+        md->speed_sum = 0;
+    }
+
+    double east, north;
+    still_offset(md, fix, &east, &north);
+    md->still_count++;
+    md->speed_sum += fix->speed;
+    double d_east = east - md->mean_east;
+    double d_north = north - md->mean_north;
+    md->mean_east += d_east / md->still_count;
+    md->mean_north += d_north / md->still_count;
+    md->m2 += d_east * (east - md->mean_east) + d_north * (north - md->mean_north);
+}
+
+static void set_state(motion_detector_t *md, motion_state_t state, int64_t time_ms)
+{
+    md->state = state;
+    md->state_since_ms = time_ms;
+    md->transitions++;
+    if (state == MOTION_MOVING) {
+        md->still_count = 0;
+    }
+}
+
+float motion_detector_spread(const motion_detector_t *md)
+{
+    if (md->still_count < 2) {
+        return 0;
+    }
+    return (float)sqrt(md->m2 / md->still_count);
+}
+
+bool motion_detector_update(motion_detector_t *md, const motion_fix_t *fix)
+{
+    /* Also rejects NaN */
+    if (!(fix->speed >= 0) || !(fix->accuracy >= 0)) {
+        return false;
+    }
+
+    if (md->state == MOTION_MOVING) {
+        if (fix->speed >= md->config.start_speed) {
+            md->still_count = 0;
+            return false;
+        }
+        still_add(md, fix);
+        if (motion_detector_spread(md) > md->config.still_radius) {
+            /* Creeping along, only count the fixes from here */
+            md->still_count = 0;
+            still_add(md, fix);
+        }
+        /* The speed of a standing asset is noise, judge it by the mean */
+        if (fix->time_ms - md->still_since_ms >= md->config.stop_time_ms &&
+            md->speed_sum < md->config.stop_speed * md->still_count) {
+            set_state(md, MOTION_STATIONARY, fix->time_ms);
+            return true;
+        }
+        return false;
+    }
+
+    double east, north;
+    still_offset(md, fix, &east, &north);
+    double d_east = east - md->mean_east;
+    double d_north = north - md->mean_north;
+    double reach = md->config.still_radius + fix->accuracy;
+    if (fix->speed >= md->config.start_speed || d_east * d_east + d_north * d_north > reach * reach) {
+        set_state(md, MOTION_MOVING, fix->time_ms);
+        return true;
+    }
+    /* Stationary fixes sharpen the position of the stop */
+    still_add(md, fix);
+    if (md->state == MOTION_STATIONARY && fix->time_ms - md->state_since_ms >= md->config.park_time_ms) {
+        set_state(md, MOTION_PARKED, fix->time_ms);
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,142 @@
+#include <stdio.h>
+#include <math.h>
+#include "motion_detector.h"
+#include "unity.h"
+
+#define LAT0    31.2304
+#define LON0    121.4737
+/* Metres per degree of latitude */
+#define M_PER_DEG   (6371008.8 * M_PI / 180)
+
+static bool feed(motion_detector_t *md, int64_t time_ms, double east, double north, float speed)
+{
+    motion_fix_t fix = {
+        .time_ms = time_ms,
+        .lat_e7 = (int32_t)lround((LAT0 + north / M_PER_DEG) * 1e7),
+        .lon_e7 = (int32_t)lround((LON0 + east / (M_PER_DEG * cos(LAT0 * M_PI / 180))) * 1e7),
+        .speed = speed,
+        .accuracy = 5,
+    };
+    return motion_detector_update(md, &fix);
+}
+
+TEST_CASE("motion detector follows a drive, stop, park and restart", "[motion_detector]")
+{
+    motion_detector_t md;
+    int64_t t = 0;
+    double east = 0;
+
+    motion_detector_init(&md, NULL);
+    TEST_ASSERT_EQUAL(MOTION_MOVING, motion_detector_state(&md));
+    TEST_ASSERT_EQUAL(5, motion_detector_interval_s(&md));
+
+    /* Two minutes at 15 m/s */
+    for (int i = 0; i < 24; i++, t += 5000) {
+        east += 75;
+        TEST_ASSERT_FALSE(feed(&md, t, east, 0, 15));
+    }
+
+    /* Standing, fixes scattered by a few metres. Stationary after a minute. */
+    int64_t stop_ms = t;
+    while (!feed(&md, t, east + 4 * sin(t / 7000.0), 3 * cos(t / 11000.0), 0.3f)) {
+        TEST_ASSERT_EQUAL(MOTION_MOVING, motion_detector_state(&md));
+        t += 5000;
+    }
+    TEST_ASSERT_EQUAL(stop_ms + 60000, t);
+    TEST_ASSERT_EQUAL(MOTION_STATIONARY, motion_detector_state(&md));
+    TEST_ASSERT_EQUAL(30, motion_detector_interval_s(&md));
+    TEST_ASSERT_TRUE(motion_detector_spread(&md) > 1);
+    TEST_ASSERT_TRUE(motion_detector_spread(&md) < 6);
+
+    /* Parked ten minutes later */
+    int64_t stationary_ms = t;
+    t += 30000;
+    while (!feed(&md, t, east + 4 * sin(t / 7000.0), 3 * cos(t / 11000.0), 0.1f)) {
+        TEST_ASSERT_EQUAL(MOTION_STATIONARY, motion_detector_state(&md));
+        t += 30000;
+    }
+    TEST_ASSERT_EQUAL(stationary_ms + 600000, t);
+    TEST_ASSERT_EQUAL(MOTION_PARKED, motion_detector_state(&md));
+    TEST_ASSERT_EQUAL(120, motion_detector_interval_s(&md));
+
+    /* A fix well outside the stop is a start, even with little speed yet */
+    t += 120000;
+    TEST_ASSERT_FALSE(feed(&md, t, east + 20, 0, 0.5f));
+    t += 120000;
+    TEST_ASSERT_TRUE(feed(&md, t, east + 60, 0, 0.5f));
+    TEST_ASSERT_EQUAL(MOTION_MOVING, motion_detector_state(&md));
+    TEST_ASSERT_EQUAL(0, motion_detector_spread(&md));
+    TEST_ASSERT_EQUAL(3, md.transitions);
+}
+
+TEST_CASE("motion detector does not flap on slow movement", "[motion_detector]")
+{
+    motion_detector_config_t config = MOTION_DETECTOR_CONFIG_DEFAULT();
+    motion_detector_t md;
+    int64_t t = 0;
+
+    config.still_radius = 10;
+    motion_detector_init(&md, &config);
+
+    /* Between stop_speed and start_speed the asset keeps moving */
+    for (int i = 0; i < 60; i++, t += 5000) {
+        TEST_ASSERT_FALSE(feed(&md, t, i * 8.0, 0, 1.6f));
+    }
+    /* Creeping below stop_speed, but too far to be standing */
+    for (int i = 0; i < 60; i++, t += 5000) {
+        TEST_ASSERT_FALSE(feed(&md, t, 480 + i * 4.5, 0, 0.9f));
+    }
+    TEST_ASSERT_EQUAL(MOTION_MOVING, motion_detector_state(&md));
+
+    /* Stopped, then a speed spike below start_speed changes nothing */
+    while (!feed(&md, t, 800, 0, 0)) {
+        t += 5000;
+    }
+    TEST_ASSERT_EQUAL(MOTION_STATIONARY, motion_detector_state(&md));
+    t += 5000;
+    TEST_ASSERT_FALSE(feed(&md, t, 802, 1, 2.0f));
+    t += 5000;
+    TEST_ASSERT_TRUE(feed(&md, t, 803, 1, 2.5f));
+    TEST_ASSERT_EQUAL(MOTION_MOVING, motion_detector_state(&md));
+}
+
+TEST_CASE("motion detector stops through speed noise", "[motion_detector]")
+{
+    motion_detector_t md;
+    int64_t t = 0;
+
+    motion_detector_init(&md, NULL);
+    /* Standing, the estimated speed now and then above stop_speed */
+    while (!feed(&md, t, (t / 1000) % 3, 0, (t / 1000) % 4 == 0 ? 1.4f : 0.3f)) {
+        TEST_ASSERT_TRUE(t < 60000);
+        t += 1000;
+    }
+    TEST_ASSERT_EQUAL(60000, t);
+    TEST_ASSERT_EQUAL(MOTION_STATIONARY, motion_detector_state(&md));
+}
+
+TEST_CASE("motion detector ignores invalid fixes and honours its configuration", "[motion_detector]")
+{
+    motion_detector_config_t config = {
+        .start_speed = 3,
+        .stop_speed = 1,
+        .still_radius = 20,
+        .stop_time_ms = 0,
+        .park_time_ms = 0,
+        .interval_s = { 1, 10, 255 },
+    };
+    motion_detector_t md;
+
+    motion_detector_init(&md, &config);
+    TEST_ASSERT_FALSE(feed(&md, 0, 0, 0, NAN));
+    TEST_ASSERT_FALSE(feed(&md, 0, 0, 0, -1));
+    TEST_ASSERT_EQUAL(0, md.still_count);
+
+    /* No stop or park time, the first slow fixes take it straight through */
+    TEST_ASSERT_TRUE(feed(&md, 1000, 0, 0, 0));
+    TEST_ASSERT_EQUAL(10, motion_detector_interval_s(&md));
+    TEST_ASSERT_TRUE(feed(&md, 2000, 0, 0, 0));
+    TEST_ASSERT_EQUAL(MOTION_PARKED, motion_detector_state(&md));
+    TEST_ASSERT_EQUAL(255, motion_detector_interval_s(&md));
+    TEST_ASSERT_FALSE(feed(&md, 3000, 0, 0, 0));
+}
@@ -0,0 +1,189 @@
+/*
+ * Streaming NMEA 0183 parser
+ *
+ * Bytes are fed in whatever chunks the UART returns and parsed one at a
+ * time, so no line is buffered and a sentence may be split across any
+ * number of calls. Fields are converted as they end, with integer
+ * arithmetic only, and written to a pending copy of the fix that is
+ * committed once the checksum has been verified. A sentence with a bad
+ * checksum therefore never changes the fix.
+ *
+ * GGA, RMC, GSA, GSV and VTG are understood, from any talker. Other
+ * sentences are checked and counted but otherwise ignored.
+ */
+#ifndef _NMEA_PARSER_H_
+#define _NMEA_PARSER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** Longest accepted sentence. NMEA 0183 allows 82 bytes, with some margin. */
+#define NMEA_MAX_SENTENCE_LEN   120
+
+/** Longest sentence identifier (talker + type), e.g. "GNGGA" */
+#define NMEA_MAX_ID_LEN         6
+
+/** Constellations with separate satellites in view counts: GP/GL/GA/GB(BD)/GQ/other */
+#define NMEA_CONSTELLATION_MAX  6
+
+/** Sentence types that are parsed */
+typedef enum {
+    NMEA_SENTENCE_UNKNOWN = 0,
+    /** Time, position, fix quality, satellites used, HDOP, altitude */
+    NMEA_SENTENCE_GGA,
+    /** Time, date, position, speed, course */
+    NMEA_SENTENCE_RMC,
+    /** Fix mode and DOP */
+    NMEA_SENTENCE_GSA,
+    /** Satellites in view */
+    NMEA_SENTENCE_GSV,
+    /** Speed and course over ground */
+    NMEA_SENTENCE_VTG,
+} nmea_sentence_t;
+
+/** Latest fix, merged from all sentences */
+typedef struct {
+    /** UTC time */
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t second;
+    uint16_t millisecond;
+    /** UTC date, from RMC */
+    uint8_t day;
+    uint8_t month;
+    uint16_t year;
+    /** Latitude in 1e-7 degrees, north positive */
+    int32_t lat_e7;
+    /** Longitude in 1e-7 degrees, east positive */
+    int32_t lon_e7;
+    /** Altitude in metres, from GGA */
+    float altitude;
+    /** Speed over ground in knots, from RMC/VTG */
+    float speed;
+    /** Course over ground in degrees true, from RMC/VTG */
+    float course;
+    /** Horizontal dilution of precision, from GGA/GSA */
+    float hdop;
+    /** Position dilution of precision, from GSA */
+    float pdop;
+    /** Vertical dilution of precision, from GSA */
+    float vdop;
+    /** GGA fix quality: 0 invalid, 1 single, 2 differential, 4/5 RTK, 6 dead reckoning */
+    uint8_t fix_quality;
+    /** GSA fix type: 1 no fix, 2 2D, 3 3D */
+    uint8_t fix_type;
+    /** Satellites used in the fix, from GGA */
+    uint8_t sats_used;
+    /** Satellites in view summed over all constellations, from GSV */
+    uint8_t sats_in_view;
+    /** RMC status is 'A' */
+    bool valid;
+} nmea_fix_t;
+
+/** Sentence callback, called only for sentences with a correct checksum
+ *
+ * \param[in] type Sentence type
+ * \param[in] fix The updated fix. Only valid during the call.
+ * \param[in] priv Private data passed to nmea_parser_init()
+ */
+typedef void (*nmea_sentence_cb_t)(nmea_sentence_t type, const nmea_fix_t *fix, void *priv);
+
+/** Parser context
+ *
+ * Please do not set/modify any elements other than reading the counters.
+ */
+typedef struct {
+    nmea_sentence_cb_t cb;
+    void *priv;
+
+    uint8_t state;
+    /** XOR of all bytes between '$' and '*' */
+    uint8_t checksum;
+    /** Checksum carried by the sentence */
+    uint8_t expected;
+    /** Bytes received for the current sentence */
+    uint8_t length;
+    /** Current field, 0 is the sentence identifier */
+    uint8_t field;
+    nmea_sentence_t type;
+    /** Constellation of the current sentence's talker */
+    uint8_t constellation;
+    char id[NMEA_MAX_ID_LEN];
+    uint8_t id_len;
+
+    /* Current field, written to pending by sentence type when it ends */
+    int64_t mantissa;
+    uint8_t decimals;
+    uint8_t digits;
+    /** Bytes in the field, 0 for an empty field */
+    uint8_t chars;
+    bool negative;
+    bool frac;
+    /** Field contains only digits, a decimal point and a minus sign */
+    bool numeric;
+    /** First byte of the field, for flags such as N/S/E/W/A/V */
+    char letter;
+
+    /** Fix as written by the current sentence, committed once the checksum matches */
+    nmea_fix_t pending;
+    uint8_t pending_in_view[NMEA_CONSTELLATION_MAX];
+    nmea_fix_t fix;
+    uint8_t in_view[NMEA_CONSTELLATION_MAX];
+
+    /** Sentences with a correct checksum */
+    uint32_t sentences;
+    /** Sentences with a wrong checksum */
+    uint32_t checksum_errors;
+    /** Sentences dropped as malformed or too long */
+    uint32_t format_errors;
+} nmea_parser_t;
+
+/** Initialize a parser
+ *
+ * \param[out] parser Parser context
+ * \param[in] cb Sentence callback, may be NULL
+ * \param[in] priv Private data passed to cb
+ */
+void nmea_parser_init(nmea_parser_t *parser, nmea_sentence_cb_t cb, void *priv);
+
+/** Feed received data, in chunks of any length
+ *
+ * Sentences may span several calls. Anything before a '$' that is not NMEA
+ * (e.g. AT responses) is ignored, and a '$' inside a sentence drops that
+ * sentence and starts a new one.
+ *
+ * \param[in] parser Parser context
+ * \param[in] data Data
+ * \param[in] len Length of data
+ */
+void nmea_parser_feed(nmea_parser_t *parser, const char *data, size_t len);
+
+/** Convert a ddmm.mmmm coordinate to 1e-7 degrees, with integer arithmetic only
+ *
+ * \param[in] ddmm The coordinate times 10^decimals, e.g. 3113.343286 is
+ * passed as 3113343286 and 6
+ * \param[in] decimals Number of decimals, at most 18
+ *
+ * \return The coordinate in 1e-7 degrees, rounded to nearest
+ */
+int32_t nmea_ddmm_to_e7(int64_t ddmm, uint8_t decimals);
+
+/** Get the latest fix
+ *
+ * \param[in] parser Parser context
+ *
+ * \return The fix, owned by the parser
+ */
+const nmea_fix_t *nmea_parser_get_fix(const nmea_parser_t *parser);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _NMEA_PARSER_H_ */
@@ -0,0 +1,423 @@
+#include <string.h>
+#include <nmea_parser.h>
+
+/* Parser states */
+enum {
+    NMEA_STATE_IDLE = 0,        /* waiting for '$' */
+    NMEA_STATE_BODY,            /* between '$' and '*' */
+    NMEA_STATE_CHECKSUM_HI,     /* checksum, high nibble */
+    NMEA_STATE_CHECKSUM_LO,     /* checksum, low nibble */
+};
+
+/* Significant digits accumulated per field. Further digits are dropped so
+ * that the mantissa cannot overflow an int64.
+ */
+#define NMEA_MAX_DIGITS     18
+
+static const int64_t s_pow10[NMEA_MAX_DIGITS + 1] = {
+    1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL, 10000000LL,
+    100000000LL, 1000000000LL, 10000000000LL, 100000000000LL,
+    1000000000000LL, 10000000000000LL, 100000000000000LL,
+    1000000000000000LL, 10000000000000000LL, 100000000000000000LL,
+    1000000000000000000LL,
+};
+
+static int nmea_hex_value(char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    } else if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    } else if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+static void nmea_field_reset(nmea_parser_t *p)
+{
+    p->mantissa = 0;
+    p->decimals = 0;
+    p->digits = 0;
+    p->chars = 0;
+    p->negative = false;
+    p->frac = false;
+    p->numeric = true;
+    p->letter = '\0';
+}
+
+static void nmea_field_char(nmea_parser_t *p, char c)
+{
+    if (p->chars < UINT8_MAX) {
+        p->chars++;
+    }
+    if (p->field == 0) {
+        if (p->id_len < NMEA_MAX_ID_LEN) {
+            p->id[p->id_len++] = c;
+        }
+        return;
+    }
+    if (p->chars == 1) {
+        p->letter = c;
+    }
+    if (c >= '0' && c <= '9') {
+        if (p->digits < NMEA_MAX_DIGITS) {
+            p->mantissa = p->mantissa * 10 + (c - '0');
+            p->digits++;
+            if (p->frac) {
+                p->decimals++;
+            }
+        } else if (!p->frac) {
+            /* integer part out of range */
+            p->numeric = false;
+        }
+    } else if (c == '.' && !p->frac) {
+        p->frac = true;
+    } else if (c == '-' && p->chars == 1) {
+        p->negative = true;
+    } else {
+        p->numeric = false;
+    }
+}
+
+static bool nmea_field_has_number(const nmea_parser_t *p)
+{
+    return p->numeric && p->digits > 0;
+}
+
+static double nmea_field_double(const nmea_parser_t *p)
+{
+    double val = (double)p->mantissa / (double)s_pow10[p->decimals];
+    return p->negative ? -val : val;
+}
+
+static int32_t nmea_field_int(const nmea_parser_t *p)
+{
+    int64_t val = p->mantissa / s_pow10[p->decimals];
+    return (int32_t)(p->negative ? -val : val);
+}
+
+/* Fractional part as milliseconds */
+static uint16_t nmea_field_millis(const nmea_parser_t *p)
+{
+    int64_t frac = p->mantissa % s_pow10[p->decimals];
+    if (p->decimals <= 3) {
+        return (uint16_t)(frac * s_pow10[3 - p->decimals]);
+    }
+    return (uint16_t)(frac / s_pow10[p->decimals - 3]);
+}
+
+static void nmea_set_time(nmea_parser_t *p)
+{
+    if (!nmea_field_has_number(p)) {
+        return;
+    }
+    int32_t hhmmss = nmea_field_int(p);
+    p->pending.hour = hhmmss / 10000;
+    p->pending.minute = hhmmss / 100 % 100;
+    p->pending.second = hhmmss % 100;
+    p->pending.millisecond = nmea_field_millis(p);
+}
+
+static void nmea_set_date(nmea_parser_t *p)
+{
+    if (!nmea_field_has_number(p)) {
+        return;
+    }
+    int32_t ddmmyy = nmea_field_int(p);
+    p->pending.day = ddmmyy / 10000;
+    p->pending.month = ddmmyy / 100 % 100;
+    p->pending.year = 2000 + ddmmyy % 100;
+}
+
+/* Minute decimals kept, further ones are below 1e-7 degrees */
+#define NMEA_MINUTE_DECIMALS    8
+
+int32_t nmea_ddmm_to_e7(int64_t ddmm, uint8_t decimals)
+{
+    bool negative = ddmm < 0;
+    if (negative) {
+        ddmm = -ddmm;
+    }
+    if (decimals > NMEA_MAX_DIGITS) {
+        decimals = NMEA_MAX_DIGITS;
+    }
+    if (decimals > NMEA_MINUTE_DECIMALS) {
+        int64_t div = s_pow10[decimals - NMEA_MINUTE_DECIMALS];
+        ddmm = (ddmm + div / 2) / div;
+        decimals = NMEA_MINUTE_DECIMALS;
+    }
+    int64_t scale = s_pow10[decimals];
+    int64_t degrees = ddmm / (100 * scale);
+    int64_t minutes = ddmm - degrees * 100 * scale;
+    /* one minute is 1e7/60 units of 1e-7 degrees, rounded to nearest */
+    int64_t e7 = degrees * 10000000 + (minutes * 10000000 + 30 * scale) / (60 * scale);
+    return (int32_t)(negative ? -e7 : e7);
+}
+
+/* ddmm.mmmm coordinate, the sign comes from the following N/S or E/W field */
+static void nmea_set_coord(nmea_parser_t *p, int32_t *val)
+{
+    if (nmea_field_has_number(p) && !p->negative) {
+        *val = nmea_ddmm_to_e7(p->mantissa, p->decimals);
+    }
+}
+
+/* Make the coordinate negative if the hemisphere field is negative */
+static void nmea_set_hemisphere(nmea_parser_t *p, int32_t *val, char negative)
+{
+    if (p->chars > 0) {
+        int32_t magnitude = *val < 0 ? -*val : *val;
+        *val = p->letter == negative ? -magnitude : magnitude;
+    }
+}
+
+static void nmea_set_float(nmea_parser_t *p, float *val)
+{
+    if (nmea_field_has_number(p)) {
+        *val = (float)nmea_field_double(p);
+    }
+}
+
+static void nmea_set_u8(nmea_parser_t *p, uint8_t *val)
+{
+    if (nmea_field_has_number(p)) {
+        *val = (uint8_t)nmea_field_int(p);
+    }
+}
+
+static uint8_t nmea_constellation(const char *talker)
+{
+    static const char *const talkers[] = { "GP", "GL", "GA", "GB", "GQ" };
+    for (int i = 0; i < sizeof(talkers) / sizeof(talkers[0]); i++) {
+        if (talker[0] == talkers[i][0] && talker[1] == talkers[i][1]) {
+            return i;
+        }
+    }
+    /* BeiDou may also use the BD talker */
+    if (talker[0] == 'B' && talker[1] == 'D') {
+        return 3;
+    }
+    return NMEA_CONSTELLATION_MAX - 1;
+}
+
+/* The identifier is complete, its last three letters give the type */
+static void nmea_identify(nmea_parser_t *p)
+{
+    static const struct {
+        char name[4];
+        nmea_sentence_t type;
+    } sentences[] = {
+        { "GGA", NMEA_SENTENCE_GGA },
+        { "RMC", NMEA_SENTENCE_RMC },
+        { "GSA", NMEA_SENTENCE_GSA },
+        { "GSV", NMEA_SENTENCE_GSV },
+        { "VTG", NMEA_SENTENCE_VTG },
+    };
+
+    p->type = NMEA_SENTENCE_UNKNOWN;
+    if (p->id_len != 5) {
+        return;
+    }
+    const char *name = p->id + 2;
+    for (int i = 0; i < sizeof(sentences) / sizeof(sentences[0]); i++) {
+        if (name[0] == sentences[i].name[0] && name[1] == sentences[i].name[1] &&
+            name[2] == sentences[i].name[2]) {
+            p->type = sentences[i].type;
+            break;
+        }
+    }
+    p->constellation = nmea_constellation(p->id);
+}
+
+static void nmea_field_gga(nmea_parser_t *p)
+{
+    switch (p->field) {
+    case 1: nmea_set_time(p); break;
+    case 2: nmea_set_coord(p, &p->pending.lat_e7); break;
+    case 3: nmea_set_hemisphere(p, &p->pending.lat_e7, 'S'); break;
+    case 4: nmea_set_coord(p, &p->pending.lon_e7); break;
+    case 5: nmea_set_hemisphere(p, &p->pending.lon_e7, 'W'); break;
+    case 6: nmea_set_u8(p, &p->pending.fix_quality); break;
+    case 7: nmea_set_u8(p, &p->pending.sats_used); break;
+    case 8: nmea_set_float(p, &p->pending.hdop); break;
+    case 9: nmea_set_float(p, &p->pending.altitude); break;
+    default: break;
+    }
+}
+
+static void nmea_field_rmc(nmea_parser_t *p)
+{
+    switch (p->field) {
+    case 1: nmea_set_time(p); break;
+    case 2: p->pending.valid = (p->letter == 'A'); break;
+    case 3: nmea_set_coord(p, &p->pending.lat_e7); break;
+    case 4: nmea_set_hemisphere(p, &p->pending.lat_e7, 'S'); break;
+    case 5: nmea_set_coord(p, &p->pending.lon_e7); break;
+    case 6: nmea_set_hemisphere(p, &p->pending.lon_e7, 'W'); break;
+    case 7: nmea_set_float(p, &p->pending.speed); break;
+    case 8: nmea_set_float(p, &p->pending.course); break;
+    case 9: nmea_set_date(p); break;
+    default: break;
+    }
+}
+
+static void nmea_field_gsa(nmea_parser_t *p)
+{
+    switch (p->field) {
+    case 2: nmea_set_u8(p, &p->pending.fix_type); break;
+    case 15: nmea_set_float(p, &p->pending.pdop); break;
+    case 16: nmea_set_float(p, &p->pending.hdop); break;
+    case 17: nmea_set_float(p, &p->pending.vdop); break;
+    default: break;
+    }
+}
+
+static void nmea_field_gsv(nmea_parser_t *p)
+{
+    if (p->field == 3) {
+        nmea_set_u8(p, &p->pending_in_view[p->constellation]);
+    }
+}
+
+static void nmea_field_vtg(nmea_parser_t *p)
+{
+    switch (p->field) {
+    case 1: nmea_set_float(p, &p->pending.course); break;
+    case 5: nmea_set_float(p, &p->pending.speed); break;
+    default: break;
+    }
+}
+
+static void nmea_field_done(nmea_parser_t *p)
+{
+    switch (p->type) {
+    case NMEA_SENTENCE_GGA: nmea_field_gga(p); break;
+    case NMEA_SENTENCE_RMC: nmea_field_rmc(p); break;
+    case NMEA_SENTENCE_GSA: nmea_field_gsa(p); break;
+    case NMEA_SENTENCE_GSV: nmea_field_gsv(p); break;
+    case NMEA_SENTENCE_VTG: nmea_field_vtg(p); break;
+    default:
+        if (p->field == 0) {
+            nmea_identify(p);
+        }
+        break;
+    }
+}
+
+static void nmea_sentence_start(nmea_parser_t *p)
+{
+    p->state = NMEA_STATE_BODY;
+    p->checksum = 0;
+    p->length = 0;
+    p->field = 0;
+    p->id_len = 0;
+    p->type = NMEA_SENTENCE_UNKNOWN;
+    nmea_field_reset(p);
+    p->pending = p->fix;
+    memcpy(p->pending_in_view, p->in_view, sizeof(p->in_view));
+}
+
+/* Checksum verified, commit what the sentence wrote */
+static void nmea_sentence_commit(nmea_parser_t *p)
+{
+    p->sentences++;
+    if (p->type == NMEA_SENTENCE_UNKNOWN) {
+        return;
+    }
+    p->fix = p->pending;
+    memcpy(p->in_view, p->pending_in_view, sizeof(p->in_view));
+    if (p->type == NMEA_SENTENCE_GSV) {
+        unsigned int sum = 0;
+        for (int i = 0; i < NMEA_CONSTELLATION_MAX; i++) {
+            sum += p->in_view[i];
+        }
+        p->fix.sats_in_view = sum > UINT8_MAX ? UINT8_MAX : sum;
+    }
+    if (p->cb) {
+        p->cb(p->type, &p->fix, p->priv);
+    }
+}
+
+static void nmea_parser_char(nmea_parser_t *p, char c)
+{
+    if (c == '$') {
+        if (p->state != NMEA_STATE_IDLE) {
+            p->format_errors++;
+        }
+        nmea_sentence_start(p);
+        return;
+    }
+
+    switch (p->state) {
+    case NMEA_STATE_BODY:
+        if (++p->length > NMEA_MAX_SENTENCE_LEN || c == '\r' || c == '\n') {
+            /* too long, or no checksum */
+            p->format_errors++;
+            p->state = NMEA_STATE_IDLE;
+        } else if (c == '*') {
+            nmea_field_done(p);
+            p->state = NMEA_STATE_CHECKSUM_HI;
+        } else {
+            p->checksum ^= (uint8_t)c;
+            if (c == ',') {
+                nmea_field_done(p);
+                if (p->field < UINT8_MAX) {
+                    p->field++;
+                }
+                nmea_field_reset(p);
+            } else {
+                nmea_field_char(p, c);
+            }
+        }
+        break;
+    case NMEA_STATE_CHECKSUM_HI: {
+        int val = nmea_hex_value(c);
+        if (val < 0) {
+            p->format_errors++;
+            p->state = NMEA_STATE_IDLE;
+            break;
+        }
+        p->expected = val << 4;
+        p->state = NMEA_STATE_CHECKSUM_LO;
+        break;
+    }
+    case NMEA_STATE_CHECKSUM_LO: {
+        int val = nmea_hex_value(c);
+        p->state = NMEA_STATE_IDLE;
+        if (val < 0) {
+            p->format_errors++;
+            break;
+        }
+        p->expected |= val;
+        if (p->expected == p->checksum) {
+            nmea_sentence_commit(p);
+        } else {
+            p->checksum_errors++;
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void nmea_parser_init(nmea_parser_t *parser, nmea_sentence_cb_t cb, void *priv)
+{
+    memset(parser, 0, sizeof(nmea_parser_t));
+    parser->cb = cb;
+    parser->priv = priv;
+    parser->state = NMEA_STATE_IDLE;
+}
+
+void nmea_parser_feed(nmea_parser_t *parser, const char *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        nmea_parser_char(parser, data[i]);
+    }
+}
+
+const nmea_fix_t *nmea_parser_get_fix(const nmea_parser_t *parser)
+{
+    return &parser->fix;
+}
@@ -0,0 +1,201 @@
+#include <stdio.h>
+#include <string.h>
+#include "nmea_parser.h"
+#include "unity.h"
+
+#define MAX_CALLBACKS       32
+
+/* Sentence types passed to the callback, in order */
+typedef struct {
+    nmea_sentence_t types[MAX_CALLBACKS];
+    int count;
+} received_t;
+
+static void on_sentence(nmea_sentence_t type, const nmea_fix_t *fix, void *priv)
+{
+    received_t *rx = priv;
+    TEST_ASSERT_NOT_NULL(fix);
+    TEST_ASSERT_TRUE(rx->count < MAX_CALLBACKS);
+    rx->types[rx->count++] = type;
+}
+
+static void feed_str(nmea_parser_t *parser, const char *str)
+{
+    nmea_parser_feed(parser, str, strlen(str));
+}
+
+/* One epoch as the module sends it, with an AT response in front */
+static const char epoch[] =
+    "+CGPS: 1\r\nOK\r\n"
+    "$GNGGA,072809.30,3113.343286,N,12121.234064,E,1,09,0.9,44.1,M,8.0,M,,*72\r\n"
+    "$GNRMC,072809.30,A,3113.343286,N,12121.234064,E,1.5,87.2,250311,,,A*74\r\n"
+    "$GNGSA,A,3,05,12,15,,,,,,,,,,1.6,0.9,1.3*22\r\n"
+    "$GPGSV,3,1,11,05,40,083,46,12,52,270,44,15,20,120,38,18,10,310,30*75\r\n"
+    "$GPGSV,3,2,11,20,35,050,41,24,12,200,29,25,60,150,47,29,05,330,*78\r\n"
+    "$GPGSV,3,3,11,31,22,010,36,32,15,100,33,33,,,*7B\r\n"
+    "$GLGSV,2,1,07,65,30,040,40,66,45,120,42,72,15,280,33,73,50,200,44*6D\r\n"
+    "$GLGSV,2,2,07,74,20,320,35,80,10,060,,81,25,150,38*5A\r\n"
+    "$BDGSV,1,1,04,01,40,120,40,03,50,200,42,06,30,300,38,08,20,020,35*6F\r\n"
+    "$GNVTG,91.5,T,,M,3.2,N,5.9,K,A*23\r\n"
+    "$GPTXT,01,01,02,ANTENNA OK*36\r\n";
+
+#define EPOCH_SENTENCES     11
+
+static void check_epoch(const nmea_parser_t *parser)
+{
+    const nmea_fix_t *fix = nmea_parser_get_fix(parser);
+
+    TEST_ASSERT_EQUAL(EPOCH_SENTENCES, parser->sentences);
+    TEST_ASSERT_EQUAL(0, parser->checksum_errors);
+    TEST_ASSERT_EQUAL(0, parser->format_errors);
+
+    TEST_ASSERT_EQUAL(7, fix->hour);
+    TEST_ASSERT_EQUAL(28, fix->minute);
+    TEST_ASSERT_EQUAL(9, fix->second);
+    TEST_ASSERT_EQUAL(300, fix->millisecond);
+    TEST_ASSERT_EQUAL(25, fix->day);
+    TEST_ASSERT_EQUAL(3, fix->month);
+    TEST_ASSERT_EQUAL(2011, fix->year);
+    TEST_ASSERT_EQUAL(312223881, fix->lat_e7);
+    TEST_ASSERT_EQUAL(1213539011, fix->lon_e7);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 44.1, fix->altitude);
+    TEST_ASSERT_EQUAL(1, fix->fix_quality);
+    TEST_ASSERT_EQUAL(9, fix->sats_used);
+    TEST_ASSERT_EQUAL(3, fix->fix_type);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 1.6, fix->pdop);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 0.9, fix->hdop);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 1.3, fix->vdop);
+    TEST_ASSERT_TRUE(fix->valid);
+    /* 11 GPS + 7 GLONASS + 4 BeiDou */
+    TEST_ASSERT_EQUAL(22, fix->sats_in_view);
+    /* VTG comes after RMC and overrides its speed and course */
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 3.2, fix->speed);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 91.5, fix->course);
+}
+
+TEST_CASE("nmea parser merges GGA, RMC, GSA, GSV and VTG into the fix", "[nmea_parser]")
+{
+    static const nmea_sentence_t expected[] = {
+        NMEA_SENTENCE_GGA, NMEA_SENTENCE_RMC, NMEA_SENTENCE_GSA,
+        NMEA_SENTENCE_GSV, NMEA_SENTENCE_GSV, NMEA_SENTENCE_GSV,
+        NMEA_SENTENCE_GSV, NMEA_SENTENCE_GSV, NMEA_SENTENCE_GSV,
+        NMEA_SENTENCE_VTG,
+    };
+    static received_t rx;
+    nmea_parser_t parser;
+
+    memset(&rx, 0, sizeof(rx));
+    nmea_parser_init(&parser, on_sentence, &rx);
+    feed_str(&parser, epoch);
+    check_epoch(&parser);
+
+    /* Unknown sentences are checked and counted, but not reported */
+    TEST_ASSERT_EQUAL(sizeof(expected) / sizeof(expected[0]), rx.count);
+    for (int i = 0; i < rx.count; i++) {
+        TEST_ASSERT_EQUAL(expected[i], rx.types[i]);
+    }
+
+    /* Southern and western hemispheres, negative altitude */
+    feed_str(&parser, "$GPGGA,235959.999,4807.038,S,01131.000,W,2,12,1.0,-12.5,M,,,,*10\r\n");
+    const nmea_fix_t *fix = nmea_parser_get_fix(&parser);
+    TEST_ASSERT_EQUAL(23, fix->hour);
+    TEST_ASSERT_EQUAL(59, fix->second);
+    TEST_ASSERT_EQUAL(999, fix->millisecond);
+    TEST_ASSERT_EQUAL(-481173000, fix->lat_e7);
+    TEST_ASSERT_EQUAL(-115166667, fix->lon_e7);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, -12.5, fix->altitude);
+    TEST_ASSERT_EQUAL(2, fix->fix_quality);
+    TEST_ASSERT_EQUAL(12, fix->sats_used);
+}
+
+TEST_CASE("nmea parser replaces the satellites in view of one constellation per GSV", "[nmea_parser]")
+{
+    nmea_parser_t parser;
+
+    nmea_parser_init(&parser, NULL, NULL);
+    feed_str(&parser, epoch);
+    TEST_ASSERT_EQUAL(22, nmea_parser_get_fix(&parser)->sats_in_view);
+
+    /* The next GPS cycle sees fewer satellites, the other constellations keep theirs */
+    feed_str(&parser, "$GPGSV,1,1,03,05,40,083,46,12,52,270,44,15,20,120,38*4D\r\n");
+    TEST_ASSERT_EQUAL(3 + 7 + 4, nmea_parser_get_fix(&parser)->sats_in_view);
+
+    /* Repeating a cycle does not count its satellites twice */
+    feed_str(&parser, "$GPGSV,1,1,03,05,40,083,46,12,52,270,44,15,20,120,38*4D\r\n");
+    TEST_ASSERT_EQUAL(3 + 7 + 4, nmea_parser_get_fix(&parser)->sats_in_view);
+}
+
+TEST_CASE("nmea parser gives the same fix for any split of the input", "[nmea_parser]")
+{
+    nmea_parser_t whole;
+    nmea_parser_t parser;
+    size_t len = strlen(epoch);
+
+    nmea_parser_init(&whole, NULL, NULL);
+    feed_str(&whole, epoch);
+
+    for (size_t cut = 0; cut <= len; cut++) {
+        nmea_parser_init(&parser, NULL, NULL);
+        nmea_parser_feed(&parser, epoch, cut);
+        nmea_parser_feed(&parser, epoch + cut, len - cut);
+        check_epoch(&parser);
+        TEST_ASSERT_EQUAL_MEMORY(&whole.fix, &parser.fix, sizeof(nmea_fix_t));
+    }
+
+    nmea_parser_init(&parser, NULL, NULL);
+    for (size_t i = 0; i < len; i++) {
+        nmea_parser_feed(&parser, &epoch[i], 1);
+    }
+    check_epoch(&parser);
+    TEST_ASSERT_EQUAL_MEMORY(&whole.fix, &parser.fix, sizeof(nmea_fix_t));
+}
+
+TEST_CASE("nmea parser checks checksums in either case and drops malformed sentences", "[nmea_parser]")
+{
+    static received_t rx;
+    nmea_parser_t parser;
+    char longest[NMEA_MAX_SENTENCE_LEN + 32];
+
+    memset(&rx, 0, sizeof(rx));
+    nmea_parser_init(&parser, on_sentence, &rx);
+
+    /* Lowercase hex digits are accepted */
+    feed_str(&parser, "$GNGSA,A,3,05,12,15,,,,,,,,,,1.6,0.9,1.3*22\r\n");
+    feed_str(&parser, "$GLGSV,2,2,07,74,20,320,35,80,10,060,,81,25,150,38*5a\r\n");
+    TEST_ASSERT_EQUAL(2, parser.sentences);
+    TEST_ASSERT_EQUAL(7, nmea_parser_get_fix(&parser)->sats_in_view);
+
+    /* A wrong checksum leaves the fix untouched */
+    feed_str(&parser, "$GNGGA,072809.30,3113.343286,N,12121.234064,E,1,09,0.9,44.1,M,8.0,M,,*73\r\n");
+    TEST_ASSERT_EQUAL(1, parser.checksum_errors);
+    TEST_ASSERT_EQUAL(0, nmea_parser_get_fix(&parser)->lat_e7);
+
+    /* A '$' inside a sentence drops it and starts over */
+    feed_str(&parser, "$GNGGA,072809.30,3113.3$GNVTG,91.5,T,,M,3.2,N,5.9,K,A*23\r\n");
+    TEST_ASSERT_EQUAL(1, parser.format_errors);
+    TEST_ASSERT_EQUAL(3, parser.sentences);
+    TEST_ASSERT_EQUAL(0, nmea_parser_get_fix(&parser)->lat_e7);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 91.5, nmea_parser_get_fix(&parser)->course);
+
+    /* Over-long sentences are dropped, including their checksum */
+    memset(longest, 0, sizeof(longest));
+    strcpy(longest, "$GPTXT,01,01,02,");
+    memset(longest + strlen(longest), 'A', NMEA_MAX_SENTENCE_LEN);
+    strcat(longest, "*00\r\n");
+    feed_str(&parser, longest);
+    TEST_ASSERT_EQUAL(2, parser.format_errors);
+    TEST_ASSERT_EQUAL(1, parser.checksum_errors);
+
+    /* A sentence without a checksum is malformed */
+    feed_str(&parser, "$GNRMC,072809.30,A,3113.343286,N,12121.234064,E,1.5,87.2,250311,,,A\r\n");
+    TEST_ASSERT_EQUAL(3, parser.format_errors);
+    TEST_ASSERT_FALSE(nmea_parser_get_fix(&parser)->valid);
+
+    /* The parser recovers on the next good sentence */
+    feed_str(&parser, "$GNGGA,072809.30,3113.343286,N,12121.234064,E,1,09,0.9,44.1,M,8.0,M,,*72\r\n");
+    TEST_ASSERT_EQUAL(4, parser.sentences);
+    TEST_ASSERT_EQUAL(312223881, nmea_parser_get_fix(&parser)->lat_e7);
+
+    TEST_ASSERT_EQUAL(4, rx.count);
+    TEST_ASSERT_EQUAL(NMEA_SENTENCE_GGA, rx.types[3]);
+}
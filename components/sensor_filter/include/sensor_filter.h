@@ -0,0 +1,150 @@
+/*
+ * Sensor signal conditioning
+ *
+ * Each channel runs its samples through a fixed chain, every stage of
+ * which can be turned off:
+ *
+ * 1. Range check, samples outside [min_value, max_value] are rejected.
+ * 2. Outlier rejection, a sample further from the median of the window than
+ *    outlier_k times the scaled median absolute deviation, and than
+ *    outlier_min, is rejected. Rejected samples still enter the window, so
+ *    a real change of level is accepted once it makes up most of the window.
+ * 3. Median of the window.
+ * 4. Exponential moving average, ema_alpha is the weight of a new sample.
+ * 5. Rate clamp, the output changes by at most max_rate per second.
+ *
+ * A rejected sample leaves the output unchanged. The window is a fixed ring
+ * buffer inside the context, nothing is allocated.
+ *
+ * The filter has no timers of its own, the caller passes a monotonic time
+ * in ms with every sample.
+ */
+#ifndef _SENSOR_FILTER_H_
+#define _SENSOR_FILTER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** Largest window */
+#define SENSOR_FILTER_MAX_WINDOW    9
+
+/** Filter tuning */
+typedef struct {
+    /** Samples kept for the median and outlier rejection, 1 to SENSOR_FILTER_MAX_WINDOW */
+    uint8_t window;
+    /** Output the median of the window rather than the newest sample */
+    bool median;
+    /** Weight of a new sample in the moving average, (0, 1], 1 turns it off */
+    float ema_alpha;
+    /** Largest change of the output per second, 0 turns the clamp off */
+    float max_rate;
+    /** Rejection threshold in scaled MADs, 0 turns outlier rejection off */
+    float outlier_k;
+    /** Deviation from the median that is never an outlier, e.g. the sensor's resolution */
+    float outlier_min;
+    /** Valid range of the raw samples */
+    float min_value;
+    float max_value;
+} sensor_filter_config_t;
+
+/** Only the median of three, the range is unlimited */
+#define SENSOR_FILTER_CONFIG_DEFAULT()  \
+    {                                   \
+        .window = 3,                    \
+        .median = true,                 \
+        .ema_alpha = 1.0f,              \
+        .max_rate = 0,                  \
+        .outlier_k = 0,                 \
+        .outlier_min = 0,               \
+        .min_value = -1e30f,            \
+        .max_value = 1e30f,             \
+    }
+
+/** Filter context
+ *
+ * Please do not set/modify any elements.
+ */
+typedef struct {
+    sensor_filter_config_t config;
+    /** Ring buffer of the last samples in range */
+    float ring[SENSOR_FILTER_MAX_WINDOW];
+    uint8_t head;
+    uint8_t fill;
+    /** An output exists */
+    bool valid;
+    /** Last sample and output */
+    float raw;
+    float value;
+    int64_t value_ms;
+    /** Totals since sensor_filter_init() */
+    uint32_t samples;
+    uint32_t rejected;
+} sensor_filter_t;
+
+/** Check a configuration
+ *
+ * \param[in] config Tuning
+ *
+ * \return true if sensor_filter_init() would accept it
+ */
+bool sensor_filter_config_valid(const sensor_filter_config_t *config);
+
+/** Initialise a filter with no output yet
+ *
+ * \param[out] filter Filter context
+ * \param[in] config Tuning, NULL for SENSOR_FILTER_CONFIG_DEFAULT()
+ *
+ * \return 0 on success, -1 if the config is invalid
+ */
+int sensor_filter_init(sensor_filter_t *filter, const sensor_filter_config_t *config);
+
+/** Change the tuning
+ *
+ * The window and the counters are kept, the window shrinks to the newest
+ * samples if it gets smaller.
+ *
+ * \param[in] filter Filter context
+ * \param[in] config Tuning
+ *
+ * \return 0 on success, -1 if the config is invalid
+ */
+int sensor_filter_set_config(sensor_filter_t *filter, const sensor_filter_config_t *config);
+
+/** Filter a sample
+ *
+ * \param[in] filter Filter context
+ * \param[in] time_ms Monotonic time of the sample
+ * \param[in] raw The sample
+ *
+ * \return true if the sample was accepted and the output updated
+ */
+bool sensor_filter_update(sensor_filter_t *filter, int64_t time_ms, float raw);
+
+/** Current output, valid if sensor_filter_valid()
+ *
+ * \param[in] filter Filter context
+ */
+static inline float sensor_filter_value(const sensor_filter_t *filter)
+{
+    return filter->value;
+}
+
+/** An output exists
+ *
+ * \param[in] filter Filter context
+ */
+static inline bool sensor_filter_valid(const sensor_filter_t *filter)
+{
+    return filter->valid;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SENSOR_FILTER_H_ */
@@ -0,0 +1,138 @@
+#include <string.h>
+#include <math.h>
+#include <sensor_filter.h>
+
+/* Scales the median absolute deviation to the standard deviation of
+ * normally distributed noise */
+#define MAD_SCALE   1.4826f
+
+bool sensor_filter_config_valid(const sensor_filter_config_t *config)
+{
+    /* Written so that NaN fails every test */
+    return config->window >= 1 && config->window <= SENSOR_FILTER_MAX_WINDOW &&
+           config->ema_alpha > 0 && config->ema_alpha <= 1 &&
+           config->max_rate >= 0 && config->outlier_k >= 0 && config->outlier_min >= 0 &&
+           config->min_value <= config->max_value;
+}
+
+int sensor_filter_init(sensor_filter_t *filter, const sensor_filter_config_t *config)
+{
+    static const sensor_filter_config_t default_config = SENSOR_FILTER_CONFIG_DEFAULT();
+
+    if (config == NULL) {
+        config = &default_config;
+    }
+    if (!sensor_filter_config_valid(config)) {
+        return -1;
+    }
+    memset(filter, 0, sizeof(sensor_filter_t));
+    filter->config = *config;
+    return 0;
+}
+
+/* Copy the window out, oldest first */
+static int window_copy(const sensor_filter_t *filter, float *out)
+{
+    int window = filter->config.window;
+    int first = filter->head + window - filter->fill;
+    for (int i = 0; i < filter->fill; i++) {
+        out[i] = filter->ring[(first + i) % window];
+    }
+    return filter->fill;
+}
+
+int sensor_filter_set_config(sensor_filter_t *filter, const sensor_filter_config_t *config)
+{
+    float samples[SENSOR_FILTER_MAX_WINDOW];
+
+    if (!sensor_filter_config_valid(config)) {
+        return -1;
+    }
+    /* Lay the window out again from the start of the ring, keeping the
+     * newest samples that fit */
+    int count = window_copy(filter, samples);
+    int keep = count < config->window ? count : config->window;
+    memcpy(filter->ring, samples + count - keep, keep * sizeof(float));
+    filter->fill = keep;
+    filter->head = keep % config->window;
+    filter->config = *config;
+    return 0;
+}
+
+static float sorted_median(float *values, int count)
+{
+    for (int i = 1; i < count; i++) {
+        float v = values[i];
+        int j = i;
+        while (j > 0 && values[j - 1] > v) {
+            values[j] = values[j - 1];
+            j--;
+        }
+        values[j] = v;
+    }
+    return count & 1 ? values[count / 2] : (values[count / 2 - 1] + values[count / 2]) / 2;
+}
+
+static bool is_outlier(const sensor_filter_t *filter, float raw)
+{
+    float values[SENSOR_FILTER_MAX_WINDOW];
+
+    /* Fewer than three samples tell nothing about the spread */
+    if (filter->config.outlier_k <= 0 || filter->fill < 3) {
+        return false;
+    }
+    int count = window_copy(filter, values);
+    float median = sorted_median(values, count);
+    for (int i = 0; i < count; i++) {
+        values[i] = fabsf(values[i] - median);
+    }
+    float limit = filter->config.outlier_k * MAD_SCALE * sorted_median(values, count);
+    if (limit < filter->config.outlier_min) {
+        limit = filter->config.outlier_min;
+    }
+    return fabsf(raw - median) > limit;
+}
+
+bool sensor_filter_update(sensor_filter_t *filter, int64_t time_ms, float raw)
+{
+    const sensor_filter_config_t *config = &filter->config;
+
+    filter->samples++;
+    filter->raw = raw;
+    if (!(raw >= config->min_value && raw <= config->max_value)) {
+        filter->rejected++;
+        return false;
+    }
+
+    bool outlier = is_outlier(filter, raw);
+    filter->ring[filter->head] = raw;
+    filter->head = (filter->head + 1) % config->window;
+    if (filter->fill < config->window) {
+        filter->fill++;
+    }
+    if (outlier) {
+        filter->rejected++;
+        return false;
+    }
+
+    float value = raw;
+    if (config->median) {
+        float values[SENSOR_FILTER_MAX_WINDOW];
+        value = sorted_median(values, window_copy(filter, values));
+    }
+    if (filter->valid) {
+        value = filter->value + config->ema_alpha * (value - filter->value);
+        if (config->max_rate > 0) {
+            float max_step = config->max_rate * (time_ms - filter->value_ms) / 1000.0f;
+            if (value > filter->value + max_step) {
+                value = filter->value + max_step;
+            } else if (value < filter->value - max_step) {
+                value = filter->value - max_step;
+            }
+        }
+    }
+    filter->value = value;
+    filter->value_ms = time_ms;
+    filter->valid = true;
+    return true;
+}
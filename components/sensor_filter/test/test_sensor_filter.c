@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <math.h>
+#include "sensor_filter.h"
+#include "unity.h"
+
+TEST_CASE("sensor filter drops glitches of a DHT11", "[sensor_filter]")
+{
+    sensor_filter_config_t config = {
+        .window = 5,
+        .median = true,
+        .ema_alpha = 1.0f,
+        .max_rate = 0,
+        .outlier_k = 3,
+        .outlier_min = 2,
+        .min_value = -40,
+        .max_value = 80,
+    };
+    sensor_filter_t filter;
+
+    TEST_ASSERT_EQUAL(0, sensor_filter_init(&filter, &config));
+    TEST_ASSERT_FALSE(sensor_filter_valid(&filter));
+
+    /* Too few samples to judge, the median follows */
+    TEST_ASSERT_TRUE(sensor_filter_update(&filter, 0, 23));
+    TEST_ASSERT_TRUE(sensor_filter_update(&filter, 2000, 24));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 23.5, sensor_filter_value(&filter));
+    TEST_ASSERT_TRUE(sensor_filter_update(&filter, 4000, 23));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 23, sensor_filter_value(&filter));
+
+    /* A bit error in range is an outlier, the output holds */
+    TEST_ASSERT_FALSE(sensor_filter_update(&filter, 6000, 60));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 60, filter.raw);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 23, sensor_filter_value(&filter));
+
+    /* Normal readings after it pass, the median hides the outlier */
+    TEST_ASSERT_TRUE(sensor_filter_update(&filter, 8000, 23));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 23, sensor_filter_value(&filter));
+    TEST_ASSERT_TRUE(sensor_filter_update(&filter, 10000, 24));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 24, sensor_filter_value(&filter));
+
+    /* Out of range and NaN never enter the window */
+    TEST_ASSERT_FALSE(sensor_filter_update(&filter, 12000, 90));
+    TEST_ASSERT_FALSE(sensor_filter_update(&filter, 14000, NAN));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 24, sensor_filter_value(&filter));
+    TEST_ASSERT_EQUAL(8, filter.samples);
+    TEST_ASSERT_EQUAL(3, filter.rejected);
+}
+
+TEST_CASE("sensor filter follows steps at a limited rate", "[sensor_filter]")
+{
+    sensor_filter_config_t config = {
+        .window = 3,
+        .median = false,
+        .ema_alpha = 1.0f,
+        .max_rate = 0,
+        .outlier_k = 3,
+        .outlier_min = 1,
+        .min_value = -1000,
+        .max_value = 1000,
+    };
+    sensor_filter_t filter;
+
+    /* A real step is accepted once it fills most of the window */
+    sensor_filter_init(&filter, &config);
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_TRUE(sensor_filter_update(&filter, i * 1000, 10));
+    }
+    TEST_ASSERT_FALSE(sensor_filter_update(&filter, 3000, 20));
+    TEST_ASSERT_FALSE(sensor_filter_update(&filter, 4000, 20));
+    TEST_ASSERT_TRUE(sensor_filter_update(&filter, 5000, 20));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 20, sensor_filter_value(&filter));
+    TEST_ASSERT_EQUAL(2, filter.rejected);
+
+    /* Moving average, then at most 1 unit per second */
+    config.window = 1;
+    config.ema_alpha = 0.5f;
+    config.max_rate = 1.0f;
+    config.outlier_k = 0;
+    sensor_filter_init(&filter, &config);
+    sensor_filter_update(&filter, 0, 0);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 0, sensor_filter_value(&filter));
+    sensor_filter_update(&filter, 1000, 10);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 1, sensor_filter_value(&filter));
+    sensor_filter_update(&filter, 3000, 10);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 3, sensor_filter_value(&filter));
+    sensor_filter_update(&filter, 13000, 10);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 6.5, sensor_filter_value(&filter));
+}
+
+TEST_CASE("sensor filter validates and changes its config", "[sensor_filter]")
+{
+    sensor_filter_config_t config = SENSOR_FILTER_CONFIG_DEFAULT();
+    sensor_filter_t filter;
+
+    TEST_ASSERT_TRUE(sensor_filter_config_valid(&config));
+    config.window = 0;
+    TEST_ASSERT_FALSE(sensor_filter_config_valid(&config));
+    config.window = SENSOR_FILTER_MAX_WINDOW + 1;
+    TEST_ASSERT_EQUAL(-1, sensor_filter_init(&filter, &config));
+    config.window = 3;
+    config.ema_alpha = 0;
+    TEST_ASSERT_FALSE(sensor_filter_config_valid(&config));
+    config.ema_alpha = NAN;
+    TEST_ASSERT_FALSE(sensor_filter_config_valid(&config));
+    config.ema_alpha = 1;
+    config.max_rate = -1;
+    TEST_ASSERT_FALSE(sensor_filter_config_valid(&config));
+    config.max_rate = 0;
+    config.min_value = 1;
+    config.max_value = 0;
+    TEST_ASSERT_FALSE(sensor_filter_config_valid(&config));
+
+    /* Median of three by default */
+    TEST_ASSERT_EQUAL(0, sensor_filter_init(&filter, NULL));
+    sensor_filter_update(&filter, 0, 1);
+    sensor_filter_update(&filter, 1, 5);
+    sensor_filter_update(&filter, 2, 3);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 3, sensor_filter_value(&filter));
+
+    /* Shrinking keeps the newest samples, growing keeps them all */
+    config = (sensor_filter_config_t)SENSOR_FILTER_CONFIG_DEFAULT();
+    config.window = 2;
+    TEST_ASSERT_EQUAL(-1, sensor_filter_set_config(&filter, &(sensor_filter_config_t){ .window = 0 }));
+    TEST_ASSERT_EQUAL(0, sensor_filter_set_config(&filter, &config));
+    sensor_filter_update(&filter, 3, 4);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 3.5, sensor_filter_value(&filter));
+    config.window = 5;
+    TEST_ASSERT_EQUAL(0, sensor_filter_set_config(&filter, &config));
+    sensor_filter_update(&filter, 4, 10);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 4, sensor_filter_value(&filter));
+    TEST_ASSERT_EQUAL(5, filter.samples);
+    TEST_ASSERT_EQUAL(0, filter.rejected);
+}
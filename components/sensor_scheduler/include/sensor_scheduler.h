@@ -0,0 +1,163 @@
+/*
+ * Multi-rate sensor sampling scheduler
+ *
+ * Each sensor is sampled once per period, in slots that start phase_ms
+ * after it was added and then every period_ms. A sensor that needs time to
+ * convert is started at the slot and read conversion_ms later, one that
+ * does not is read at the slot. The pending actions of all sensors are kept
+ * ordered by deadline, earliest first and by sensor id on a tie, so the
+ * caller only ever looks at the head.
+ *
+ * Every slot is served exactly once. Slots are not shifted by late service,
+ * so the sampling rate does not drift, and slots that are already over by
+ * the time the previous one is served are skipped rather than read in a
+ * burst.
+ *
+ * A sensor whose conversion time varies can move the read of the slot it
+ * has just started.
+ *
+ * The scheduler has no timers of its own, the caller passes a monotonic
+ * time in ms to every call.
+ */
+#ifndef _SENSOR_SCHEDULER_H_
+#define _SENSOR_SCHEDULER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** Sensors one scheduler can hold */
+#define SENSOR_SCHED_MAX_SENSORS    8
+
+/** Nothing is due, returned by sensor_sched_next_ms() */
+#define SENSOR_SCHED_NEVER          INT64_MAX
+
+/** Sampling of one sensor */
+typedef struct {
+    /** Time between slots, more than conversion_ms */
+    uint32_t period_ms;
+    /** Offset of the first slot from sensor_sched_add() */
+    uint32_t phase_ms;
+    /** Time from start to read, 0 to read at the slot without starting */
+    uint32_t conversion_ms;
+} sensor_sched_config_t;
+
+/** What the caller has to do */
+typedef enum {
+    /** Nothing is due yet */
+    SENSOR_SCHED_IDLE = 0,
+    /** Trigger a conversion */
+    SENSOR_SCHED_START,
+    /** Read the result */
+    SENSOR_SCHED_READ,
+} sensor_sched_action_t;
+
+/** State and counters of one sensor */
+typedef struct {
+    sensor_sched_config_t config;
+    /** Start of the current slot */
+    int64_t slot_ms;
+    /** Time of the next action */
+    int64_t due_ms;
+    /** Started, the read is next */
+    bool converting;
+    /** Slots served */
+    uint32_t reads;
+    /** Slots skipped because the previous one was served too late */
+    uint32_t skipped;
+    /** Largest delay of a slot's first action */
+    uint32_t max_late_ms;
+} sensor_sched_entry_t;
+
+/** Scheduler context
+ *
+ * Please do not set/modify any elements.
+ */
+typedef struct {
+    sensor_sched_entry_t sensors[SENSOR_SCHED_MAX_SENSORS];
+    /** Sensor ids ordered by due_ms */
+    uint8_t order[SENSOR_SCHED_MAX_SENSORS];
+    uint8_t count;
+} sensor_sched_t;
+
+/** Initialise an empty scheduler
+ *
+ * \param[out] sched Scheduler context
+ */
+void sensor_sched_init(sensor_sched_t *sched);
+
+/** Add a sensor
+ *
+ * \param[in] sched Scheduler context
+ * \param[in] config Sampling of the sensor
+ * \param[in] now_ms Current time
+ *
+ * \return Sensor id, counting from 0 in the order added, or -1 if the
+ * scheduler is full or the config is invalid
+ */
+int sensor_sched_add(sensor_sched_t *sched, const sensor_sched_config_t *config, int64_t now_ms);
+
+/** Take the earliest due action
+ *
+ * Call again until it returns SENSOR_SCHED_IDLE, then wait until
+ * sensor_sched_next_ms().
+ *
+ * \param[in] sched Scheduler context
+ * \param[in] now_ms Current time
+ * \param[out] id Sensor the action is for, unchanged for SENSOR_SCHED_IDLE
+ *
+ * \return The action, counted as done
+ */
+sensor_sched_action_t sensor_sched_poll(sensor_sched_t *sched, int64_t now_ms, int *id);
+
+/** Give up the current slot of a sensor, e.g. after its start failed
+ *
+ * \param[in] sched Scheduler context
+ * \param[in] id Sensor id
+ * \param[in] now_ms Current time
+ */
+void sensor_sched_abort(sensor_sched_t *sched, int id, int64_t now_ms);
+
+/** Change when the read of a started conversion is due
+ *
+ * For sensors whose conversion time depends on their current setting. The
+ * configured conversion_ms stays the default for the following slots. A
+ * read that ends up after the next slot starts makes that slot skipped.
+ *
+ * \param[in] sched Scheduler context
+ * \param[in] id Sensor id, after SENSOR_SCHED_START for it
+ * \param[in] now_ms Time the conversion was started
+ * \param[in] conversion_ms Time from now_ms to the read. As for
+ * sensor_sched_add(), it must be shorter than the period.
+ *
+ * \return 0 on success, -1 if the sensor is not converting or
+ * conversion_ms is not shorter than the period. The read then stays due
+ * after the configured conversion_ms.
+ */
+int sensor_sched_set_conversion(sensor_sched_t *sched, int id, int64_t now_ms, uint32_t conversion_ms);
+
+/** Time of the earliest pending action, SENSOR_SCHED_NEVER if none
+ *
+ * \param[in] sched Scheduler context
+ */
+int64_t sensor_sched_next_ms(const sensor_sched_t *sched);
+
+/** State and counters of a sensor
+ *
+ * \param[in] sched Scheduler context
+ * \param[in] id Sensor id
+ */
+static inline const sensor_sched_entry_t *sensor_sched_get(const sensor_sched_t *sched, int id)
+{
+    return &sched->sensors[id];
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SENSOR_SCHEDULER_H_ */
@@ -0,0 +1,138 @@
+#include <string.h>
+#include <sensor_scheduler.h>
+
+void sensor_sched_init(sensor_sched_t *sched)
+{
+    memset(sched, 0, sizeof(sensor_sched_t));
+}
+
+static bool due_before(const sensor_sched_t *sched, int a, int b)
+{
+    int64_t due_a = sched->sensors[a].due_ms;
+    int64_t due_b = sched->sensors[b].due_ms;
+    return due_a < due_b || (due_a == due_b && a < b);
+}
+
+/* Put the sensor at order[pos] back in place after its deadline moved later */
+static void sift_down(sensor_sched_t *sched, int pos)
+{
+    uint8_t id = sched->order[pos];
+    while (pos + 1 < sched->count && due_before(sched, sched->order[pos + 1], id)) {
+        sched->order[pos] = sched->order[pos + 1];
+        pos++;
+    }
+    sched->order[pos] = id;
+}
+
+int sensor_sched_add(sensor_sched_t *sched, const sensor_sched_config_t *config, int64_t now_ms)
+{
+    if (sched->count >= SENSOR_SCHED_MAX_SENSORS || config->period_ms == 0 ||
+        config->conversion_ms >= config->period_ms) {
+        return -1;
+    }
+    int id = sched->count;
+    sensor_sched_entry_t *entry = &sched->sensors[id];
+    memset(entry, 0, sizeof(sensor_sched_entry_t));
+    entry->config = *config;
+    entry->slot_ms = now_ms + config->phase_ms;
+    entry->due_ms = entry->slot_ms;
+
+    /* Insert from the back, the new id is the largest so it goes after ties */
+    int pos = sched->count++;
+    while (pos > 0 && due_before(sched, id, sched->order[pos - 1])) {
+        sched->order[pos] = sched->order[pos - 1];
+        pos--;
+    }
+    sched->order[pos] = id;
+    return id;
+}
+
+/* Move on to the first slot that has not started yet */
+static void next_slot(sensor_sched_entry_t *entry, int64_t now_ms)
+{
+    entry->converting = false;
+    entry->slot_ms += entry->config.period_ms;
+    if (entry->slot_ms <= now_ms) {
+        int64_t missed = (now_ms - entry->slot_ms) / entry->config.period_ms + 1;
+        entry->slot_ms += missed * entry->config.period_ms;
+        entry->skipped += (uint32_t)missed;
+    }
+    entry->due_ms = entry->slot_ms;
+}
+
+sensor_sched_action_t sensor_sched_poll(sensor_sched_t *sched, int64_t now_ms, int *id)
+{
+    if (sched->count == 0) {
+        return SENSOR_SCHED_IDLE;
+    }
+    int head = sched->order[0];
+    sensor_sched_entry_t *entry = &sched->sensors[head];
+    if (entry->due_ms > now_ms) {
+        return SENSOR_SCHED_IDLE;
+    }
+    *id = head;
+
+    sensor_sched_action_t action;
+    if (!entry->converting) {
+        int64_t late = now_ms - entry->slot_ms;
+        if (late > entry->max_late_ms) {
+            entry->max_late_ms = late < UINT32_MAX ? (uint32_t)late : UINT32_MAX;
+        }
+    }
+    if (!entry->converting && entry->config.conversion_ms > 0) {
+        /* The conversion runs from the actual start, not from the slot */
+        entry->converting = true;
+        entry->due_ms = now_ms + entry->config.conversion_ms;
+        action = SENSOR_SCHED_START;
+    } else {
+        entry->reads++;
+        next_slot(entry, now_ms);
+        action = SENSOR_SCHED_READ;
+    }
+    sift_down(sched, 0);
+    return action;
+}
+
+/* Put a sensor back in place after its deadline moved either way */
+static void resort(sensor_sched_t *sched, int id)
+{
+    int pos = 0;
+    while (sched->order[pos] != id) {
+        pos++;
+    }
+    while (pos > 0 && due_before(sched, id, sched->order[pos - 1])) {
+        sched->order[pos] = sched->order[pos - 1];
+        pos--;
+    }
+    sched->order[pos] = id;
+    sift_down(sched, pos);
+}
+
+void sensor_sched_abort(sensor_sched_t *sched, int id, int64_t now_ms)
+{
+    if (id < 0 || id >= sched->count) {
+        return;
+    }
+    next_slot(&sched->sensors[id], now_ms);
+    /* The slot may move earlier than the pending read */
+    resort(sched, id);
+}
+
+int sensor_sched_set_conversion(sensor_sched_t *sched, int id, int64_t now_ms, uint32_t conversion_ms)
+{
+    if (id < 0 || id >= sched->count || !sched->sensors[id].converting ||
+        conversion_ms >= sched->sensors[id].config.period_ms) {
+        return -1;
+    }
+    sched->sensors[id].due_ms = now_ms + conversion_ms;
+    resort(sched, id);
+    return 0;
+}
+
+int64_t sensor_sched_next_ms(const sensor_sched_t *sched)
+{
+    if (sched->count == 0) {
+        return SENSOR_SCHED_NEVER;
+    }
+    return sched->sensors[sched->order[0]].due_ms;
+}
@@ -0,0 +1,153 @@
+#include <stdio.h>
+#include "sensor_scheduler.h"
+#include "unity.h"
+
+/* Run the scheduler like the sensor task does, serving every action at its
+ * deadline, and count the reads of each sensor */
+static void run_until(sensor_sched_t *sched, int64_t *now, int64_t end_ms, uint32_t reads[])
+{
+    while (sensor_sched_next_ms(sched) <= end_ms) {
+        *now = sensor_sched_next_ms(sched);
+        int id = -1;
+        sensor_sched_action_t action;
+        while ((action = sensor_sched_poll(sched, *now, &id)) != SENSOR_SCHED_IDLE) {
+            if (action == SENSOR_SCHED_READ) {
+                reads[id]++;
+            }
+        }
+    }
+    *now = end_ms;
+}
+
+TEST_CASE("sensor scheduler runs sensors at their own rates", "[sensor_scheduler]")
+{
+    sensor_sched_config_t dht = { .period_ms = 2000, .phase_ms = 0, .conversion_ms = 0 };
+    sensor_sched_config_t light = { .period_ms = 500, .phase_ms = 250, .conversion_ms = 180 };
+    sensor_sched_t sched;
+    uint32_t reads[2] = { 0 };
+    int64_t now = 1000;
+    int id = -1;
+
+    sensor_sched_init(&sched);
+    TEST_ASSERT_EQUAL(SENSOR_SCHED_NEVER, sensor_sched_next_ms(&sched));
+    TEST_ASSERT_EQUAL(SENSOR_SCHED_IDLE, sensor_sched_poll(&sched, now, &id));
+    TEST_ASSERT_EQUAL(0, sensor_sched_add(&sched, &dht, now));
+    TEST_ASSERT_EQUAL(1, sensor_sched_add(&sched, &light, now));
+
+    /* The DHT is read straight away, the light sensor is started at its
+     * phase and read after its conversion */
+    TEST_ASSERT_EQUAL(SENSOR_SCHED_READ, sensor_sched_poll(&sched, now, &id));
+    TEST_ASSERT_EQUAL(0, id);
+    TEST_ASSERT_EQUAL(SENSOR_SCHED_IDLE, sensor_sched_poll(&sched, now, &id));
+    TEST_ASSERT_EQUAL(1250, sensor_sched_next_ms(&sched));
+    TEST_ASSERT_EQUAL(SENSOR_SCHED_START, sensor_sched_poll(&sched, 1250, &id));
+    TEST_ASSERT_EQUAL(1, id);
+    TEST_ASSERT_EQUAL(1430, sensor_sched_next_ms(&sched));
+    TEST_ASSERT_EQUAL(SENSOR_SCHED_IDLE, sensor_sched_poll(&sched, 1429, &id));
+    TEST_ASSERT_EQUAL(SENSOR_SCHED_READ, sensor_sched_poll(&sched, 1430, &id));
+    TEST_ASSERT_EQUAL(1, id);
+    TEST_ASSERT_EQUAL(1750, sensor_sched_next_ms(&sched));
+
+    /* A minute on: 30 more DHT reads, two light reads a second */
+    now = 1430;
+    run_until(&sched, &now, 61000, reads);
+    TEST_ASSERT_EQUAL(30, reads[0]);
+    TEST_ASSERT_EQUAL(119, reads[1]);
+    TEST_ASSERT_EQUAL(31, sensor_sched_get(&sched, 0)->reads);
+    TEST_ASSERT_EQUAL(0, sensor_sched_get(&sched, 0)->skipped);
+    TEST_ASSERT_EQUAL(0, sensor_sched_get(&sched, 1)->max_late_ms);
+    TEST_ASSERT_EQUAL(61250, sensor_sched_next_ms(&sched));
+}
+
+TEST_CASE("sensor scheduler serves each slot exactly once", "[sensor_scheduler]")
+{
+    sensor_sched_config_t a = { .period_ms = 1000, .phase_ms = 0, .conversion_ms = 0 };
+    sensor_sched_config_t b = { .period_ms = 1000, .phase_ms = 0, .conversion_ms = 100 };
+    sensor_sched_t sched;
+    int id = -1;
+
+    sensor_sched_init(&sched);
+    sensor_sched_add(&sched, &a, 0);
+    sensor_sched_add(&sched, &b, 0);
+
+    /* Ties go by id, and nothing is handed out twice */
+    TEST_ASSERT_EQUAL(SENSOR_SCHED_READ, sensor_sched_poll(&sched, 0, &id));
+    TEST_ASSERT_EQUAL(0, id);
+    TEST_ASSERT_EQUAL(SENSOR_SCHED_START, sensor_sched_poll(&sched, 0, &id));
+    TEST_ASSERT_EQUAL(1, id);
+    TEST_ASSERT_EQUAL(SENSOR_SCHED_IDLE, sensor_sched_poll(&sched, 0, &id));
+
+    /* Served late, the next slot stays on the grid */
+    TEST_ASSERT_EQUAL(SENSOR_SCHED_READ, sensor_sched_poll(&sched, 400, &id));
+    TEST_ASSERT_EQUAL(1, id);
+    TEST_ASSERT_EQUAL(SENSOR_SCHED_READ, sensor_sched_poll(&sched, 1300, &id));
+    TEST_ASSERT_EQUAL(0, id);
+    TEST_ASSERT_EQUAL(300, sensor_sched_get(&sched, 0)->max_late_ms);
+    TEST_ASSERT_EQUAL(SENSOR_SCHED_START, sensor_sched_poll(&sched, 1300, &id));
+    TEST_ASSERT_EQUAL(SENSOR_SCHED_IDLE, sensor_sched_poll(&sched, 1300, &id));
+    TEST_ASSERT_EQUAL(1400, sensor_sched_next_ms(&sched));
+
+    /* Blocked for 3.5 s, the slots at 2, 3 and 4 s are skipped, not read
+     * back to back */
+    TEST_ASSERT_EQUAL(SENSOR_SCHED_READ, sensor_sched_poll(&sched, 4500, &id));
+    TEST_ASSERT_EQUAL(1, id);
+    TEST_ASSERT_EQUAL(3, sensor_sched_get(&sched, 1)->skipped);
+    TEST_ASSERT_EQUAL(SENSOR_SCHED_READ, sensor_sched_poll(&sched, 4500, &id));
+    TEST_ASSERT_EQUAL(0, id);
+    TEST_ASSERT_EQUAL(SENSOR_SCHED_IDLE, sensor_sched_poll(&sched, 4500, &id));
+    TEST_ASSERT_EQUAL(2, sensor_sched_get(&sched, 0)->skipped);
+    TEST_ASSERT_EQUAL(5000, sensor_sched_next_ms(&sched));
+}
+
+TEST_CASE("sensor scheduler aborts or moves a slot and rejects bad configs", "[sensor_scheduler]")
+{
+    sensor_sched_config_t ok = { .period_ms = 1000, .phase_ms = 10, .conversion_ms = 200 };
+    sensor_sched_config_t bad = { .period_ms = 100, .phase_ms = 0, .conversion_ms = 100 };
+    sensor_sched_t sched;
+    int id = -1;
+
+    sensor_sched_init(&sched);
+    TEST_ASSERT_EQUAL(-1, sensor_sched_add(&sched, &bad, 0));
+    bad.period_ms = 0;
+    bad.conversion_ms = 0;
+    TEST_ASSERT_EQUAL(-1, sensor_sched_add(&sched, &bad, 0));
+    for (int i = 0; i < SENSOR_SCHED_MAX_SENSORS; i++) {
+        TEST_ASSERT_EQUAL(i, sensor_sched_add(&sched, &ok, 0));
+    }
+    TEST_ASSERT_EQUAL(-1, sensor_sched_add(&sched, &ok, 0));
+
+    /* Sensor 0 fails to start, its read is dropped */
+    TEST_ASSERT_EQUAL(SENSOR_SCHED_START, sensor_sched_poll(&sched, 10, &id));
+    TEST_ASSERT_EQUAL(0, id);
+    sensor_sched_abort(&sched, 0, 10);
+    for (int i = 1; i < SENSOR_SCHED_MAX_SENSORS; i++) {
+        TEST_ASSERT_EQUAL(SENSOR_SCHED_START, sensor_sched_poll(&sched, 10, &id));
+        TEST_ASSERT_EQUAL(i, id);
+    }
+    for (int i = 1; i < SENSOR_SCHED_MAX_SENSORS; i++) {
+        TEST_ASSERT_EQUAL(SENSOR_SCHED_READ, sensor_sched_poll(&sched, 210, &id));
+        TEST_ASSERT_EQUAL(i, id);
+    }
+    TEST_ASSERT_EQUAL(SENSOR_SCHED_IDLE, sensor_sched_poll(&sched, 210, &id));
+    TEST_ASSERT_EQUAL(0, sensor_sched_get(&sched, 0)->reads);
+    TEST_ASSERT_EQUAL(1010, sensor_sched_next_ms(&sched));
+    TEST_ASSERT_EQUAL(SENSOR_SCHED_START, sensor_sched_poll(&sched, 1010, &id));
+    TEST_ASSERT_EQUAL(0, id);
+
+    /* A conversion may not outlast the period, any more than in the config */
+    TEST_ASSERT_EQUAL(-1, sensor_sched_set_conversion(&sched, 0, 1010, 1000));
+    TEST_ASSERT_EQUAL(1210, sensor_sched_get(&sched, 0)->due_ms);
+
+    /* Sensor 0 converts faster this time, sensor 1 has not started yet */
+    TEST_ASSERT_EQUAL(0, sensor_sched_set_conversion(&sched, 0, 1010, 50));
+    TEST_ASSERT_EQUAL(-1, sensor_sched_set_conversion(&sched, 1, 1010, 50));
+    TEST_ASSERT_EQUAL(1010, sensor_sched_next_ms(&sched));
+    for (int i = 1; i < SENSOR_SCHED_MAX_SENSORS; i++) {
+        TEST_ASSERT_EQUAL(SENSOR_SCHED_START, sensor_sched_poll(&sched, 1010, &id));
+    }
+    TEST_ASSERT_EQUAL(1060, sensor_sched_next_ms(&sched));
+    TEST_ASSERT_EQUAL(SENSOR_SCHED_READ, sensor_sched_poll(&sched, 1060, &id));
+    TEST_ASSERT_EQUAL(0, id);
+    TEST_ASSERT_EQUAL(1210, sensor_sched_next_ms(&sched));
+    TEST_ASSERT_EQUAL(2010, sensor_sched_get(&sched, 0)->due_ms);
+}
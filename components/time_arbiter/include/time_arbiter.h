@@ -0,0 +1,147 @@
+/*
+ * Time source arbiter
+ *
+ * Several sources can set the system clock: SNTP, GNSS and the clock that
+ * survived the last reset (RTC). Each sample comes with an uncertainty. The
+ * clock's own uncertainty is that of the sample it was last set from, grown
+ * by drift_ppm since then. A sample is used when it is at least as good as
+ * the clock, so the best available source wins, and a worse source takes
+ * over once the better one has gone quiet for long enough.
+ *
+ * A used sample steps the clock when it is off by more than
+ * step_threshold_ms or was never set, slews it when it is off by more than
+ * the sample's uncertainty, and otherwise leaves it alone.
+ *
+ * The arbiter only decides, the caller reads and changes the clock, and
+ * passes a monotonic time in ms to every call.
+ */
+#ifndef _TIME_ARBITER_H_
+#define _TIME_ARBITER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** Uncertainty of a clock that was never set */
+#define TIME_ARBITER_UNKNOWN    UINT32_MAX
+
+typedef enum {
+    TIME_SOURCE_NONE = 0,
+    TIME_SOURCE_RTC,
+    TIME_SOURCE_GNSS,
+    TIME_SOURCE_SNTP,
+    TIME_SOURCE_MAX,
+} time_source_t;
+
+/** What to do with the clock after a sample */
+typedef enum {
+    /** The clock is better than the sample, leave it */
+    TIME_ARBITER_REJECT = 0,
+    /** Sample used, the clock is already within its uncertainty */
+    TIME_ARBITER_KEEP,
+    /** Sample used, slew the clock by the correction */
+    TIME_ARBITER_SLEW,
+    /** Sample used, step the clock by the correction */
+    TIME_ARBITER_STEP,
+} time_arbiter_action_t;
+
+/** Arbiter tuning */
+typedef struct {
+    /** Drift of the system clock, grows the uncertainty between samples */
+    uint32_t drift_ppm;
+    /** Largest correction that is slewed rather than stepped */
+    uint32_t step_threshold_ms;
+} time_arbiter_config_t;
+
+#define TIME_ARBITER_CONFIG_DEFAULT()   \
+    {                                   \
+        .drift_ppm = 100,               \
+        .step_threshold_ms = 1000,      \
+    }
+
+/** Per source counters */
+typedef struct {
+    uint32_t samples;
+    uint32_t used;
+    /** Last sample minus the clock, positive if the clock was behind */
+    int64_t last_offset_ms;
+    uint32_t last_uncertainty_ms;
+    /** Monotonic time of the last sample, 0 if none */
+    int64_t last_mono_ms;
+} time_source_stats_t;
+
+/** Arbiter context
+ *
+ * Please do not set/modify any elements.
+ */
+typedef struct {
+    time_arbiter_config_t config;
+    /** Source the clock was last set from */
+    time_source_t source;
+    /** Uncertainty of the clock at base_mono_ms */
+    uint32_t base_uncertainty_ms;
+    int64_t base_mono_ms;
+    time_source_stats_t stats[TIME_SOURCE_MAX];
+} time_arbiter_t;
+
+/** Initialise an arbiter, the clock starts unset
+ *
+ * \param[out] ta Arbiter context
+ * \param[in] config Tuning, NULL for TIME_ARBITER_CONFIG_DEFAULT()
+ */
+void time_arbiter_init(time_arbiter_t *ta, const time_arbiter_config_t *config);
+
+/** Offer a sample
+ *
+ * \param[in] ta Arbiter context
+ * \param[in] source Source of the sample
+ * \param[in] mono_ms Monotonic time of the sample
+ * \param[in] clock_ms The clock when the sample was taken, Unix time
+ * \param[in] sample_ms The sample, Unix time
+ * \param[in] uncertainty_ms Uncertainty of the sample
+ * \param[out] correction_ms What to add to the clock for TIME_ARBITER_SLEW
+ * and TIME_ARBITER_STEP, 0 otherwise
+ *
+ * \return What to do with the clock
+ */
+time_arbiter_action_t time_arbiter_offer(time_arbiter_t *ta, time_source_t source, int64_t mono_ms,
+                                         int64_t clock_ms, int64_t sample_ms, uint32_t uncertainty_ms,
+                                         int64_t *correction_ms);
+
+/** Uncertainty of the clock
+ *
+ * \param[in] ta Arbiter context
+ * \param[in] mono_ms Monotonic time now
+ *
+ * \return Uncertainty in ms, TIME_ARBITER_UNKNOWN if the clock was never set
+ */
+uint32_t time_arbiter_uncertainty_ms(const time_arbiter_t *ta, int64_t mono_ms);
+
+/** Source the clock was last set from, TIME_SOURCE_NONE if never
+ *
+ * \param[in] ta Arbiter context
+ */
+static inline time_source_t time_arbiter_source(const time_arbiter_t *ta)
+{
+    return ta->source;
+}
+
+/** Counters of a source
+ *
+ * \param[in] ta Arbiter context
+ * \param[in] source The source
+ */
+static inline const time_source_stats_t *time_arbiter_get_stats(const time_arbiter_t *ta, time_source_t source)
+{
+    return &ta->stats[source];
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _TIME_ARBITER_H_ */
@@ -0,0 +1,61 @@
+#include <string.h>
+#include <time_arbiter.h>
+
+void time_arbiter_init(time_arbiter_t *ta, const time_arbiter_config_t *config)
+{
+    static const time_arbiter_config_t default_config = TIME_ARBITER_CONFIG_DEFAULT();
+
+    memset(ta, 0, sizeof(time_arbiter_t));
+    ta->config = config ? *config : default_config;
+    ta->base_uncertainty_ms = TIME_ARBITER_UNKNOWN;
+}
+
+uint32_t time_arbiter_uncertainty_ms(const time_arbiter_t *ta, int64_t mono_ms)
+{
+    if (ta->source == TIME_SOURCE_NONE) {
+        return TIME_ARBITER_UNKNOWN;
+    }
+    int64_t age_ms = mono_ms > ta->base_mono_ms ? mono_ms - ta->base_mono_ms : 0;
+    int64_t uncertainty = ta->base_uncertainty_ms + age_ms * ta->config.drift_ppm / 1000000;
+    return uncertainty < TIME_ARBITER_UNKNOWN ? (uint32_t)uncertainty : TIME_ARBITER_UNKNOWN - 1;
+}
+
+time_arbiter_action_t time_arbiter_offer(time_arbiter_t *ta, time_source_t source, int64_t mono_ms,
+                                         int64_t clock_ms, int64_t sample_ms, uint32_t uncertainty_ms,
+                                         int64_t *correction_ms)
+{
+    int64_t offset = sample_ms - clock_ms;
+    uint64_t abs_offset = offset < 0 ? -(uint64_t)offset : (uint64_t)offset;
+
+    *correction_ms = 0;
+    if (source <= TIME_SOURCE_NONE || source >= TIME_SOURCE_MAX) {
+        return TIME_ARBITER_REJECT;
+    }
+    time_source_stats_t *stats = &ta->stats[source];
+    stats->samples++;
+    stats->last_offset_ms = offset;
+    stats->last_uncertainty_ms = uncertainty_ms;
+    stats->last_mono_ms = mono_ms;
+
+    bool was_set = ta->source != TIME_SOURCE_NONE;
+    if (was_set && uncertainty_ms > time_arbiter_uncertainty_ms(ta, mono_ms)) {
+        return TIME_ARBITER_REJECT;
+    }
+    stats->used++;
+    ta->source = source;
+    ta->base_uncertainty_ms = uncertainty_ms;
+    ta->base_mono_ms = mono_ms;
+
+    if (!was_set || abs_offset > ta->config.step_threshold_ms) {
+        *correction_ms = offset;
+        return TIME_ARBITER_STEP;
+    }
+    if (abs_offset <= uncertainty_ms) {
+        return TIME_ARBITER_KEEP;
+    }
+    /* Off by up to the correction until the slew is done. A later sample
+     * replaces what is left of it. */
+    ta->base_uncertainty_ms += (uint32_t)abs_offset;
+    *correction_ms = offset;
+    return TIME_ARBITER_SLEW;
+}
@@ -0,0 +1,118 @@
+#include <stdio.h>
+#include "time_arbiter.h"
+#include "unity.h"
+
+#define T0_MS   1700000000000LL
+
+TEST_CASE("time arbiter steps an unset clock from any source", "[time_arbiter]")
+{
+    time_arbiter_t ta;
+    int64_t correction;
+
+    time_arbiter_init(&ta, NULL);
+    TEST_ASSERT_EQUAL(TIME_SOURCE_NONE, time_arbiter_source(&ta));
+    TEST_ASSERT_EQUAL(TIME_ARBITER_UNKNOWN, time_arbiter_uncertainty_ms(&ta, 0));
+
+    /* GNSS a few seconds after boot, the clock still at 1970 */
+    TEST_ASSERT_EQUAL(TIME_ARBITER_STEP, time_arbiter_offer(&ta, TIME_SOURCE_GNSS, 3000, 3000,
+                                                           T0_MS, 1000, &correction));
+    TEST_ASSERT_EQUAL(T0_MS - 3000, correction);
+    TEST_ASSERT_EQUAL(TIME_SOURCE_GNSS, time_arbiter_source(&ta));
+    TEST_ASSERT_EQUAL(1000, time_arbiter_uncertainty_ms(&ta, 3000));
+    /* 100 ppm, 0.1 ms per second */
+    TEST_ASSERT_EQUAL(1360, time_arbiter_uncertainty_ms(&ta, 3000 + 3600 * 1000));
+
+    /* Even a zero offset sets an unset clock, e.g. the RTC after a reset */
+    time_arbiter_init(&ta, NULL);
+    TEST_ASSERT_EQUAL(TIME_ARBITER_STEP, time_arbiter_offer(&ta, TIME_SOURCE_RTC, 100, T0_MS, T0_MS,
+                                                           10000, &correction));
+    TEST_ASSERT_EQUAL(0, correction);
+    TEST_ASSERT_EQUAL(TIME_SOURCE_RTC, time_arbiter_source(&ta));
+
+    /* Invalid sources are ignored */
+    TEST_ASSERT_EQUAL(TIME_ARBITER_REJECT, time_arbiter_offer(&ta, TIME_SOURCE_NONE, 100, T0_MS, 0, 0,
+                                                             &correction));
+    TEST_ASSERT_EQUAL(TIME_ARBITER_REJECT, time_arbiter_offer(&ta, TIME_SOURCE_MAX, 100, T0_MS, 0, 0,
+                                                             &correction));
+    TEST_ASSERT_EQUAL(TIME_SOURCE_RTC, time_arbiter_source(&ta));
+}
+
+TEST_CASE("time arbiter prefers the best source until it ages", "[time_arbiter]")
+{
+    time_arbiter_t ta;
+    int64_t correction;
+    int64_t mono = 1000;
+
+    time_arbiter_init(&ta, NULL);
+    time_arbiter_offer(&ta, TIME_SOURCE_RTC, mono, T0_MS, T0_MS, 10000, &correction);
+
+    /* GNSS beats the RTC, 5 s off is stepped */
+    mono += 2000;
+    TEST_ASSERT_EQUAL(TIME_ARBITER_STEP, time_arbiter_offer(&ta, TIME_SOURCE_GNSS, mono, T0_MS + 2000,
+                                                           T0_MS + 7000, 1000, &correction));
+    TEST_ASSERT_EQUAL(5000, correction);
+
+    /* SNTP beats GNSS, 300 ms off is slewed */
+    mono += 1000;
+    TEST_ASSERT_EQUAL(TIME_ARBITER_SLEW, time_arbiter_offer(&ta, TIME_SOURCE_SNTP, mono, T0_MS + 8000,
+                                                           T0_MS + 8300, 50, &correction));
+    TEST_ASSERT_EQUAL(300, correction);
+    TEST_ASSERT_EQUAL(TIME_SOURCE_SNTP, time_arbiter_source(&ta));
+
+    /* A GNSS fix a second later finds the clock mid slew, but it is worse
+     * than SNTP, which is only known to 50 ms plus the slew */
+    mono += 1000;
+    TEST_ASSERT_EQUAL(TIME_ARBITER_REJECT, time_arbiter_offer(&ta, TIME_SOURCE_GNSS, mono, T0_MS + 9200,
+                                                             T0_MS + 9300, 1000, &correction));
+    TEST_ASSERT_EQUAL(0, correction);
+    TEST_ASSERT_EQUAL(100, time_arbiter_get_stats(&ta, TIME_SOURCE_GNSS)->last_offset_ms);
+
+    /* SNTP again, clock within 50 ms */
+    mono += 1000;
+    TEST_ASSERT_EQUAL(TIME_ARBITER_KEEP, time_arbiter_offer(&ta, TIME_SOURCE_SNTP, mono, T0_MS + 10300,
+                                                           T0_MS + 10320, 50, &correction));
+    TEST_ASSERT_EQUAL(50, time_arbiter_uncertainty_ms(&ta, mono));
+
+    /* Without SNTP GNSS takes over once the clock is known worse than 1 s,
+     * after 950 ms / 100 ppm = 9500 s */
+    TEST_ASSERT_EQUAL(TIME_ARBITER_REJECT, time_arbiter_offer(&ta, TIME_SOURCE_GNSS, mono + 9000 * 1000,
+                                                             T0_MS, T0_MS, 1000, &correction));
+    TEST_ASSERT_EQUAL(TIME_ARBITER_KEEP, time_arbiter_offer(&ta, TIME_SOURCE_GNSS, mono + 9600 * 1000,
+                                                           T0_MS, T0_MS + 500, 1000, &correction));
+    TEST_ASSERT_EQUAL(TIME_SOURCE_GNSS, time_arbiter_source(&ta));
+
+    /* GNSS keeps refreshing itself */
+    mono += 9601 * 1000;
+    TEST_ASSERT_EQUAL(TIME_ARBITER_SLEW, time_arbiter_offer(&ta, TIME_SOURCE_GNSS, mono, T0_MS,
+                                                           T0_MS - 1000, 900, &correction));
+    TEST_ASSERT_EQUAL(-1000, correction);
+
+    const time_source_stats_t *stats = time_arbiter_get_stats(&ta, TIME_SOURCE_GNSS);
+    TEST_ASSERT_EQUAL(5, stats->samples);
+    TEST_ASSERT_EQUAL(3, stats->used);
+    TEST_ASSERT_EQUAL(-1000, stats->last_offset_ms);
+    TEST_ASSERT_EQUAL(mono, stats->last_mono_ms);
+    TEST_ASSERT_EQUAL(2, time_arbiter_get_stats(&ta, TIME_SOURCE_SNTP)->used);
+}
+
+TEST_CASE("time arbiter honours its configuration", "[time_arbiter]")
+{
+    time_arbiter_config_t config = { .drift_ppm = 0, .step_threshold_ms = 60000 };
+    time_arbiter_t ta;
+    int64_t correction;
+
+    time_arbiter_init(&ta, &config);
+    time_arbiter_offer(&ta, TIME_SOURCE_SNTP, 0, 0, T0_MS, 100, &correction);
+
+    /* No drift, the clock never gets worse */
+    TEST_ASSERT_EQUAL(100, time_arbiter_uncertainty_ms(&ta, INT64_MAX / 2));
+    TEST_ASSERT_EQUAL(TIME_ARBITER_REJECT, time_arbiter_offer(&ta, TIME_SOURCE_GNSS, 1000000, T0_MS,
+                                                             T0_MS, 101, &correction));
+    /* Up to a minute is slewed */
+    TEST_ASSERT_EQUAL(TIME_ARBITER_SLEW, time_arbiter_offer(&ta, TIME_SOURCE_SNTP, 2000000, T0_MS,
+                                                           T0_MS - 59000, 100, &correction));
+    TEST_ASSERT_EQUAL(-59000, correction);
+    TEST_ASSERT_EQUAL(TIME_ARBITER_STEP, time_arbiter_offer(&ta, TIME_SOURCE_SNTP, 3000000, T0_MS,
+                                                           T0_MS + 61000, 100, &correction));
+    TEST_ASSERT_EQUAL(61000, correction);
+}
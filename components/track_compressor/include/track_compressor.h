@@ -0,0 +1,159 @@
+/*
+ * Track compressor for GPS history upload
+ *
+ * Fixes are simplified online with an opening window: a point is dropped as
+ * long as every dropped point since the last kept one lies within
+ * tolerance_m of the straight, constant speed segment between the kept
+ * points, measured at its own time (synchronised euclidean distance). A track
+ * rebuilt by linear interpolation of the kept points is therefore never
+ * further than tolerance_m from any raw fix.
+ *
+ * Kept points are encoded into a batch as zigzag varints of the difference
+ * to the previous point, coordinates in micro-degrees and time in ms. The
+ * first point of each batch is relative to zero, so every batch can be
+ * decoded on its own with track_decode().
+ *
+ * Batch format:
+ *   uint8  version, TRACK_FORMAT_VERSION
+ *   then per point: varint zz(dt_ms), varint zz(dlat_e6), varint zz(dlon_e6)
+ */
+#ifndef _TRACK_COMPRESSOR_H_
+#define _TRACK_COMPRESSOR_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define TRACK_FORMAT_VERSION    1
+/** Longest encoding of one point */
+#define TRACK_POINT_MAX_BYTES   (10 + 5 + 5)
+/** Points held back while deciding which to keep. A full window keeps its
+ * last point, which bounds the time between kept points. */
+#define TRACK_WINDOW_SIZE       32
+
+/** A fix, in fixed point */
+typedef struct {
+    /** Time, any epoch, must not go backwards */
+    int64_t time_ms;
+    /** Decimal degrees x 1e6, north and east positive */
+    int32_t lat_e6;
+    int32_t lon_e6;
+} track_point_t;
+
+/** Counters, all cumulative since track_compressor_init() */
+typedef struct {
+    /** Points added */
+    uint32_t points_in;
+    /** Points encoded */
+    uint32_t points_out;
+    /** Bytes of finished batches */
+    uint32_t bytes_out;
+    /** Largest distance of a dropped point from the encoded track, in metres */
+    float max_error_m;
+} track_compressor_stats_t;
+
+/** Compressor context
+ *
+ * Please do not set/modify any elements.
+ */
+typedef struct {
+    float tolerance_m;
+    uint8_t *buf;
+    size_t size;
+    size_t len;
+    /** Part of the batch already in stats.bytes_out */
+    size_t counted;
+    /** Previous encoded point, base of the next delta */
+    track_point_t prev;
+    /** Last kept point, start of the segment being extended */
+    track_point_t anchor;
+    bool has_anchor;
+    /** Metres per micro-degree of longitude near the anchor */
+    float m_per_lon_e6;
+    track_point_t window[TRACK_WINDOW_SIZE];
+    int window_len;
+    /** Error of the dropped points against anchor..window[window_len - 1] */
+    float window_error_m;
+    track_compressor_stats_t stats;
+} track_compressor_t;
+
+/** Initialise a compressor and start the first batch
+ *
+ * \param[out] tc Compressor context
+ * \param[in] tolerance_m Largest allowed distance of a dropped point from
+ * the simplified track, 0 keeps every point
+ * \param[in] buf Batch buffer, must stay valid while the compressor is in use
+ * \param[in] size Size of buf, at least 1 + 2 * TRACK_POINT_MAX_BYTES
+ *
+ * \return 0 on success
+ * \return -1 if an argument is invalid
+ */
+int track_compressor_init(track_compressor_t *tc, float tolerance_m, uint8_t *buf, size_t size);
+
+/** Add a fix
+ *
+ * \param[in] tc Compressor context
+ * \param[in] point The fix. Points older than the previous one are ignored.
+ *
+ * \return true if the batch is nearly full and should be finished now.
+ * Points added to a full batch are dropped.
+ */
+bool track_compressor_add(track_compressor_t *tc, const track_point_t *point);
+
+/** Finish the batch
+ *
+ * The latest point is encoded even if it would otherwise be held back, so
+ * the batch reaches up to the last fix. Call track_compressor_next_batch()
+ * once the batch has been sent.
+ *
+ * \param[in] tc Compressor context
+ *
+ * \return Length of the batch in the buffer passed to track_compressor_init(),
+ * 0 if it has no points
+ */
+size_t track_compressor_finish(track_compressor_t *tc);
+
+/** Start a new batch, simplification carries on from the last kept point
+ *
+ * \param[in] tc Compressor context
+ */
+void track_compressor_next_batch(track_compressor_t *tc);
+
+/** Counters
+ *
+ * \param[in] tc Compressor context
+ */
+static inline const track_compressor_stats_t *track_compressor_get_stats(const track_compressor_t *tc)
+{
+    return &tc->stats;
+}
+
+/** Compression ratio of the finished batches against raw track_point_t
+ * records of all added points, 0 if nothing was finished yet
+ *
+ * \param[in] tc Compressor context
+ */
+float track_compressor_ratio(const track_compressor_t *tc);
+
+/** Decode a batch
+ *
+ * \param[in] buf Batch
+ * \param[in] len Length of buf
+ * \param[out] points Decoded points
+ * \param[in] max_points Size of points
+ *
+ * \return Number of points, more than max_points if points was too small
+ * \return -1 if the batch is malformed
+ */
+int track_decode(const uint8_t *buf, size_t len, track_point_t *points, int max_points);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _TRACK_COMPRESSOR_H_ */
@@ -0,0 +1,193 @@
+#include <string.h>
+#include <math.h>
+#include <track_compressor.h>
+
+/* Metres per micro-degree of latitude, mean earth radius */
+#define M_PER_E6                (6371008.8 * M_PI / 180.0 / 1e6)
+
+static size_t varint_put(uint8_t *buf, int64_t value)
+{
+    /* Zigzag, small negative numbers become small positive ones */
+    uint64_t v = ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+    size_t n = 0;
+    while (v >= 0x80) {
+        buf[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    buf[n++] = (uint8_t)v;
+    return n;
+}
+
+static bool varint_get(const uint8_t *buf, size_t len, size_t *pos, int64_t *value)
+{
+    uint64_t v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (*pos >= len) {
+            return false;
+        }
+        uint8_t b = buf[(*pos)++];
+        v |= (uint64_t)(b & 0x7f) << shift;
+        if (!(b & 0x80)) {
+            *value = (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool batch_is_full(const track_compressor_t *tc)
+{
+    return tc->size - tc->len < 2 * TRACK_POINT_MAX_BYTES;
+}
+
+static void track_emit(track_compressor_t *tc, const track_point_t *point)
+{
+    uint8_t *p = tc->buf + tc->len;
+    p += varint_put(p, point->time_ms - tc->prev.time_ms);
+    p += varint_put(p, (int64_t)point->lat_e6 - tc->prev.lat_e6);
+    p += varint_put(p, (int64_t)point->lon_e6 - tc->prev.lon_e6);
+    tc->len = p - tc->buf;
+    tc->prev = *point;
+    tc->stats.points_out++;
+}
+
+static void track_set_anchor(track_compressor_t *tc, const track_point_t *point)
+{
+    tc->anchor = *point;
+    tc->has_anchor = true;
+    tc->m_per_lon_e6 = M_PER_E6 * cos(point->lat_e6 / 1e6 * M_PI / 180.0);
+}
+
+/* Keep the last point of the window, dropping the ones before it */
+static void track_keep_window(track_compressor_t *tc)
+{
+    const track_point_t *last = &tc->window[tc->window_len - 1];
+    track_emit(tc, last);
+    if (tc->window_error_m > tc->stats.max_error_m) {
+        tc->stats.max_error_m = tc->window_error_m;
+    }
+    track_set_anchor(tc, last);
+    tc->window_len = 0;
+    tc->window_error_m = 0;
+}
+
+/* Distance of p from the segment a..b at p's time */
+static float track_sed(const track_compressor_t *tc, const track_point_t *a,
+                       const track_point_t *b, const track_point_t *p)
+{
+    double f = 0;
+    if (b->time_ms > a->time_ms) {
+        f = (double)(p->time_ms - a->time_ms) / (b->time_ms - a->time_ms);
+    }
+    double lat = a->lat_e6 + f * ((double)b->lat_e6 - a->lat_e6);
+    double lon = a->lon_e6 + f * ((double)b->lon_e6 - a->lon_e6);
+    double dn = (p->lat_e6 - lat) * M_PER_E6;
+    double de = (p->lon_e6 - lon) * tc->m_per_lon_e6;
+    return sqrt(dn * dn + de * de);
+}
+
+int track_compressor_init(track_compressor_t *tc, float tolerance_m, uint8_t *buf, size_t size)
+{
+    if (!tc || !buf || size < 1 + 2 * TRACK_POINT_MAX_BYTES || !(tolerance_m >= 0)) {
+        return -1;
+    }
+    memset(tc, 0, sizeof(track_compressor_t));
+    tc->tolerance_m = tolerance_m;
+    tc->buf = buf;
+    tc->size = size;
+    track_compressor_next_batch(tc);
+    return 0;
+}
+
+bool track_compressor_add(track_compressor_t *tc, const track_point_t *point)
+{
+    if (batch_is_full(tc)) {
+        return true;
+    }
+    const track_point_t *latest = tc->window_len ? &tc->window[tc->window_len - 1] : &tc->anchor;
+    if (tc->has_anchor && point->time_ms < latest->time_ms) {
+        return false;
+    }
+    tc->stats.points_in++;
+
+    if (!tc->has_anchor || tc->tolerance_m == 0) {
+        track_emit(tc, point);
+        track_set_anchor(tc, point);
+        return batch_is_full(tc);
+    }
+
+    /* Can the segment stretch to the new point? */
+    float error = 0;
+    for (int i = 0; i < tc->window_len && error <= tc->tolerance_m; i++) {
+        float e = track_sed(tc, &tc->anchor, point, &tc->window[i]);
+        error = e > error ? e : error;
+    }
+    if (error > tc->tolerance_m || tc->window_len == TRACK_WINDOW_SIZE) {
+        track_keep_window(tc);
+        error = 0;
+    }
+    tc->window[tc->window_len++] = *point;
+    tc->window_error_m = error;
+    return batch_is_full(tc);
+}
+
+size_t track_compressor_finish(track_compressor_t *tc)
+{
+    if (tc->window_len) {
+        track_keep_window(tc);
+    }
+    if (tc->len <= 1) {
+        return 0;
+    }
+    tc->stats.bytes_out += tc->len - tc->counted;
+    tc->counted = tc->len;
+    return tc->len;
+}
+
+void track_compressor_next_batch(track_compressor_t *tc)
+{
+    tc->buf[0] = TRACK_FORMAT_VERSION;
+    tc->len = 1;
+    tc->counted = 1;
+    memset(&tc->prev, 0, sizeof(track_point_t));
+}
+
+float track_compressor_ratio(const track_compressor_t *tc)
+{
+    if (tc->stats.bytes_out == 0) {
+        return 0;
+    }
+    return (float)tc->stats.points_in * sizeof(track_point_t) / tc->stats.bytes_out;
+}
+
+int track_decode(const uint8_t *buf, size_t len, track_point_t *points, int max_points)
+{
+    if (!buf || len < 1 || buf[0] != TRACK_FORMAT_VERSION) {
+        return -1;
+    }
+    track_point_t p = { 0 };
+    size_t pos = 1;
+    int count = 0;
+    while (pos < len) {
+        int64_t dt;
+        int64_t dlat;
+        int64_t dlon;
+        if (!varint_get(buf, len, &pos, &dt) || !varint_get(buf, len, &pos, &dlat) ||
+            !varint_get(buf, len, &pos, &dlon)) {
+            return -1;
+        }
+        int64_t lat = p.lat_e6 + dlat;
+        int64_t lon = p.lon_e6 + dlon;
+        if (lat < -90000000 || lat > 90000000 || lon < -180000000 || lon > 180000000) {
+            return -1;
+        }
+        p.time_ms += dt;
+        p.lat_e6 = (int32_t)lat;
+        p.lon_e6 = (int32_t)lon;
+        if (count < max_points) {
+            points[count] = p;
+        }
+        count++;
+    }
+    return count;
+}
@@ -0,0 +1,179 @@
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "track_compressor.h"
+#include "unity.h"
+
+#define TRACK_LEN       3600
+#define BATCH_SIZE      256
+#define M_PER_E6        (6371008.8 * M_PI / 180.0 / 1e6)
+
+static track_point_t s_raw[TRACK_LEN];
+static track_point_t s_decoded[TRACK_LEN];
+
+static uint32_t s_seed;
+
+/* Uniform in [-1, 1], repeatable */
+static double noise(void)
+{
+    s_seed = s_seed * 1664525 + 1013904223;
+    return (s_seed >> 8) / (double)(1 << 23) - 1;
+}
+
+/* An hour at 1 Hz: town driving with turns, traffic lights and a long stop,
+ * with 2 m of GNSS noise */
+static void make_track(void)
+{
+    double lat = 31.230416;
+    double lon = 121.473701;
+    double heading = 0;
+    double m_per_deg_lon = M_PER_E6 * 1e6 * cos(lat * M_PI / 180);
+
+    s_seed = 1;
+    for (int i = 0; i < TRACK_LEN; i++) {
+        double speed = 12;
+        if ((i % 300) >= 240 && (i % 300) < 270) {
+            speed = 0;          /* red light */
+        } else if (i >= 1800 && i < 2400) {
+            speed = 0;          /* parked */
+        }
+        if ((i % 120) < 10) {
+            heading += 9;       /* 90 degree turn every two minutes */
+        }
+        lat += speed * cos(heading * M_PI / 180) / (M_PER_E6 * 1e6);
+        lon += speed * sin(heading * M_PI / 180) / m_per_deg_lon;
+        s_raw[i].time_ms = 1700000000000LL + i * 1000LL;
+        s_raw[i].lat_e6 = (int32_t)lround(lat * 1e6 + noise() * 2 / M_PER_E6);
+        s_raw[i].lon_e6 = (int32_t)lround((lon + noise() * 2 / m_per_deg_lon) * 1e6);
+    }
+}
+
+/* Compress the whole track, decoding every batch into s_decoded */
+static int compress_track(track_compressor_t *tc, float tolerance_m, int *batches)
+{
+    static uint8_t buf[BATCH_SIZE];
+    int count = 0;
+
+    *batches = 0;
+    TEST_ASSERT_EQUAL(0, track_compressor_init(tc, tolerance_m, buf, sizeof(buf)));
+    for (int i = 0; i < TRACK_LEN; i++) {
+        bool full = track_compressor_add(tc, &s_raw[i]);
+        if (full || i == TRACK_LEN - 1) {
+            size_t len = track_compressor_finish(tc);
+            TEST_ASSERT_TRUE(len > 1 && len <= sizeof(buf));
+            int n = track_decode(buf, len, s_decoded + count, TRACK_LEN - count);
+            TEST_ASSERT_TRUE(n > 0 && n <= TRACK_LEN - count);
+            count += n;
+            (*batches)++;
+            track_compressor_next_batch(tc);
+        }
+    }
+    return count;
+}
+
+/* Distance of each raw fix from the decoded track at the same time */
+static double max_track_error(int count)
+{
+    double max_error = 0;
+    int j = 0;
+    for (int i = 0; i < TRACK_LEN; i++) {
+        const track_point_t *p = &s_raw[i];
+        while (j + 1 < count && s_decoded[j + 1].time_ms <= p->time_ms) {
+            j++;
+        }
+        const track_point_t *a = &s_decoded[j];
+        const track_point_t *b = &s_decoded[j + 1 < count ? j + 1 : j];
+        double f = b->time_ms > a->time_ms ? (double)(p->time_ms - a->time_ms) / (b->time_ms - a->time_ms) : 0;
+        double dn = (p->lat_e6 - (a->lat_e6 + f * ((double)b->lat_e6 - a->lat_e6))) * M_PER_E6;
+        double de = (p->lon_e6 - (a->lon_e6 + f * ((double)b->lon_e6 - a->lon_e6))) * M_PER_E6 *
+                    cos(p->lat_e6 / 1e6 * M_PI / 180);
+        double e = sqrt(dn * dn + de * de);
+        max_error = e > max_error ? e : max_error;
+    }
+    return max_error;
+}
+
+TEST_CASE("track compressor stays within tolerance of the raw track", "[track_compressor]")
+{
+    static const float tolerances[] = { 5, 10, 25 };
+    track_compressor_t tc;
+    int batches;
+
+    make_track();
+    for (int t = 0; t < sizeof(tolerances) / sizeof(tolerances[0]); t++) {
+        int count = compress_track(&tc, tolerances[t], &batches);
+        const track_compressor_stats_t *stats = track_compressor_get_stats(&tc);
+        double error = max_track_error(count);
+
+        printf("tolerance %.0f m: %d of %d points kept in %d batches, %lu bytes, ratio %.1f, "
+               "max error %.2f m\n", tolerances[t], count, TRACK_LEN, batches,
+               (unsigned long)stats->bytes_out, track_compressor_ratio(&tc), error);
+        TEST_ASSERT_EQUAL(TRACK_LEN, stats->points_in);
+        TEST_ASSERT_EQUAL(count, stats->points_out);
+        TEST_ASSERT_EQUAL(s_raw[0].time_ms, s_decoded[0].time_ms);
+        TEST_ASSERT_EQUAL(s_raw[TRACK_LEN - 1].time_ms, s_decoded[count - 1].time_ms);
+        /* The reported error is the real one */
+        TEST_ASSERT_TRUE(error <= tolerances[t] + 0.01);
+        TEST_ASSERT_TRUE(fabs(error - stats->max_error_m) < 0.01);
+        /* A kept point at least every TRACK_WINDOW_SIZE fixes */
+        for (int i = 1; i < count; i++) {
+            TEST_ASSERT_TRUE(s_decoded[i].time_ms - s_decoded[i - 1].time_ms <= TRACK_WINDOW_SIZE * 1000);
+        }
+    }
+    /* 10 m keeps well under a tenth of the 16 byte raw records */
+    compress_track(&tc, 10, &batches);
+    TEST_ASSERT_TRUE(track_compressor_ratio(&tc) > 10);
+}
+
+TEST_CASE("track compressor is lossless at zero tolerance", "[track_compressor]")
+{
+    track_compressor_t tc;
+    int batches;
+
+    make_track();
+    int count = compress_track(&tc, 0, &batches);
+    TEST_ASSERT_EQUAL(TRACK_LEN, count);
+    TEST_ASSERT_EQUAL(0, memcmp(s_raw, s_decoded, sizeof(s_raw)));
+    TEST_ASSERT_EQUAL(0, track_compressor_get_stats(&tc)->max_error_m);
+    /* Delta coding alone still beats the raw records */
+    TEST_ASSERT_TRUE(track_compressor_ratio(&tc) > 2);
+}
+
+TEST_CASE("track compressor encodes extreme deltas", "[track_compressor]")
+{
+    static const track_point_t points[] = {
+        { 0, 0, 0 },
+        { 1, 90000000, 179999999 },
+        { 2, -90000000, -179999999 },
+        { 1700000000000LL, -1, 1 },
+        { INT64_MAX / 2, 45000000, -90000000 },
+    };
+    uint8_t buf[1 + 5 * TRACK_POINT_MAX_BYTES + TRACK_POINT_MAX_BYTES];
+    track_point_t out[8];
+    track_compressor_t tc;
+    int n = sizeof(points) / sizeof(points[0]);
+
+    TEST_ASSERT_EQUAL(0, track_compressor_init(&tc, 0, buf, sizeof(buf)));
+    for (int i = 0; i < n; i++) {
+        track_compressor_add(&tc, &points[i]);
+    }
+    /* Going back in time is ignored */
+    track_compressor_add(&tc, &points[2]);
+    size_t len = track_compressor_finish(&tc);
+    TEST_ASSERT_EQUAL(n, track_decode(buf, len, out, 8));
+    TEST_ASSERT_EQUAL(0, memcmp(points, out, sizeof(points)));
+    /* points too small, the count is still returned */
+    TEST_ASSERT_EQUAL(n, track_decode(buf, len, out, 2));
+
+    /* Malformed batches */
+    TEST_ASSERT_EQUAL(-1, track_decode(buf, len - 1, out, 8));
+    buf[0] = TRACK_FORMAT_VERSION + 1;
+    TEST_ASSERT_EQUAL(-1, track_decode(buf, len, out, 8));
+    TEST_ASSERT_EQUAL(-1, track_decode(buf, 0, out, 8));
+
+    /* An empty batch has nothing to send */
+    track_compressor_next_batch(&tc);
+    TEST_ASSERT_EQUAL(0, track_compressor_finish(&tc));
+    TEST_ASSERT_EQUAL(-1, track_compressor_init(&tc, 0, buf, 2 * TRACK_POINT_MAX_BYTES));
+    TEST_ASSERT_EQUAL(-1, track_compressor_init(&tc, -1, buf, sizeof(buf)));
+}
@@ -5,7 +5,8 @@
 #include "esp_flash_partitions.h"
 #include "esp_app_format.h"
 #include "driver/gpio.h"
-#include "cJSON.h"
+#include "esp_system.h"
+#include "json_stream.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include <string.h>
@@ -14,9 +15,21 @@ static const char *TAG = "OTA_API";
 
 #define BUFFSIZE 1024
 #define HASH_LEN 32 /* SHA-256 digest length */
+#define OTA_VERSION_SIZE 32
 
 
 static char ota_write_data[BUFFSIZE + 1] = { 0 };
+
+// 正在接收的OTA消息，消息可能分多个MQTT分片到达
+typedef struct {
+    json_stream_t stream;              // 流式解析器
+    size_t received;                   // 已接收的字节数
+    bool active;                       // 消息接收中且未出错
+    char version[OTA_VERSION_SIZE];    // version字段
+    char url[OTA_URL_SIZE];            // url字段
+} ota_msg_t;
+
+static ota_msg_t s_ota_msg;
 extern const uint8_t server_cert_pem_start[] asm("_binary_ca_cert_pem_start");
 extern const uint8_t server_cert_pem_end[] asm("_binary_ca_cert_pem_end");
 
@@ -324,40 +337,90 @@ static void ota_task(void *pvParameter)
     return ;
 }
 
+// 只取根对象的version和url字符串，其他字段忽略
+static int ota_msg_cb(const json_stream_event_t *event, void *priv)
+{
+    ota_msg_t *msg = (ota_msg_t *)priv;
+
+    if (event->depth == 0) {
+        // 根必须是对象
+        return (event->type == JSON_STREAM_OBJECT_START || event->type == JSON_STREAM_OBJECT_END) ? 0 : -1;
+    }
+    if (event->depth != 1 || event->type != JSON_STREAM_STRING) {
+        return 0;
+    }
+
+    char *dst;
+    size_t size;
+    if (strcmp(event->key, "version") == 0) {
+        dst = msg->version;
+        size = sizeof(msg->version);
+    } else if (strcmp(event->key, "url") == 0) {
+        dst = msg->url;
+        size = sizeof(msg->url);
+    } else {
+        return 0;
+    }
+    if ((size_t)event->value_len >= size) {
+        ESP_LOGE(TAG, "%s字段过长", event->key);
+        return -1;
+    }
+    memcpy(dst, event->value, event->value_len + 1);
+    return 0;
+}
+
 /**
  * @brief MQTT OTA处理函数
  * 
- * @param mqtt_data MQTT消息数据(JSON格式：{"version": "x.y.z", "url": "http://firmware-url"})
- * @param data_len 数据长度
- * @return esp_err_t ESP_OK:成功处理  ESP_FAIL:处理失败
+ * 消息超出MQTT接收缓冲区时分多个分片到达，逐片流式解析，最后一个分片到达后处理。
+ * 
+ * @param mqtt_data 分片内容(JSON格式：{"version": "x.y.z", "url": "http://firmware-url"})，不需要以'\0'结尾
+ * @param data_len 分片长度
+ * @param offset 分片在消息中的偏移，0表示新消息
+ * @param total_len 消息总长度
+ * @return esp_err_t ESP_OK:成功处理或等待后续分片  ESP_FAIL:处理失败  ESP_ERR_INVALID_STATE:分片不连续
  */
-esp_err_t mqtt_ota_handler(const char *mqtt_data, size_t data_len)
+esp_err_t mqtt_ota_handler(const char *mqtt_data, size_t data_len, size_t offset, size_t total_len)
 {
-    if (!mqtt_data || data_len == 0) {
+    ota_msg_t *msg = &s_ota_msg;
+
+    if (!mqtt_data || data_len == 0 || offset + data_len > total_len) {
         ESP_LOGE(TAG, "无效的MQTT数据");
         return ESP_FAIL;
     }
-    
-    // 解析JSON数据
-    cJSON *root = cJSON_Parse(mqtt_data);
-    if (!root) {
+    if (offset == 0) {
+        memset(msg, 0, sizeof(ota_msg_t));
+        json_stream_init(&msg->stream, ota_msg_cb, msg);
+        msg->active = true;
+    } else if (!msg->active || offset != msg->received) {
+        // 已出错的消息的后续分片，或丢失了分片
+        msg->active = false;
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    msg->received += data_len;
+    if (json_stream_feed(&msg->stream, mqtt_data, data_len) != OS_SUCCESS) {
+        ESP_LOGE(TAG, "JSON解析失败, 偏移%u", (unsigned)msg->stream.offset);
+        msg->active = false;
+        return ESP_FAIL;
+    }
+    if (msg->received < total_len) {
+        return ESP_OK;
+    }
+    msg->active = false;
+    if (json_stream_end(&msg->stream) != OS_SUCCESS) {
         ESP_LOGE(TAG, "JSON解析失败");
         return ESP_FAIL;
     }
-    
-    // 提取版本和URL
-    cJSON *version_json = cJSON_GetObjectItem(root, "version");
-    cJSON *url_json = cJSON_GetObjectItem(root, "url");
-    
-    if (!version_json || !url_json || !cJSON_IsString(version_json) || !cJSON_IsString(url_json)) {
+
+    char *new_version = msg->version;
+    char *update_url = msg->url;
+    if (new_version[0] == '\0' || update_url[0] == '\0' ||
+        json_unescape_string(new_version) < 0 || json_unescape_string(update_url) < 0) {
         ESP_LOGE(TAG, "JSON格式错误, 需要version和url字段");
-        cJSON_Delete(root);
         return ESP_FAIL;
     }
     
-    const char *new_version = version_json->valuestring;
-    const char *update_url = url_json->valuestring;
-    
     // 获取当前固件版本
     const esp_app_desc_t *app_desc = esp_app_get_description();
     const char *current_version = app_desc->version;
@@ -372,7 +435,6 @@ esp_err_t mqtt_ota_handler(const char *mqtt_data, size_t data_len)
         ota_task_param_t *param = (ota_task_param_t *)malloc(sizeof(ota_task_param_t));
         if (!param) {
             ESP_LOGE(TAG, "内存分配失败");
-            cJSON_Delete(root);
             return ESP_FAIL;
         }
         
@@ -380,7 +442,6 @@ esp_err_t mqtt_ota_handler(const char *mqtt_data, size_t data_len)
         if (!param->url) {
             ESP_LOGE(TAG, "URL内存分配失败");
             free(param);
-            cJSON_Delete(root);
             return ESP_FAIL;
         }
         
@@ -390,7 +451,6 @@ esp_err_t mqtt_ota_handler(const char *mqtt_data, size_t data_len)
             ESP_LOGE(TAG, "创建OTA任务失败");
             free(param->url);
             free(param);
-            cJSON_Delete(root);
             return ESP_FAIL;
         }
         
@@ -399,6 +459,5 @@ esp_err_t mqtt_ota_handler(const char *mqtt_data, size_t data_len)
         ESP_LOGI(TAG, "当前已是最新版本");
     }
     
-    cJSON_Delete(root);
     return ESP_OK;
 }
\ No newline at end of file
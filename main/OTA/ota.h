@@ -11,7 +11,7 @@ typedef struct {
     char *url;
 } ota_task_param_t;
 
-esp_err_t mqtt_ota_handler(const char *mqtt_data, size_t data_len);
+esp_err_t mqtt_ota_handler(const char *mqtt_data, size_t data_len, size_t offset, size_t total_len);
 
 void run_diagnostic(void);
 
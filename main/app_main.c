@@ -30,6 +30,8 @@
 #include "wifi_manager.h"
 #include "ota.h"
 #include "modem_http_config.h"
+#include "track_upload.h"
+#include "geofence_manager.h"
 
 static const char *TAG = "app_main";
 static modem_wifi_config_t wifi_AP_config = MODEM_WIFI_DEFAULT_CONFIG();
@@ -100,6 +102,12 @@ void app_main(void)
     // 启动GPS模块
     ESP_ERROR_CHECK(gps_start());
 
+    // 启动轨迹压缩上传
+    ESP_ERROR_CHECK(track_upload_init());
+
+    // 启动地理围栏，需在MQTT之前以接收围栏配置
+    ESP_ERROR_CHECK(geofence_manager_init());
+
     // 创建传感器任务
     ESP_ERROR_CHECK(sensors_task_init());
     
@@ -1,12 +1,91 @@
+#include <stddef.h>
 #include <string.h>
+#include "freertos/FreeRTOS.h"
 #include "esp_log.h"
 #include "esp_system.h"
+#include "esp_attr.h"
+#include "esp_rom_crc.h"
 #include "data_model.h"
 #include "gps.h"
 #include "esp_mac.h"
 static const char *TAG = "data_model";
 static data_model_t s_data_model = {0};
 static bool s_model_initialized = false;
+static bool s_model_restored = false;
+// 保护传感器数据，各通道由不同驱动在不同时刻写入
+static portMUX_TYPE s_sensor_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// RTC慢速内存中保存的上次状态，软件复位(OTA、切换网络模式)后内容仍然保留
+#define RTC_STATE_MAGIC     0x444D5354  // "DMST"
+#define RTC_STATE_VERSION   4
+// 超过该时长的快照不再恢复，避免把过期数据当作当前数据上报
+#define RTC_STATE_MAX_AGE_S (30 * 60)
+
+typedef struct {
+    uint32_t magic;            // 魔数
+    uint16_t version;          // 结构版本
+    uint16_t size;             // 数据模型大小，固件升级后结构变化时失效
+    sensor_data_t sensors;     // 传感器数据
+    gps_data_t gps;            // GPS数据
+    time_t timestamp;          // 数据时间戳
+    uint32_t crc;              // 以上字段的CRC32
+} rtc_state_t;
+
+static RTC_NOINIT_ATTR rtc_state_t s_rtc_state;
+
+static uint32_t rtc_state_crc(const rtc_state_t *state)
+{
+    return esp_rom_crc32_le(0, (const uint8_t *)state, offsetof(rtc_state_t, crc));
+}
+
+static bool rtc_state_is_valid(void)
+{
+    if (s_rtc_state.magic != RTC_STATE_MAGIC ||
+        s_rtc_state.version != RTC_STATE_VERSION ||
+        s_rtc_state.size != sizeof(data_model_t)) {
+        return false;
+    }
+    return s_rtc_state.crc == rtc_state_crc(&s_rtc_state);
+}
+
+// 重启前将最新数据写入RTC内存
+static void data_model_shutdown_handler(void)
+{
+    data_model_save_to_rtc(NULL);
+}
+
+// 从RTC内存恢复上次状态。快照只在esp_restart()前写入，因此只在软件复位后恢复；
+// panic、看门狗等复位时快照可能是更早一次重启留下的
+static bool data_model_restore_from_rtc(data_model_t *model)
+{
+    esp_reset_reason_t reason = esp_reset_reason();
+    bool valid = rtc_state_is_valid();
+
+    // 快照只使用一次，无论是否恢复都立即作废
+    s_rtc_state.magic = 0;
+
+    if (reason != ESP_RST_SW) {
+        return false;
+    }
+
+    if (!valid) {
+        ESP_LOGI(TAG, "RTC内存中无有效的历史数据");
+        return false;
+    }
+
+    // 软件复位后系统时间继续计时，据此判断快照是否过期
+    time_t now = time(NULL);
+    if (s_rtc_state.timestamp > now || now - s_rtc_state.timestamp > RTC_STATE_MAX_AGE_S) {
+        ESP_LOGI(TAG, "RTC内存中的历史数据已过期(%ld秒前)，不再恢复",
+                 (long)(now - s_rtc_state.timestamp));
+        return false;
+    }
+
+    model->sensors = s_rtc_state.sensors;
+    model->gps = s_rtc_state.gps;
+    model->timestamp = s_rtc_state.timestamp;
+    return true;
+}
 
 esp_err_t data_model_init(data_model_t *model)
 {
@@ -32,6 +111,18 @@ esp_err_t data_model_init(data_model_t *model)
     // 设置初始时间戳
     model->timestamp = 0;
     
+    // 热启动时恢复上次的传感器和定位数据，启动后即可上报
+    s_model_restored = data_model_restore_from_rtc(model);
+    if (s_model_restored) {
+        ESP_LOGI(TAG, "已从RTC内存恢复上次数据，传感器有效: %d, GPS有效: %d",
+                 model->sensors.sensors_valid, model->gps.gps_valid);
+    }
+    
+    esp_err_t ret = esp_register_shutdown_handler(data_model_shutdown_handler);
+    if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {
+        ESP_LOGW(TAG, "注册关机回调失败: %s", esp_err_to_name(ret));
+    }
+    
     s_model_initialized = true;
     ESP_LOGI(TAG, "数据模型初始化完成，设备ID: %s", model->device.device_id);
     
@@ -42,6 +133,17 @@ esp_err_t data_model_update_sensor_data(data_model_t *model,
                                       float temperature, 
                                       float humidity, 
                                       float light)
+{
+    float values[SENSOR_CH_MAX] = {
+        [SENSOR_CH_TEMPERATURE] = temperature,
+        [SENSOR_CH_HUMIDITY] = humidity,
+        [SENSOR_CH_LIGHT] = light,
+    };
+    return data_model_update_sensor_channels(model, values, SENSOR_CH_BIT(SENSOR_CH_MAX) - 1);
+}
+
+esp_err_t data_model_update_sensor_channels(data_model_t *model, const float values[SENSOR_CH_MAX],
+                                            uint32_t channels)
 {
     if (!s_model_initialized) {
         ESP_LOGW(TAG, "数据模型未初始化");
@@ -52,18 +154,40 @@ esp_err_t data_model_update_sensor_data(data_model_t *model,
         model = &s_data_model;
     }
     
-    // 更新传感器数据
-    model->sensors.temperature = temperature;
-    model->sensors.humidity = humidity;
-    model->sensors.light_intensity = light;
-    model->sensors.sensors_valid = true;
+    if (values == NULL || channels == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
     
-    // 更新时间戳
-    model->timestamp = time(NULL);
+    time_t now = time(NULL);
+    portENTER_CRITICAL(&s_sensor_lock);
+    if (channels & SENSOR_CH_BIT(SENSOR_CH_TEMPERATURE)) {
+        model->sensors.temperature = values[SENSOR_CH_TEMPERATURE];
+    }
+    if (channels & SENSOR_CH_BIT(SENSOR_CH_HUMIDITY)) {
+        model->sensors.humidity = values[SENSOR_CH_HUMIDITY];
+    }
+    if (channels & SENSOR_CH_BIT(SENSOR_CH_LIGHT)) {
+        model->sensors.light_intensity = values[SENSOR_CH_LIGHT];
+    }
+    model->sensors.valid_mask |= channels & (SENSOR_CH_BIT(SENSOR_CH_MAX) - 1);
+    model->sensors.sensors_valid = model->sensors.valid_mask != 0;
+    model->timestamp = now;
+    portEXIT_CRITICAL(&s_sensor_lock);
     
     return ESP_OK;
 }
 
+void data_model_get_sensor_data(const data_model_t *model, sensor_data_t *sensors)
+{
+    if (model == NULL) {
+        model = &s_data_model;
+    }
+    
+    portENTER_CRITICAL(&s_sensor_lock);
+    *sensors = model->sensors;
+    portEXIT_CRITICAL(&s_sensor_lock);
+}
+
 esp_err_t data_model_update_gps_data(data_model_t *model, void *gps_info)
 {
     if (!s_model_initialized) {
@@ -84,30 +208,14 @@ esp_err_t data_model_update_gps_data(data_model_t *model, void *gps_info)
     
     // 检查GPS数据是否有效
     if (info->valid) {
-        // 将经纬度从ddmm.mmmm格式转换为十进制度格式
-        int lat_deg = (int)(info->latitude / 100.0);
-        double lat_min = info->latitude - lat_deg * 100.0;
-        model->gps.latitude = lat_deg + lat_min / 60.0;
-        
-        int lon_deg = (int)(info->longitude / 100.0);
-        double lon_min = info->longitude - lon_deg * 100.0;
-        model->gps.longitude = lon_deg + lon_min / 60.0;
-        
-        // 根据北南东西指示符调整经纬度正负值
-        if (info->ns_indicator == 'S') {
-            model->gps.latitude = -model->gps.latitude;
-        }
-        
-        if (info->ew_indicator == 'W') {
-            model->gps.longitude = -model->gps.longitude;
-        }
-        
-        // 保存其他GPS数据
-        model->gps.ns_indicator = info->ns_indicator;
-        model->gps.ew_indicator = info->ew_indicator;
+        // 保存GPS数据，坐标在解析时已转换为1e-7度
+        model->gps.lat_e7 = info->lat_e7;
+        model->gps.lon_e7 = info->lon_e7;
         model->gps.altitude = info->altitude;
         model->gps.speed = info->speed;
         model->gps.course = info->course;
+        model->gps.accuracy = info->accuracy;
+        model->gps.utc_ms = info->utc_ms;
         model->gps.data_source = info->data_source;
         model->gps.gps_valid = true;
         
@@ -129,4 +237,30 @@ data_model_t* data_model_get_latest(void)
     }
     
     return &s_data_model;
-} 
\ No newline at end of file
+}
+
+esp_err_t data_model_save_to_rtc(const data_model_t *model)
+{
+    if (!s_model_initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    if (model == NULL) {
+        model = &s_data_model;
+    }
+    
+    s_rtc_state.magic = RTC_STATE_MAGIC;
+    s_rtc_state.version = RTC_STATE_VERSION;
+    s_rtc_state.size = sizeof(data_model_t);
+    data_model_get_sensor_data(model, &s_rtc_state.sensors);
+    s_rtc_state.gps = model->gps;
+    s_rtc_state.timestamp = model->timestamp;
+    s_rtc_state.crc = rtc_state_crc(&s_rtc_state);
+    
+    return ESP_OK;
+}
+
+bool data_model_is_restored(void)
+{
+    return s_model_restored;
+}
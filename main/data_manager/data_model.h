@@ -12,23 +12,34 @@ typedef struct {
     char firmware_version[16]; // 固件版本
 } device_info_t;
 
+// 传感器通道，驱动按通道提交读数
+typedef enum {
+    SENSOR_CH_TEMPERATURE = 0, // 温度，°C
+    SENSOR_CH_HUMIDITY,        // 湿度，%
+    SENSOR_CH_LIGHT,           // 光照强度，lx
+    SENSOR_CH_MAX,
+} sensor_channel_t;
+
+#define SENSOR_CH_BIT(ch)      (1U << (ch))
+
 // 传感器数据结构体
 typedef struct {
     float temperature;         // 温度值，°C
     float humidity;            // 湿度值，%
     float light_intensity;     // 光照强度，lx
-    bool sensors_valid;        // 传感器数据是否有效
+    uint32_t valid_mask;       // 已有读数的通道，SENSOR_CH_BIT()的组合，其余通道的值无意义
+    bool sensors_valid;        // 是否有任一通道有效
 } sensor_data_t;
 
 // GPS数据结构体
 typedef struct {
-    double latitude;           // 纬度，十进制度格式
-    double longitude;          // 经度，十进制度格式
-    char ns_indicator;         // 北/南指示符: 'N'=北, 'S'=南
-    char ew_indicator;         // 东/西指示符: 'E'=东, 'W'=西
+    int32_t lat_e7;            // 纬度，单位为1e-7度，北纬为正
+    int32_t lon_e7;            // 经度，单位为1e-7度，东经为正
     float altitude;            // 高度，单位为米
     float speed;               // 地面速度，单位为节
     float course;              // 航向，单位为度
+    float accuracy;            // 定位不确定半径，单位为米
+    int64_t utc_ms;            // 定位时刻，UTC Unix时间(毫秒)，0表示未知
     int data_source;           // 数据来源: 0=GNSS, 1=LBS
     bool gps_valid;            // GPS数据是否有效
 } gps_data_t;
@@ -63,6 +74,28 @@ esp_err_t data_model_update_sensor_data(data_model_t *model,
                                        float humidity, 
                                        float light);
 
+/**
+ * @brief 更新部分传感器通道
+ * 
+ * 只写入channels中置位的通道并标记为有效，其余通道保持原值。整组写入在临界区内完成，
+ * 与data_model_get_sensor_data()配合，读取方不会看到一半新一半旧的数据。
+ * 
+ * @param model 数据模型指针，为NULL时使用内部数据模型
+ * @param values 按sensor_channel_t索引的读数
+ * @param channels 要更新的通道，SENSOR_CH_BIT()的组合
+ * @return esp_err_t ESP_OK成功，其他值失败
+ */
+esp_err_t data_model_update_sensor_channels(data_model_t *model, const float values[SENSOR_CH_MAX],
+                                            uint32_t channels);
+
+/**
+ * @brief 获取传感器数据的一致快照
+ * 
+ * @param model 数据模型指针，为NULL时使用内部数据模型
+ * @param sensors 输出的传感器数据
+ */
+void data_model_get_sensor_data(const data_model_t *model, sensor_data_t *sensors);
+
 /**
  * @brief 更新GPS数据
  * 
@@ -79,4 +112,24 @@ esp_err_t data_model_update_gps_data(data_model_t *model, void *gps_info);
  */
 data_model_t* data_model_get_latest(void);
 
+/**
+ * @brief 将数据模型保存到RTC慢速内存(带CRC校验)
+ * 
+ * 软件复位(OTA升级、网络模式切换)后，data_model_init()会从RTC内存恢复这些数据；
+ * 快照只恢复一次，超过30分钟的快照不再恢复。
+ * 数据模型初始化时已注册关机回调，esp_restart()前会自动调用本函数。
+ * 
+ * @param model 数据模型指针，为NULL时使用内部数据模型
+ * @return esp_err_t ESP_OK成功，其他值失败
+ */
+esp_err_t data_model_save_to_rtc(const data_model_t *model);
+
+/**
+ * @brief 数据模型是否已从RTC内存恢复上次的状态
+ * 
+ * @return true 已恢复（热启动）
+ * @return false 冷启动或RTC数据无效
+ */
+bool data_model_is_restored(void);
+
 #endif // DATA_MODEL_H 
\ No newline at end of file
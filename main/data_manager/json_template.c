@@ -0,0 +1,218 @@
+#include <string.h>
+#include "esp_log.h"
+#include "json_template.h"
+#include "json_wrapper.h"
+#include "json_generator.h"
+#include "gps_parser.h"
+
+static const char *TAG = "json_template";
+
+// 各槽位宽度，按字段可能出现的最长取值确定
+static const uint8_t s_slot_width[JSON_SLOT_MAX] = {
+    [JSON_SLOT_TIMESTAMP]   = 11,   // -2147483648
+    [JSON_SLOT_TEMPERATURE] = 8,
+    [JSON_SLOT_HUMIDITY]    = 8,
+    [JSON_SLOT_LIGHT]       = 10,   // 留出BH1750量程上限的余量
+    [JSON_SLOT_LATITUDE]    = 12,   // -90.0000000
+    [JSON_SLOT_LONGITUDE]   = 13,   // -180.0000000
+    [JSON_SLOT_LAT_DISPLAY] = 14,   // "90.0000000N"
+    [JSON_SLOT_LON_DISPLAY] = 15,   // "180.0000000E"
+    [JSON_SLOT_ALTITUDE]    = 10,
+    [JSON_SLOT_SPEED]       = 10,
+    [JSON_SLOT_COURSE]      = 8,
+    [JSON_SLOT_ACCURACY]    = 10,
+    [JSON_SLOT_SOURCE]      = 4,
+    [JSON_SLOT_GPS_TIME]    = 14,   // 毫秒，到2286年为13位
+};
+
+void json_template_reset(json_template_t *tpl)
+{
+    if (tpl != NULL) {
+        tpl->ready = false;
+    }
+}
+
+static bool slot_reserve(json_gen_str_t *jstr, json_template_t *tpl, json_slot_id_t id, const char *name)
+{
+    int offset = json_gen_obj_reserve(jstr, name, s_slot_width[id]);
+    tpl->offset[id] = offset;
+    return offset >= 0;
+}
+
+// 生成骨架，字段顺序与json_generate_from_data_model()一致
+static esp_err_t json_template_build(json_template_t *tpl, const data_model_t *model,
+                                     const sensor_data_t *sensors)
+{
+    bool ok = true;
+    json_gen_str_t jstr;
+
+    tpl->ready = false;
+    for (int i = 0; i < JSON_SLOT_MAX; i++) {
+        tpl->offset[i] = -1;
+    }
+    tpl->sensor_mask = sensors->valid_mask;
+    tpl->with_gps = model->gps.gps_valid;
+
+    json_gen_str_start(&jstr, tpl->buf, sizeof(tpl->buf), NULL, NULL);
+    json_gen_start_object(&jstr);
+
+    json_gen_push_object(&jstr, "device");
+    json_gen_obj_set_string(&jstr, "id", model->device.device_id);
+    json_gen_obj_set_string(&jstr, "version", model->device.firmware_version);
+    json_gen_pop_object(&jstr);
+
+    ok &= slot_reserve(&jstr, tpl, JSON_SLOT_TIMESTAMP, "timestamp");
+
+    // 只为已有读数的通道留出槽位
+    if (tpl->sensor_mask != 0) {
+        json_gen_push_object(&jstr, "sensors");
+        if (tpl->sensor_mask & SENSOR_CH_BIT(SENSOR_CH_TEMPERATURE)) {
+            ok &= slot_reserve(&jstr, tpl, JSON_SLOT_TEMPERATURE, "temperature");
+        }
+        if (tpl->sensor_mask & SENSOR_CH_BIT(SENSOR_CH_HUMIDITY)) {
+            ok &= slot_reserve(&jstr, tpl, JSON_SLOT_HUMIDITY, "humidity");
+        }
+        if (tpl->sensor_mask & SENSOR_CH_BIT(SENSOR_CH_LIGHT)) {
+            ok &= slot_reserve(&jstr, tpl, JSON_SLOT_LIGHT, "light");
+        }
+        json_gen_pop_object(&jstr);
+    }
+
+    if (tpl->with_gps) {
+        json_gen_push_object(&jstr, "gps");
+        ok &= slot_reserve(&jstr, tpl, JSON_SLOT_LATITUDE, "latitude");
+        ok &= slot_reserve(&jstr, tpl, JSON_SLOT_LONGITUDE, "longitude");
+        ok &= slot_reserve(&jstr, tpl, JSON_SLOT_LAT_DISPLAY, "lat_display");
+        ok &= slot_reserve(&jstr, tpl, JSON_SLOT_LON_DISPLAY, "lon_display");
+        ok &= slot_reserve(&jstr, tpl, JSON_SLOT_ALTITUDE, "altitude");
+        ok &= slot_reserve(&jstr, tpl, JSON_SLOT_SPEED, "speed");
+        ok &= slot_reserve(&jstr, tpl, JSON_SLOT_COURSE, "course");
+        ok &= slot_reserve(&jstr, tpl, JSON_SLOT_ACCURACY, "accuracy");
+        ok &= slot_reserve(&jstr, tpl, JSON_SLOT_SOURCE, "source");
+        ok &= slot_reserve(&jstr, tpl, JSON_SLOT_GPS_TIME, "time");
+        json_gen_pop_object(&jstr);
+    }
+
+    json_gen_end_object(&jstr);
+    int len = json_gen_str_end(&jstr);
+    if (!ok || len > (int)sizeof(tpl->buf)) {
+        ESP_LOGE(TAG, "模板缓冲区不足: 需要%d字节", len);
+        return ESP_ERR_NO_MEM;
+    }
+
+    tpl->len = len - 1;
+    tpl->ready = true;
+    ESP_LOGI(TAG, "已生成JSON模板: %d字节, 传感器通道=0x%lx, GPS=%d",
+             (int)tpl->len, (unsigned long)tpl->sensor_mask, tpl->with_gps);
+    return ESP_OK;
+}
+
+// 将字符串写入槽位，剩余部分以空格填充
+static bool slot_write(json_template_t *tpl, json_slot_id_t id, const char *str, int len)
+{
+    int offset = tpl->offset[id];
+    int width = s_slot_width[id];
+    if (offset < 0) {
+        return true;
+    }
+    if (len > width) {
+        return false;
+    }
+    memcpy(tpl->buf + offset, str, len);
+    memset(tpl->buf + offset + len, ' ', width - len);
+    return true;
+}
+
+static bool slot_write_number(json_template_t *tpl, json_slot_id_t id, double val, int precision)
+{
+    char str[JSON_GEN_MAX_FLOAT_STR];
+    int len = json_gen_double_to_str(str, val, precision);
+    return slot_write(tpl, id, str, len);
+}
+
+static bool slot_write_fixed(json_template_t *tpl, json_slot_id_t id, int64_t val, int decimals)
+{
+    char str[JSON_GEN_MAX_FLOAT_STR];
+    int len = json_gen_fixed_to_str(str, val, decimals);
+    return slot_write(tpl, id, str, len);
+}
+
+// 带方向指示符的坐标字符串，如"31.2304160N"，indicators为正、负方向的指示符
+static bool slot_write_display(json_template_t *tpl, json_slot_id_t id, int32_t coord_e7, const char *indicators)
+{
+    char str[JSON_GEN_MAX_FLOAT_STR + 3];
+    int64_t magnitude = coord_e7 < 0 ? -(int64_t)coord_e7 : coord_e7;
+    int len = 0;
+    str[len++] = '"';
+    len += json_gen_fixed_to_str(str + len, magnitude, GPS_COORD_DECIMALS);
+    str[len++] = indicators[coord_e7 < 0];
+    str[len++] = '"';
+    return slot_write(tpl, id, str, len);
+}
+
+static bool json_template_patch(json_template_t *tpl, const data_model_t *model, const sensor_data_t *sensors)
+{
+    bool ok = true;
+    const gps_data_t *gps = &model->gps;
+
+    // 数值类型与通用生成器保持一致，保证输出相同；骨架中没有的槽位不写入
+    ok &= slot_write_number(tpl, JSON_SLOT_TIMESTAMP, (int)model->timestamp, 0);
+    ok &= slot_write_number(tpl, JSON_SLOT_TEMPERATURE, sensors->temperature, JSON_PREC_TEMPERATURE);
+    ok &= slot_write_number(tpl, JSON_SLOT_HUMIDITY, sensors->humidity, JSON_PREC_HUMIDITY);
+    ok &= slot_write_number(tpl, JSON_SLOT_LIGHT, sensors->light_intensity, JSON_PREC_LIGHT);
+    if (tpl->with_gps) {
+        ok &= slot_write_fixed(tpl, JSON_SLOT_LATITUDE, gps->lat_e7, GPS_COORD_DECIMALS);
+        ok &= slot_write_fixed(tpl, JSON_SLOT_LONGITUDE, gps->lon_e7, GPS_COORD_DECIMALS);
+        ok &= slot_write_display(tpl, JSON_SLOT_LAT_DISPLAY, gps->lat_e7, "NS");
+        ok &= slot_write_display(tpl, JSON_SLOT_LON_DISPLAY, gps->lon_e7, "EW");
+        ok &= slot_write_number(tpl, JSON_SLOT_ALTITUDE, gps->altitude, JSON_PREC_ALTITUDE);
+        ok &= slot_write_number(tpl, JSON_SLOT_SPEED, gps->speed, JSON_PREC_SPEED);
+        ok &= slot_write_number(tpl, JSON_SLOT_COURSE, gps->course, JSON_PREC_COURSE);
+        ok &= slot_write_number(tpl, JSON_SLOT_ACCURACY, gps->accuracy, JSON_PREC_ACCURACY);
+        ok &= slot_write_number(tpl, JSON_SLOT_SOURCE, gps->data_source, 0);
+        ok &= slot_write_fixed(tpl, JSON_SLOT_GPS_TIME, gps->utc_ms, 0);
+    }
+    return ok;
+}
+
+esp_err_t json_template_render(json_template_t *tpl, const data_model_t *model,
+                               const char **json_str, size_t *json_len)
+{
+    if (tpl == NULL || model == NULL || json_str == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // 取快照，骨架和数值使用同一组传感器数据
+    sensor_data_t sensors;
+    data_model_get_sensor_data(model, &sensors);
+
+    // 有效的传感器通道或GPS有效性变化时文档结构不同，需要重新生成骨架
+    if (!tpl->ready || tpl->sensor_mask != sensors.valid_mask ||
+        tpl->with_gps != model->gps.gps_valid) {
+        esp_err_t ret = json_template_build(tpl, model, &sensors);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+    }
+
+    if (!json_template_patch(tpl, model, &sensors)) {
+        // 数值超出槽位宽度，本次使用通用生成器，骨架已被覆盖需重新生成
+        ESP_LOGW(TAG, "数值超出模板槽位宽度，使用通用生成器");
+        tpl->ready = false;
+        esp_err_t ret = json_generate_from_data_model(model, tpl->buf, sizeof(tpl->buf));
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        *json_str = tpl->buf;
+        if (json_len != NULL) {
+            *json_len = strlen(tpl->buf);
+        }
+        return ESP_OK;
+    }
+
+    *json_str = tpl->buf;
+    if (json_len != NULL) {
+        *json_len = tpl->len;
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,66 @@
+#ifndef JSON_TEMPLATE_H
+#define JSON_TEMPLATE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "data_model.h"
+
+// 模板缓冲区大小，需容纳包含全部字段的完整数据模型JSON
+#define JSON_TEMPLATE_BUF_SIZE  512
+
+// 模板中每次发布需要填写的数值槽位
+typedef enum {
+    JSON_SLOT_TIMESTAMP = 0,
+    JSON_SLOT_TEMPERATURE,
+    JSON_SLOT_HUMIDITY,
+    JSON_SLOT_LIGHT,
+    JSON_SLOT_LATITUDE,
+    JSON_SLOT_LONGITUDE,
+    JSON_SLOT_LAT_DISPLAY,
+    JSON_SLOT_LON_DISPLAY,
+    JSON_SLOT_ALTITUDE,
+    JSON_SLOT_SPEED,
+    JSON_SLOT_COURSE,
+    JSON_SLOT_ACCURACY,
+    JSON_SLOT_SOURCE,
+    JSON_SLOT_GPS_TIME,
+    JSON_SLOT_MAX
+} json_slot_id_t;
+
+// 预编译的数据模型JSON模板
+typedef struct {
+    char buf[JSON_TEMPLATE_BUF_SIZE];   // JSON骨架，每次发布时原地填写数值
+    size_t len;                         // JSON长度，不含结束符
+    int16_t offset[JSON_SLOT_MAX];      // 各槽位在buf中的偏移，-1表示当前骨架不含该槽位
+    bool ready;                         // 骨架是否可用
+    uint32_t sensor_mask;               // 骨架包含的传感器通道，SENSOR_CH_BIT()的组合
+    bool with_gps;                      // 骨架是否包含gps对象
+} json_template_t;
+
+/**
+ * @brief 使模板失效，下次渲染时重新生成骨架
+ *
+ * 设备信息在生成骨架时固定写入，设备信息变化后需调用此函数
+ *
+ * @param tpl 模板指针
+ */
+void json_template_reset(json_template_t *tpl);
+
+/**
+ * @brief 按数据模型渲染JSON，输出与json_generate_from_data_model()字段相同
+ *
+ * 首次调用或有效的传感器通道、GPS有效性变化时生成骨架，之后只将数值填入固定宽度的槽位，
+ * 未用满的槽位以空格填充。数值超出槽位宽度时退回到通用生成器
+ *
+ * @param tpl 模板指针
+ * @param model 数据模型指针
+ * @param json_str 输出的JSON字符串，指向模板内部缓冲区，下次渲染前有效
+ * @param json_len 输出的JSON长度，可为NULL
+ * @return esp_err_t ESP_OK成功，其他值失败
+ */
+esp_err_t json_template_render(json_template_t *tpl, const data_model_t *model,
+                               const char **json_str, size_t *json_len);
+
+#endif // JSON_TEMPLATE_H
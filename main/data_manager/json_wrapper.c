@@ -3,9 +3,55 @@
 #include "esp_log.h"
 #include "json_wrapper.h"
 #include "json_generator.h"
+#include "gps_parser.h"
 
 static const char *TAG = "json_wrapper";
 
+// 带方向指示符的坐标字符串，如"31.2304160N"，indicators为正、负方向的指示符
+static void json_format_coord_display(char *str, int32_t coord_e7, const char *indicators)
+{
+    int64_t magnitude = coord_e7 < 0 ? -(int64_t)coord_e7 : coord_e7;
+    int len = json_gen_fixed_to_str(str, magnitude, GPS_COORD_DECIMALS);
+    str[len++] = indicators[coord_e7 < 0];
+    str[len] = '\0';
+}
+
+// 只输出已有读数的通道，尚未读到的通道的值无意义
+static void json_add_sensor_channels(json_gen_str_t *jstr, const sensor_data_t *sensors)
+{
+    if (sensors->valid_mask & SENSOR_CH_BIT(SENSOR_CH_TEMPERATURE)) {
+        json_gen_obj_set_float_prec(jstr, "temperature", sensors->temperature, JSON_PREC_TEMPERATURE);
+    }
+    if (sensors->valid_mask & SENSOR_CH_BIT(SENSOR_CH_HUMIDITY)) {
+        json_gen_obj_set_float_prec(jstr, "humidity", sensors->humidity, JSON_PREC_HUMIDITY);
+    }
+    if (sensors->valid_mask & SENSOR_CH_BIT(SENSOR_CH_LIGHT)) {
+        json_gen_obj_set_float_prec(jstr, "light", sensors->light_intensity, JSON_PREC_LIGHT);
+    }
+}
+
+// GPS字段，各生成函数共用以保证输出一致，字段顺序与json_template一致
+static void json_add_gps_fields(json_gen_str_t *jstr, const gps_data_t *gps)
+{
+    json_gen_obj_set_fixed(jstr, "latitude", gps->lat_e7, GPS_COORD_DECIMALS);
+    json_gen_obj_set_fixed(jstr, "longitude", gps->lon_e7, GPS_COORD_DECIMALS);
+    
+    // 添加方向指示符
+    char lat_str[JSON_GEN_MAX_FLOAT_STR], lon_str[JSON_GEN_MAX_FLOAT_STR];
+    json_format_coord_display(lat_str, gps->lat_e7, "NS");
+    json_format_coord_display(lon_str, gps->lon_e7, "EW");
+    json_gen_obj_set_string(jstr, "lat_display", lat_str);
+    json_gen_obj_set_string(jstr, "lon_display", lon_str);
+    
+    // 其他GPS信息
+    json_gen_obj_set_float_prec(jstr, "altitude", gps->altitude, JSON_PREC_ALTITUDE);
+    json_gen_obj_set_float_prec(jstr, "speed", gps->speed, JSON_PREC_SPEED);
+    json_gen_obj_set_float_prec(jstr, "course", gps->course, JSON_PREC_COURSE);
+    json_gen_obj_set_float_prec(jstr, "accuracy", gps->accuracy, JSON_PREC_ACCURACY);
+    json_gen_obj_set_int(jstr, "source", gps->data_source);
+    json_gen_obj_set_int64(jstr, "time", gps->utc_ms);
+}
+
 esp_err_t json_generate_from_data_model(const data_model_t *model, char *json_str, size_t json_str_size)
 {
     if (model == NULL || json_str == NULL || json_str_size == 0) {
@@ -28,33 +74,19 @@ esp_err_t json_generate_from_data_model(const data_model_t *model, char *json_st
     // 添加时间戳
     json_gen_obj_set_int(&jstr, "timestamp", model->timestamp);
     
-    // 添加传感器数据
-    if (model->sensors.sensors_valid) {
+    // 添加传感器数据，取快照以免读到传感器任务写入一半的数据
+    sensor_data_t sensors;
+    data_model_get_sensor_data(model, &sensors);
+    if (sensors.valid_mask != 0) {
         json_gen_push_object(&jstr, "sensors");
-        json_gen_obj_set_float(&jstr, "temperature", model->sensors.temperature);
-        json_gen_obj_set_float(&jstr, "humidity", model->sensors.humidity);
-        json_gen_obj_set_float(&jstr, "light", model->sensors.light_intensity);
+        json_add_sensor_channels(&jstr, &sensors);
         json_gen_pop_object(&jstr);
     }
     
     // 添加GPS数据
     if (model->gps.gps_valid) {
         json_gen_push_object(&jstr, "gps");
-        json_gen_obj_set_float(&jstr, "latitude", model->gps.latitude);
-        json_gen_obj_set_float(&jstr, "longitude", model->gps.longitude);
-        
-        // 添加方向指示符
-        char lat_str[16], lon_str[16];
-        snprintf(lat_str, sizeof(lat_str), "%.6f%c", model->gps.latitude, model->gps.ns_indicator);
-        snprintf(lon_str, sizeof(lon_str), "%.6f%c", model->gps.longitude, model->gps.ew_indicator);
-        json_gen_obj_set_string(&jstr, "lat_display", lat_str);
-        json_gen_obj_set_string(&jstr, "lon_display", lon_str);
-        
-        // 其他GPS信息
-        json_gen_obj_set_float(&jstr, "altitude", model->gps.altitude);
-        json_gen_obj_set_float(&jstr, "speed", model->gps.speed);
-        json_gen_obj_set_float(&jstr, "course", model->gps.course);
-        json_gen_obj_set_int(&jstr, "source", model->gps.data_source);
+        json_add_gps_fields(&jstr, &model->gps);
         json_gen_pop_object(&jstr);
     }
     
@@ -79,9 +111,7 @@ esp_err_t json_generate_from_sensor_data(const sensor_data_t *sensor_data, char
     json_gen_start_object(&jstr);
     
     // 添加传感器数据
-    json_gen_obj_set_float(&jstr, "temperature", sensor_data->temperature);
-    json_gen_obj_set_float(&jstr, "humidity", sensor_data->humidity);
-    json_gen_obj_set_float(&jstr, "light", sensor_data->light_intensity);
+    json_add_sensor_channels(&jstr, sensor_data);
     
     // 结束JSON对象
     json_gen_end_object(&jstr);
@@ -104,21 +134,7 @@ esp_err_t json_generate_from_gps_data(const gps_data_t *gps_data, char *json_str
     json_gen_start_object(&jstr);
     
     // 添加GPS数据
-    json_gen_obj_set_float(&jstr, "latitude", gps_data->latitude);
-    json_gen_obj_set_float(&jstr, "longitude", gps_data->longitude);
-    
-    // 添加方向指示符
-    char lat_str[16], lon_str[16];
-    snprintf(lat_str, sizeof(lat_str), "%.6f%c", gps_data->latitude, gps_data->ns_indicator);
-    snprintf(lon_str, sizeof(lon_str), "%.6f%c", gps_data->longitude, gps_data->ew_indicator);
-    json_gen_obj_set_string(&jstr, "lat_display", lat_str);
-    json_gen_obj_set_string(&jstr, "lon_display", lon_str);
-    
-    // 其他GPS信息
-    json_gen_obj_set_float(&jstr, "altitude", gps_data->altitude);
-    json_gen_obj_set_float(&jstr, "speed", gps_data->speed);
-    json_gen_obj_set_float(&jstr, "course", gps_data->course);
-    json_gen_obj_set_int(&jstr, "source", gps_data->data_source);
+    json_add_gps_fields(&jstr, gps_data);
     
     // 结束JSON对象
     json_gen_end_object(&jstr);
@@ -142,33 +158,19 @@ esp_err_t json_add_data_to_generator(const data_model_t *model, json_gen_str_t *
     // 添加时间戳
     json_gen_obj_set_int(jstr, "timestamp", model->timestamp);
     
-    // 添加传感器数据
-    if (model->sensors.sensors_valid) {
+    // 添加传感器数据，取快照以免读到传感器任务写入一半的数据
+    sensor_data_t sensors;
+    data_model_get_sensor_data(model, &sensors);
+    if (sensors.valid_mask != 0) {
         json_gen_push_object(jstr, "sensors");
-        json_gen_obj_set_float(jstr, "temperature", model->sensors.temperature);
-        json_gen_obj_set_float(jstr, "humidity", model->sensors.humidity);
-        json_gen_obj_set_float(jstr, "light", model->sensors.light_intensity);
+        json_add_sensor_channels(jstr, &sensors);
         json_gen_pop_object(jstr);
     }
     
     // 添加GPS数据
     if (model->gps.gps_valid) {
         json_gen_push_object(jstr, "gps");
-        json_gen_obj_set_float(jstr, "latitude", model->gps.latitude);
-        json_gen_obj_set_float(jstr, "longitude", model->gps.longitude);
-        
-        // 添加方向指示符
-        char lat_str[16], lon_str[16];
-        snprintf(lat_str, sizeof(lat_str), "%.6f%c", model->gps.latitude, model->gps.ns_indicator);
-        snprintf(lon_str, sizeof(lon_str), "%.6f%c", model->gps.longitude, model->gps.ew_indicator);
-        json_gen_obj_set_string(jstr, "lat_display", lat_str);
-        json_gen_obj_set_string(jstr, "lon_display", lon_str);
-        
-        // 其他GPS信息
-        json_gen_obj_set_float(jstr, "altitude", model->gps.altitude);
-        json_gen_obj_set_float(jstr, "speed", model->gps.speed);
-        json_gen_obj_set_float(jstr, "course", model->gps.course);
-        json_gen_obj_set_int(jstr, "source", model->gps.data_source);
+        json_add_gps_fields(jstr, &model->gps);
         json_gen_pop_object(jstr);
     }
     
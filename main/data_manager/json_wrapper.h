@@ -5,6 +5,15 @@
 #include "data_model.h"
 #include "json_generator.h"
 
+// 各字段输出的小数位数，坐标为定点数，按GPS_COORD_DECIMALS原样输出
+#define JSON_PREC_TEMPERATURE   1
+#define JSON_PREC_HUMIDITY      1
+#define JSON_PREC_LIGHT         1
+#define JSON_PREC_ALTITUDE      1
+#define JSON_PREC_SPEED         2
+#define JSON_PREC_COURSE        1
+#define JSON_PREC_ACCURACY      1
+
 /**
  * @brief 将数据模型转换为JSON字符串
  * 
@@ -0,0 +1,413 @@
+#include <string.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+#include "json_parser.h"
+#include "json_stream.h"
+#include "json_generator.h"
+#include "geofence.h"
+#include "geofence_manager.h"
+#include "mqtt.h"
+
+static const char *TAG = "GEOFENCE";
+
+#define GEOFENCE_MAX_FENCES     CONFIG_GEOFENCE_MAX_FENCES
+#define GEOFENCE_MAX_VERTICES   CONFIG_GEOFENCE_MAX_VERTICES
+#define GEOFENCE_MAX_POLYGON_VERTICES CONFIG_GEOFENCE_MAX_POLYGON_VERTICES
+// 一次定位最多发布的事件数，超出的事件丢弃
+#define GEOFENCE_MAX_EVENTS     16
+#define GEOFENCE_EVENT_JSON_SIZE 160
+
+static geofence_t s_geofence;
+static SemaphoreHandle_t s_geofence_mutex = NULL;
+
+// 本次定位产生的事件，释放互斥锁后再发布，避免与MQTT任务互相等待
+static geofence_event_t s_events[GEOFENCE_MAX_EVENTS];
+static int s_event_count = 0;
+static uint32_t s_dropped_events = 0;
+
+typedef enum {
+    GEOFENCE_OP_NONE = 0,
+    GEOFENCE_OP_ADD,
+    GEOFENCE_OP_REMOVE,
+    GEOFENCE_OP_CLEAR,
+} geofence_op_t;
+
+static const char *const s_event_names[] = {
+    [GEOFENCE_ENTER] = "enter",
+    [GEOFENCE_EXIT] = "exit",
+    [GEOFENCE_DWELL] = "dwell",
+};
+
+// 由geofence_update()在持有互斥锁时调用
+static void geofence_event_handler(const geofence_event_t *event, void *priv)
+{
+    if (s_event_count < GEOFENCE_MAX_EVENTS) {
+        s_events[s_event_count++] = *event;
+    } else {
+        s_dropped_events++;
+    }
+}
+
+static void geofence_publish_event(const geofence_event_t *event)
+{
+    char buf[GEOFENCE_EVENT_JSON_SIZE];
+    json_gen_str_t jstr;
+
+    json_gen_str_start(&jstr, buf, sizeof(buf), NULL, NULL);
+    json_gen_start_object(&jstr);
+    json_gen_obj_set_int(&jstr, "id", (int)event->id);
+    json_gen_obj_set_string(&jstr, "event", s_event_names[event->type]);
+    json_gen_obj_set_int(&jstr, "timestamp", (int)(event->time_ms / 1000));
+    json_gen_obj_set_int(&jstr, "lat_e7", event->position.lat_e7);
+    json_gen_obj_set_int(&jstr, "lon_e7", event->position.lon_e7);
+    json_gen_end_object(&jstr);
+    // 返回的长度包含结尾的'\0'，超出缓冲区时文档已被截断
+    int len = json_gen_str_end(&jstr);
+    if (len > (int)sizeof(buf)) {
+        ESP_LOGE(TAG, "围栏事件JSON缓冲区不足: 需要%d字节", len);
+        return;
+    }
+
+    ESP_LOGI(TAG, "围栏%lu: %s", (unsigned long)event->id, s_event_names[event->type]);
+    if (mqtt_publish_geofence_event(buf, len - 1) != ESP_OK) {
+        ESP_LOGW(TAG, "围栏事件发布失败");
+    }
+}
+
+esp_err_t geofence_manager_init(void)
+{
+    s_geofence_mutex = xSemaphoreCreateMutex();
+    if (s_geofence_mutex == NULL) {
+        ESP_LOGE(TAG, "创建围栏互斥锁失败");
+        return ESP_FAIL;
+    }
+    if (geofence_init(&s_geofence, GEOFENCE_MAX_FENCES, GEOFENCE_MAX_VERTICES,
+                      geofence_event_handler, NULL) != 0) {
+        ESP_LOGE(TAG, "围栏内存分配失败");
+        vSemaphoreDelete(s_geofence_mutex);
+        s_geofence_mutex = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+void geofence_manager_on_fix(const gps_info_t *gps_info)
+{
+    if (s_geofence_mutex == NULL || gps_info == NULL || !gps_info->valid) {
+        return;
+    }
+
+    // 优先使用定位时刻，缓存的基站定位结果没有时间，取当前时间
+    int64_t time_ms = gps_info->utc_ms;
+    if (time_ms <= 0) {
+        struct timeval tv;
+        gettimeofday(&tv, NULL);
+        time_ms = (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+    }
+    geofence_point_t position = {
+        .lat_e7 = gps_info->lat_e7,
+        .lon_e7 = gps_info->lon_e7,
+    };
+
+    xSemaphoreTake(s_geofence_mutex, portMAX_DELAY);
+    s_event_count = 0;
+    geofence_update(&s_geofence, time_ms, position);
+    int event_count = s_event_count;
+    xSemaphoreGive(s_geofence_mutex);
+
+    // 事件只在GPS事件任务中产生和读取
+    for (int i = 0; i < event_count; i++) {
+        geofence_publish_event(&s_events[i]);
+    }
+    if (s_dropped_events > 0) {
+        ESP_LOGW(TAG, "围栏事件过多，已丢弃%lu个", (unsigned long)s_dropped_events);
+        s_dropped_events = 0;
+    }
+}
+
+// 解析中的围栏
+typedef struct {
+    int index;                  // 在fences数组中的位置
+    bool error;
+    bool polygon;
+    uint8_t fields;             // GEOFENCE_FIELD_*
+    int32_t id;
+    int32_t dwell_s;
+    geofence_point_t center;
+    float radius_m;
+    uint32_t vertex_count;      // 超出GEOFENCE_MAX_POLYGON_VERTICES时仍计数，用于报错
+    uint8_t point_fields;       // 当前顶点已给出的坐标，bit0纬度、bit1经度
+} geofence_msg_fence_t;
+
+// 一条围栏消息的解析状态，消息可能分多个MQTT分片到达
+typedef struct {
+    json_stream_t stream;
+    bool active;                // 已收到首个分片且尚未出错
+    size_t received;
+    geofence_op_t op;
+    bool in_fence;
+    geofence_msg_fence_t fence;
+    int failed;                 // 失败的围栏数
+} geofence_msg_t;
+
+#define GEOFENCE_FIELD_ID       (1 << 0)
+#define GEOFENCE_FIELD_LAT      (1 << 1)
+#define GEOFENCE_FIELD_LON      (1 << 2)
+#define GEOFENCE_FIELD_RADIUS   (1 << 3)
+#define GEOFENCE_FIELD_CIRCLE   (GEOFENCE_FIELD_LAT | GEOFENCE_FIELD_LON | GEOFENCE_FIELD_RADIUS)
+
+// 只在MQTT任务中使用
+static geofence_msg_t s_msg;
+static geofence_point_t s_vertices[GEOFENCE_MAX_POLYGON_VERTICES];
+
+static bool geofence_parse_int(const json_stream_event_t *event, int32_t *out)
+{
+    char *end;
+    if (event->type != JSON_STREAM_NUMBER) {
+        return false;
+    }
+    long long value = strtoll(event->value, &end, 10);
+    if (end != event->value + event->value_len || value < INT32_MIN || value > INT32_MAX) {
+        return false;
+    }
+    *out = (int32_t)value;
+    return true;
+}
+
+static void geofence_fence_begin(geofence_msg_t *msg, int index)
+{
+    memset(&msg->fence, 0, sizeof(msg->fence));
+    msg->fence.index = index;
+    msg->in_fence = true;
+}
+
+static void geofence_fence_end(geofence_msg_t *msg)
+{
+    geofence_msg_fence_t *fence = &msg->fence;
+    int err = -1;
+
+    msg->in_fence = false;
+    if (!fence->error && (fence->fields & GEOFENCE_FIELD_ID) && fence->id >= 0) {
+        uint32_t dwell_ms = fence->dwell_s > 0 ? (uint32_t)fence->dwell_s * 1000 : 0;
+        xSemaphoreTake(s_geofence_mutex, portMAX_DELAY);
+        if (fence->polygon) {
+            if (fence->vertex_count <= GEOFENCE_MAX_POLYGON_VERTICES) {
+                err = geofence_add_polygon(&s_geofence, fence->id, s_vertices, fence->vertex_count, dwell_ms);
+            }
+        } else if ((fence->fields & GEOFENCE_FIELD_CIRCLE) == GEOFENCE_FIELD_CIRCLE) {
+            err = geofence_add_circle(&s_geofence, fence->id, fence->center, fence->radius_m, dwell_ms);
+        }
+        xSemaphoreGive(s_geofence_mutex);
+    }
+    if (err != 0) {
+        ESP_LOGW(TAG, "第%d个围栏%s", fence->index, err == -2 ? "超出容量" : "格式错误");
+        msg->failed++;
+    }
+}
+
+// fences数组中围栏对象的成员，depth为3
+static void geofence_fence_member(geofence_msg_t *msg, const json_stream_event_t *event)
+{
+    geofence_msg_fence_t *fence = &msg->fence;
+    int32_t value;
+
+    if (strcmp(event->key, "points") == 0) {
+        if (event->type == JSON_STREAM_ARRAY_START) {
+            fence->polygon = true;
+            fence->vertex_count = 0;
+        } else if (event->type != JSON_STREAM_ARRAY_END) {
+            fence->error = true;
+        }
+        return;
+    }
+    if (strcmp(event->key, "radius_m") == 0) {
+        char *end;
+        fence->radius_m = strtof(event->value ? event->value : "", &end);
+        if (event->type != JSON_STREAM_NUMBER || end != event->value + event->value_len) {
+            fence->error = true;
+        }
+        fence->fields |= GEOFENCE_FIELD_RADIUS;
+        return;
+    }
+
+    bool ok = geofence_parse_int(event, &value);
+    if (strcmp(event->key, "id") == 0) {
+        fence->id = value;
+        fence->fields |= GEOFENCE_FIELD_ID;
+    } else if (strcmp(event->key, "dwell_s") == 0) {
+        fence->dwell_s = value;
+    } else if (strcmp(event->key, "lat_e7") == 0) {
+        fence->center.lat_e7 = value;
+        fence->fields |= GEOFENCE_FIELD_LAT;
+    } else if (strcmp(event->key, "lon_e7") == 0) {
+        fence->center.lon_e7 = value;
+        fence->fields |= GEOFENCE_FIELD_LON;
+    } else {
+        // 未知字段忽略
+        return;
+    }
+    if (!ok) {
+        fence->error = true;
+    }
+}
+
+// points数组中的顶点[lat_e7, lon_e7]，顶点为depth 4，坐标为depth 5
+static void geofence_fence_point(geofence_msg_t *msg, const json_stream_event_t *event)
+{
+    geofence_msg_fence_t *fence = &msg->fence;
+    int32_t value;
+
+    if (event->depth == 4) {
+        if (event->type == JSON_STREAM_ARRAY_START) {
+            fence->point_fields = 0;
+        } else if (event->type == JSON_STREAM_ARRAY_END && fence->point_fields == 0x3) {
+            fence->vertex_count++;
+        } else {
+            fence->error = true;
+        }
+        return;
+    }
+    if (!geofence_parse_int(event, &value) || event->index < 0 || event->index > 1) {
+        fence->error = true;
+        return;
+    }
+    // 顶点过多时只计数，结束时报错
+    if (fence->vertex_count < GEOFENCE_MAX_POLYGON_VERTICES) {
+        geofence_point_t *vertex = &s_vertices[fence->vertex_count];
+        if (event->index == 0) {
+            vertex->lat_e7 = value;
+        } else {
+            vertex->lon_e7 = value;
+        }
+    }
+    fence->point_fields |= 1 << event->index;
+}
+
+static int geofence_msg_cb(const json_stream_event_t *event, void *priv)
+{
+    geofence_msg_t *msg = priv;
+    const char *array = json_stream_get_key(&msg->stream, 1);
+
+    if (event->depth == 1) {
+        if (event->key == NULL) {
+            // 根不是对象
+            return -1;
+        }
+        if (strcmp(event->key, "op") == 0) {
+            if (event->type != JSON_STREAM_STRING) {
+                return -1;
+            }
+            if (strcmp(event->value, "add") == 0) {
+                msg->op = GEOFENCE_OP_ADD;
+            } else if (strcmp(event->value, "remove") == 0) {
+                msg->op = GEOFENCE_OP_REMOVE;
+            } else if (strcmp(event->value, "clear") == 0) {
+                msg->op = GEOFENCE_OP_CLEAR;
+            } else {
+                return -1;
+            }
+        } else if (event->type == JSON_STREAM_ARRAY_START &&
+                   ((strcmp(event->key, "fences") == 0 && msg->op != GEOFENCE_OP_ADD) ||
+                    (strcmp(event->key, "ids") == 0 && msg->op != GEOFENCE_OP_REMOVE))) {
+            // 分片到达即生效，须先知道操作
+            ESP_LOGE(TAG, "JSON格式错误, op需位于%s之前", event->key);
+            return -1;
+        }
+        return 0;
+    }
+    if (event->depth < 2 || array == NULL) {
+        return 0;
+    }
+
+    if (strcmp(array, "ids") == 0 && event->depth == 2) {
+        int32_t id;
+        if (geofence_parse_int(event, &id) && id >= 0) {
+            xSemaphoreTake(s_geofence_mutex, portMAX_DELAY);
+            geofence_remove(&s_geofence, id);
+            xSemaphoreGive(s_geofence_mutex);
+        }
+    } else if (strcmp(array, "fences") == 0) {
+        if (event->depth == 2) {
+            if (event->type == JSON_STREAM_OBJECT_START) {
+                geofence_fence_begin(msg, event->index);
+            } else if (event->type == JSON_STREAM_OBJECT_END) {
+                geofence_fence_end(msg);
+            } else if (event->type != JSON_STREAM_ARRAY_END) {
+                // 不是对象的元素，数组在开始时已计入
+                ESP_LOGW(TAG, "第%d个围栏格式错误", event->index);
+                msg->failed++;
+            }
+        } else if (msg->in_fence && event->depth == 3) {
+            geofence_fence_member(msg, event);
+        } else if (msg->in_fence && event->depth <= 5) {
+            const char *member = json_stream_get_key(&msg->stream, 3);
+            if (member != NULL && strcmp(member, "points") == 0) {
+                geofence_fence_point(msg, event);
+            }
+        }
+    }
+    return 0;
+}
+
+// 整条消息收齐后执行clear并重建索引
+static esp_err_t geofence_msg_finish(geofence_msg_t *msg)
+{
+    static const char *const op_names[] = {
+        [GEOFENCE_OP_NONE] = "",
+        [GEOFENCE_OP_ADD] = "add",
+        [GEOFENCE_OP_REMOVE] = "remove",
+        [GEOFENCE_OP_CLEAR] = "clear",
+    };
+
+    if (json_stream_end(&msg->stream) != OS_SUCCESS || msg->op == GEOFENCE_OP_NONE) {
+        ESP_LOGE(TAG, "JSON格式错误, op需为add、remove或clear");
+        return ESP_FAIL;
+    }
+
+    xSemaphoreTake(s_geofence_mutex, portMAX_DELAY);
+    if (msg->op == GEOFENCE_OP_CLEAR) {
+        geofence_clear(&s_geofence);
+    }
+    // 在此重建索引，不占用GPS事件任务的时间
+    if (geofence_build_index(&s_geofence) != 0) {
+        ESP_LOGW(TAG, "围栏索引内存不足，将逐个判断围栏");
+    }
+    ESP_LOGI(TAG, "围栏操作%s完成, 共%d个围栏, %lu个顶点", op_names[msg->op], s_geofence.fence_count,
+             (unsigned long)s_geofence.vertex_count);
+    xSemaphoreGive(s_geofence_mutex);
+    return msg->failed > 0 ? ESP_FAIL : ESP_OK;
+}
+
+esp_err_t geofence_manager_on_message(const char *data, size_t data_len, size_t offset, size_t total_len)
+{
+    geofence_msg_t *msg = &s_msg;
+
+    if (s_geofence_mutex == NULL || data == NULL || offset + data_len > total_len) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (offset == 0) {
+        memset(msg, 0, sizeof(geofence_msg_t));
+        json_stream_init(&msg->stream, geofence_msg_cb, msg);
+        msg->active = true;
+    } else if (!msg->active || offset != msg->received) {
+        // 已出错的消息的后续分片，或丢失了分片
+        msg->active = false;
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    msg->received += data_len;
+    if (json_stream_feed(&msg->stream, data, data_len) != OS_SUCCESS) {
+        ESP_LOGE(TAG, "JSON解析失败, 偏移%u", (unsigned)msg->stream.offset);
+        msg->active = false;
+        return ESP_FAIL;
+    }
+    if (msg->received < total_len) {
+        return ESP_OK;
+    }
+    msg->active = false;
+    return geofence_msg_finish(msg);
+}
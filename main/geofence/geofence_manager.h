@@ -0,0 +1,46 @@
+#ifndef GEOFENCE_MANAGER_H
+#define GEOFENCE_MANAGER_H
+
+#include <stddef.h>
+#include "esp_err.h"
+#include "gps_parser.h"
+
+/**
+ * @brief 初始化地理围栏
+ *
+ * 围栏由CONFIG_MQTT_GEOFENCE_TOPIC主题下发，坐标为度x1e7的整数:
+ *   {"op":"add","fences":[{"id":1,"dwell_s":60,"lat_e7":312304160,"lon_e7":1214737010,"radius_m":100},
+ *                         {"id":2,"points":[[312304160,1214737010],[312314160,1214737010],...]}]}
+ *   {"op":"remove","ids":[1,2]}
+ *   {"op":"clear"}
+ * 同id的围栏被替换。进入、离开、停留事件立即发布到"<用户名>/geofence"主题:
+ *   {"id":1,"event":"enter","timestamp":1700000000,"lat_e7":312304160,"lon_e7":1214737010}
+ *
+ * @return esp_err_t ESP_OK成功，其他值失败
+ */
+esp_err_t geofence_manager_init(void);
+
+/**
+ * @brief 用一个定位结果判断围栏，并发布产生的事件
+ *
+ * @param gps_info GPS信息结构体指针
+ */
+void geofence_manager_on_fix(const gps_info_t *gps_info);
+
+/**
+ * @brief 处理围栏配置消息的一个分片
+ *
+ * 超出MQTT接收缓冲区的消息分多个分片到达，逐片流式解析，内存占用与消息长度无关。
+ * 围栏和删除在解析到时即生效，因此op须位于fences或ids之前；消息中途出错时，
+ * 之前的围栏已生效。
+ *
+ * @param data 分片内容，不需要以'\0'结尾
+ * @param data_len 分片长度
+ * @param offset 分片在消息中的偏移，0表示新消息
+ * @param total_len 消息总长度
+ * @return esp_err_t 最后一个分片返回整条消息的结果，之前的分片返回ESP_OK；
+ *         ESP_FAIL格式错误或有围栏未能添加，ESP_ERR_INVALID_STATE分片不连续
+ */
+esp_err_t geofence_manager_on_message(const char *data, size_t data_len, size_t offset, size_t total_len);
+
+#endif // GEOFENCE_MANAGER_H
@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 #include "esp_err.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -8,7 +9,18 @@
 #include "string.h"
 #include "esp_idf_version.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "gps.h"
+#include "track_upload.h"
+#include "geofence_manager.h"
+#include "time_sync.h"
+#include "nmea_parser.h"
+#include "line_assembler.h"
+#include "gnss_fusion.h"
+#include "lbs_scheduler.h"
+#include "motion_detector.h"
+#include "json_generator.h"
+#include "mqtt.h"
 
 
 static const char *TAG = "GPS";
@@ -18,14 +30,34 @@ static const char *TAG = "GPS";
 #define UART_TX_PIN             CONFIG_GNSS_UART_TX
 #define UART_RX_BUF_SIZE        (2048)
 #define ESP_GPS_BUF_SIZE        2048
+// 单行最大长度，+CGPSINFO约80字节，NMEA语句不超过82字节
+#define GPS_LINE_BUF_SIZE       256
 #define GPS_EVENT_LOOP_QUEUE_SIZE (16)
 //AT commands For GNSS
 //more details in SIM76XX AT command manual
 #define GNSSPWRON       "AT+CGNSSPWR=1\r\n"
 #define GNSSPWROFF      "AT+CGNSSPWR=0\r\n"
-#define GPSINFO         "AT+CGPSINFO=15\r\n"
+// 上报间隔随运动状态调整，单位为秒，取值1~255
+#define GPSINFO         "AT+CGPSINFO=%u\r\n"
 #define GNSSPORTSWITCH  "AT+CGNSSPORTSWITCH=1,0\r\n"
 #define LBSINFO         "AT+CLBS=4,,,,2\r\n"
+#define CELLINFO        "AT+CPSI?\r\n"
+#define GNSSHOTSTART    "AT+CGPSHOT\r\n"
+// NMEA输出: 语句输出到UART，启用GGA/GSA/GSV/RMC/VTG，1Hz
+#define GNSSNMEAPORT    "AT+CGNSSPORTSWITCH=0,1\r\n"
+#define GNSSNMEATYPE    "AT+CGNSSNMEA=1,0,1,1,1,1,0,0\r\n"
+#define GNSSNMEARATE    "AT+CGPSNMEARATE=0\r\n"
+
+// 无定位时查询服务小区并调度基站定位的最小间隔，NMEA模式下每秒都会报告无定位
+#define NO_FIX_INTERVAL_US      (10 * 1000 * 1000LL)
+
+// GNSS水平精度按 HDOP × 用户等效测距误差 估计
+#define GNSS_UERE_M             5.0f
+// 无HDOP(+CGPSINFO)或基站未给出精度时使用的默认精度，单位为米
+#define GNSS_DEFAULT_ACCURACY_M 10.0f
+#define LBS_DEFAULT_ACCURACY_M  1000.0f
+
+#define MOTION_EVENT_JSON_SIZE  160
 
 
 ESP_EVENT_DEFINE_BASE(ESP_GPS_EVENT);
@@ -39,375 +71,345 @@ typedef struct {
     TaskHandle_t tsk_hdl;              // GPS解析任务句柄
     uart_port_t uart_port;             // UART端口号
     uint8_t *buffer;                   // 运行时缓冲区
+    char line_buf[GPS_LINE_BUF_SIZE];  // 未接收完整的行
+    line_assembler_t lines;            // 按行拆分UART数据并分发
+    uint32_t reported_drops;           // 上次打印时的丢弃字节数
     gps_info_t gps_data;               // GPS数据
+    nmea_parser_t nmea;                // NMEA流式解析器
+    int64_t last_no_fix_us;            // 上次处理无定位的时间
+    uint64_t cell;                     // 最近一次查询到的服务小区
+    lbs_sched_t lbs;                   // 基站定位请求调度及结果缓存
+    gnss_fusion_t fusion;              // GNSS/基站定位融合滤波器
+    motion_detector_t motion;          // 运动状态检测，决定GNSS上报间隔
 } esp_gps_t;
 
 /**
- * @brief 将GPS坐标从度分格式(ddmm.mmmm)转换为十进制度格式
- * 
- * @param coord_ddmm 度分格式的坐标
- * @return double 十进制度格式的坐标
+ * @brief 设置+CGPSINFO上报间隔
  */
-double convert_to_decimal_degrees(double coord_ddmm)
+static void esp_gps_set_report_interval(esp_gps_t *esp_gps, uint16_t interval_s)
 {
-    int degrees = (int)(coord_ddmm / 100.0);
-    double minutes = coord_ddmm - degrees * 100.0;
-    return degrees + minutes / 60.0;
+    char cmd[32];
+    int len = snprintf(cmd, sizeof(cmd), GPSINFO, (unsigned)interval_s);
+    uart_tx_chars(esp_gps->uart_port, cmd, len);
 }
 
+static void GNSS_module_init(void *arg){
+    esp_gps_t *esp_gps = (esp_gps_t *)arg;
+    uart_tx_chars(esp_gps->uart_port,"\r\n",strlen("\r\n"));
+    vTaskDelay(1500);
+    uart_tx_chars(esp_gps->uart_port,GNSSPWRON,strlen(GNSSPWRON));
+    vTaskDelay(2000);
+    // 热启动且上次有GNSS定位时，使用热启动加快首次定位
+    data_model_t *model = data_model_get_latest();
+    if (data_model_is_restored() && model != NULL &&
+        model->gps.gps_valid && model->gps.data_source == FROM_GNSS) {
+        ESP_LOGI(TAG, "使用上次定位结果热启动GNSS");
+        uart_tx_chars(esp_gps->uart_port, GNSSHOTSTART, strlen(GNSSHOTSTART));
+        vTaskDelay(1000);
+    }
+#if CONFIG_GNSS_NMEA_OUTPUT
+    uart_tx_chars(esp_gps->uart_port, GNSSNMEATYPE, strlen(GNSSNMEATYPE));
+    vTaskDelay(1000);
+    uart_tx_chars(esp_gps->uart_port, GNSSNMEARATE, strlen(GNSSNMEARATE));
+    vTaskDelay(1000);
+    uart_tx_chars(esp_gps->uart_port, GNSSNMEAPORT, strlen(GNSSNMEAPORT));
+    vTaskDelay(1000);
+#else
+    uart_tx_chars(esp_gps->uart_port, GNSSPORTSWITCH, strlen(GNSSPORTSWITCH));
+    vTaskDelay(1000);
+    esp_gps_set_report_interval(esp_gps, motion_detector_interval_s(&esp_gps->motion));
+    vTaskDelay(1000);
+#endif
 
-/**
- * @brief 将GPS的ddmmyy日期格式转换为yyyy/mm/dd格式
- * 
- * @param date_in GPS日期字符串，格式为ddmmyy
- * @param date_out 输出缓冲区，至少15字节
- * @return int 0表示成功，-1表示失败
- */
-int convert_gps_date(const char *date_in, char *date_out) {
-    if (date_in == NULL || date_out == NULL || strlen(date_in) < 6) {
-        return -1;
+}
+
+// 定位结果的水平精度，单位为米
+static float gps_fix_accuracy(const gps_info_t *info)
+{
+    if (info->data_source == FROM_LBS) {
+        return info->accuracy > 0 ? info->accuracy : LBS_DEFAULT_ACCURACY_M;
     }
-    
-    // 提取日、月、年
-    char day[3] = {0};
-    char month[3] = {0};
-    char year[3] = {0};
-    
-    // 复制前两位作为日
-    strncpy(day, date_in, 2);
-    // 复制中间两位作为月
-    strncpy(month, date_in + 2, 2);
-    // 复制最后两位作为年
-    strncpy(year, date_in + 4, 2);
-    
-    // 格式化为yyyy/mm/dd，年份前加"20"表示21世纪
-    sprintf(date_out, "20%s/%s/%s", year, month, day);
-    
-    return 0;
+    return info->hdop > 0 ? info->hdop * GNSS_UERE_M : GNSS_DEFAULT_ACCURACY_M;
 }
 
 /**
- * @brief 将GPS的hhmmss.ss时间格式转换为hh:mm:ss格式
+ * @brief 以融合后的GNSS定位更新运动状态，状态变化时调整上报间隔并发布事件
  * 
- * @param time_in GPS时间字符串，格式为hhmmss.ss
- * @param time_out 输出缓冲区，至少9字节
- * @return int 0表示成功，-1表示失败
+ * 基站定位的离散程度远大于静止判定半径，不参与判定
  */
-int convert_gps_time(const char *time_in, char *time_out) {
-    if (time_in == NULL || time_out == NULL || strlen(time_in) < 6) {
-        return -1;
+static void esp_gps_update_motion(esp_gps_t *esp_gps, int64_t now_ms, const gnss_fusion_estimate_t *estimate)
+{
+    motion_fix_t fix = {
+        .time_ms = now_ms,
+        .lat_e7 = estimate->lat_e7,
+        .lon_e7 = estimate->lon_e7,
+        .speed = estimate->speed,
+        .accuracy = estimate->accuracy,
+    };
+    if (!motion_detector_update(&esp_gps->motion, &fix)) {
+        return;
     }
-    
-    // 提取时、分、秒
-    char hour[3] = {0};
-    char minute[3] = {0};
-    char second[3] = {0};
-    
-    // 复制前两位作为时
-    strncpy(hour, time_in, 2);
-    // 复制中间两位作为分
-    strncpy(minute, time_in + 2, 2);
-    // 复制后两位作为秒，忽略小数点后的部分
-    strncpy(second, time_in + 4, 2);
-    
-    // 格式化为hh:mm:ss
-    sprintf(time_out, "%s:%s:%s", hour, minute, second);
-    
-    return 0;
-}
 
+    gps_motion_event_t event = {
+        .state = motion_detector_state(&esp_gps->motion),
+        .interval_s = motion_detector_interval_s(&esp_gps->motion),
+        .utc_ms = esp_gps->gps_data.utc_ms,
+        .lat_e7 = estimate->lat_e7,
+        .lon_e7 = estimate->lon_e7,
+    };
+#if !CONFIG_GNSS_NMEA_OUTPUT
+    // NMEA模式固定1Hz输出，只发布事件
+    esp_gps_set_report_interval(esp_gps, event.interval_s);
+#endif
+    esp_event_post_to(esp_gps->event_loop_hdl, ESP_GPS_EVENT, GPS_MOTION_CHANGE, &event, sizeof(event), 100 / portTICK_PERIOD_MS);
+}
 
 /**
- * @brief 解析CGPSINFO响应字符串
+ * @brief 将定位结果送入融合滤波器，发布融合后的位置及不确定半径
  * 
- * @param line CGPSINFO响应字符串
- * @param gps_info GPS信息结构体指针
- * @return int 0表示成功解析有效数据，1表示成功解析但无GPS信号，负数表示解析失败
+ * 偏离当前估计过远的定位结果作为异常值丢弃，不发布
  */
-int parse_gps_info(const char *line, gps_info_t *gps_info)
+static void esp_gps_publish(esp_gps_t *esp_gps)
 {
-    if (!line || !gps_info) {
-        return -1;
-    }
-    
-    // 检查是否为CGPSINFO响应
-    const char *cgpsinfo_start = strstr(line, "+CGPSINFO:");
-    if (cgpsinfo_start == NULL) {
-        return -2;
-    }
-    
-    // 初始化为无效状态
-    gps_info->valid = 0;
-    
-    // 跳过"+CGPSINFO:"前缀
-    const char *data_start = cgpsinfo_start + strlen("+CGPSINFO:");
-    
-    // 检查是否为无信号响应（+CGPSINFO: ,,,,,,,,）
-    if (strstr(data_start, ",,,,,,,,") != NULL) {
-        //ESP_LOGW(TAG, "GPS无定位信号");
-        // 清空所有数据字段
-        memset(gps_info, 0, sizeof(gps_info_t));
-        // 明确标记为无效
-        gps_info->valid = 0;
-        return 1;  // 返回1表示成功解析但无信号
-    }
-    
-    // 分配临时存储空间
-    char buffer[256] = {0};
-    strncpy(buffer, data_start, sizeof(buffer) - 1);
-    
-    // 使用strtok分割字符串
-    char *tokens[9] = {NULL};
-    char *token = strtok(buffer, ",");
-    int i = 0;
-    
-    // 提取所有的字段
-    while (token != NULL && i < 9) {
-        tokens[i++] = token;
-        token = strtok(NULL, ",");
-    }
-    
-    // 检查是否有足够的字段
-    if (i != 9) {
-        ESP_LOGW(TAG, "GPS信息字段不完整: 预期9个字段，实际获得%d个", i);
-        return -3;
+    gps_info_t *info = &esp_gps->gps_data;
+    int64_t now_ms = esp_timer_get_time() / 1000;
+    gnss_fusion_fix_t fix = {
+        .time_ms = now_ms,
+        .lat_e7 = info->lat_e7,
+        .lon_e7 = info->lon_e7,
+        .accuracy = gps_fix_accuracy(info),
+    };
+
+    gnss_fusion_result_t result = gnss_fusion_update(&esp_gps->fusion, &fix);
+    if (result == GNSS_FUSION_REJECTED || result == GNSS_FUSION_INVALID) {
+        char lat_str[16];
+        char lon_str[16];
+        gps_format_coord(lat_str, sizeof(lat_str), fix.lat_e7, "NS");
+        gps_format_coord(lon_str, sizeof(lon_str), fix.lon_e7, "EW");
+        ESP_LOGW(TAG, "丢弃异常定位: %s, %s, 精度%.0fm, 来源%s", lat_str, lon_str, fix.accuracy,
+                 info->data_source == FROM_LBS ? "LBS" : "GNSS");
+        return;
     }
-    
-    // 检查第一个字段是否为空，表示无经纬度数据
-    if (strlen(tokens[0]) == 0) {
-        ESP_LOGW(TAG, "GPS无定位数据");
-        memset(gps_info, 0, sizeof(gps_info_t));
-        gps_info->valid = 0;
-        return 1;  // 无GPS定位信息但解析成功
+
+    gnss_fusion_estimate_t estimate;
+    gnss_fusion_get_estimate(&esp_gps->fusion, now_ms, &estimate);
+    info->lat_e7 = estimate.lat_e7;
+    info->lon_e7 = estimate.lon_e7;
+    info->accuracy = estimate.accuracy;
+    esp_event_post_to(esp_gps->event_loop_hdl, ESP_GPS_EVENT, GPS_DATA_UPDATE, info, sizeof(gps_info_t), 100 / portTICK_PERIOD_MS);
+    if (info->data_source == FROM_GNSS) {
+        esp_gps_update_motion(esp_gps, now_ms, &estimate);
     }
-    
-    // 解析所有字段
-    gps_info->latitude = atof(tokens[0]);
-    gps_info->ns_indicator = tokens[1][0]; // 'N' 或 'S'
-    gps_info->longitude = atof(tokens[2]);
-    gps_info->ew_indicator = tokens[3][0]; // 'E' 或 'W'
-    
-    // 复制日期和时间字符串
-    convert_gps_date(tokens[4], gps_info->date);
-    convert_gps_time(tokens[5], gps_info->utc_time);
-    
-    gps_info->altitude = atof(tokens[6]);
-    gps_info->speed = atof(tokens[7]);
-    gps_info->course = atof(tokens[8]);
-    
-    // 设置为有效状态
-    gps_info->valid = 1;
-    gps_info->data_source = FROM_GNSS; // 设置数据来源为GNSS
-    // 调试输出
-    // ESP_LOGI(TAG, "解析GPS数据成功: 纬度=%.6f%c, 经度=%.6f%c, 高度=%.1f米, 速度=%.1f节, 航向=%.1f度, 日期=%s, 时间=%s, 数据来源：GNSS",
-    //          gps_info->latitude, gps_info->ns_indicator,
-    //          gps_info->longitude, gps_info->ew_indicator,
-    //          gps_info->altitude, gps_info->speed, gps_info->course,
-    //          gps_info->date, gps_info->utc_time);
-    
-    return 0;
 }
 
-
 /**
- * @brief 解析LBS基站定位响应
+ * @brief GNSS无定位时调用，由调度器决定是否请求基站定位
  * 
- * @param line LBS响应字符串
- * @param gps_info GPS信息结构体指针，用于存储解析结果
- * @return int 0表示成功解析有效数据，非零表示解析失败
+ * 服务小区不变时请求间隔指数退避，回到已知小区时直接使用缓存结果。
+ * 同时查询服务小区，供下一次调度使用
  */
-int parse_lbs_info(const char *line, gps_info_t *gps_info)
+static void esp_gps_on_no_fix(esp_gps_t *esp_gps)
 {
-    if (!line || !gps_info) {
-        return -1;
+    int64_t now_us = esp_timer_get_time();
+    if (esp_gps->last_no_fix_us != 0 && now_us - esp_gps->last_no_fix_us < NO_FIX_INTERVAL_US) {
+        return;
     }
-    
-    // 检查是否为CLBS响应
-    const char *clbs_start = strstr(line, "+CLBS:");
-    if (clbs_start == NULL) {
-        return -2;
-    }
-    
-    // 跳过"+CLBS:"前缀
-    const char *data_start = clbs_start + strlen("+CLBS:");
-    
-    // 分配临时存储空间
-    char buffer[256] = {0};
-    strncpy(buffer, data_start, sizeof(buffer) - 1);
-    
-    // 使用strtok分割字符串
-    char *tokens[6] = {NULL};
-    char *token = strtok(buffer, ",");
-    int i = 0;
-    
-    // 提取所有的字段
-    while (token != NULL && i < 6) {
-        tokens[i++] = token;
-        token = strtok(NULL, ",");
-    }
-    
-    // 检查是否有足够的字段
-    if (i != 6) {
-        ESP_LOGW(TAG, "LBS信息字段不完整: 预期6个字段，实际获得%d个", i);
-        return -3;
-    }
-    
-    // 检查第一个字段是否为0，0表示成功
-    int status = atoi(tokens[0]);
-    if (status != 0) {
-        ESP_LOGW(TAG, "LBS定位失败，状态码: %d", status);
-        memset(gps_info, 0, sizeof(gps_info_t));
-        gps_info->valid = 0;
-        return -4;
+    esp_gps->last_no_fix_us = now_us;
+    uart_tx_chars(esp_gps->uart_port, CELLINFO, strlen(CELLINFO));
+
+    int64_t now_ms = now_us / 1000;
+    lbs_position_t pos;
+    switch (lbs_sched_on_no_fix(&esp_gps->lbs, now_ms, esp_gps->cell, &pos)) {
+        case LBS_SCHED_QUERY:
+            ESP_LOGI(TAG, "请求基站定位，近1小时共%lu次",
+                     (unsigned long)lbs_sched_queries_last_hour(&esp_gps->lbs, now_ms));
+            uart_tx_chars(esp_gps->uart_port, LBSINFO, strlen(LBSINFO));
+            break;
+        case LBS_SCHED_USE_CACHE:
+            ESP_LOGI(TAG, "使用服务小区缓存的基站定位结果");
+            memset(&esp_gps->gps_data, 0, sizeof(gps_info_t));
+            esp_gps->gps_data.lat_e7 = pos.lat_e7;
+            esp_gps->gps_data.lon_e7 = pos.lon_e7;
+            esp_gps->gps_data.accuracy = pos.accuracy;
+            esp_gps->gps_data.data_source = FROM_LBS;
+            esp_gps->gps_data.valid = 1;
+            esp_gps_publish(esp_gps);
+            break;
+        default:
+            break;
     }
-    
-    // 解析经纬度（注意LBS返回的是十进制格式，不是度分格式）
-    double latitude = atof(tokens[1]);
-    double longitude = atof(tokens[2]);
-    //int accuracy = atoi(tokens[3]);
-    
-    // 填充GPS信息结构体
-    memset(gps_info, 0, sizeof(gps_info_t)); // 先清空结构体
-    
-    // 直接使用十进制度格式的经纬度
-    // 我们需要将十进制度转换为ddmm.mmmm格式存储，以保持和GPS格式一致
-    int lat_deg = (int)latitude;
-    double lat_min = (latitude - lat_deg) * 60.0;
-    gps_info->latitude = lat_deg * 100.0 + lat_min;
-    
-    int lon_deg = (int)longitude;
-    double lon_min = (longitude - lon_deg) * 60.0;
-    gps_info->longitude = lon_deg * 100.0 + lon_min;
-    
-    // 设置北/南、东/西指示符
-    gps_info->ns_indicator = (latitude >= 0) ? 'N' : 'S';
-    gps_info->ew_indicator = (longitude >= 0) ? 'E' : 'W';
-    
-    // 设置其他字段
-    // 对于LBS定位，我们没有高度、速度和航向信息，设为0
-    gps_info->altitude = 0;
-    gps_info->speed = 0;
-    gps_info->course = 0;
-    gps_info->data_source = FROM_LBS;
-
-    // 设置日期和时间
-    memcpy(gps_info->date, tokens[4], sizeof(gps_info->date)-1);
-    memcpy(gps_info->utc_time, tokens[5], sizeof(gps_info->utc_time)-1);
-    // 设置为有效状态
-    gps_info->valid = 1;
-    
-    // 调试输出
-    // ESP_LOGI(TAG, "解析LBS数据成功: 纬度=%.6f%c (%.6f), 经度=%.6f%c (%.6f), 精度=%d米, 日期=%s, 时间=%s",
-    //          gps_info->latitude, gps_info->ns_indicator, latitude,
-    //          gps_info->longitude, gps_info->ew_indicator, longitude,
-    //          accuracy, gps_info->date, gps_info->utc_time);
-    
-    return 0;
 }
 
-
-static void GNSS_module_init(void *arg){
+/**
+ * @brief NMEA语句校验通过后的回调，每个RMC发布一次定位
+ * 
+ * RMC之前到达的GGA/GSA/GSV提供精度信息
+ */
+static void process_nmea_sentence(nmea_sentence_t type, const nmea_fix_t *fix, void *arg)
+{
     esp_gps_t *esp_gps = (esp_gps_t *)arg;
-    uart_tx_chars(esp_gps->uart_port,"\r\n",strlen("\r\n"));
-    vTaskDelay(1500);
-    uart_tx_chars(esp_gps->uart_port,GNSSPWRON,strlen(GNSSPWRON));
-    vTaskDelay(2000);
-    uart_tx_chars(esp_gps->uart_port, GNSSPORTSWITCH, strlen(GNSSPORTSWITCH));
-    vTaskDelay(1000);
-    uart_tx_chars(esp_gps->uart_port, GPSINFO, strlen(GPSINFO));
-    vTaskDelay(1000);
+    if (type != NMEA_SENTENCE_RMC) {
+        return;
+    }
 
+    int result = parse_nmea_fix(fix, &esp_gps->gps_data);
+    if (result == 0) {
+        lbs_sched_on_gnss_fix(&esp_gps->lbs);
+        esp_gps_publish(esp_gps);
+    } else {
+        esp_gps_on_no_fix(esp_gps);
+    }
 }
 
-static void uart_get_lbs(void *arg){
+/**
+ * @brief NMEA语句行，交给流式解析器
+ */
+static void process_nmea_line(const char *line, size_t length, void *arg)
+{
     esp_gps_t *esp_gps = (esp_gps_t *)arg;
-    uart_tx_chars(esp_gps->uart_port,LBSINFO,strlen(LBSINFO));
-    vTaskDelay(1000);
+    nmea_parser_feed(&esp_gps->nmea, line, length);
 }
 
 /**
  * @brief 处理接收到+CGPSINFO响应的函数
  * 
- * @param buffer 接收缓冲区
- * @param length 数据长度
+ * @param line 完整的一行，以NULL结尾
+ * @param length 行长度
  */
-static void process_cgps_info(void *arg, size_t length)
+static void process_cgps_info(const char *line, size_t length, void *arg)
 {
     esp_gps_t *esp_gps = (esp_gps_t *)arg;
-    // 确保字符串以NULL结尾
-    esp_gps->buffer[length] = '\0';
-    //ESP_LOGI(TAG, "接收到数据: %s", buffer);
     
     // 解析GPS信息
-    int result = parse_gps_info((char*)(esp_gps->buffer), &esp_gps->gps_data);
+    int result = parse_gps_info(line, &esp_gps->gps_data);
     
     if (result == 0) {
         // 解析成功且有有效GPS信息
-        esp_event_post_to(esp_gps->event_loop_hdl, ESP_GPS_EVENT, GPS_DATA_UPDATE, &(esp_gps->gps_data), sizeof(gps_info_t), 100 / portTICK_PERIOD_MS);
+        lbs_sched_on_gnss_fix(&esp_gps->lbs);
+        esp_gps_publish(esp_gps);
     } else if (result == 1) {
         // 解析成功但无GPS信号
         ESP_LOGW(TAG, "当前无GPS信号或正在搜索卫星,将尝试使用基站定位");
-        uart_get_lbs(esp_gps);
+        esp_gps_on_no_fix(esp_gps);
     } else {
         // 解析失败
         ESP_LOGW(TAG, "GPS信息解析失败，错误码: %d ，将尝试使用基站定位", result);
-        uart_get_lbs(esp_gps);
+        esp_gps_on_no_fix(esp_gps);
     }
 }
 
 
 /**
-* @brief 处理接收到+CGPSINFO响应的函数
+* @brief 处理接收到+CLBS响应的函数
 * 
-* @param buffer 接收缓冲区
-* @param length 数据长度
+* @param line 完整的一行，以NULL结尾
+* @param length 行长度
 */
-static void process_clbs_info(void *arg, size_t length)
+static void process_clbs_info(const char *line, size_t length, void *arg)
 {
     esp_gps_t *esp_gps = (esp_gps_t *)arg;
-    // 确保字符串以NULL结尾
-    esp_gps->buffer[length] = '\0';
-    //ESP_LOGI(TAG, "接收到数据: %s", buffer);
     
     // 解析GPS信息
-    int result = parse_lbs_info((char*)(esp_gps->buffer), &esp_gps->gps_data);
+    int result = parse_lbs_info(line, &esp_gps->gps_data);
+    int64_t now_ms = esp_timer_get_time() / 1000;
     
     if (result == 0) {
-        // 解析成功且有有效GPS信息
-        esp_event_post_to(esp_gps->event_loop_hdl, ESP_GPS_EVENT, GPS_DATA_UPDATE, &(esp_gps->gps_data), sizeof(gps_info_t), 100 / portTICK_PERIOD_MS);
+        // 解析成功且有有效GPS信息，缓存到当前服务小区
+        lbs_position_t pos = {
+            .lat_e7 = esp_gps->gps_data.lat_e7,
+            .lon_e7 = esp_gps->gps_data.lon_e7,
+            .accuracy = esp_gps->gps_data.accuracy,
+        };
+        lbs_sched_on_result(&esp_gps->lbs, now_ms, &pos);
+        esp_gps_publish(esp_gps);
     } else if (result == 1) {
         // 解析成功但无GPS信号
         ESP_LOGW(TAG, "当前基站无定位信息");
+        lbs_sched_on_result(&esp_gps->lbs, now_ms, NULL);
         esp_event_post_to(esp_gps->event_loop_hdl, ESP_GPS_EVENT, GPS_DATA_ERROR,NULL, sizeof(gps_info_t), 100 / portTICK_PERIOD_MS);
     } else {
         // 解析失败
         ESP_LOGW(TAG, "基站定位信息解析失败，错误码: %d", result);
+        lbs_sched_on_result(&esp_gps->lbs, now_ms, NULL);
         esp_event_post_to(esp_gps->event_loop_hdl, ESP_GPS_EVENT, GPS_DATA_ERROR,NULL, sizeof(gps_info_t), 100 / portTICK_PERIOD_MS);
     }
 }
 
-static void esp_handle_uart_pattern(void *arg)
+/**
+* @brief 处理接收到+CPSI响应的函数，记录当前服务小区
+* 
+* @param line 完整的一行，以NULL结尾
+* @param length 行长度
+*/
+static void process_cpsi_info(const char *line, size_t length, void *arg)
 {
     esp_gps_t *esp_gps = (esp_gps_t *)arg;
-    int pos = uart_pattern_pop_pos(esp_gps->uart_port);
-    if (pos != -1){
-        size_t buffered_size;
-        uart_get_buffered_data_len(esp_gps->uart_port, &buffered_size);
-        int read_len = uart_read_bytes(esp_gps->uart_port, esp_gps->buffer, buffered_size, pdMS_TO_TICKS(100));
-        if (read_len > 0){
-            esp_gps->buffer[read_len] = '\0';
-            if (strstr((char*)esp_gps->buffer, "+CGPSINFO:") != NULL) {
-                process_cgps_info(esp_gps, read_len);
-            }
-            else if (strstr((char*)esp_gps->buffer, "+CLBS:") != NULL) {
-                process_clbs_info(esp_gps, read_len);
-            }
-        }
+    cell_info_t cell;
+
+    int result = parse_cpsi_info(line, &cell);
+    if (result == 0) {
+        esp_gps->cell = lbs_sched_cell_key(cell.mcc, cell.mnc, cell.lac, cell.cell_id);
     } else {
-        //ESP_LOGE(TAG, "检测到模式但位置无效");
+        // 无服务或无法识别时按未知小区处理，不使用缓存结果
+        esp_gps->cell = LBS_CELL_UNKNOWN;
+    }
+}
+
+// 按响应前缀分发完整的行，NMEA语句与AT响应共用UART
+static const line_dispatch_t s_gps_dispatch[] = {
+    { "+CGPSINFO:", process_cgps_info },
+    { "+CLBS:",     process_clbs_info },
+    { "+CPSI:",     process_cpsi_info },
+    { "$",          process_nmea_line },
+};
+
+/**
+ * @brief 丢弃计数有变化时打印
+ */
+static void esp_gps_report_drops(esp_gps_t *esp_gps)
+{
+    const line_assembler_stats_t *stats = line_assembler_get_stats(&esp_gps->lines);
+    if (stats->dropped_bytes != esp_gps->reported_drops) {
+        esp_gps->reported_drops = stats->dropped_bytes;
+        ESP_LOGW(TAG, "UART数据丢弃: 累计%lu字节, %lu行 (共接收%lu行)",
+                 (unsigned long)stats->dropped_bytes, (unsigned long)stats->dropped_lines,
+                 (unsigned long)stats->lines);
     }
 }
 
+/**
+ * @brief 读出UART中已缓存的全部数据并按行分发
+ */
+static void esp_handle_uart_data(esp_gps_t *esp_gps)
+{
+    size_t buffered_size = 0;
+    uart_get_buffered_data_len(esp_gps->uart_port, &buffered_size);
+    while (buffered_size > 0) {
+        size_t read_size = buffered_size > ESP_GPS_BUF_SIZE ? ESP_GPS_BUF_SIZE : buffered_size;
+        int read_len = uart_read_bytes(esp_gps->uart_port, esp_gps->buffer, read_size, 0);
+        if (read_len <= 0) {
+            break;
+        }
+        // 跨读取的行在此拼接，一次读取中的多行依次分发
+        line_assembler_feed(&esp_gps->lines, (const char *)esp_gps->buffer, read_len);
+        buffered_size -= read_len;
+    }
+    esp_gps_report_drops(esp_gps);
+}
+
+/**
+ * @brief 清空UART后丢弃未完成的行，避免与后续数据拼接
+ */
+static void esp_gps_flush_uart(esp_gps_t *esp_gps)
+{
+    size_t buffered_size = 0;
+    uart_get_buffered_data_len(esp_gps->uart_port, &buffered_size);
+    uart_flush(esp_gps->uart_port);
+    xQueueReset(esp_gps->event_queue);
+    line_assembler_reset(&esp_gps->lines, buffered_size);
+    esp_gps_report_drops(esp_gps);
+}
+
 static void ESP_GPS_TASK(void *arg) 
 {   
     esp_gps_t *esp_gps = (esp_gps_t *)arg;
@@ -419,19 +421,15 @@ static void ESP_GPS_TASK(void *arg)
             // 只处理接收到数据的事件
             switch (event.type){
             case UART_DATA:
+                esp_handle_uart_data(esp_gps);
                 break;
             case UART_FIFO_OVF:
                 ESP_LOGW(TAG, "HW FIFO Overflow");
-                uart_flush(esp_gps->uart_port);
-                xQueueReset(esp_gps->event_queue);
+                esp_gps_flush_uart(esp_gps);
                 break;
             case UART_BUFFER_FULL:
                 ESP_LOGW(TAG, "Ring Buffer Full");
-                uart_flush(esp_gps->uart_port);
-                xQueueReset(esp_gps->event_queue);
-                break;
-            case UART_PATTERN_DET:
-                esp_handle_uart_pattern(esp_gps);   
+                esp_gps_flush_uart(esp_gps);
                 break;
             default:
                 break;
@@ -443,6 +441,26 @@ static void ESP_GPS_TASK(void *arg)
 }
 
 
+/**
+ * @brief 初始化行拼接器、解析器和滤波器，不涉及UART和任务
+ * 
+ * 回放测试(test_apps/gps_replay)也从这里开始
+ */
+static void esp_gps_state_init(esp_gps_t *esp_gps)
+{
+    nmea_parser_init(&esp_gps->nmea, process_nmea_sentence, esp_gps);
+    gnss_fusion_init(&esp_gps->fusion, NULL);
+    lbs_sched_init(&esp_gps->lbs, NULL);
+    motion_detector_config_t motion_config = MOTION_DETECTOR_CONFIG_DEFAULT();
+    motion_config.park_time_ms = CONFIG_GNSS_PARK_TIME_S * 1000;
+    motion_config.interval_s[MOTION_MOVING] = CONFIG_GNSS_MOVING_INTERVAL_S;
+    motion_config.interval_s[MOTION_STATIONARY] = CONFIG_GNSS_STATIONARY_INTERVAL_S;
+    motion_config.interval_s[MOTION_PARKED] = CONFIG_GNSS_PARKED_INTERVAL_S;
+    motion_detector_init(&esp_gps->motion, &motion_config);
+    line_assembler_init(&esp_gps->lines, esp_gps->line_buf, sizeof(esp_gps->line_buf),
+                        s_gps_dispatch, sizeof(s_gps_dispatch) / sizeof(s_gps_dispatch[0]), esp_gps);
+}
+
 esp_gps_handle_t esp_gps_init(const esp_gps_config_t *config){
     esp_gps_t *esp_gps = calloc(1, sizeof(esp_gps_t));
     if (!esp_gps) {
@@ -456,6 +474,7 @@ esp_gps_handle_t esp_gps_init(const esp_gps_config_t *config){
     }
     /* Set attributes */
     esp_gps->uart_port = config->uart.uart_port;
+    esp_gps_state_init(esp_gps);
     /* Install UART friver */
     uart_config_t uart_config = {
         .baud_rate = config->uart.baud_rate,
@@ -480,9 +499,7 @@ esp_gps_handle_t esp_gps_init(const esp_gps_config_t *config){
         goto err_uart_config;
     }
 
-    uart_enable_pattern_det_baud_intr(esp_gps->uart_port, '\n', 1, 9, 0, 0);
-
-    uart_pattern_queue_reset(esp_gps->uart_port, config->uart.event_queue_size);
+    // UART_DATA事件到达即读出，行边界由行拼接器处理
     uart_flush(esp_gps->uart_port);
 
     esp_event_loop_args_t loop_args = {
@@ -546,28 +563,91 @@ esp_err_t esp_gps_remove_handler(esp_gps_handle_t gps_hdl, esp_event_handler_t e
 }
 
 
+// 定位时刻格式化为yyyy/mm/dd hh:mm:ss.s，仅用于日志
+static const char *gps_format_utc(int64_t utc_ms, char *buf, size_t size)
+{
+    if (utc_ms <= 0) {
+        return "未知";
+    }
+    time_t seconds = utc_ms / 1000;
+    struct tm tm;
+    gmtime_r(&seconds, &tm);
+    size_t len = strftime(buf, size, "%Y/%m/%d %H:%M:%S", &tm);
+    snprintf(buf + len, size - len, ".%d", (int)(utc_ms % 1000) / 100);
+    return buf;
+}
+
+static const char *const s_motion_events[] = {
+    [MOTION_MOVING] = "start",
+    [MOTION_STATIONARY] = "stop",
+    [MOTION_PARKED] = "park",
+};
+
+static void gps_publish_motion_event(const gps_motion_event_t *event)
+{
+    char buf[MOTION_EVENT_JSON_SIZE];
+    json_gen_str_t jstr;
+
+    // 缓存的基站定位之后可能没有定位时刻，取当前时间；系统时间也未设置时不带时间戳
+    int64_t time_ms = event->utc_ms;
+    if (time_ms <= 0 && time_sync_is_valid()) {
+        time_ms = (int64_t)time(NULL) * 1000;
+    }
+
+    json_gen_str_start(&jstr, buf, sizeof(buf), NULL, NULL);
+    json_gen_start_object(&jstr);
+    json_gen_obj_set_string(&jstr, "event", s_motion_events[event->state]);
+    if (time_ms > 0) {
+        json_gen_obj_set_int(&jstr, "timestamp", (int)(time_ms / 1000));
+    }
+    json_gen_obj_set_int(&jstr, "lat_e7", event->lat_e7);
+    json_gen_obj_set_int(&jstr, "lon_e7", event->lon_e7);
+    json_gen_obj_set_int(&jstr, "interval", event->interval_s);
+    json_gen_end_object(&jstr);
+    // 返回的长度包含结尾的'\0'，超出缓冲区时文档已被截断
+    int len = json_gen_str_end(&jstr);
+    if (len > (int)sizeof(buf)) {
+        ESP_LOGE(TAG, "运动事件JSON缓冲区不足: 需要%d字节", len);
+        return;
+    }
+
+    ESP_LOGI(TAG, "运动状态: %s, 上报间隔%us", s_motion_events[event->state], (unsigned)event->interval_s);
+    if (mqtt_publish_motion_event(buf, len - 1) != ESP_OK) {
+        ESP_LOGW(TAG, "运动事件发布失败");
+    }
+}
+
 static void gps_event_handler(void *event_handler_arg, esp_event_base_t event_base, int32_t event_id, void *event_data){
     gps_info_t *gps_info = (gps_info_t *)event_data;
     data_model_t *data_model = data_model_get_latest();
+    char utc_str[32];
+    char lat_str[16];
+    char lon_str[16];
     switch (event_id) {
         case GPS_DATA_UPDATE:
+            gps_format_coord(lat_str, sizeof(lat_str), gps_info->lat_e7, "NS");
+            gps_format_coord(lon_str, sizeof(lon_str), gps_info->lon_e7, "EW");
             if (gps_info->data_source == FROM_GNSS) {
-                ESP_LOGI(TAG, "GPS位置: %.6f°%c, %.6f°%c, 时间: %s %s, 数据来源: GNSS",
-                         convert_to_decimal_degrees(gps_info->latitude), gps_info->ns_indicator,
-                         convert_to_decimal_degrees(gps_info->longitude), gps_info->ew_indicator,
-                         gps_info->date, gps_info->utc_time);
+                time_sync_on_gnss(gps_info);
+                ESP_LOGI(TAG, "GPS位置: %s, %s, 精度: %.1fm, 时间: %s, HDOP: %.1f, 卫星: %d, 数据来源: GNSS",
+                         lat_str, lon_str, gps_info->accuracy,
+                         gps_format_utc(gps_info->utc_ms, utc_str, sizeof(utc_str)), gps_info->hdop, gps_info->satellites);
             } else if (gps_info->data_source == FROM_LBS) {
-                ESP_LOGI(TAG, "GPS位置: %.6f°%c, %.6f°%c ,数据来源: LBS",
-                         convert_to_decimal_degrees(gps_info->latitude), gps_info->ns_indicator,
-                         convert_to_decimal_degrees(gps_info->longitude), gps_info->ew_indicator);
+                ESP_LOGI(TAG, "GPS位置: %s, %s, 精度: %.1fm, 数据来源: LBS",
+                         lat_str, lon_str, gps_info->accuracy);
             }
             if (data_model != NULL) {
                 data_model_update_gps_data(data_model, (void *)gps_info);
             }
+            track_upload_add(gps_info);
+            geofence_manager_on_fix(gps_info);
             break;
         case GPS_DATA_ERROR:
             ESP_LOGW(TAG, "GPS数据错误");
             break;
+        case GPS_MOTION_CHANGE:
+            gps_publish_motion_event((const gps_motion_event_t *)event_data);
+            break;
         default:
             ESP_LOGW(TAG, "未知事件");
             break;
@@ -8,31 +8,24 @@
 #include "driver/uart.h"
 #include "sdkconfig.h"
 #include "data_model.h"
-
-typedef enum {
-    FROM_GNSS,  // GNSS模块
-    FROM_LBS ,  // 基站定位
-} gps_data_src_t;
+#include "gps_parser.h"
+#include "motion_detector.h"
 
 // GPS事件类型
 typedef enum {
     GPS_DATA_UPDATE,   // GPS数据已更新
-    GPS_DATA_ERROR     // GPS数据解析错误
+    GPS_DATA_ERROR,    // GPS数据解析错误
+    GPS_MOTION_CHANGE  // 运动状态变化，事件数据为gps_motion_event_t
 } gps_event_id_t;
 
+// 运动状态变化事件
 typedef struct {
-    double latitude;        // 纬度，格式为 ddmm.mmmmmm (度分)
-    char ns_indicator;      // 北/南指示符: 'N'=北, 'S'=南
-    double longitude;       // 经度，格式为 dddmm.mmmmmm (度分)
-    char ew_indicator;      // 东/西指示符: 'E'=东, 'W'=西
-    char date[15];           // 日期，格式为 2020/06/17 20yy/mm/dd
-    char utc_time[10];      // UTC时间，格式为  09:34:16 hh:mm:ss
-    float altitude;         // 高度，单位为米
-    float speed;            // 地面速度，单位为节
-    float course;           // 航向，单位为度
-    int valid;              // 数据是否有效的标志
-    gps_data_src_t data_source;        // 数据来源: FROM_GNSS 或 FROM_LBS
-} gps_info_t;
+    motion_state_t state;   // 新的运动状态
+    uint16_t interval_s;    // 新的GNSS上报间隔，单位为秒
+    int64_t utc_ms;         // 触发变化的定位时刻，Unix时间毫秒
+    int32_t lat_e7;         // 触发变化的位置，1e-7度
+    int32_t lon_e7;
+} gps_motion_event_t;
 
 
 
@@ -98,12 +91,4 @@ esp_err_t gps_update_data_model(data_model_t *model, const gps_info_t *gps_info)
  */
 esp_err_t gps_register_event_handler(esp_event_handler_t event_handler, void *handler_args);
 
-/**
- * @brief 将GPS坐标从度分格式(ddmm.mmmm)转换为十进制度格式
- * 
- * @param coord_ddmm 度分格式的坐标
- * @return double 十进制度格式的坐标
- */
-double convert_to_decimal_degrees(double coord_ddmm);
-
 #endif // GPS_H
\ No newline at end of file
@@ -0,0 +1,393 @@
+#include <stdio.h>
+#include <string.h>
+#include "esp_log.h"
+#include "field_scanner.h"
+#include "gps_parser.h"
+
+static const char *TAG = "GPS";
+
+int gps_format_coord(char *buf, size_t size, int32_t coord_e7, const char *indicators)
+{
+    uint32_t magnitude = coord_e7 < 0 ? -(uint32_t)coord_e7 : (uint32_t)coord_e7;
+    return snprintf(buf, size, "%lu.%07lu%c", (unsigned long)(magnitude / GPS_COORD_SCALE),
+                    (unsigned long)(magnitude % GPS_COORD_SCALE), indicators[coord_e7 < 0]);
+}
+
+// 度分格式坐标字段与方向字段转换为1e-7度，超出范围返回false
+static bool field_to_coord(const field_slice_t *ddmm, const field_slice_t *indicator,
+                           const char *indicators, int32_t max_e7, int32_t *coord_e7)
+{
+    // 分的小数保留8位，足够1e-7度的精度
+    int64_t value;
+    if (!field_to_fixed(ddmm, 8, &value) || value < 0 || indicator->len != 1 ||
+        (indicator->ptr[0] != indicators[0] && indicator->ptr[0] != indicators[1])) {
+        return false;
+    }
+    int32_t e7 = nmea_ddmm_to_e7(value, 8);
+    if (e7 > max_e7) {
+        return false;
+    }
+    *coord_e7 = indicator->ptr[0] == indicators[1] ? -e7 : e7;
+    return true;
+}
+
+// 十进制度坐标字段转换为1e-7度，超出范围返回false
+static bool field_to_degrees_e7(const field_slice_t *field, int32_t max_e7, int32_t *coord_e7)
+{
+    int64_t value;
+    if (!field_to_fixed(field, GPS_COORD_DECIMALS, &value) || value > max_e7 || value < -max_e7) {
+        return false;
+    }
+    *coord_e7 = (int32_t)value;
+    return true;
+}
+
+// 检查字段前n个字节是否均为数字
+static bool field_has_digits(const field_slice_t *field, size_t n)
+{
+    if (field->len < n) {
+        return false;
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (field->ptr[i] < '0' || field->ptr[i] > '9') {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 读取n位十进制数字，遇到非数字返回-1
+static int parse_digits(const char *p, size_t n)
+{
+    int value = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (p[i] < '0' || p[i] > '9') {
+            return -1;
+        }
+        value = value * 10 + (p[i] - '0');
+    }
+    return value;
+}
+
+// 公历UTC日期时间转换为Unix时间(毫秒)，字段超出范围返回-1
+static int utc_to_ms(int year, int month, int day, int hour, int minute, int second,
+                     int millisecond, int64_t *utc_ms)
+{
+    if (year < 1970 || month < 1 || month > 12 || day < 1 || day > 31 ||
+        hour < 0 || hour > 23 || minute < 0 || minute > 59 || second < 0 || second > 60) {
+        return -1;
+    }
+    // 距1970/01/01的天数，按3月为年初计算闰日
+    year -= month <= 2;
+    int era = year / 400;
+    int yoe = year - era * 400;
+    int doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    int64_t days = (int64_t)era * 146097 + doe - 719468;
+    *utc_ms = ((days * 24 + hour) * 60 + minute) * 60000LL + second * 1000 + millisecond;
+    return 0;
+}
+
+/**
+ * @brief 将GPS的ddmmyy日期与hhmmss.ss时间转换为Unix时间
+ * 
+ * @param date_in GPS日期字段，格式为ddmmyy
+ * @param time_in GPS时间字段，格式为hhmmss.ss，小数部分可选
+ * @param utc_ms 输出Unix时间，单位为毫秒
+ * @return int 0表示成功，-1表示失败
+ */
+int parse_gps_utc(const field_slice_t *date_in, const field_slice_t *time_in, int64_t *utc_ms)
+{
+    if (date_in == NULL || time_in == NULL || utc_ms == NULL ||
+        !field_has_digits(date_in, 6) || !field_has_digits(time_in, 6)) {
+        return -1;
+    }
+
+    // 小数秒取前3位
+    int millisecond = 0;
+    if (time_in->len > 7 && time_in->ptr[6] == '.') {
+        int scale = 100;
+        for (size_t i = 7; i < time_in->len && scale > 0; i++, scale /= 10) {
+            int digit = parse_digits(&time_in->ptr[i], 1);
+            if (digit < 0) {
+                return -1;
+            }
+            millisecond += digit * scale;
+        }
+    }
+
+    const char *d = date_in->ptr;
+    const char *t = time_in->ptr;
+    // 年份前加"20"表示21世纪
+    return utc_to_ms(2000 + parse_digits(d + 4, 2), parse_digits(d + 2, 2), parse_digits(d, 2),
+                     parse_digits(t, 2), parse_digits(t + 2, 2), parse_digits(t + 4, 2),
+                     millisecond, utc_ms);
+}
+
+// 将CLBS的yyyy/mm/dd日期与hh:mm:ss时间转换为Unix时间
+static int parse_lbs_utc(const field_slice_t *date_in, const field_slice_t *time_in, int64_t *utc_ms)
+{
+    const char *d = date_in->ptr;
+    const char *t = time_in->ptr;
+    if (date_in->len != 10 || d[4] != '/' || d[7] != '/' ||
+        time_in->len != 8 || t[2] != ':' || t[5] != ':') {
+        return -1;
+    }
+    return utc_to_ms(parse_digits(d, 4), parse_digits(d + 5, 2), parse_digits(d + 8, 2),
+                     parse_digits(t, 2), parse_digits(t + 3, 2), parse_digits(t + 6, 2), 0, utc_ms);
+}
+
+// +CGPSINFO: <lat>,<N/S>,<log>,<E/W>,<date>,<UTC time>,<alt>,<speed>,<course>
+#define GPSINFO_FIELDS  9
+// +CLBS: <locationcode>,<latitude>,<longitude>,<acc>,<date>,<time>
+#define LBSINFO_FIELDS  6
+// +CPSI: <system mode>,<operation mode>,<mcc>-<mnc>,<lac/tac>,<cell id>,...
+#define CPSI_FIELDS     5
+
+/**
+ * @brief 解析CGPSINFO响应字符串
+ * 
+ * @param line CGPSINFO响应字符串
+ * @param gps_info GPS信息结构体指针
+ * @return int 0表示成功解析有效数据，1表示成功解析但无GPS信号，负数表示解析失败
+ */
+int parse_gps_info(const char *line, gps_info_t *gps_info)
+{
+    if (!line || !gps_info) {
+        return -1;
+    }
+    
+    // 检查是否为CGPSINFO响应
+    const char *cgpsinfo_start = strstr(line, "+CGPSINFO:");
+    if (cgpsinfo_start == NULL) {
+        return -2;
+    }
+    
+    // 初始化为无效状态
+    gps_info->valid = 0;
+    
+    // 跳过"+CGPSINFO:"前缀，按逗号切分到行尾，空字段保留原位置
+    const char *data_start = cgpsinfo_start + strlen("+CGPSINFO:");
+    field_slice_t fields[GPSINFO_FIELDS];
+    int count = field_split(data_start, FIELD_NUL_TERMINATED, ',', fields, GPSINFO_FIELDS);
+    
+    // 检查是否有足够的字段
+    if (count < GPSINFO_FIELDS) {
+        ESP_LOGW(TAG, "GPS信息字段不完整: 预期9个字段，实际获得%d个", count);
+        return -3;
+    }
+    
+    // 纬度为空表示无定位（+CGPSINFO: ,,,,,,,,）
+    if (field_is_empty(&fields[0])) {
+        memset(gps_info, 0, sizeof(gps_info_t));
+        gps_info->valid = 0;
+        return 1;  // 返回1表示成功解析但无信号
+    }
+    
+    // 经纬度及方向为必需字段，在此一次转换为1e-7度
+    if (!field_to_coord(&fields[0], &fields[1], "NS", 90 * GPS_COORD_SCALE, &gps_info->lat_e7) ||
+        !field_to_coord(&fields[2], &fields[3], "EW", 180 * GPS_COORD_SCALE, &gps_info->lon_e7)) {
+        ESP_LOGW(TAG, "GPS经纬度字段无效");
+        return -4;
+    }
+    
+    // 定位时刻，缺失时为0
+    if (parse_gps_utc(&fields[4], &fields[5], &gps_info->utc_ms) != 0) {
+        gps_info->utc_ms = 0;
+    }
+    
+    // 可选字段为空时置0
+    if (!field_to_float(&fields[6], &gps_info->altitude)) {
+        gps_info->altitude = 0;
+    }
+    if (!field_to_float(&fields[7], &gps_info->speed)) {
+        gps_info->speed = 0;
+    }
+    if (!field_to_float(&fields[8], &gps_info->course)) {
+        gps_info->course = 0;
+    }
+    // +CGPSINFO不包含精度信息
+    gps_info->hdop = 0;
+    gps_info->satellites = 0;
+    gps_info->accuracy = 0;
+    
+    // 设置为有效状态
+    gps_info->valid = 1;
+    gps_info->data_source = FROM_GNSS; // 设置数据来源为GNSS
+    
+    return 0;
+}
+
+
+/**
+ * @brief 解析LBS基站定位响应
+ * 
+ * @param line LBS响应字符串
+ * @param gps_info GPS信息结构体指针，用于存储解析结果
+ * @return int 0表示成功解析有效数据，非零表示解析失败
+ */
+int parse_lbs_info(const char *line, gps_info_t *gps_info)
+{
+    if (!line || !gps_info) {
+        return -1;
+    }
+    
+    // 检查是否为CLBS响应
+    const char *clbs_start = strstr(line, "+CLBS:");
+    if (clbs_start == NULL) {
+        return -2;
+    }
+    
+    // 跳过"+CLBS:"前缀
+    const char *data_start = clbs_start + strlen("+CLBS:");
+    field_slice_t fields[LBSINFO_FIELDS];
+    int count = field_split(data_start, FIELD_NUL_TERMINATED, ',', fields, LBSINFO_FIELDS);
+    
+    // 第一个字段为状态码，0表示成功，失败时只有这一个字段
+    int32_t status;
+    if (!field_to_int(&fields[0], &status)) {
+        ESP_LOGW(TAG, "LBS状态码无效");
+        return -3;
+    }
+    if (status != 0) {
+        ESP_LOGW(TAG, "LBS定位失败，状态码: %d", (int)status);
+        memset(gps_info, 0, sizeof(gps_info_t));
+        gps_info->valid = 0;
+        return -4;
+    }
+    
+    // 检查是否有足够的字段
+    if (count < LBSINFO_FIELDS) {
+        ESP_LOGW(TAG, "LBS信息字段不完整: 预期6个字段，实际获得%d个", count);
+        return -3;
+    }
+    
+    // 解析经纬度（注意LBS返回的是十进制格式，不是度分格式）
+    int32_t lat_e7;
+    int32_t lon_e7;
+    if (!field_to_degrees_e7(&fields[1], 90 * GPS_COORD_SCALE, &lat_e7) ||
+        !field_to_degrees_e7(&fields[2], 180 * GPS_COORD_SCALE, &lon_e7)) {
+        ESP_LOGW(TAG, "LBS经纬度字段无效");
+        return -5;
+    }
+    
+    // 填充GPS信息结构体
+    memset(gps_info, 0, sizeof(gps_info_t)); // 先清空结构体
+    gps_info->lat_e7 = lat_e7;
+    gps_info->lon_e7 = lon_e7;
+    
+    // 基站给出的定位精度，单位为米，缺失时为0
+    if (!field_to_float(&fields[3], &gps_info->accuracy) || gps_info->accuracy < 0) {
+        gps_info->accuracy = 0;
+    }
+    
+    // 对于LBS定位，我们没有高度、速度和航向信息，已清零
+    gps_info->data_source = FROM_LBS;
+
+    // 基站定位时刻，缺失时为0
+    if (parse_lbs_utc(&fields[4], &fields[5], &gps_info->utc_ms) != 0) {
+        gps_info->utc_ms = 0;
+    }
+    // 设置为有效状态
+    gps_info->valid = 1;
+    
+    return 0;
+}
+
+int parse_nmea_fix(const nmea_fix_t *fix, gps_info_t *gps_info)
+{
+    if (!fix || !gps_info) {
+        return -1;
+    }
+
+    // RMC状态为V表示无定位
+    if (!fix->valid) {
+        memset(gps_info, 0, sizeof(gps_info_t));
+        gps_info->satellites = fix->sats_used;
+        return 1;
+    }
+
+    gps_info->lat_e7 = fix->lat_e7;
+    gps_info->lon_e7 = fix->lon_e7;
+    if (utc_to_ms(fix->year, fix->month, fix->day, fix->hour, fix->minute, fix->second,
+                  fix->millisecond, &gps_info->utc_ms) != 0) {
+        gps_info->utc_ms = 0;
+    }
+    gps_info->altitude = fix->altitude;
+    gps_info->speed = fix->speed;
+    gps_info->course = fix->course;
+    gps_info->hdop = fix->hdop;
+    gps_info->satellites = fix->sats_used;
+    gps_info->accuracy = 0;
+    gps_info->valid = 1;
+    gps_info->data_source = FROM_GNSS;
+    return 0;
+}
+
+// 解析0x开头的十六进制字段
+static bool field_to_hex(const field_slice_t *field, uint32_t *val)
+{
+    if (field->len < 3 || field->len > 10 || field->ptr[0] != '0' ||
+        (field->ptr[1] != 'x' && field->ptr[1] != 'X')) {
+        return false;
+    }
+    uint32_t v = 0;
+    for (size_t i = 2; i < field->len; i++) {
+        char c = field->ptr[i];
+        if (c >= '0' && c <= '9') {
+            v = (v << 4) | (uint32_t)(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            v = (v << 4) | (uint32_t)(c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            v = (v << 4) | (uint32_t)(c - 'A' + 10);
+        } else {
+            return false;
+        }
+    }
+    *val = v;
+    return true;
+}
+
+int parse_cpsi_info(const char *line, cell_info_t *cell)
+{
+    if (!line || !cell) {
+        return -1;
+    }
+
+    const char *cpsi_start = strstr(line, "+CPSI:");
+    if (cpsi_start == NULL) {
+        return -2;
+    }
+
+    const char *data_start = cpsi_start + strlen("+CPSI:");
+    while (*data_start == ' ') {
+        data_start++;
+    }
+    field_slice_t fields[CPSI_FIELDS];
+    int count = field_split(data_start, FIELD_NUL_TERMINATED, ',', fields, CPSI_FIELDS);
+
+    memset(cell, 0, sizeof(cell_info_t));
+    // 无服务时只有模式和运行状态两个字段
+    if (count < CPSI_FIELDS || field_equals(&fields[0], "NO SERVICE")) {
+        return 1;
+    }
+
+    // MCC与MNC以'-'分隔
+    field_slice_t plmn[2];
+    int32_t mcc;
+    int32_t mnc;
+    uint32_t lac;
+    int32_t cell_id;
+    if (field_split(fields[2].ptr, fields[2].len, '-', plmn, 2) != 2 ||
+        !field_to_int(&plmn[0], &mcc) || !field_to_int(&plmn[1], &mnc) ||
+        !field_to_hex(&fields[3], &lac) || !field_to_int(&fields[4], &cell_id) || cell_id < 0) {
+        ESP_LOGW(TAG, "CPSI服务小区字段无效");
+        return -3;
+    }
+
+    cell->mcc = (uint16_t)mcc;
+    cell->mnc = (uint16_t)mnc;
+    cell->lac = (uint16_t)lac;
+    cell->cell_id = (uint32_t)cell_id;
+    return 0;
+}
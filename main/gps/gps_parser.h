@@ -0,0 +1,96 @@
+#ifndef GPS_PARSER_H
+#define GPS_PARSER_H
+
+#include "nmea_parser.h"
+#include "field_scanner.h"
+
+// 坐标定点数的小数位数，1e-7度约为1.1厘米
+#define GPS_COORD_DECIMALS  7
+#define GPS_COORD_SCALE     10000000
+
+typedef enum {
+    FROM_GNSS,  // GNSS模块
+    FROM_LBS ,  // 基站定位
+} gps_data_src_t;
+
+// GPS/LBS定位结果
+typedef struct {
+    int32_t lat_e7;         // 纬度，单位为1e-7度，北纬为正
+    int32_t lon_e7;         // 经度，单位为1e-7度，东经为正
+    int64_t utc_ms;         // 定位时刻，UTC Unix时间(毫秒)，0表示未知
+    float altitude;         // 高度，单位为米
+    float speed;            // 地面速度，单位为节
+    float course;           // 航向，单位为度
+    float hdop;             // 水平精度因子，0表示未知
+    uint8_t satellites;     // 参与定位的卫星数，0表示未知
+    float accuracy;         // 水平精度半径，单位为米，0表示未知；发布时为融合后的不确定半径
+    int valid;              // 数据是否有效的标志
+    gps_data_src_t data_source;        // 数据来源: FROM_GNSS 或 FROM_LBS
+} gps_info_t;
+
+// 服务小区标识
+typedef struct {
+    uint16_t mcc;           // 移动国家码
+    uint16_t mnc;           // 移动网络码
+    uint16_t lac;           // 位置区码(LTE为跟踪区码)
+    uint32_t cell_id;       // 小区标识
+} cell_info_t;
+
+/**
+ * @brief 将1e-7度坐标格式化为带方向指示符的十进制度，如"31.2304160N"
+ * 
+ * @param buf 输出缓冲区
+ * @param size 缓冲区大小，16字节足够
+ * @param coord_e7 坐标，单位为1e-7度
+ * @param indicators 正、负方向的指示符，纬度为"NS"，经度为"EW"
+ * @return int 写入的长度，不含结束符
+ */
+int gps_format_coord(char *buf, size_t size, int32_t coord_e7, const char *indicators);
+
+/**
+ * @brief 将GPS的ddmmyy日期与hhmmss.ss时间转换为Unix时间
+ * 
+ * @param date_in GPS日期字段，格式为ddmmyy
+ * @param time_in GPS时间字段，格式为hhmmss.ss，小数部分可选
+ * @param utc_ms 输出Unix时间，单位为毫秒
+ * @return int 0表示成功，-1表示失败
+ */
+int parse_gps_utc(const field_slice_t *date_in, const field_slice_t *time_in, int64_t *utc_ms);
+
+/**
+ * @brief 解析CGPSINFO响应字符串
+ * 
+ * @param line CGPSINFO响应字符串
+ * @param gps_info GPS信息结构体指针
+ * @return int 0表示成功解析有效数据，1表示成功解析但无GPS信号，负数表示解析失败
+ */
+int parse_gps_info(const char *line, gps_info_t *gps_info);
+
+/**
+ * @brief 解析LBS基站定位响应
+ * 
+ * @param line LBS响应字符串
+ * @param gps_info GPS信息结构体指针，用于存储解析结果
+ * @return int 0表示成功解析有效数据，非零表示解析失败
+ */
+int parse_lbs_info(const char *line, gps_info_t *gps_info);
+
+/**
+ * @brief 解析AT+CPSI?响应中的服务小区
+ * 
+ * @param line CPSI响应字符串
+ * @param cell 输出服务小区
+ * @return int 0表示成功，1表示无服务，负数表示解析失败
+ */
+int parse_cpsi_info(const char *line, cell_info_t *cell);
+
+/**
+ * @brief 将NMEA解析器汇总的定位状态转换为GPS信息
+ * 
+ * @param fix NMEA定位状态
+ * @param gps_info GPS信息结构体指针
+ * @return int 0表示有效定位，1表示无定位，负数表示参数错误
+ */
+int parse_nmea_fix(const nmea_fix_t *fix, gps_info_t *gps_info);
+
+#endif // GPS_PARSER_H
@@ -17,6 +17,7 @@
 #include "esp_tls_crypto.h"
 #include "esp_vfs.h"
 #include "json_parser.h"
+#include "json_generator.h"
 #include "nvs.h"
 #include "nvs_flash.h"
 #include "esp_event.h"
@@ -25,6 +26,9 @@
 #include "esp_wifi.h"
 #include "modem_http_config.h"
 #include "data_model.h"
+#include "sensor_filters.h"
+#include "sensors.h"
+#include "gps_parser.h"
 #include "network_manager.h"
 #include "wifi_manager.h"
 #include "mqtt.h"
@@ -131,6 +135,158 @@ typedef struct {
     rest_server_context_t *rest_context;
 } ctx_info_t;
 
+/* 请求体接收到服务器的scratch缓冲区中，不再按content_len分配堆内存。
+ * 处理函数都在httpd任务中串行执行，可以共用同一块缓冲区。
+ */
+#define HTTP_BODY_MAX_LEN       4096
+/* 请求JSON的token上限，token池位于处理函数栈上 */
+#define HTTP_JSON_MAX_TOKENS    32
+
+_Static_assert(SCRATCH_BUFSIZE >= 2 * (HTTP_BODY_MAX_LEN + 1), "scratch buffer too small for request body");
+
+/**
+ * @brief 接收请求体到scratch缓冲区
+ *
+ * @param req HTTP请求，user_ctx必须为ctx_info_t
+ * @param body 输出的请求体，以'\0'结尾
+ * @param body_len 输出的请求体长度
+ * @return esp_err_t ESP_OK成功，ESP_ERR_INVALID_SIZE请求体过长，其他值接收失败
+ */
+static esp_err_t http_recv_body(httpd_req_t *req, char **body, int *body_len)
+{
+    ctx_info_t *ctx_info = (ctx_info_t *)req->user_ctx;
+    if (ctx_info == NULL || ctx_info->rest_context == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (req->content_len > HTTP_BODY_MAX_LEN) {
+        ESP_LOGE(TAG, "%s: 请求体过长 %d", req->uri, req->content_len);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    char *buf = ctx_info->rest_context->scratch;
+    int cur_len = 0;
+    while (cur_len < req->content_len) {
+        int received = httpd_req_recv(req, buf + cur_len, req->content_len - cur_len);
+        if (received == HTTPD_SOCK_ERR_TIMEOUT) {
+            /* Retry receiving if timeout occurred */
+            continue;
+        }
+        if (received <= 0) {
+            ESP_LOGE(TAG, "%s: 接收请求体失败", req->uri);
+            return ESP_FAIL;
+        }
+        cur_len += received;
+    }
+    buf[cur_len] = '\0';
+
+    *body = buf;
+    *body_len = cur_len;
+    return ESP_OK;
+}
+
+/**
+ * @brief 接收请求体并用调用者提供的token池解析JSON，整个过程不分配堆内存
+ *
+ * @param req HTTP请求
+ * @param jctx 解析上下文
+ * @param tokens token池
+ * @param max_tokens token池大小
+ * @param body_len 输出的请求体长度，可为NULL
+ * @return esp_err_t ESP_OK成功，ESP_ERR_INVALID_ARG JSON无效，其他值同http_recv_body()
+ */
+static esp_err_t http_recv_json(httpd_req_t *req, jparse_ctx_t *jctx, json_tok_t *tokens, int max_tokens,
+                                int *body_len)
+{
+    char *body = NULL;
+    int len = 0;
+
+    esp_err_t ret = http_recv_body(req, &body, &len);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ESP_LOGD(TAG, "%s: %.*s", req->uri, len, body);
+
+    if (json_parse_start_static(jctx, body, len, tokens, max_tokens) != OS_SUCCESS) {
+        ESP_LOGE(TAG, "%s: JSON解析失败", req->uri);
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (body_len) {
+        *body_len = len;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief 读取JSON字符串字段并解码转义字符
+ */
+static int http_json_get_string(jparse_ctx_t *jctx, const char *name, char *val, int size)
+{
+    if (json_obj_get_string(jctx, name, val, size) != OS_SUCCESS) {
+        return -OS_FAIL;
+    }
+    return json_unescape_string(val) < 0 ? -OS_FAIL : OS_SUCCESS;
+}
+
+// 分块发送JSON的上下文，作为json_generator刷新回调的priv
+typedef struct {
+    httpd_req_t *req;
+    esp_err_t err;      // 第一次发送失败的错误码
+} http_json_ctx_t;
+
+/**
+ * @brief json_generator的刷新回调，将生成的JSON以分块方式发送
+ *
+ * 发送失败(如客户端已断开)后记录错误，不再发送后续分块
+ */
+static void http_json_flush_cb(char *buf, void *priv)
+{
+    http_json_ctx_t *ctx = (http_json_ctx_t *)priv;
+    if (ctx->err == ESP_OK) {
+        ctx->err = httpd_resp_send_chunk(ctx->req, buf, strlen(buf));
+    }
+}
+
+/**
+ * @brief 发送结束分块
+ *
+ * @return esp_err_t ESP_OK整个响应发送成功，ESP_FAIL有分块发送失败
+ */
+static esp_err_t http_json_finish(http_json_ctx_t *ctx)
+{
+    if (ctx->err == ESP_OK) {
+        ctx->err = httpd_resp_send_chunk(ctx->req, NULL, 0);
+    }
+    if (ctx->err != ESP_OK) {
+        ESP_LOGW(TAG, "%s: 响应发送失败: %s", ctx->req->uri, esp_err_to_name(ctx->err));
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief 发送WLAN基本设置
+ *
+ * SSID和密码由用户设置，可能包含引号等字符，由json_generator转义
+ */
+static esp_err_t wlan_general_send_json(httpd_req_t *req, const char *ssid, const char *hide_ssid,
+                                        const char *auth_mode, const char *password)
+{
+    char buf[128];
+    json_gen_str_t jstr;
+    http_json_ctx_t ctx = { .req = req, .err = ESP_OK };
+
+    json_gen_str_start(&jstr, buf, sizeof(buf), http_json_flush_cb, &ctx);
+    json_gen_start_object(&jstr);
+    json_gen_obj_set_string(&jstr, "status", "200");
+    json_gen_obj_set_string(&jstr, "ssid", ssid);
+    json_gen_obj_set_string(&jstr, "if_hide_ssid", hide_ssid);
+    json_gen_obj_set_string(&jstr, "auth_mode", auth_mode);
+    json_gen_obj_set_string(&jstr, "password", password);
+    json_gen_end_object(&jstr);
+    json_gen_str_end(&jstr);
+    return http_json_finish(&ctx);
+}
+
 void nvs_get_str_log(esp_err_t err, char *key, char *value)
 {
     switch (err) {
@@ -302,13 +458,6 @@ static esp_err_t wlan_general_get_handler(httpd_req_t *req)
         break;
     }
 
-    char *json_str = NULL;
-    size_t size = 0;
-    size = asprintf(&json_str,
-                    "{\"status\":\"200\", \"ssid\":\"%s\", \"if_hide_ssid\":\"%s\", "
-                    "\"auth_mode\":\"%s\", \"password\":\"%s\"}",
-                    user_ssid, user_hide_ssid, user_auth_mode, user_password);
-
     /**
      * @brief Set the HTTP status code
      */
@@ -327,10 +476,7 @@ static esp_err_t wlan_general_get_handler(httpd_req_t *req)
      * @brief Set some custom headers
      */
 
-    ret = httpd_resp_send(req, json_str, size);
-    free(json_str);
-    ESP_ERROR_CHECK(ret);
-    return ESP_OK;
+    return wlan_general_send_json(req, user_ssid, user_hide_ssid, user_auth_mode, user_password);
 }
 
 static esp_err_t wlan_general_post_handler(httpd_req_t *req)
@@ -340,46 +486,23 @@ static esp_err_t wlan_general_post_handler(httpd_req_t *req)
     char user_hide_ssid[8] = "";
     char user_auth_mode[16] = "";
 
-    char buf[256] = { 0 };
-    int len_ret, remaining = req->content_len;
-
-    if (remaining > sizeof(buf)) {
-        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "string too long");
-        return ESP_FAIL;
-    }
-
-    while (remaining > 0) {
-        /* Read the data for the request */
-        if ((len_ret = httpd_req_recv(req, buf, MIN(remaining, sizeof(buf)))) <= 0) {
-            if (len_ret == HTTPD_SOCK_ERR_TIMEOUT) {
-                /* Retry receiving if timeout occurred */
-                continue;
-            }
-
-            return ESP_FAIL;
-        }
-
-        remaining -= len_ret;
-
-        /* Log data received */
-        ESP_LOGI(TAG, "=========== RECEIVED DATA ==========");
-        ESP_LOGI(TAG, "%.*s", len_ret, buf);
-        ESP_LOGI(TAG, "====================================");
-    }
     httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
     httpd_resp_set_hdr(req, "Access-Control-Allow-Methods", "*");
     httpd_resp_set_hdr(req, "Access-Control-Allow-Headers", "*");
     jparse_ctx_t jctx;
-    int ps_ret = json_parse_start(&jctx, buf, strlen(buf));
-
-    if (ps_ret != OS_SUCCESS) {
+    json_tok_t tokens[HTTP_JSON_MAX_TOKENS];
+    esp_err_t recv_ret = http_recv_json(req, &jctx, tokens, HTTP_JSON_MAX_TOKENS, NULL);
+    if (recv_ret == ESP_ERR_INVALID_SIZE) {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "string too long");
+        return ESP_FAIL;
+    } else if (recv_ret != ESP_OK) {
         ESP_LOGE(TAG, "Parser failed\n");
         return ESP_FAIL;
     }
 
     char str_val[64];
 
-    if (json_obj_get_string(&jctx, "ssid", str_val, sizeof(str_val)) == OS_SUCCESS) {
+    if (http_json_get_string(&jctx, "ssid", str_val, sizeof(str_val)) == OS_SUCCESS) {
         snprintf(user_ssid, sizeof(user_ssid), "%.*s", sizeof(user_ssid) - 1, str_val);
         ESP_LOGI(TAG, "ssid %s\n", user_ssid);
     } else {
@@ -387,7 +510,7 @@ static esp_err_t wlan_general_post_handler(httpd_req_t *req)
         return ESP_FAIL;
     }
 
-    if (json_obj_get_string(&jctx, "if_hide_ssid", str_val, sizeof(str_val)) == OS_SUCCESS) {
+    if (http_json_get_string(&jctx, "if_hide_ssid", str_val, sizeof(str_val)) == OS_SUCCESS) {
         snprintf(user_hide_ssid, sizeof(user_hide_ssid), "%.*s", sizeof(user_hide_ssid) - 1, str_val);
         ESP_LOGI(TAG, "if_hide_ssid %s\n", user_hide_ssid);
     } else {
@@ -395,7 +518,7 @@ static esp_err_t wlan_general_post_handler(httpd_req_t *req)
         return ESP_FAIL;
     }
 
-    if (json_obj_get_string(&jctx, "auth_mode", str_val, sizeof(str_val)) == OS_SUCCESS) {
+    if (http_json_get_string(&jctx, "auth_mode", str_val, sizeof(str_val)) == OS_SUCCESS) {
         snprintf(user_auth_mode, sizeof(user_auth_mode), "%.*s", sizeof(user_auth_mode) - 1, str_val);
         ESP_LOGI(TAG, "auth_mode %s\n", user_auth_mode);
     } else {
@@ -403,7 +526,7 @@ static esp_err_t wlan_general_post_handler(httpd_req_t *req)
         return ESP_FAIL;
     }
 
-    if (json_obj_get_string(&jctx, "password", str_val, sizeof(str_val)) == OS_SUCCESS) {
+    if (http_json_get_string(&jctx, "password", str_val, sizeof(str_val)) == OS_SUCCESS) {
         snprintf(user_password, sizeof(user_password), "%.*s", sizeof(user_password) - 1, str_val);
         ESP_LOGI(TAG, "password %s\n", user_password);
     } else {
@@ -411,19 +534,12 @@ static esp_err_t wlan_general_post_handler(httpd_req_t *req)
         return ESP_FAIL;
     }
 
-    char *json_str = NULL;
-    size_t size = 0;
-    size = asprintf(&json_str,
-                    "{\"status\":\"200\", \"ssid\":\"%s\", \"if_hide_ssid\":\"%s\", "
-                    "\"auth_mode\":\"%s\", \"password\":\"%s\"}",
-                    user_ssid, user_hide_ssid, user_auth_mode, user_password);
     esp_err_t ret = httpd_resp_set_status(req, HTTPD_200);
     ESP_ERROR_CHECK(ret);
     ret = httpd_resp_set_type(req, HTTPD_TYPE_JSON);
     ESP_ERROR_CHECK(ret);
-    ret = httpd_resp_send(req, json_str, size);
-    free(json_str);
-    ESP_ERROR_CHECK(ret);
+    // 客户端已断开时仍保存配置并重启
+    wlan_general_send_json(req, user_ssid, user_hide_ssid, user_auth_mode, user_password);
 
     ESP_ERROR_CHECK(from_nvs_set_value("ssid", user_ssid));
     ESP_ERROR_CHECK(from_nvs_set_value("hide_ssid", user_hide_ssid));
@@ -476,46 +592,23 @@ static esp_err_t wlan_advance_post_handler(httpd_req_t *req)
     char user_channel[4] = "";
     char user_bandwidth[4] = "";
 
-    char buf[256] = { 0 };
-    int len_ret, remaining = req->content_len;
-
-    if (remaining > sizeof(buf)) {
-        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "string too long");
-        return ESP_FAIL;
-    }
-
-    while (remaining > 0) {
-        /* Read the data for the request */
-        if ((len_ret = httpd_req_recv(req, buf, MIN(remaining, sizeof(buf)))) <= 0) {
-            if (len_ret == HTTPD_SOCK_ERR_TIMEOUT) {
-                /* Retry receiving if timeout occurred */
-                continue;
-            }
-
-            return ESP_FAIL;
-        }
-
-        remaining -= len_ret;
-
-        /* Log data received */
-        ESP_LOGI(TAG, "=========== RECEIVED DATA ==========");
-        ESP_LOGI(TAG, "%.*s", len_ret, buf);
-        ESP_LOGI(TAG, "====================================");
-    }
     httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
     httpd_resp_set_hdr(req, "Access-Control-Allow-Methods", "*");
     httpd_resp_set_hdr(req, "Access-Control-Allow-Headers", "*");
     jparse_ctx_t jctx;
-    int ps_ret = json_parse_start(&jctx, buf, strlen(buf));
-
-    if (ps_ret != OS_SUCCESS) {
+    json_tok_t tokens[HTTP_JSON_MAX_TOKENS];
+    esp_err_t recv_ret = http_recv_json(req, &jctx, tokens, HTTP_JSON_MAX_TOKENS, NULL);
+    if (recv_ret == ESP_ERR_INVALID_SIZE) {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "string too long");
+        return ESP_FAIL;
+    } else if (recv_ret != ESP_OK) {
         ESP_LOGE(TAG, "Parser failed\n");
         return ESP_FAIL;
     }
 
     char str_val[64];
 
-    if (json_obj_get_string(&jctx, "bandwidth", str_val, sizeof(str_val)) == OS_SUCCESS) {
+    if (http_json_get_string(&jctx, "bandwidth", str_val, sizeof(str_val)) == OS_SUCCESS) {
         snprintf(user_bandwidth, sizeof(user_bandwidth), "%.*s", sizeof(user_bandwidth) - 1, str_val);
         ESP_LOGI(TAG, "bandwidth: %s\n", user_bandwidth);
     } else {
@@ -523,7 +616,7 @@ static esp_err_t wlan_advance_post_handler(httpd_req_t *req)
         return ESP_FAIL;
     }
 
-    if (json_obj_get_string(&jctx, "channel", str_val, sizeof(str_val)) == OS_SUCCESS) {
+    if (http_json_get_string(&jctx, "channel", str_val, sizeof(str_val)) == OS_SUCCESS) {
         snprintf(user_channel, sizeof(user_channel), "%.*s", sizeof(user_channel) - 1, str_val);
         ESP_LOGI(TAG, "channel: %s\n", user_channel);
     } else {
@@ -552,24 +645,10 @@ static esp_err_t wlan_advance_post_handler(httpd_req_t *req)
 
 static esp_err_t system_station_get_handler(httpd_req_t *req)
 {
-    char *json_str = NULL;
-    char *json_str_old = NULL;
-    size_t size = 0;
+    char buf[256];
+    char str[24];
+    json_gen_str_t jstr;
     struct modem_netif_sta_info *node;
-    size = asprintf(&json_str, "{\"station_list\":[");
-    SLIST_FOREACH(node, &s_sta_list_head, field) {
-        asprintf(&json_str_old, "%s", json_str);
-        free(json_str);
-        json_str = NULL;
-        size = asprintf(&json_str,
-                        "%s{\"name_str\":\"%s\",\"mac_str\":\"" MACSTR "\",\"ip_str\":\"" IPSTR
-                        "\",\"online_time_s\":\"%lld\"}%c",
-                        json_str_old, node->name, MAC2STR(node->mac), IP2STR(&node->ip),
-                        node->start_time, node->field.sle_next ? ',' : '\0');
-        free(json_str_old);
-        json_str_old = NULL;
-    }
-    size = asprintf(&json_str_old, "%s],\"now_time\":\"%lld\"}", json_str, esp_timer_get_time());
 
     httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
     httpd_resp_set_hdr(req, "Access-Control-Allow-Methods", "*");
@@ -586,63 +665,55 @@ static esp_err_t system_station_get_handler(httpd_req_t *req)
     ret = httpd_resp_set_type(req, HTTPD_TYPE_JSON);
     ESP_ERROR_CHECK(ret);
 
-    /**
-     * @brief Set some custom headers
-     */
-
-    ret = httpd_resp_send(req, json_str_old, size);
-    ESP_LOGD(TAG, "%s", json_str_old);
-    free(json_str);
-    free(json_str_old);
-    ESP_ERROR_CHECK(ret);
-    return ESP_OK;
+    // 设备名称由用户修改，可能包含需要转义的字符
+    http_json_ctx_t ctx = { .req = req, .err = ESP_OK };
+    json_gen_str_start(&jstr, buf, sizeof(buf), http_json_flush_cb, &ctx);
+    json_gen_start_object(&jstr);
+    json_gen_push_array(&jstr, "station_list");
+    SLIST_FOREACH(node, &s_sta_list_head, field) {
+        json_gen_start_object(&jstr);
+        json_gen_obj_set_string(&jstr, "name_str", node->name);
+        snprintf(str, sizeof(str), MACSTR, MAC2STR(node->mac));
+        json_gen_obj_set_string(&jstr, "mac_str", str);
+        snprintf(str, sizeof(str), IPSTR, IP2STR(&node->ip));
+        json_gen_obj_set_string(&jstr, "ip_str", str);
+        snprintf(str, sizeof(str), "%lld", node->start_time);
+        json_gen_obj_set_string(&jstr, "online_time_s", str);
+        json_gen_end_object(&jstr);
+    }
+    json_gen_pop_array(&jstr);
+    snprintf(str, sizeof(str), "%lld", esp_timer_get_time());
+    json_gen_obj_set_string(&jstr, "now_time", str);
+    json_gen_end_object(&jstr);
+    json_gen_str_end(&jstr);
+
+    return http_json_finish(&ctx);
 }
 
 static esp_err_t system_station_delete_device_post_handler(httpd_req_t *req)
 {
-    char buf[256] = { 0 };
     char mac_str[18] = "";
     int value[6] = { 0 };
     uint8_t mac_byte[6] = { 0 };
     uint16_t aid = 0;
-    int len_ret, remaining = req->content_len;
-
-    if (remaining > sizeof(buf)) {
-        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "string too long");
-        return ESP_FAIL;
-    }
-
-    while (remaining > 0) {
-        /* Read the data for the request */
-        if ((len_ret = httpd_req_recv(req, buf, MIN(remaining, sizeof(buf)))) <= 0) {
-            if (len_ret == HTTPD_SOCK_ERR_TIMEOUT) {
-                /* Retry receiving if timeout occurred */
-                continue;
-            }
-            return ESP_FAIL;
-        }
-
-        remaining -= len_ret;
 
-        /* Log data received */
-        ESP_LOGI(TAG, "=========== RECEIVED DATA ==========");
-        ESP_LOGI(TAG, "%.*s", len_ret, buf);
-        ESP_LOGI(TAG, "====================================");
-    }
     httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
     httpd_resp_set_hdr(req, "Access-Control-Allow-Methods", "*");
     httpd_resp_set_hdr(req, "Access-Control-Allow-Headers", "*");
     jparse_ctx_t jctx;
-    int ps_ret = json_parse_start(&jctx, buf, strlen(buf));
-
-    if (ps_ret != OS_SUCCESS) {
+    json_tok_t tokens[HTTP_JSON_MAX_TOKENS];
+    esp_err_t recv_ret = http_recv_json(req, &jctx, tokens, HTTP_JSON_MAX_TOKENS, NULL);
+    if (recv_ret == ESP_ERR_INVALID_SIZE) {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "string too long");
+        return ESP_FAIL;
+    } else if (recv_ret != ESP_OK) {
         ESP_LOGE(TAG, "Parser failed\n");
         return ESP_FAIL;
     }
 
     char str_val[64];
 
-    if (json_obj_get_string(&jctx, "mac_str", str_val, sizeof(str_val)) == OS_SUCCESS) {
+    if (http_json_get_string(&jctx, "mac_str", str_val, sizeof(str_val)) == OS_SUCCESS) {
         snprintf(mac_str, sizeof(mac_str), "%.*s", sizeof(mac_str) - 1, str_val);
         ESP_LOGI(TAG, "mac_str: %s\n", mac_str);
     } else {
@@ -681,39 +752,16 @@ static esp_err_t system_station_delete_device_post_handler(httpd_req_t *req)
 
 static esp_err_t system_station_change_name_post_handler(httpd_req_t *req)
 {
-    char buf[256] = { 0 };
-    int len_ret, remaining = req->content_len;
-
-    if (remaining > sizeof(buf)) {
-        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "string too long");
-        return ESP_FAIL;
-    }
-
-    while (remaining > 0) {
-        /* Read the data for the request */
-        if ((len_ret = httpd_req_recv(req, buf, MIN(remaining, sizeof(buf)))) <= 0) {
-            if (len_ret == HTTPD_SOCK_ERR_TIMEOUT) {
-                /* Retry receiving if timeout occurred */
-                continue;
-            }
-
-            return ESP_FAIL;
-        }
-
-        remaining -= len_ret;
-
-        /* Log data received */
-        ESP_LOGI(TAG, "=========== RECEIVED DATA ==========");
-        ESP_LOGI(TAG, "%.*s", len_ret, buf);
-        ESP_LOGI(TAG, "====================================");
-    }
     httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
     httpd_resp_set_hdr(req, "Access-Control-Allow-Methods", "*");
     httpd_resp_set_hdr(req, "Access-Control-Allow-Headers", "*");
     jparse_ctx_t jctx;
-    int ps_ret = json_parse_start(&jctx, buf, strlen(buf));
-
-    if (ps_ret != OS_SUCCESS) {
+    json_tok_t tokens[HTTP_JSON_MAX_TOKENS];
+    esp_err_t recv_ret = http_recv_json(req, &jctx, tokens, HTTP_JSON_MAX_TOKENS, NULL);
+    if (recv_ret == ESP_ERR_INVALID_SIZE) {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "string too long");
+        return ESP_FAIL;
+    } else if (recv_ret != ESP_OK) {
         ESP_LOGE(TAG, "Parser failed\n");
         return ESP_FAIL;
     }
@@ -722,7 +770,7 @@ static esp_err_t system_station_change_name_post_handler(httpd_req_t *req)
     char name_str[36] = "";
     char mac_str[18] = "";
 
-    if (json_obj_get_string(&jctx, "name_str", str_val, sizeof(str_val)) == OS_SUCCESS) {
+    if (http_json_get_string(&jctx, "name_str", str_val, sizeof(str_val)) == OS_SUCCESS) {
         snprintf(name_str, sizeof(name_str), "%.*s", sizeof(name_str) - 1, str_val);
         ESP_LOGI(TAG, "name_str: %s\n", name_str);
     } else {
@@ -730,7 +778,7 @@ static esp_err_t system_station_change_name_post_handler(httpd_req_t *req)
         return ESP_FAIL;
     }
 
-    if (json_obj_get_string(&jctx, "mac_str", str_val, sizeof(str_val)) == OS_SUCCESS) {
+    if (http_json_get_string(&jctx, "mac_str", str_val, sizeof(str_val)) == OS_SUCCESS) {
         snprintf(mac_str, sizeof(mac_str), "%.*s", sizeof(mac_str) - 1, str_val);
         ESP_LOGI(TAG, "mac_str: %s\n", mac_str);
     } else {
@@ -836,20 +884,47 @@ static esp_err_t sensors_data_get_handler(httpd_req_t *req)
         httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "No sensor data available");
         return ESP_FAIL;
     }
+    sensor_data_t sensors;
+    data_model_get_sensor_data(model, &sensors);
+
+    // 单次测量模式下附带光照的采集耗时和量程
+    char light_info[128] = "";
+    sensors_light_info_t info;
+    if (sensors_get_light_info(&info) == ESP_OK) {
+        snprintf(light_info, sizeof(light_info),
+                 "\"light_mode\":\"%s\",\"light_mtreg\":%u,"
+                 "\"light_acquisition_ms\":%lu,\"light_acquisition_max_ms\":%lu,",
+                 info.mode, info.mtreg, (unsigned long)info.acquisition_ms,
+                 (unsigned long)info.max_acquisition_ms);
+    }
     
+    // 只输出已有读数的通道，尚未读到的通道省略
+    char channels[96] = "";
+    int pos = 0;
+    if (sensors.valid_mask & SENSOR_CH_BIT(SENSOR_CH_TEMPERATURE)) {
+        pos += snprintf(channels + pos, sizeof(channels) - pos,
+                        "\"temperature\":%.2f,", sensors.temperature);
+    }
+    if (sensors.valid_mask & SENSOR_CH_BIT(SENSOR_CH_HUMIDITY)) {
+        pos += snprintf(channels + pos, sizeof(channels) - pos,
+                        "\"humidity\":%.2f,", sensors.humidity);
+    }
+    if (sensors.valid_mask & SENSOR_CH_BIT(SENSOR_CH_LIGHT)) {
+        pos += snprintf(channels + pos, sizeof(channels) - pos,
+                        "\"light_intensity\":%.2f,", sensors.light_intensity);
+    }
+
     // 构建传感器数据JSON响应（移除GPS相关数据）
     size = asprintf(&json_str, 
                     "{"
-                    "\"temperature\":%.2f,"
-                    "\"humidity\":%.2f,"
-                    "\"light_intensity\":%.2f,"
+                    "%s"
+                    "%s"
                     "\"sensors_valid\":%s,"
                     "\"timestamp\":%ld"
                     "}",
-                    model->sensors.temperature,
-                    model->sensors.humidity,
-                    model->sensors.light_intensity,
-                    model->sensors.sensors_valid ? "true" : "false",
+                    channels,
+                    light_info,
+                    sensors.sensors_valid ? "true" : "false",
                     (long)model->timestamp);
     
     httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
@@ -873,6 +948,57 @@ static esp_err_t sensors_data_get_handler(httpd_req_t *req)
     return ESP_OK;
 }
 
+/**
+ * @brief 获取传感器滤波配置，以及各通道最近的原始值、滤波值和剔除计数
+ */
+static esp_err_t sensor_filter_get_handler(httpd_req_t *req)
+{
+    char buf[128];
+    json_gen_str_t jstr;
+    http_json_ctx_t ctx = { .req = req, .err = ESP_OK };
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+
+    json_gen_str_start(&jstr, buf, sizeof(buf), http_json_flush_cb, &ctx);
+    json_gen_start_object(&jstr);
+    json_gen_obj_set_bool(&jstr, "success", true);
+    sensor_filters_add_json(&jstr);
+    json_gen_end_object(&jstr);
+    json_gen_str_end(&jstr);
+    return http_json_finish(&ctx);
+}
+
+/**
+ * @brief 修改传感器滤波配置，格式见sensor_filters_on_message()
+ */
+static esp_err_t sensor_filter_save_handler(httpd_req_t *req)
+{
+    char *body = NULL;
+    int len = 0;
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+
+    esp_err_t ret = http_recv_body(req, &body, &len);
+    if (ret != ESP_OK && ret != ESP_ERR_INVALID_SIZE) {
+        httpd_resp_send_500(req);
+        return ESP_FAIL;
+    }
+    if (ret == ESP_OK) {
+        ret = sensor_filters_on_message(body, len);
+    }
+
+    if (ret == ESP_OK) {
+        httpd_resp_sendstr(req, "{\"success\":true,\"message\":\"滤波配置已保存\"}");
+    } else if (ret == ESP_ERR_INVALID_ARG || ret == ESP_ERR_INVALID_SIZE) {
+        httpd_resp_sendstr(req, "{\"success\":false,\"message\":\"滤波参数无效\"}");
+    } else {
+        httpd_resp_sendstr(req, "{\"success\":false,\"message\":\"无法保存配置\"}");
+    }
+    return ESP_OK;
+}
+
 // 新增GPS数据专用处理函数
 static esp_err_t gps_data_get_handler(httpd_req_t *req)
 {
@@ -886,27 +1012,35 @@ static esp_err_t gps_data_get_handler(httpd_req_t *req)
         return ESP_FAIL;
     }
     
+    // 坐标为1e-7度定点数，按整数格式化
+    char lat_str[JSON_GEN_MAX_FLOAT_STR];
+    char lon_str[JSON_GEN_MAX_FLOAT_STR];
+    json_gen_fixed_to_str(lat_str, model->gps.lat_e7, GPS_COORD_DECIMALS);
+    json_gen_fixed_to_str(lon_str, model->gps.lon_e7, GPS_COORD_DECIMALS);
+
     // 构建GPS数据JSON响应
     size = asprintf(&json_str, 
                     "{"
-                    "\"latitude\":%.6f,"
-                    "\"longitude\":%.6f,"
+                    "\"latitude\":%s,"
+                    "\"longitude\":%s,"
                     "\"ns_indicator\":\"%c\","
                     "\"ew_indicator\":\"%c\","
                     "\"altitude\":%.2f,"
                     "\"speed\":%.2f,"
                     "\"course\":%.2f,"
+                    "\"accuracy\":%.1f,"
                     "\"data_source\":%d,"
                     "\"gps_valid\":%s,"
                     "\"timestamp\":%ld"
                     "}",
-                    model->gps.latitude,
-                    model->gps.longitude,
-                    model->gps.ns_indicator,
-                    model->gps.ew_indicator,
+                    lat_str,
+                    lon_str,
+                    model->gps.lat_e7 < 0 ? 'S' : 'N',
+                    model->gps.lon_e7 < 0 ? 'W' : 'E',
                     model->gps.altitude,
                     model->gps.speed,
                     model->gps.course,
+                    model->gps.accuracy,
                     model->gps.data_source,
                     model->gps.gps_valid ? "true" : "false",
                     (long)model->timestamp);
@@ -944,35 +1078,17 @@ static esp_err_t wifi_sta_get_handler(httpd_req_t *req)
 static esp_err_t wifi_sta_post_handler(httpd_req_t *req)
 {
     // 获取POST数据
-    char *buf = malloc(1024);
-    if (buf == NULL) {
-        ESP_LOGE(TAG, "内存分配失败");
-        return ESP_FAIL;
-    }
-    
-    int total_len = req->content_len;
-    int cur_len = 0;
-    int received = 0;
-    
-    if (total_len >= 1024) {
-        ESP_LOGE(TAG, "内容太长");
-        free(buf);
+    char *buf = NULL;
+    int total_len = 0;
+    esp_err_t recv_ret = http_recv_body(req, &buf, &total_len);
+    if (recv_ret == ESP_ERR_INVALID_SIZE) {
         httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "内容太长");
         return ESP_FAIL;
+    } else if (recv_ret != ESP_OK) {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "接收数据失败");
+        return ESP_FAIL;
     }
     
-    while (cur_len < total_len) {
-        received = httpd_req_recv(req, buf + cur_len, total_len - cur_len);
-        if (received <= 0) {
-            ESP_LOGE(TAG, "接收数据失败");
-            free(buf);
-            httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "接收数据失败");
-            return ESP_FAIL;
-        }
-        cur_len += received;
-    }
-    buf[total_len] = '\0';
-    
     ESP_LOGI(TAG, "收到的WiFi配置数据: %s", buf);
     
     // 解析SSID和密码
@@ -985,25 +1101,17 @@ static esp_err_t wifi_sta_post_handler(httpd_req_t *req)
     if (ssid_ptr) {
         ssid_ptr += 5; // 跳过 "ssid="
         char *end = strchr(ssid_ptr, '&');
-        if (end) {
-            strncpy(ssid, ssid_ptr, end - ssid_ptr);
-        } else {
-            strcpy(ssid, ssid_ptr);
-        }
+        int len = end ? end - ssid_ptr : strlen(ssid_ptr);
+        strncpy(ssid, ssid_ptr, MIN(len, sizeof(ssid) - 1));
     }
     
     if (password_ptr) {
         password_ptr += 9; // 跳过 "password="
         char *end = strchr(password_ptr, '&');
-        if (end) {
-            strncpy(password, password_ptr, end - password_ptr);
-        } else {
-            strcpy(password, password_ptr);
-        }
+        int len = end ? end - password_ptr : strlen(password_ptr);
+        strncpy(password, password_ptr, MIN(len, sizeof(password) - 1));
     }
     
-    free(buf);
-    
     // URL解码
     char decoded_ssid[33] = {0};
     char decoded_password[65] = {0};
@@ -1097,50 +1205,34 @@ static esp_err_t mqtt_topics_get_handler(httpd_req_t *req)
 /* 添加MQTT主题处理函数 */
 static esp_err_t mqtt_topic_add_handler(httpd_req_t *req)
 {
-    int total_len = req->content_len;
-    int cur_len = 0;
-    char *buf = malloc(total_len + 1);
-    if (buf == NULL) {
+    jparse_ctx_t jctx;
+    json_tok_t tokens[HTTP_JSON_MAX_TOKENS];
+    int body_len = 0;
+    esp_err_t recv_ret = http_recv_json(req, &jctx, tokens, HTTP_JSON_MAX_TOKENS, &body_len);
+    if (recv_ret != ESP_OK && recv_ret != ESP_ERR_INVALID_ARG) {
         httpd_resp_send_500(req);
         return ESP_FAIL;
     }
     
-    int received = 0;
-    while (cur_len < total_len) {
-        received = httpd_req_recv(req, buf + cur_len, total_len - cur_len);
-        if (received <= 0) {
-            free(buf);
-            httpd_resp_send_500(req);
-            return ESP_FAIL;
-        }
-        cur_len += received;
-    }
-    buf[total_len] = '\0';
-
-    cJSON *root = cJSON_Parse(buf);
-    free(buf);
-    
     char resp_str[256];
     
-    if (root == NULL) {
+    if (recv_ret == ESP_ERR_INVALID_ARG) {
         snprintf(resp_str, sizeof(resp_str), "{\"success\":false,\"message\":\"无效的JSON数据\"}");
         httpd_resp_set_type(req, "application/json");
         httpd_resp_send(req, resp_str, strlen(resp_str));
         return ESP_OK;
     }
 
-    cJSON *topic_json = cJSON_GetObjectItem(root, "topic");
-    if (!cJSON_IsString(topic_json) || (topic_json->valuestring == NULL)) {
+    char topic[MAX_TOPIC_LENGTH];
+    if (http_json_get_string(&jctx, "topic", topic, sizeof(topic)) != OS_SUCCESS) {
         snprintf(resp_str, sizeof(resp_str), "{\"success\":false,\"message\":\"无效的主题\"}");
-        cJSON_Delete(root);
         httpd_resp_set_type(req, "application/json");
         httpd_resp_send(req, resp_str, strlen(resp_str));
         return ESP_OK;
     }
 
     // 添加并订阅主题
-    esp_err_t ret = mqtt_subscribe_topic(topic_json->valuestring, true);
-    cJSON_Delete(root);
+    esp_err_t ret = mqtt_subscribe_topic(topic, true);
     
     if (ret == ESP_OK) {
         snprintf(resp_str, sizeof(resp_str), "{\"success\":true,\"message\":\"主题添加成功\"}");
@@ -1159,50 +1251,34 @@ static esp_err_t mqtt_topic_add_handler(httpd_req_t *req)
 /* 删除MQTT主题处理函数 */
 static esp_err_t mqtt_topic_delete_handler(httpd_req_t *req)
 {
-    int total_len = req->content_len;
-    int cur_len = 0;
-    char *buf = malloc(total_len + 1);
-    if (buf == NULL) {
+    jparse_ctx_t jctx;
+    json_tok_t tokens[HTTP_JSON_MAX_TOKENS];
+    int body_len = 0;
+    esp_err_t recv_ret = http_recv_json(req, &jctx, tokens, HTTP_JSON_MAX_TOKENS, &body_len);
+    if (recv_ret != ESP_OK && recv_ret != ESP_ERR_INVALID_ARG) {
         httpd_resp_send_500(req);
         return ESP_FAIL;
     }
     
-    int received = 0;
-    while (cur_len < total_len) {
-        received = httpd_req_recv(req, buf + cur_len, total_len - cur_len);
-        if (received <= 0) {
-            free(buf);
-            httpd_resp_send_500(req);
-            return ESP_FAIL;
-        }
-        cur_len += received;
-    }
-    buf[total_len] = '\0';
-
-    cJSON *root = cJSON_Parse(buf);
-    free(buf);
-    
     char resp_str[256];
     
-    if (root == NULL) {
+    if (recv_ret == ESP_ERR_INVALID_ARG) {
         snprintf(resp_str, sizeof(resp_str), "{\"success\":false,\"message\":\"无效的JSON数据\"}");
         httpd_resp_set_type(req, "application/json");
         httpd_resp_send(req, resp_str, strlen(resp_str));
         return ESP_OK;
     }
 
-    cJSON *topic_json = cJSON_GetObjectItem(root, "topic");
-    if (!cJSON_IsString(topic_json) || (topic_json->valuestring == NULL)) {
+    char topic[MAX_TOPIC_LENGTH];
+    if (http_json_get_string(&jctx, "topic", topic, sizeof(topic)) != OS_SUCCESS) {
         snprintf(resp_str, sizeof(resp_str), "{\"success\":false,\"message\":\"无效的主题\"}");
-        cJSON_Delete(root);
         httpd_resp_set_type(req, "application/json");
         httpd_resp_send(req, resp_str, strlen(resp_str));
         return ESP_OK;
     }
 
     // 取消订阅并删除主题
-    esp_err_t ret = mqtt_unsubscribe_topic(topic_json->valuestring, true);
-    cJSON_Delete(root);
+    esp_err_t ret = mqtt_unsubscribe_topic(topic, true);
     
     if (ret == ESP_OK) {
         snprintf(resp_str, sizeof(resp_str), "{\"success\":true,\"message\":\"主题删除成功\"}");
@@ -1221,53 +1297,38 @@ static esp_err_t mqtt_topic_delete_handler(httpd_req_t *req)
 /* 发布MQTT消息处理函数 */
 static esp_err_t mqtt_publish_handler(httpd_req_t *req)
 {
-    int total_len = req->content_len;
-    int cur_len = 0;
-    char *buf = malloc(total_len + 1);
-    if (buf == NULL) {
+    jparse_ctx_t jctx;
+    json_tok_t tokens[HTTP_JSON_MAX_TOKENS];
+    int body_len = 0;
+    esp_err_t recv_ret = http_recv_json(req, &jctx, tokens, HTTP_JSON_MAX_TOKENS, &body_len);
+    if (recv_ret != ESP_OK && recv_ret != ESP_ERR_INVALID_ARG) {
         httpd_resp_send_500(req);
         return ESP_FAIL;
     }
     
-    int received = 0;
-    while (cur_len < total_len) {
-        received = httpd_req_recv(req, buf + cur_len, total_len - cur_len);
-        if (received <= 0) {
-            free(buf);
-            httpd_resp_send_500(req);
-            return ESP_FAIL;
-        }
-        cur_len += received;
-    }
-    buf[total_len] = '\0';
-
-    cJSON *root = cJSON_Parse(buf);
-    free(buf);
-    
     char resp_str[256];
     
-    if (root == NULL) {
+    if (recv_ret == ESP_ERR_INVALID_ARG) {
         snprintf(resp_str, sizeof(resp_str), "{\"success\":false,\"message\":\"无效的JSON数据\"}");
         httpd_resp_set_type(req, "application/json");
         httpd_resp_send(req, resp_str, strlen(resp_str));
         return ESP_OK;
     }
 
-    cJSON *topic_json = cJSON_GetObjectItem(root, "topic");
-    cJSON *message_json = cJSON_GetObjectItem(root, "message");
+    // 消息内容不超过请求体长度，放在scratch缓冲区中请求体之后
+    char topic[MAX_TOPIC_LENGTH];
+    char *message = (char *)jctx.js + body_len + 1;
     
-    if (!cJSON_IsString(topic_json) || (topic_json->valuestring == NULL) || 
-        !cJSON_IsString(message_json) || (message_json->valuestring == NULL)) {
+    if (http_json_get_string(&jctx, "topic", topic, sizeof(topic)) != OS_SUCCESS ||
+        http_json_get_string(&jctx, "message", message, HTTP_BODY_MAX_LEN + 1) != OS_SUCCESS) {
         snprintf(resp_str, sizeof(resp_str), "{\"success\":false,\"message\":\"无效的主题或消息\"}");
-        cJSON_Delete(root);
         httpd_resp_set_type(req, "application/json");
         httpd_resp_send(req, resp_str, strlen(resp_str));
         return ESP_OK;
     }
 
     // 发布消息
-    esp_err_t ret = mqtt_publish_message(topic_json->valuestring, message_json->valuestring, 1);  // QoS 1
-    cJSON_Delete(root);
+    esp_err_t ret = mqtt_publish_message(topic, message, 1);  // QoS 1
     
     if (ret == ESP_OK) {
         snprintf(resp_str, sizeof(resp_str), "{\"success\":true,\"message\":\"消息发布成功\"}");
@@ -1376,44 +1437,17 @@ static esp_err_t mqtt_settings_save_handler(httpd_req_t *req)
     httpd_resp_set_type(req, "application/json");
     httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
     
-    int total_len = req->content_len;
-    int cur_len = 0;
-    char *buf = malloc(total_len + 1);
-    if (buf == NULL) {
-        ESP_LOGE(TAG, "内存分配失败");
+    // 接收并解析请求体
+    jparse_ctx_t jctx;
+    json_tok_t tokens[HTTP_JSON_MAX_TOKENS];
+    esp_err_t recv_ret = http_recv_json(req, &jctx, tokens, HTTP_JSON_MAX_TOKENS, NULL);
+    if (recv_ret != ESP_OK && recv_ret != ESP_ERR_INVALID_ARG) {
         httpd_resp_send_500(req);
         return ESP_FAIL;
     }
     
-    // 接收请求体
-    int received = 0;
-    while (cur_len < total_len) {
-        received = httpd_req_recv(req, buf + cur_len, total_len - cur_len);
-        if (received <= 0) {
-            ESP_LOGE(TAG, "接收请求体失败");
-            free(buf);
-            httpd_resp_send_500(req);
-            return ESP_FAIL;
-        }
-        cur_len += received;
-    }
-    buf[total_len] = '\0';
-    
-    // 解析JSON
-    cJSON *root = cJSON_Parse(buf);
-    free(buf);
-    
-    if (root == NULL) {
-        ESP_LOGE(TAG, "JSON解析失败");
-        cJSON *err_root = cJSON_CreateObject();
-        cJSON_AddBoolToObject(err_root, "success", false);
-        cJSON_AddStringToObject(err_root, "message", "请求格式无效");
-        
-        const char *err_response = cJSON_Print(err_root);
-        httpd_resp_sendstr(req, err_response);
-        
-        cJSON_Delete(err_root);
-        free((void *)err_response);
+    if (recv_ret == ESP_ERR_INVALID_ARG) {
+        httpd_resp_sendstr(req, "{\"success\":false,\"message\":\"请求格式无效\"}");
         return ESP_OK;
     }
     
@@ -1422,41 +1456,32 @@ static esp_err_t mqtt_settings_save_handler(httpd_req_t *req)
     esp_err_t err = nvs_open(NVS_MQTT_NAMESPACE, NVS_READWRITE, &nvs_handle);
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "打开NVS命名空间失败: %s", esp_err_to_name(err));
-        cJSON *err_root = cJSON_CreateObject();
-        cJSON_AddBoolToObject(err_root, "success", false);
-        cJSON_AddStringToObject(err_root, "message", "无法访问存储");
-        
-        const char *err_response = cJSON_Print(err_root);
-        httpd_resp_sendstr(req, err_response);
-        
-        cJSON_Delete(err_root);
-        cJSON_Delete(root);
-        free((void *)err_response);
+        httpd_resp_sendstr(req, "{\"success\":false,\"message\":\"无法访问存储\"}");
         return ESP_OK;
     }
     
     // 获取并保存MQTT Broker
-    cJSON *broker_json = cJSON_GetObjectItem(root, "broker");
-    if (broker_json != NULL && cJSON_IsString(broker_json)) {
-        err = nvs_set_str(nvs_handle, NVS_MQTT_BROKER_KEY, broker_json->valuestring);
+    char broker[128];
+    if (http_json_get_string(&jctx, "broker", broker, sizeof(broker)) == OS_SUCCESS) {
+        err = nvs_set_str(nvs_handle, NVS_MQTT_BROKER_KEY, broker);
         if (err != ESP_OK) {
             ESP_LOGE(TAG, "保存MQTT Broker失败: %s", esp_err_to_name(err));
         }
     }
     
     // 获取并保存MQTT用户名
-    cJSON *username_json = cJSON_GetObjectItem(root, "username");
-    if (username_json != NULL && cJSON_IsString(username_json)) {
-        err = nvs_set_str(nvs_handle, NVS_MQTT_USERNAME_KEY, username_json->valuestring);
+    char username[64];
+    if (http_json_get_string(&jctx, "username", username, sizeof(username)) == OS_SUCCESS) {
+        err = nvs_set_str(nvs_handle, NVS_MQTT_USERNAME_KEY, username);
         if (err != ESP_OK) {
             ESP_LOGE(TAG, "保存MQTT用户名失败: %s", esp_err_to_name(err));
         }
     }
     
     // 获取并保存MQTT密码
-    cJSON *password_json = cJSON_GetObjectItem(root, "password");
-    if (password_json != NULL && cJSON_IsString(password_json)) {
-        err = nvs_set_str(nvs_handle, NVS_MQTT_PASSWORD_KEY, password_json->valuestring);
+    char password[64];
+    if (http_json_get_string(&jctx, "password", password, sizeof(password)) == OS_SUCCESS) {
+        err = nvs_set_str(nvs_handle, NVS_MQTT_PASSWORD_KEY, password);
         if (err != ESP_OK) {
             ESP_LOGE(TAG, "保存MQTT密码失败: %s", esp_err_to_name(err));
         }
@@ -1474,18 +1499,7 @@ static esp_err_t mqtt_settings_save_handler(httpd_req_t *req)
     // 尝试重新连接MQTT
     mqtt_reconnect();
     
-    // 构造响应
-    cJSON *resp_root = cJSON_CreateObject();
-    cJSON_AddBoolToObject(resp_root, "success", true);
-    cJSON_AddStringToObject(resp_root, "message", "MQTT设置已保存并重新连接");
-    
-    const char *response = cJSON_Print(resp_root);
-    httpd_resp_sendstr(req, response);
-    
-    // 释放资源
-    cJSON_Delete(root);
-    cJSON_Delete(resp_root);
-    free((void *)response);
+    httpd_resp_sendstr(req, "{\"success\":true,\"message\":\"MQTT设置已保存并重新连接\"}");
     
     return ESP_OK;
 }
@@ -1619,6 +1633,20 @@ static httpd_uri_t sensors_data_get = {
     .user_ctx  = NULL
 };
 
+static httpd_uri_t sensor_filter_get = {
+    .uri       = "/api/sensors/filter",
+    .method    = HTTP_GET,
+    .handler   = sensor_filter_get_handler,
+    .user_ctx  = NULL
+};
+
+static httpd_uri_t sensor_filter_save_post = {
+    .uri       = "/api/sensors/filter/save",
+    .method    = HTTP_POST,
+    .handler   = sensor_filter_save_handler,
+    .user_ctx  = NULL
+};
+
 static httpd_uri_t gps_data_get = {
     .uri       = "/sensors/gps",
     .method    = HTTP_GET,
@@ -1707,7 +1735,7 @@ static httpd_handle_t start_webserver(const char *base_path)
     httpd_handle_t server = NULL;
     httpd_config_t config = HTTPD_DEFAULT_CONFIG();
     config.stack_size = 8192;
-    config.max_uri_handlers = 20;
+    config.max_uri_handlers = 24;
     config.lru_purge_enable = true;
     config.uri_match_fn = httpd_uri_match_wildcard;
     config.task_priority = 15;
@@ -1735,6 +1763,10 @@ static httpd_handle_t start_webserver(const char *base_path)
         httpd_register_uri_handler(server, &system_station_change_name_post);
         sensors_data_get.user_ctx = ctx_info;
         httpd_register_uri_handler(server, &sensors_data_get);
+        sensor_filter_get.user_ctx = ctx_info;
+        httpd_register_uri_handler(server, &sensor_filter_get);
+        sensor_filter_save_post.user_ctx = ctx_info;
+        httpd_register_uri_handler(server, &sensor_filter_save_post);
         gps_data_get.user_ctx = ctx_info;
         httpd_register_uri_handler(server, &gps_data_get);
         wifi_sta_get.user_ctx = ctx_info;
@@ -1743,12 +1775,19 @@ static httpd_handle_t start_webserver(const char *base_path)
         httpd_register_uri_handler(server, &wifi_sta_post);
         network_mode_get.user_ctx = ctx_info;
         httpd_register_uri_handler(server, &network_mode_get);
+        mqtt_topics_uri.user_ctx = ctx_info;
         httpd_register_uri_handler(server, &mqtt_topics_uri);
+        mqtt_add_topic_uri.user_ctx = ctx_info;
         httpd_register_uri_handler(server, &mqtt_add_topic_uri);
+        mqtt_delete_topic_uri.user_ctx = ctx_info;
         httpd_register_uri_handler(server, &mqtt_delete_topic_uri);
+        mqtt_publish_uri.user_ctx = ctx_info;
         httpd_register_uri_handler(server, &mqtt_publish_uri);
+        mqtt_settings_uri.user_ctx = ctx_info;
         httpd_register_uri_handler(server, &mqtt_settings_uri);
+        mqtt_settings_save_uri.user_ctx = ctx_info;
         httpd_register_uri_handler(server, &mqtt_settings_save_uri);
+        mqtt_status_uri.user_ctx = ctx_info;
         httpd_register_uri_handler(server, &mqtt_status_uri);
 
         httpd_uri_t common_get_uri = {
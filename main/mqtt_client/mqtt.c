@@ -3,7 +3,10 @@
 #include "mqtt.h"
 #include "esp_log.h"
 #include "json_wrapper.h"
+#include "json_template.h"
 #include "ota.h"
+#include "geofence_manager.h"
+#include "sensor_filters.h"
 #include "nvs_flash.h"
 #include "nvs.h"
 static const char *TAG = "MQTT";
@@ -15,8 +18,9 @@ static const char *TAG = "MQTT";
 #define MQTT_BROKER_USERNAME    CONFIG_MQTT_BROKER_USERNAME
 #define MQTT_BROKER_PASSWORD    CONFIG_MQTT_BROKER_PASSWORD
 #define MQTT_OTA_TOPIC          CONFIG_MQTT_OTA_TOPIC
+#define MQTT_GEOFENCE_TOPIC     CONFIG_MQTT_GEOFENCE_TOPIC
+#define MQTT_SENSOR_FILTER_TOPIC CONFIG_MQTT_SENSOR_FILTER_TOPIC
 
-#define JSON_BUFFER_SIZE        2048
 #define MAX_MQTT_TOPICS         20
 #define MAX_TOPIC_LENGTH        64
 #define NVS_MQTT_NAMESPACE      "mqtt_topics"
@@ -34,7 +38,21 @@ static char s_topics[MAX_MQTT_TOPICS][MAX_TOPIC_LENGTH];
 static int s_topic_count = 0;
 static TaskHandle_t data_publish_task_handle = NULL;
 
+// 数据模型JSON模板，仅由数据发布任务使用
+static json_template_t s_data_template;
+
 // MQTT状态跟踪
+// 订阅的配置主题，超出接收缓冲区的消息分多个MQTT_EVENT_DATA到达，只有第一个分片带主题
+typedef enum {
+    MQTT_RX_OTHER = 0,
+    MQTT_RX_OTA,
+    MQTT_RX_GEOFENCE,
+    MQTT_RX_SENSOR_FILTER,
+} mqtt_rx_topic_t;
+
+// 当前消息的主题，只在MQTT任务中使用
+static mqtt_rx_topic_t s_rx_topic = MQTT_RX_OTHER;
+
 static mqtt_connection_status_t s_mqtt_status = MQTT_CONNECTION_STATUS_DISCONNECTED;
 static char s_mqtt_error_message[256] = {0};
 
@@ -96,6 +114,51 @@ static void log_error_if_nonzero(const char *message, int error_code)
     }
 }
 
+static bool mqtt_topic_is(const esp_mqtt_event_handle_t event, const char *topic)
+{
+    return event->topic_len == (int)strlen(topic) && strncmp(event->topic, topic, event->topic_len) == 0;
+}
+
+// 处理一个消息分片，后续分片按第一个分片的主题分发
+static void mqtt_on_data(const esp_mqtt_event_handle_t event)
+{
+    if (event->current_data_offset == 0) {
+        printf("TOPIC=%.*s\r\n", event->topic_len, event->topic);
+        if (mqtt_topic_is(event, MQTT_OTA_TOPIC)) {
+            s_rx_topic = MQTT_RX_OTA;
+        } else if (mqtt_topic_is(event, MQTT_GEOFENCE_TOPIC)) {
+            s_rx_topic = MQTT_RX_GEOFENCE;
+        } else if (mqtt_topic_is(event, MQTT_SENSOR_FILTER_TOPIC)) {
+            s_rx_topic = MQTT_RX_SENSOR_FILTER;
+        } else {
+            s_rx_topic = MQTT_RX_OTHER;
+        }
+    }
+    printf("DATA=%.*s\r\n", event->data_len, event->data);
+
+    // 围栏和OTA消息逐片流式解析；滤波配置消息须在一个分片内
+    bool complete = event->current_data_offset == 0 && event->data_len == event->total_data_len;
+    switch (s_rx_topic) {
+    case MQTT_RX_GEOFENCE:
+        geofence_manager_on_message((const char*)event->data, event->data_len,
+                                    event->current_data_offset, event->total_data_len);
+        break;
+    case MQTT_RX_OTA:
+        mqtt_ota_handler((const char*)event->data, event->data_len,
+                         event->current_data_offset, event->total_data_len);
+        break;
+    case MQTT_RX_SENSOR_FILTER:
+        if (complete) {
+            sensor_filters_on_message((const char*)event->data, event->data_len);
+        } else if (event->current_data_offset == 0) {
+            ESP_LOGW(TAG, "消息%d字节超出接收缓冲区，已丢弃", event->total_data_len);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
 /*
  * @brief Event handler registered to receive MQTT events
  *
@@ -115,7 +178,11 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_
     case MQTT_EVENT_CONNECTED:
         ESP_LOGI(TAG, "MQTT_EVENT_CONNECTED");
         esp_mqtt_client_subscribe(client, MQTT_OTA_TOPIC, 0);
-        ESP_LOGI(TAG, "Subscribed to topics: %s", MQTT_OTA_TOPIC);
+        // 围栏配置使用QoS 1，断线期间下发的配置在重连后补收
+        esp_mqtt_client_subscribe(client, MQTT_GEOFENCE_TOPIC, 1);
+        esp_mqtt_client_subscribe(client, MQTT_SENSOR_FILTER_TOPIC, 1);
+        ESP_LOGI(TAG, "Subscribed to topics: %s, %s, %s", MQTT_OTA_TOPIC, MQTT_GEOFENCE_TOPIC,
+                 MQTT_SENSOR_FILTER_TOPIC);
         
         // 更新状态为已连接
         s_mqtt_status = MQTT_CONNECTION_STATUS_CONNECTED;
@@ -143,11 +210,7 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_
         break;
     case MQTT_EVENT_DATA:
         ESP_LOGI(TAG, "MQTT_EVENT_DATA");
-        printf("TOPIC=%.*s\r\n", event->topic_len, event->topic);
-        printf("DATA=%.*s\r\n", event->data_len, event->data);
-        if (strncmp(event->topic, MQTT_OTA_TOPIC, strlen(MQTT_OTA_TOPIC)) == 0) {
-            mqtt_ota_handler((const char*)event->data, event->data_len);
-        }
+        mqtt_on_data(event);
         break;
     case MQTT_EVENT_ERROR:
         ESP_LOGI(TAG, "MQTT_EVENT_ERROR");
@@ -298,18 +361,17 @@ esp_err_t mqtt_publish_data_model(esp_mqtt_client_handle_t client,
         topic = default_topic;
     }
     
-    // 创建JSON字符串缓冲区
-    char json_buffer[JSON_BUFFER_SIZE];
-    
-    // 将数据模型转换为JSON
-    esp_err_t ret = json_generate_from_data_model(model, json_buffer, JSON_BUFFER_SIZE);
+    // 按模板填写数值生成JSON，结构不变时无需重新生成整个文档
+    const char *json_str = NULL;
+    size_t json_len = 0;
+    esp_err_t ret = json_template_render(&s_data_template, model, &json_str, &json_len);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "生成JSON数据失败: %d", ret);
         return ret;
     }
     
     // 发布到MQTT
-    int msg_id = esp_mqtt_client_publish(client, topic, json_buffer, strlen(json_buffer), 1, 0);
+    int msg_id = esp_mqtt_client_publish(client, topic, json_str, json_len, 1, 0);
     if (msg_id < 0) {
         ESP_LOGE(TAG, "发布数据失败");
         return ESP_FAIL;
@@ -319,6 +381,65 @@ esp_err_t mqtt_publish_data_model(esp_mqtt_client_handle_t client,
     return ESP_OK;
 }
 
+esp_err_t mqtt_publish_track(const uint8_t *data, size_t len)
+{
+    if (data == NULL || len == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_mqtt_client == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    char topic[128];
+    snprintf(topic, sizeof(topic), "%s/track", username);
+    int msg_id = esp_mqtt_client_publish(s_mqtt_client, topic, (const char *)data, len, 1, 0);
+    if (msg_id < 0) {
+        ESP_LOGE(TAG, "发布轨迹失败");
+        return ESP_FAIL;
+    }
+
+    ESP_LOGI(TAG, "发布轨迹成功，%u字节，msg_id=%d", (unsigned)len, msg_id);
+    return ESP_OK;
+}
+
+esp_err_t mqtt_publish_geofence_event(const char *data, size_t len)
+{
+    if (data == NULL || len == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_mqtt_client == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // 只放入发件箱由MQTT任务发送，不阻塞调用者，未连接时保留到重连后发送
+    char topic[128];
+    snprintf(topic, sizeof(topic), "%s/geofence", username);
+    int msg_id = esp_mqtt_client_enqueue(s_mqtt_client, topic, data, len, 1, 0, true);
+    if (msg_id < 0) {
+        ESP_LOGE(TAG, "围栏事件加入发送队列失败");
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+esp_err_t mqtt_publish_motion_event(const char *data, size_t len)
+{
+    if (data == NULL || len == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_mqtt_client == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    char topic[128];
+    snprintf(topic, sizeof(topic), "%s/motion", username);
+    int msg_id = esp_mqtt_client_enqueue(s_mqtt_client, topic, data, len, 1, 0, true);
+    if (msg_id < 0) {
+        ESP_LOGE(TAG, "运动事件加入发送队列失败");
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
 
 esp_mqtt_client_handle_t mqtt_get_client(void)
 {
@@ -60,6 +60,37 @@ esp_err_t mqtt_publish_data_model(esp_mqtt_client_handle_t client,
                                   const char *topic);
 
 
+/**
+ * @brief 发布压缩轨迹批次到"<用户名>/track"主题
+ * 
+ * @param data 轨迹批次，格式见track_compressor.h
+ * @param len 批次长度
+ * @return esp_err_t ESP_OK成功，其他值失败
+ */
+esp_err_t mqtt_publish_track(const uint8_t *data, size_t len);
+
+/**
+ * @brief 发布地理围栏事件到"<用户名>/geofence"主题
+ * 
+ * 消息放入发送队列后立即返回，MQTT未连接时保留到重连后发送
+ * 
+ * @param data 事件JSON
+ * @param len 长度
+ * @return esp_err_t ESP_OK成功，其他值失败
+ */
+esp_err_t mqtt_publish_geofence_event(const char *data, size_t len);
+
+/**
+ * @brief 发布运动状态事件(启动/停止/驻车)到"<用户名>/motion"主题
+ * 
+ * 消息放入发送队列后立即返回，MQTT未连接时保留到重连后发送
+ * 
+ * @param data 事件JSON
+ * @param len 长度
+ * @return esp_err_t ESP_OK成功，其他值失败
+ */
+esp_err_t mqtt_publish_motion_event(const char *data, size_t len);
+
 /**
  * @brief 获取当前MQTT客户端句柄
  * 
@@ -0,0 +1,154 @@
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "driver/rmt_rx.h"
+#include "driver/gpio.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "soc/soc_caps.h"
+#include "dht_decoder.h"
+#include "dht_rmt.h"
+
+static const char *TAG = "dht_rmt";
+
+// 1MHz计数，符号时长即为微秒
+#define DHT_RMT_RESOLUTION_HZ   (1000 * 1000)
+// 起始信号+应答+40位+结束，另留余量
+#define DHT_RMT_SYMBOLS         64
+// 起始信号至少18ms
+#define DHT_START_MS            20
+// 短于3us的脉冲视为毛刺，不超过RMT滤波器上限(255个源时钟)
+#define DHT_GLITCH_NS           3000
+// 电平保持不变超过此时间即结束接收，须长于起始信号，不超过RMT空闲阈值上限
+#define DHT_IDLE_NS             (30 * 1000 * 1000)
+// 起始信号、数据和空闲判定总共约55ms
+#define DHT_TIMEOUT_MS          100
+
+typedef struct {
+    gpio_num_t gpio;
+    rmt_channel_handle_t channel;
+    QueueHandle_t done_queue;
+} dht_rmt_t;
+
+static dht_rmt_t s_dht = { .gpio = GPIO_NUM_NC };
+// 使用DMA时接收缓冲区须位于可DMA访问的内存
+static DMA_ATTR rmt_symbol_word_t s_symbols[DHT_RMT_SYMBOLS];
+
+_Static_assert(sizeof(dht_symbol_t) == sizeof(rmt_symbol_word_t), "symbol layout differs from RMT");
+
+// 接收完成回调，在中断中执行
+static bool dht_rmt_rx_done(rmt_channel_handle_t channel, const rmt_rx_done_event_data_t *edata, void *user_ctx)
+{
+    BaseType_t task_woken = pdFALSE;
+    xQueueSendFromISR((QueueHandle_t)user_ctx, edata, &task_woken);
+    return task_woken == pdTRUE;
+}
+
+static esp_err_t dht_rmt_new_channel(gpio_num_t gpio, bool with_dma)
+{
+    rmt_rx_channel_config_t config = {
+        .gpio_num = gpio,
+        .clk_src = RMT_CLK_SRC_DEFAULT,
+        .resolution_hz = DHT_RMT_RESOLUTION_HZ,
+        .mem_block_symbols = with_dma ? DHT_RMT_SYMBOLS : SOC_RMT_MEM_WORDS_PER_CHANNEL,
+        .flags.with_dma = with_dma,
+    };
+    return rmt_new_rx_channel(&config, &s_dht.channel);
+}
+
+esp_err_t dht_rmt_init(gpio_num_t gpio)
+{
+    if (s_dht.channel != NULL) {
+        return ESP_OK;
+    }
+
+    esp_err_t ret = ESP_ERR_NOT_SUPPORTED;
+#if SOC_RMT_SUPPORT_DMA
+    // 带DMA的接收通道只有一个，被占用时退回使用通道内存
+    ret = dht_rmt_new_channel(gpio, true);
+#endif
+    if (ret != ESP_OK) {
+        ret = dht_rmt_new_channel(gpio, false);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "创建RMT接收通道失败: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    s_dht.done_queue = xQueueCreate(1, sizeof(rmt_rx_done_event_data_t));
+    if (s_dht.done_queue == NULL) {
+        ESP_LOGE(TAG, "创建接收队列失败");
+        rmt_del_channel(s_dht.channel);
+        s_dht.channel = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    rmt_rx_event_callbacks_t callbacks = {
+        .on_recv_done = dht_rmt_rx_done,
+    };
+    ret = rmt_rx_register_event_callbacks(s_dht.channel, &callbacks, s_dht.done_queue);
+    if (ret == ESP_OK) {
+        ret = rmt_enable(s_dht.channel);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "启用RMT接收通道失败: %s", esp_err_to_name(ret));
+        rmt_del_channel(s_dht.channel);
+        s_dht.channel = NULL;
+        vQueueDelete(s_dht.done_queue);
+        return ret;
+    }
+
+    // RMT已接管输入，另开开漏输出发送起始信号，空闲时释放为高电平
+    gpio_set_direction(gpio, GPIO_MODE_INPUT_OUTPUT_OD);
+    gpio_set_pull_mode(gpio, GPIO_PULLUP_ONLY);
+    gpio_set_level(gpio, 1);
+    s_dht.gpio = gpio;
+    return ESP_OK;
+}
+
+esp_err_t dht_rmt_read(float *temperature, float *humidity)
+{
+    if (s_dht.gpio == GPIO_NUM_NC) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    rmt_receive_config_t receive_config = {
+        .signal_range_min_ns = DHT_GLITCH_NS,
+        .signal_range_max_ns = DHT_IDLE_NS,
+    };
+    xQueueReset(s_dht.done_queue);
+    esp_err_t ret = rmt_receive(s_dht.channel, s_symbols, sizeof(s_symbols), &receive_config);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    // 起始信号期间任务休眠，之后的应答和数据全部由RMT捕获
+    gpio_set_level(s_dht.gpio, 0);
+    vTaskDelay(pdMS_TO_TICKS(DHT_START_MS) + 1);
+    gpio_set_level(s_dht.gpio, 1);
+
+    rmt_rx_done_event_data_t done;
+    if (xQueueReceive(s_dht.done_queue, &done, pdMS_TO_TICKS(DHT_TIMEOUT_MS)) != pdTRUE) {
+        // 重新启用通道以取消未完成的接收
+        rmt_disable(s_dht.channel);
+        rmt_enable(s_dht.channel);
+        ESP_LOGW(TAG, "DHT11无应答");
+        return ESP_ERR_TIMEOUT;
+    }
+
+    dht_reading_t reading;
+    dht_decode_result_t result = dht_decode(DHT_DECODER_DHT11, (const dht_symbol_t *)done.received_symbols,
+                                            done.num_symbols, &reading);
+    switch (result) {
+        case DHT_DECODE_OK:
+            *temperature = reading.temperature / 10.0f;
+            *humidity = reading.humidity / 10.0f;
+            return ESP_OK;
+        case DHT_DECODE_CHECKSUM:
+            ESP_LOGW(TAG, "DHT11校验和错误");
+            return ESP_ERR_INVALID_CRC;
+        default:
+            ESP_LOGW(TAG, "DHT11波形无效(%d)，共%u个符号", result, (unsigned)done.num_symbols);
+            return ESP_ERR_INVALID_RESPONSE;
+    }
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "esp_err.h"
+#include "driver/gpio.h"
+
+/**
+ * @brief 初始化基于RMT接收的DHT11驱动，已初始化时直接返回ESP_OK
+ * 
+ * 起始信号由GPIO开漏输出，应答和40位数据由RMT接收通道(支持时使用DMA)捕获后解码，
+ * 读取期间不占用CPU，也不受任务抢占影响
+ * 
+ * @param gpio DHT11数据引脚
+ * @return esp_err_t ESP_OK成功，其他值失败
+ */
+esp_err_t dht_rmt_init(gpio_num_t gpio);
+
+/**
+ * @brief 读取一次温湿度，阻塞约55ms，期间任务让出CPU
+ * 
+ * @param temperature 输出温度，°C
+ * @param humidity 输出相对湿度，%
+ * @return esp_err_t ESP_OK成功，ESP_ERR_TIMEOUT无应答，ESP_ERR_INVALID_RESPONSE波形无效，
+ *                   ESP_ERR_INVALID_CRC校验和错误
+ */
+esp_err_t dht_rmt_read(float *temperature, float *humidity);
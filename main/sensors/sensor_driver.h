@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "data_model.h"
+
+/**
+ * @brief 传感器驱动接口
+ *
+ * 传感器任务按注册时的周期调度各驱动：需要转换时间的传感器在时隙开始时调用start()，
+ * conversion_ms后调用read()；conversion_ms为0时在时隙开始时直接read()。
+ * 所有回调都在传感器任务中调用，驱动内部无需加锁。
+ */
+typedef struct {
+    const char *name;
+
+    /**
+     * @brief 初始化传感器，注册时及连续读取失败后重新调用
+     */
+    esp_err_t (*init)(void);
+
+    /**
+     * @brief 触发一次转换，conversion_ms为0时可为NULL
+     *
+     * @param conversion_ms 输入为驱动的conversion_ms，本次转换时间不同(如随量程变化)时改写
+     */
+    esp_err_t (*start)(uint32_t *conversion_ms);
+
+    /**
+     * @brief 读取结果
+     *
+     * @param values 按sensor_channel_t索引写入读数
+     * @param channels 输出本次写入的通道，SENSOR_CH_BIT()的组合
+     */
+    esp_err_t (*read)(float values[SENSOR_CH_MAX], uint32_t *channels);
+
+    /**
+     * @brief 打开或关闭传感器电源，不支持时可为NULL
+     */
+    esp_err_t (*power)(bool on);
+
+    // 从start()到可以read()的时间(毫秒)，start()可逐次改写
+    uint32_t conversion_ms;
+} sensor_driver_t;
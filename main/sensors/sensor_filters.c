@@ -0,0 +1,231 @@
+#include <math.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "nvs.h"
+#include "json_parser.h"
+#include "sensor_filter.h"
+#include "sensor_filters.h"
+
+static const char *TAG = "sensor_filters";
+
+#define NVS_FILTER_NAMESPACE        "sensor_filter"
+// 3个通道各8个参数，token池位于调用者栈上
+#define FILTER_JSON_MAX_TOKENS      64
+
+// 通道名同时用作JSON字段名和NVS键名
+static const char *const s_channel_names[SENSOR_CH_MAX] = {
+    [SENSOR_CH_TEMPERATURE] = "temperature",
+    [SENSOR_CH_HUMIDITY] = "humidity",
+    [SENSOR_CH_LIGHT] = "light",
+};
+
+// DHT11分辨率为1°C和1%，单个位错误会产生数十度的跳变；
+// 光照在开关灯时确实会突变，默认不剔除离群值
+static const sensor_filter_config_t s_default_configs[SENSOR_CH_MAX] = {
+    [SENSOR_CH_TEMPERATURE] = {
+        .window = 5, .median = true, .ema_alpha = 1.0f, .max_rate = 0,
+        .outlier_k = 3, .outlier_min = 2, .min_value = -40, .max_value = 80,
+    },
+    [SENSOR_CH_HUMIDITY] = {
+        .window = 5, .median = true, .ema_alpha = 1.0f, .max_rate = 0,
+        .outlier_k = 3, .outlier_min = 5, .min_value = 0, .max_value = 100,
+    },
+    [SENSOR_CH_LIGHT] = {
+        .window = 3, .median = true, .ema_alpha = 1.0f, .max_rate = 0,
+        .outlier_k = 0, .outlier_min = 0, .min_value = 0, .max_value = 120000,
+    },
+};
+
+static sensor_filter_t s_filters[SENSOR_CH_MAX];
+static SemaphoreHandle_t s_filter_mutex = NULL;
+
+// 从NVS读取保存的配置，无效时使用默认配置
+static void sensor_filters_load(sensor_filter_config_t configs[SENSOR_CH_MAX])
+{
+    memcpy(configs, s_default_configs, sizeof(s_default_configs));
+
+    nvs_handle_t nvs_handle;
+    if (nvs_open(NVS_FILTER_NAMESPACE, NVS_READONLY, &nvs_handle) != ESP_OK) {
+        return;
+    }
+    for (int ch = 0; ch < SENSOR_CH_MAX; ch++) {
+        sensor_filter_config_t config;
+        size_t len = sizeof(config);
+        if (nvs_get_blob(nvs_handle, s_channel_names[ch], &config, &len) == ESP_OK &&
+            len == sizeof(config) && sensor_filter_config_valid(&config)) {
+            configs[ch] = config;
+        }
+    }
+    nvs_close(nvs_handle);
+}
+
+static esp_err_t sensor_filters_save(const sensor_filter_config_t configs[SENSOR_CH_MAX])
+{
+    nvs_handle_t nvs_handle;
+    esp_err_t err = nvs_open(NVS_FILTER_NAMESPACE, NVS_READWRITE, &nvs_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "打开NVS命名空间失败: %s", esp_err_to_name(err));
+        return err;
+    }
+    for (int ch = 0; ch < SENSOR_CH_MAX && err == ESP_OK; ch++) {
+        err = nvs_set_blob(nvs_handle, s_channel_names[ch], &configs[ch], sizeof(configs[ch]));
+    }
+    if (err == ESP_OK) {
+        err = nvs_commit(nvs_handle);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "保存滤波配置失败: %s", esp_err_to_name(err));
+    }
+    nvs_close(nvs_handle);
+    return err;
+}
+
+esp_err_t sensor_filters_init(void)
+{
+    if (s_filter_mutex == NULL) {
+        s_filter_mutex = xSemaphoreCreateMutex();
+        if (s_filter_mutex == NULL) {
+            ESP_LOGE(TAG, "创建滤波互斥锁失败");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    sensor_filter_config_t configs[SENSOR_CH_MAX];
+    sensor_filters_load(configs);
+    for (int ch = 0; ch < SENSOR_CH_MAX; ch++) {
+        sensor_filter_init(&s_filters[ch], &configs[ch]);
+    }
+    return ESP_OK;
+}
+
+uint32_t sensor_filters_apply(int64_t time_ms, float values[SENSOR_CH_MAX], uint32_t channels)
+{
+    uint32_t accepted = 0;
+
+    if (s_filter_mutex == NULL) {
+        return channels;
+    }
+
+    xSemaphoreTake(s_filter_mutex, portMAX_DELAY);
+    for (int ch = 0; ch < SENSOR_CH_MAX; ch++) {
+        if (!(channels & SENSOR_CH_BIT(ch))) {
+            continue;
+        }
+        if (sensor_filter_update(&s_filters[ch], time_ms, values[ch])) {
+            values[ch] = sensor_filter_value(&s_filters[ch]);
+            accepted |= SENSOR_CH_BIT(ch);
+        } else {
+            ESP_LOGD(TAG, "剔除%s读数 %.2f, 累计%lu个", s_channel_names[ch], values[ch],
+                     (unsigned long)s_filters[ch].rejected);
+        }
+    }
+    xSemaphoreGive(s_filter_mutex);
+    return accepted;
+}
+
+// 读取当前对象中给出的参数，覆盖config中对应的值
+static void sensor_filters_parse_config(jparse_ctx_t *jctx, sensor_filter_config_t *config)
+{
+    int window = config->window;
+    json_field_t fields[] = {
+        { "window", JSON_FIELD_INT, &window, 0 },
+        { "median", JSON_FIELD_BOOL, &config->median, 0 },
+        { "ema_alpha", JSON_FIELD_FLOAT, &config->ema_alpha, 0 },
+        { "max_rate", JSON_FIELD_FLOAT, &config->max_rate, 0 },
+        { "outlier_k", JSON_FIELD_FLOAT, &config->outlier_k, 0 },
+        { "outlier_min", JSON_FIELD_FLOAT, &config->outlier_min, 0 },
+        { "min", JSON_FIELD_FLOAT, &config->min_value, 0 },
+        { "max", JSON_FIELD_FLOAT, &config->max_value, 0 },
+    };
+
+    json_obj_get_fields(jctx, fields, sizeof(fields) / sizeof(fields[0]));
+    // 超出范围的窗口长度留给sensor_filter_config_valid()拒绝
+    config->window = window >= 0 && window <= UINT8_MAX ? (uint8_t)window : 0;
+}
+
+esp_err_t sensor_filters_on_message(const char *data, size_t data_len)
+{
+    if (s_filter_mutex == NULL || data == NULL || data_len == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    jparse_ctx_t jctx;
+    json_tok_t tokens[FILTER_JSON_MAX_TOKENS];
+    if (json_parse_start_static(&jctx, data, data_len, tokens, FILTER_JSON_MAX_TOKENS) != OS_SUCCESS) {
+        ESP_LOGE(TAG, "JSON解析失败");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = ESP_OK;
+    uint32_t changed = 0;
+    sensor_filter_config_t configs[SENSOR_CH_MAX];
+
+    xSemaphoreTake(s_filter_mutex, portMAX_DELAY);
+    for (int ch = 0; ch < SENSOR_CH_MAX; ch++) {
+        configs[ch] = s_filters[ch].config;
+        if (json_obj_get_object(&jctx, s_channel_names[ch]) != OS_SUCCESS) {
+            continue;
+        }
+        sensor_filters_parse_config(&jctx, &configs[ch]);
+        json_obj_leave_object(&jctx);
+        if (!sensor_filter_config_valid(&configs[ch])) {
+            ESP_LOGE(TAG, "%s滤波参数无效", s_channel_names[ch]);
+            ret = ESP_ERR_INVALID_ARG;
+        }
+        changed |= SENSOR_CH_BIT(ch);
+    }
+    if (ret == ESP_OK) {
+        for (int ch = 0; ch < SENSOR_CH_MAX; ch++) {
+            sensor_filter_set_config(&s_filters[ch], &configs[ch]);
+        }
+    }
+    xSemaphoreGive(s_filter_mutex);
+    json_parse_end_static(&jctx);
+
+    if (ret == ESP_OK && changed != 0) {
+        ESP_LOGI(TAG, "滤波配置已更新, 通道掩码0x%lx", (unsigned long)changed);
+        ret = sensor_filters_save(configs);
+    }
+    return ret;
+}
+
+void sensor_filters_add_json(json_gen_str_t *jstr)
+{
+    sensor_filter_t filters[SENSOR_CH_MAX];
+
+    if (s_filter_mutex == NULL) {
+        return;
+    }
+    // 复制后再生成，生成时可能经回调发送数据，不持有互斥锁
+    xSemaphoreTake(s_filter_mutex, portMAX_DELAY);
+    memcpy(filters, s_filters, sizeof(filters));
+    xSemaphoreGive(s_filter_mutex);
+
+    json_gen_push_object(jstr, "filters");
+    for (int ch = 0; ch < SENSOR_CH_MAX; ch++) {
+        const sensor_filter_t *filter = &filters[ch];
+        const sensor_filter_config_t *config = &filter->config;
+
+        json_gen_push_object(jstr, s_channel_names[ch]);
+        json_gen_obj_set_int(jstr, "window", config->window);
+        json_gen_obj_set_bool(jstr, "median", config->median);
+        json_gen_obj_set_float(jstr, "ema_alpha", config->ema_alpha);
+        json_gen_obj_set_float(jstr, "max_rate", config->max_rate);
+        json_gen_obj_set_float(jstr, "outlier_k", config->outlier_k);
+        json_gen_obj_set_float(jstr, "outlier_min", config->outlier_min);
+        json_gen_obj_set_float(jstr, "min", config->min_value);
+        json_gen_obj_set_float(jstr, "max", config->max_value);
+        if (filter->samples > 0 && isfinite(filter->raw)) {
+            json_gen_obj_set_float(jstr, "raw", filter->raw);
+        }
+        if (sensor_filter_valid(filter)) {
+            json_gen_obj_set_float(jstr, "value", sensor_filter_value(filter));
+        }
+        json_gen_obj_set_int64(jstr, "samples", filter->samples);
+        json_gen_obj_set_int64(jstr, "rejected", filter->rejected);
+        json_gen_pop_object(jstr);
+    }
+    json_gen_pop_object(jstr);
+}
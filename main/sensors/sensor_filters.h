@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "json_generator.h"
+#include "data_model.h"
+
+/**
+ * @brief 初始化各传感器通道的滤波器，并从NVS加载保存的配置
+ *
+ * 每个通道依次经过量程检查、离群值剔除、中值、指数滑动平均和变化率限制，
+ * 见sensor_filter.h。
+ *
+ * @return esp_err_t ESP_OK成功，其他值失败
+ */
+esp_err_t sensor_filters_init(void);
+
+/**
+ * @brief 对一组读数滤波
+ *
+ * @param time_ms 读数的单调时间(毫秒)
+ * @param values 按sensor_channel_t索引的原始读数，被接受的通道改写为滤波后的值
+ * @param channels 有读数的通道，SENSOR_CH_BIT()的组合
+ * @return uint32_t 被接受的通道，被剔除的通道不应写入数据模型
+ */
+uint32_t sensor_filters_apply(int64_t time_ms, float values[SENSOR_CH_MAX], uint32_t channels);
+
+/**
+ * @brief 处理滤波配置消息，立即生效并保存到NVS
+ *
+ * 按通道名给出要修改的参数，未给出的通道和参数保持不变:
+ *   {"temperature":{"window":5,"median":true,"ema_alpha":0.5,"max_rate":0.5,
+ *                   "outlier_k":3,"outlier_min":2,"min":-20,"max":60},
+ *    "light":{"window":1}}
+ * 任一通道的参数无效时整条消息不生效。
+ *
+ * @param data 消息内容，不需要以'\0'结尾
+ * @param data_len 消息长度
+ * @return esp_err_t ESP_OK成功，ESP_ERR_INVALID_ARG格式错误或参数无效
+ */
+esp_err_t sensor_filters_on_message(const char *data, size_t data_len);
+
+/**
+ * @brief 在当前JSON对象中添加"filters"对象，包含各通道的配置、最近的原始值、
+ *        滤波值、样本数和剔除数
+ *
+ * @param jstr JSON生成器
+ */
+void sensor_filters_add_json(json_gen_str_t *jstr);
@@ -1,11 +1,17 @@
 #include <stdio.h>
+#include <math.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "driver/i2c.h"
 #include "bh1750.h"
 #include "dht.h"
+#include "dht_rmt.h"
 #include "sensors.h"
+#include "sensor_scheduler.h"
+#include "light_ranging.h"
+#include "sensor_filters.h"
 #include "data_model.h"
 #include "mqtt.h"
 
@@ -20,10 +26,48 @@ static const char *TAG = "sensors";
 // DHT11配置
 #define DHT11_GPIO_PIN              CONFIG_DHT11_GPIO_PIN       // DHT11数据引脚
 
-// 传感器数据更新间隔(毫秒)
-#define SENSOR_UPDATE_INTERVAL_MS   5000
+// 采样周期(毫秒)，光照的时隙错开半个周期，避免与DHT11读取排在同一时刻
+#define DHT11_PERIOD_MS             CONFIG_SENSOR_DHT11_PERIOD_MS
+#define BH1750_PERIOD_MS            CONFIG_SENSOR_BH1750_PERIOD_MS
+#define BH1750_PHASE_MS             (BH1750_PERIOD_MS / 2)
+
+// 连续失败达到此次数后重新上电并初始化传感器
+#define SENSOR_MAX_FAILURES         5
+// 无传感器时的空闲等待(毫秒)
+#define SENSOR_IDLE_WAIT_MS         1000
+
+typedef struct {
+    const sensor_driver_t *driver;
+    uint32_t failures;              // 连续失败次数
+} sensor_entry_t;
 
 static bh1750_handle_t bh1750_dev = NULL;
+static sensor_sched_t s_sched;
+static sensor_entry_t s_sensors[SENSOR_SCHED_MAX_SENSORS];
+
+#if CONFIG_BH1750_ONE_SHOT
+// bh1750_get_data()按H模式、MTreg为69把计数除以1.2
+#define BH1750_COUNTS_PER_LX        1.2f
+
+static const bh1750_measure_mode_t s_bh1750_oneshot_modes[] = {
+    [LIGHT_MODE_H] = BH1750_ONETIME_1LX_RES,
+    [LIGHT_MODE_H2] = BH1750_ONETIME_HALFLX_RES,
+    [LIGHT_MODE_L] = BH1750_ONETIME_4LX_RES,
+};
+
+static const char *const s_light_mode_names[] = {
+    [LIGHT_MODE_H] = "H",
+    [LIGHT_MODE_H2] = "H2",
+    [LIGHT_MODE_L] = "L",
+};
+
+static light_ranging_t s_light_ranging;
+static uint8_t s_bh1750_mtreg = 0;              // 传感器中的MTreg，0表示未知
+static int64_t s_light_start_us = 0;            // 本次采集的上电时刻
+// 采集信息由传感器任务写入，其他任务读取
+static sensors_light_info_t s_light_info;
+static portMUX_TYPE s_light_info_lock = portMUX_INITIALIZER_UNLOCKED;
+#endif
 
 // 初始化I2C
 static esp_err_t i2c_master_init(void)
@@ -43,33 +87,226 @@ static esp_err_t i2c_master_init(void)
     return i2c_driver_install(I2C_MASTER_NUM, conf.mode, 0, 0, 0);
 }
 
-// 初始化传感器
-esp_err_t sensors_init(void)
+static esp_err_t dht11_init(void)
 {
-    // 初始化I2C
+#if CONFIG_DHT11_USE_RMT
+    return dht_rmt_init(DHT11_GPIO_PIN);
+#else
+    return ESP_OK;
+#endif
+}
+
+static esp_err_t dht11_read(float values[SENSOR_CH_MAX], uint32_t *channels)
+{
+    esp_err_t ret = read_temperature_humidity(&values[SENSOR_CH_TEMPERATURE], &values[SENSOR_CH_HUMIDITY]);
+    *channels = SENSOR_CH_BIT(SENSOR_CH_TEMPERATURE) | SENSOR_CH_BIT(SENSOR_CH_HUMIDITY);
+    return ret;
+}
+
+static const sensor_driver_t s_dht11_driver = {
+    .name = "DHT11",
+    .init = dht11_init,
+    .read = dht11_read,
+};
+
+// I2C驱动和设备只创建一次，重新初始化时不再重复创建
+static esp_err_t bh1750_create_device(void)
+{
+    if (bh1750_dev != NULL) {
+        return ESP_OK;
+    }
     esp_err_t ret = i2c_master_init();
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "I2C初始化失败");
         return ret;
     }
-
-    // 初始化BH1750
     bh1750_dev = bh1750_create(I2C_MASTER_NUM, BH1750_I2C_ADDRESS_DEFAULT);
     if (bh1750_dev == NULL) {
         ESP_LOGE(TAG, "BH1750初始化失败");
         return ESP_FAIL;
     }
+    return ESP_OK;
+}
+
+static esp_err_t bh1750_power(bool on)
+{
+    if (bh1750_dev == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return on ? bh1750_power_on(bh1750_dev) : bh1750_power_down(bh1750_dev);
+}
+
+#if !CONFIG_BH1750_ONE_SHOT
+static esp_err_t bh1750_init(void)
+{
+    esp_err_t ret = bh1750_create_device();
+    if (ret != ESP_OK) {
+        return ret;
+    }
 
     // 设置BH1750测量模式
     ret = bh1750_set_measure_mode(bh1750_dev, BH1750_CONTINUE_1LX_RES);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "BH1750设置测量模式失败");
+    }
+    return ret;
+}
+
+static esp_err_t bh1750_read(float values[SENSOR_CH_MAX], uint32_t *channels)
+{
+    *channels = SENSOR_CH_BIT(SENSOR_CH_LIGHT);
+    return read_light_intensity(&values[SENSOR_CH_LIGHT]);
+}
+
+static const sensor_driver_t s_bh1750_driver = {
+    .name = "BH1750",
+    .init = bh1750_init,
+    .read = bh1750_read,
+    .power = bh1750_power,
+};
+#else
+static esp_err_t bh1750_oneshot_init(void)
+{
+    esp_err_t ret = bh1750_create_device();
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    // 重新上电后MTreg恢复为默认值，下次启动时重新设置
+    s_bh1750_mtreg = 0;
+    return bh1750_power_down(bh1750_dev);
+}
+
+// 上电并按上次读数选择的量程触发单次测量，测量结束后传感器自动掉电
+static esp_err_t bh1750_oneshot_start(uint32_t *conversion_ms)
+{
+    if (bh1750_dev == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    const light_setting_t *setting = light_ranging_setting(&s_light_ranging);
+
+    s_light_start_us = esp_timer_get_time();
+    esp_err_t ret = bh1750_power_on(bh1750_dev);
+    if (ret == ESP_OK && setting->mtreg != s_bh1750_mtreg) {
+        ret = bh1750_set_measure_time(bh1750_dev, setting->mtreg);
+        s_bh1750_mtreg = ret == ESP_OK ? setting->mtreg : 0;
+    }
+    if (ret == ESP_OK) {
+        ret = bh1750_set_measure_mode(bh1750_dev, s_bh1750_oneshot_modes[setting->mode]);
+    }
+    if (ret != ESP_OK) {
+        bh1750_power_down(bh1750_dev);
+        return ret;
+    }
+    // 转换期间传感器任务休眠，由调度器在转换结束后读取
+    *conversion_ms = light_ranging_conversion_ms(setting);
+    return ESP_OK;
+}
+
+static esp_err_t bh1750_oneshot_read(float values[SENSOR_CH_MAX], uint32_t *channels)
+{
+    const light_setting_t *setting = light_ranging_setting(&s_light_ranging);
+    float nominal_lux;
+
+    *channels = SENSOR_CH_BIT(SENSOR_CH_LIGHT);
+    esp_err_t ret = bh1750_get_data(bh1750_dev, &nominal_lux);
+    if (ret != ESP_OK) {
+        bh1750_power_down(bh1750_dev);
         return ret;
     }
+    // 还原原始计数，按实际的模式和MTreg换算并选择下次的量程
+    uint16_t count = (uint16_t)lroundf(nominal_lux * BH1750_COUNTS_PER_LX);
+    values[SENSOR_CH_LIGHT] = light_ranging_update(&s_light_ranging, count);
 
+    uint32_t acquisition_ms = (uint32_t)((esp_timer_get_time() - s_light_start_us + 999) / 1000);
+    portENTER_CRITICAL(&s_light_info_lock);
+    s_light_info.acquisition_ms = acquisition_ms;
+    if (acquisition_ms > s_light_info.max_acquisition_ms) {
+        s_light_info.max_acquisition_ms = acquisition_ms;
+    }
+    s_light_info.acquisitions++;
+    s_light_info.mode = s_light_mode_names[setting->mode];
+    s_light_info.mtreg = setting->mtreg;
+    s_light_info.saturated = s_light_ranging.saturated;
+    portEXIT_CRITICAL(&s_light_info_lock);
+
+    ESP_LOGD(TAG, "光照采集%lums, 模式%s, MTreg %u, 计数%u", (unsigned long)acquisition_ms,
+             s_light_mode_names[setting->mode], setting->mtreg, count);
     return ESP_OK;
 }
 
+// 单次测量模式，conversion_ms为中等量程的转换时间，实际时间由start()按量程给出
+static const sensor_driver_t s_bh1750_oneshot_driver = {
+    .name = "BH1750",
+    .init = bh1750_oneshot_init,
+    .start = bh1750_oneshot_start,
+    .read = bh1750_oneshot_read,
+    .power = bh1750_power,
+    .conversion_ms = 180,
+};
+#endif
+
+esp_err_t sensors_register(const sensor_driver_t *driver, uint32_t period_ms, uint32_t phase_ms)
+{
+    if (driver == NULL || driver->init == NULL || driver->read == NULL ||
+        (driver->conversion_ms > 0 && driver->start == NULL)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // 初始化失败也注册，连续读取失败后会重新初始化
+    if (driver->init() != ESP_OK) {
+        ESP_LOGW(TAG, "%s初始化失败", driver->name);
+    }
+
+    sensor_sched_config_t config = {
+        .period_ms = period_ms,
+        .phase_ms = phase_ms,
+        .conversion_ms = driver->conversion_ms,
+    };
+    int id = sensor_sched_add(&s_sched, &config, esp_timer_get_time() / 1000);
+    if (id < 0) {
+        ESP_LOGE(TAG, "注册%s失败，周期%lums", driver->name, (unsigned long)period_ms);
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_sensors[id].driver = driver;
+    s_sensors[id].failures = 0;
+    ESP_LOGI(TAG, "%s采样周期%lums", driver->name, (unsigned long)period_ms);
+    return ESP_OK;
+}
+
+// 初始化传感器
+esp_err_t sensors_init(void)
+{
+    sensor_sched_init(&s_sched);
+    sensor_filters_init();
+
+    esp_err_t ret = sensors_register(&s_dht11_driver, DHT11_PERIOD_MS, 0);
+#if CONFIG_BH1750_ONE_SHOT
+    light_ranging_init(&s_light_ranging);
+    esp_err_t light_ret = sensors_register(&s_bh1750_oneshot_driver, BH1750_PERIOD_MS, BH1750_PHASE_MS);
+#else
+    esp_err_t light_ret = sensors_register(&s_bh1750_driver, BH1750_PERIOD_MS, BH1750_PHASE_MS);
+#endif
+    if (ret == ESP_OK) {
+        ret = light_ret;
+    }
+    return ret;
+}
+
+esp_err_t sensors_get_light_info(sensors_light_info_t *info)
+{
+#if CONFIG_BH1750_ONE_SHOT
+    if (info == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    portENTER_CRITICAL(&s_light_info_lock);
+    *info = s_light_info;
+    portEXIT_CRITICAL(&s_light_info_lock);
+    return info->acquisitions > 0 ? ESP_OK : ESP_ERR_INVALID_STATE;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
 // 读取光照强度
 esp_err_t read_light_intensity(float *light)
 {
@@ -82,58 +319,96 @@ esp_err_t read_light_intensity(float *light)
 // 读取温湿度
 esp_err_t read_temperature_humidity(float *temperature, float *humidity)
 {
+#if CONFIG_DHT11_USE_RMT
+    return dht_rmt_read(temperature, humidity);
+#else
     return dht_read_float_data(DHT_TYPE_DHT11, DHT11_GPIO_PIN, humidity, temperature);
+#endif
 }
 
-// 更新数据模型中的传感器数据
-esp_err_t sensors_update_data_model(data_model_t *model)
+// 记录一次失败，连续失败过多时重新上电并初始化
+static void sensors_on_failure(sensor_entry_t *sensor, esp_err_t err)
 {
-    if (model == NULL) {
-        return ESP_ERR_INVALID_ARG;
+    const sensor_driver_t *driver = sensor->driver;
+
+    ESP_LOGD(TAG, "%s读取失败: %s", driver->name, esp_err_to_name(err));
+    if (++sensor->failures < SENSOR_MAX_FAILURES) {
+        return;
     }
-    
-    float temperature = 0.0f;
-    float humidity = 0.0f;
-    float light = 0.0f;
-    
-    // 读取温湿度
-    esp_err_t temp_hum_ret = read_temperature_humidity(&temperature, &humidity);
-    
-    // 读取光照强度
-    esp_err_t light_ret = read_light_intensity(&light);
-    
-    // 只要有一个数据读取成功，就更新数据模型
-    if (temp_hum_ret == ESP_OK || light_ret == ESP_OK) {
-        return data_model_update_sensor_data(model, temperature, humidity, light);
-    } else {
-        ESP_LOGW(TAG, "未能读取任何传感器数据");
-        return ESP_FAIL;
+    ESP_LOGW(TAG, "%s连续%lu次读取失败，重新初始化", driver->name, (unsigned long)sensor->failures);
+    sensor->failures = 0;
+    if (driver->power != NULL) {
+        driver->power(false);
+        driver->power(true);
+    }
+    driver->init();
+}
+
+// 执行调度器给出的动作，读取结果写入数据模型
+static void sensors_run(int id, sensor_sched_action_t action, data_model_t *data_model, int64_t now_ms)
+{
+    sensor_entry_t *sensor = &s_sensors[id];
+    const sensor_driver_t *driver = sensor->driver;
+
+    if (action == SENSOR_SCHED_START) {
+        uint32_t conversion_ms = driver->conversion_ms;
+        esp_err_t ret = driver->start(&conversion_ms);
+        if (ret != ESP_OK) {
+            // 本时隙放弃读取
+            sensor_sched_abort(&s_sched, id, now_ms);
+            sensors_on_failure(sensor, ret);
+        } else if (conversion_ms != driver->conversion_ms &&
+                   sensor_sched_set_conversion(&s_sched, id, now_ms, conversion_ms) != 0) {
+            // 转换时间不短于采样周期，提前读取的结果无效，本时隙放弃读取
+            ESP_LOGW(TAG, "%s转换需要%lums，不短于采样周期", driver->name, (unsigned long)conversion_ms);
+            sensor_sched_abort(&s_sched, id, now_ms);
+        }
+        return;
+    }
+
+    float values[SENSOR_CH_MAX] = { 0 };
+    uint32_t channels = 0;
+    esp_err_t ret = driver->read(values, &channels);
+    if (ret != ESP_OK) {
+        sensors_on_failure(sensor, ret);
+        return;
+    }
+    sensor->failures = 0;
+    // 被剔除的通道保持数据模型中的上一个滤波值
+    channels = sensor_filters_apply(now_ms, values, channels);
+    if (data_model != NULL && channels != 0) {
+        data_model_update_sensor_channels(data_model, values, channels);
+    }
+    if (channels & SENSOR_CH_BIT(SENSOR_CH_LIGHT)) {
+        ESP_LOGD(TAG, "光照强度: %.2f lx", values[SENSOR_CH_LIGHT]);
+    }
+    if (channels & SENSOR_CH_BIT(SENSOR_CH_TEMPERATURE)) {
+        ESP_LOGD(TAG, "温度: %.1f°C, 湿度: %.1f%%", values[SENSOR_CH_TEMPERATURE], values[SENSOR_CH_HUMIDITY]);
     }
 }
 
-// 传感器任务
+// 传感器任务，按截止时间依次执行各传感器的启动和读取，其余时间休眠
 void sensors_task(void *pvParameters)
 {
-    float light, temperature, humidity;
     data_model_t *data_model = data_model_get_latest();
     
     while (1) {
-        // 读取光照强度
-        if (read_light_intensity(&light) == ESP_OK) {
-            ESP_LOGI(TAG, "光照强度: %.2f lx", light);
-        }
+        int64_t now_ms = esp_timer_get_time() / 1000;
+        sensor_sched_action_t action;
+        int id;
 
-        // 读取温湿度
-        if (read_temperature_humidity(&temperature, &humidity) == ESP_OK) {
-            ESP_LOGI(TAG, "温度: %.1f°C, 湿度: %.1f%%", temperature, humidity);
-        }
-        
-        // 更新数据模型
-        if (data_model != NULL) {
-            sensors_update_data_model(data_model);
+        while ((action = sensor_sched_poll(&s_sched, now_ms, &id)) != SENSOR_SCHED_IDLE) {
+            sensors_run(id, action, data_model, now_ms);
+            now_ms = esp_timer_get_time() / 1000;
         }
 
-        vTaskDelay(pdMS_TO_TICKS(SENSOR_UPDATE_INTERVAL_MS)); // 每10秒读取一次
+        // 等到下一个截止时间，向上取整到tick，避免提前醒来空转
+        int64_t wait_ms = sensor_sched_next_ms(&s_sched) - now_ms;
+        if (wait_ms > SENSOR_IDLE_WAIT_MS) {
+            wait_ms = SENSOR_IDLE_WAIT_MS;
+        }
+        TickType_t ticks = (wait_ms + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS;
+        vTaskDelay(ticks > 0 ? ticks : 1);
     }
 } 
 
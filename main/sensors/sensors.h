@@ -2,18 +2,47 @@
 
 #include "esp_err.h"
 #include "data_model.h"
+#include "sensor_driver.h"
 
 // 初始化所有传感器
 esp_err_t sensors_init(void);
 
-// 读取光照强度
+// 读取光照强度，单次测量模式下为上次测量按H模式、MTreg 69换算的值
 esp_err_t read_light_intensity(float *light);
 
+// BH1750单次测量的采集信息
+typedef struct {
+    uint32_t acquisition_ms;        // 最近一次从上电到读出结果的时间(毫秒)
+    uint32_t max_acquisition_ms;    // 最长的一次
+    uint32_t acquisitions;          // 采集次数
+    uint32_t saturated;             // 计数饱和的次数
+    const char *mode;               // 最近一次的分辨率模式，"H"、"H2"或"L"
+    uint8_t mtreg;                  // 最近一次的测量时间寄存器
+} sensors_light_info_t;
+
+/**
+ * @brief 获取BH1750单次测量的采集信息
+ *
+ * @param info 输出采集信息
+ * @return esp_err_t ESP_OK成功，ESP_ERR_INVALID_STATE尚未采集，
+ *         ESP_ERR_NOT_SUPPORTED未启用单次测量模式
+ */
+esp_err_t sensors_get_light_info(sensors_light_info_t *info);
+
 // 读取温湿度
 esp_err_t read_temperature_humidity(float *temperature, float *humidity);
 
-// 更新数据模型中的传感器数据
-esp_err_t sensors_update_data_model(data_model_t *model);
+/**
+ * @brief 注册传感器驱动，由传感器任务按周期采样，读数按通道写入数据模型
+ * 
+ * 注册时调用驱动的init()。须在sensors_task_init()之前调用。
+ * 
+ * @param driver 驱动，须在整个运行期间有效
+ * @param period_ms 采样周期(毫秒)，须大于驱动的conversion_ms
+ * @param phase_ms 首次采样相对注册时刻的延迟(毫秒)，用于错开各传感器
+ * @return esp_err_t ESP_OK成功，ESP_ERR_INVALID_ARG参数无效或已满
+ */
+esp_err_t sensors_register(const sensor_driver_t *driver, uint32_t period_ms, uint32_t phase_ms);
 
 // 传感器任务
 void sensors_task(void *pvParameters); 
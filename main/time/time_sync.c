@@ -1,22 +1,129 @@
+#include <sys/time.h>
 #include "time_sync.h"
+#include "time_arbiter.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include "esp_netif_sntp.h"
+#include "esp_sntp.h"
+#include "esp_timer.h"
 #include "esp_log.h"
 #include "time.h"
 
 static const char *TAG = "TIME_SYNC";
 
-void time_sync_init(void)
+// 早于此时间(2024/01/01)的系统时间视为未设置
+#define TIME_VALID_AFTER_MS         1704067200000LL
+// 软件复位前保留的系统时间，复位过程中RTC慢速时钟有少量误差
+#define RTC_UNCERTAINTY_MS          10000
+// GNSS时间为定位时刻，经AT响应或NMEA读取时已过去不到1个定位周期，取中点
+#define GNSS_LATENCY_MS             500
+#define GNSS_UNCERTAINTY_MS         500
+#define SNTP_UNCERTAINTY_MS         100
+
+static const char *const s_source_names[] = {
+    [TIME_SOURCE_NONE] = "无",
+    [TIME_SOURCE_RTC] = "RTC",
+    [TIME_SOURCE_GNSS] = "GNSS",
+    [TIME_SOURCE_SNTP] = "SNTP",
+};
+
+static time_arbiter_t s_arbiter;
+static SemaphoreHandle_t s_time_mutex = NULL;
+
+static int64_t time_sync_clock_ms(void)
 {
-    // 初始化SNTP 同步时间
-    esp_sntp_config_t config = ESP_NETIF_SNTP_DEFAULT_CONFIG("ntp.aliyun.com");
-    esp_netif_sntp_init(&config);
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+// 提交一个时间样本，按仲裁结果调整系统时间
+static void time_sync_offer(time_source_t source, int64_t sample_ms, uint32_t uncertainty_ms)
+{
+    if (s_time_mutex == NULL) {
+        return;
+    }
 
-    if (esp_netif_sntp_sync_wait(pdMS_TO_TICKS(10000)) != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to update system time within 10s timeout");
-    }else{
-        ESP_LOGI(TAG, "Time updated successfully");
+    xSemaphoreTake(s_time_mutex, portMAX_DELAY);
+    time_source_t old_source = time_arbiter_source(&s_arbiter);
+    int64_t correction_ms;
+    time_arbiter_action_t action = time_arbiter_offer(&s_arbiter, source, esp_timer_get_time() / 1000,
+                                                      time_sync_clock_ms(), sample_ms, uncertainty_ms,
+                                                      &correction_ms);
+    if (action == TIME_ARBITER_STEP) {
+        int64_t now_ms = time_sync_clock_ms() + correction_ms;
+        struct timeval tv = {
+            .tv_sec = now_ms / 1000,
+            .tv_usec = (now_ms % 1000) * 1000,
+        };
+        settimeofday(&tv, NULL);
+    } else if (action == TIME_ARBITER_SLEW) {
+        struct timeval delta = {
+            .tv_sec = correction_ms / 1000,
+            .tv_usec = (correction_ms % 1000) * 1000,
+        };
+        adjtime(&delta, NULL);
     }
+    xSemaphoreGive(s_time_mutex);
+
+    if (action == TIME_ARBITER_STEP || action == TIME_ARBITER_SLEW) {
+        ESP_LOGI(TAG, "%s时间%s %lldms", s_source_names[source],
+                 action == TIME_ARBITER_STEP ? "跳变" : "平滑调整", (long long)correction_ms);
+    }
+    if (source != old_source && time_arbiter_source(&s_arbiter) == source) {
+        ESP_LOGI(TAG, "时间来源: %s -> %s, 不确定度%lums", s_source_names[old_source],
+                 s_source_names[source], (unsigned long)uncertainty_ms);
+    }
+}
+
+// 覆盖SNTP默认的设置时间函数，由仲裁决定是否采用
+void sntp_sync_time(struct timeval *tv)
+{
+    time_sync_offer(TIME_SOURCE_SNTP, (int64_t)tv->tv_sec * 1000 + tv->tv_usec / 1000, SNTP_UNCERTAINTY_MS);
+    sntp_set_sync_status(SNTP_SYNC_STATUS_COMPLETED);
+}
+
+void time_sync_on_gnss(const gps_info_t *gps_info)
+{
+    if (gps_info == NULL || !gps_info->valid || gps_info->data_source != FROM_GNSS ||
+        gps_info->utc_ms < TIME_VALID_AFTER_MS) {
+        return;
+    }
+    time_sync_offer(TIME_SOURCE_GNSS, gps_info->utc_ms + GNSS_LATENCY_MS, GNSS_UNCERTAINTY_MS);
+}
+
+// 仲裁状态由tcpip任务(SNTP回调)和GPS任务写入，读取时同样需要加锁
+bool time_sync_is_valid(void)
+{
+    if (s_time_mutex == NULL) {
+        return false;
+    }
+
+    xSemaphoreTake(s_time_mutex, portMAX_DELAY);
+    bool valid = time_arbiter_source(&s_arbiter) != TIME_SOURCE_NONE;
+    xSemaphoreGive(s_time_mutex);
+    return valid;
+}
+
+void time_sync_init(void)
+{
     setenv("TZ", "CST-8", 1);
     tzset();
-}
 
+    s_time_mutex = xSemaphoreCreateMutex();
+    if (s_time_mutex == NULL) {
+        ESP_LOGE(TAG, "创建时间互斥锁失败");
+        return;
+    }
+    time_arbiter_init(&s_arbiter, NULL);
+
+    // 软件复位后系统时间仍在走，作为最低优先级的来源
+    int64_t now_ms = time_sync_clock_ms();
+    if (now_ms >= TIME_VALID_AFTER_MS) {
+        time_sync_offer(TIME_SOURCE_RTC, now_ms, RTC_UNCERTAINTY_MS);
+    }
+
+    // 初始化SNTP 同步时间，结果由sntp_sync_time()提交，不等待
+    esp_sntp_config_t config = ESP_NETIF_SNTP_DEFAULT_CONFIG("ntp.aliyun.com");
+    esp_netif_sntp_init(&config);
+}
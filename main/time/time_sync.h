@@ -1,8 +1,30 @@
 #ifndef __TIME_SYNC_H__
 #define __TIME_SYNC_H__
 
+#include <stdbool.h>
+#include <stdint.h>
+#include "gps_parser.h"
 
+/**
+ * @brief 初始化时间同步，不阻塞
+ *
+ * 系统时间由SNTP、GNSS和复位前保留的系统时间(RTC)中当前最可信的来源设置，
+ * 偏差较小时平滑调整，较大时直接跳变。无网络时GNSS定位后数秒内即可得到有效时间。
+ */
 void time_sync_init(void);
 
-#endif
+/**
+ * @brief 以GNSS定位结果中的UTC时间校准系统时间
+ *
+ * @param gps_info GPS信息结构体指针，非GNSS来源的结果被忽略
+ */
+void time_sync_on_gnss(const gps_info_t *gps_info);
+
+/**
+ * @brief 系统时间是否已由任一来源设置
+ *
+ * @return true 时间有效
+ */
+bool time_sync_is_valid(void);
 
+#endif
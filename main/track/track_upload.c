@@ -0,0 +1,126 @@
+#include <string.h>
+#include <sys/time.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+#include "track_compressor.h"
+#include "track_upload.h"
+#include "mqtt.h"
+#include "time_sync.h"
+
+static const char *TAG = "TRACK";
+
+// 抽稀容差，上传的轨迹与原始定位的最大偏差
+#define TRACK_TOLERANCE_M           CONFIG_TRACK_TOLERANCE_M
+#define TRACK_UPLOAD_INTERVAL_MS    (CONFIG_TRACK_UPLOAD_INTERVAL_S * 1000)
+// 单批最大字节数，10m容差下约可容纳1小时轨迹
+#define TRACK_BATCH_SIZE            1024
+
+static track_compressor_t s_track;
+static uint8_t s_batch[TRACK_BATCH_SIZE];
+// 已完成但尚未发布成功的批次，发布成功前不取新批次
+static uint8_t s_pending[TRACK_BATCH_SIZE];
+static size_t s_pending_len = 0;
+static SemaphoreHandle_t s_track_mutex = NULL;
+static TaskHandle_t s_track_task = NULL;
+static uint32_t s_dropped_points = 0;
+
+// 取出当前批次到待发布缓冲区
+static void track_take_batch(void)
+{
+    xSemaphoreTake(s_track_mutex, portMAX_DELAY);
+    size_t len = track_compressor_finish(&s_track);
+    if (len > 0) {
+        memcpy(s_pending, s_batch, len);
+        s_pending_len = len;
+        track_compressor_next_batch(&s_track);
+
+        const track_compressor_stats_t *stats = track_compressor_get_stats(&s_track);
+        ESP_LOGI(TAG, "轨迹批次%u字节, 累计%lu点压缩为%lu点, 压缩比%.1f, 最大误差%.1fm, 丢弃%lu点",
+                 (unsigned)len, (unsigned long)stats->points_in, (unsigned long)stats->points_out,
+                 track_compressor_ratio(&s_track), stats->max_error_m, (unsigned long)s_dropped_points);
+    }
+    xSemaphoreGive(s_track_mutex);
+}
+
+// 定期或批次将满时上传轨迹，MQTT未连接时保留批次下次重试
+static void track_upload_task(void *pvParameter)
+{
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(TRACK_UPLOAD_INTERVAL_MS));
+
+        if (s_pending_len == 0) {
+            track_take_batch();
+        }
+        if (s_pending_len > 0 && mqtt_get_connection_status() == MQTT_CONNECTION_STATUS_CONNECTED) {
+            if (mqtt_publish_track(s_pending, s_pending_len) == ESP_OK) {
+                s_pending_len = 0;
+            }
+        }
+    }
+}
+
+esp_err_t track_upload_init(void)
+{
+    s_track_mutex = xSemaphoreCreateMutex();
+    if (s_track_mutex == NULL) {
+        ESP_LOGE(TAG, "创建轨迹互斥锁失败");
+        return ESP_FAIL;
+    }
+    track_compressor_init(&s_track, TRACK_TOLERANCE_M, s_batch, sizeof(s_batch));
+
+    BaseType_t ret = xTaskCreate(track_upload_task, "track_upload", 4096, NULL, 5, &s_track_task);
+    if (ret != pdPASS) {
+        ESP_LOGE(TAG, "轨迹上传任务创建失败");
+        vSemaphoreDelete(s_track_mutex);
+        s_track_mutex = NULL;
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+// 定位结果为1e-7度，轨迹格式为1e-6度，四舍五入
+static int32_t track_e7_to_e6(int32_t coord_e7)
+{
+    return (coord_e7 >= 0 ? coord_e7 + 5 : coord_e7 - 5) / 10;
+}
+
+void track_upload_add(const gps_info_t *gps_info)
+{
+    if (s_track_mutex == NULL || gps_info == NULL || !gps_info->valid) {
+        return;
+    }
+
+    // 优先使用定位时刻，缓存的基站定位结果没有时间，取当前时间；
+    // 系统时间也未设置时无法给出时刻，丢弃该点
+    int64_t time_ms = gps_info->utc_ms;
+    if (time_ms <= 0) {
+        if (!time_sync_is_valid()) {
+            ESP_LOGD(TAG, "系统时间未设置，丢弃无定位时刻的轨迹点");
+            return;
+        }
+        struct timeval tv;
+        gettimeofday(&tv, NULL);
+        time_ms = (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+    }
+    track_point_t point = {
+        .time_ms = time_ms,
+        .lat_e6 = track_e7_to_e6(gps_info->lat_e7),
+        .lon_e6 = track_e7_to_e6(gps_info->lon_e7),
+    };
+
+    xSemaphoreTake(s_track_mutex, portMAX_DELAY);
+    uint32_t points_in = track_compressor_get_stats(&s_track)->points_in;
+    bool full = track_compressor_add(&s_track, &point);
+    if (track_compressor_get_stats(&s_track)->points_in == points_in) {
+        // 批次已满且上一批次未发布，或时间回退
+        s_dropped_points++;
+    }
+    xSemaphoreGive(s_track_mutex);
+
+    if (full) {
+        xTaskNotifyGive(s_track_task);
+    }
+}
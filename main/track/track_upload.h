@@ -0,0 +1,24 @@
+#ifndef TRACK_UPLOAD_H
+#define TRACK_UPLOAD_H
+
+#include "esp_err.h"
+#include "gps_parser.h"
+
+/**
+ * @brief 初始化轨迹上传，创建上传任务
+ * 
+ * 定位结果按容差在线抽稀后以差分varint编码缓存，定期或缓冲区将满时
+ * 批量发布到"<用户名>/track"主题，格式见track_compressor.h
+ * 
+ * @return esp_err_t ESP_OK成功，其他值失败
+ */
+esp_err_t track_upload_init(void);
+
+/**
+ * @brief 添加一个定位结果到轨迹
+ * 
+ * @param gps_info GPS信息结构体指针
+ */
+void track_upload_add(const gps_info_t *gps_info);
+
+#endif // TRACK_UPLOAD_H
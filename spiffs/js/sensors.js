@@ -74,16 +74,13 @@ function updateSensorsData() {
         var lightIntensity = document.getElementById('light-intensity');
         var sensorsUpdateTime = document.getElementById('sensors-update-time');
 
-        // 检查传感器数据有效性
-        if (res.sensors_valid) {
-            temperature.innerHTML = res.temperature.toFixed(1) + '°C';
-            humidity.innerHTML = res.humidity.toFixed(1) + '%';
-            lightIntensity.innerHTML = res.light_intensity.toFixed(1) + 'lx';
-        } else {
-            temperature.innerHTML = '--°C';
-            humidity.innerHTML = '--%';
-            lightIntensity.innerHTML = '--lx';
-        }
+        // 逐个通道检查有效性，尚未读到的通道不会出现在响应中
+        temperature.innerHTML = typeof res.temperature === 'number' ?
+            res.temperature.toFixed(1) + '°C' : '--°C';
+        humidity.innerHTML = typeof res.humidity === 'number' ?
+            res.humidity.toFixed(1) + '%' : '--%';
+        lightIntensity.innerHTML = typeof res.light_intensity === 'number' ?
+            res.light_intensity.toFixed(1) + 'lx' : '--lx';
 
         // 更新传感器数据时间显示
         var date = new Date(res.timestamp * 1000);
@@ -0,0 +1,138 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bench.h"
+
+#define BENCH_ROUNDS        9
+#define BENCH_ROUND_NS      20000000ULL
+#define BENCH_MAX_ITERS     (1U << 26)
+
+/* Heap accounting. The linux target links against glibc, so malloc and
+ * friends can be interposed and forwarded to the glibc implementation.
+ * Only allocations made while a benchmark is running are counted.
+ */
+static bool s_counting;
+static size_t s_alloc_count;
+static size_t s_alloc_bytes;
+
+#ifdef __GLIBC__
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+
+static inline void bench_count_alloc(size_t size)
+{
+    if (s_counting) {
+        s_alloc_count++;
+        s_alloc_bytes += size;
+    }
+}
+
+void *malloc(size_t size)
+{
+    bench_count_alloc(size);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size)
+{
+    bench_count_alloc(nmemb * size);
+    return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    bench_count_alloc(size);
+    return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr)
+{
+    __libc_free(ptr);
+}
+#define BENCH_HEAP_STATS    1
+#else
+#define BENCH_HEAP_STATS    0
+#endif
+
+/* Keeps the results of the benchmarked calls alive */
+static volatile size_t s_sink;
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static uint64_t bench_round(bench_fn_t fn, void *arg, uint32_t iters)
+{
+    size_t sink = 0;
+    uint64_t start = bench_now_ns();
+    for (uint32_t i = 0; i < iters; i++) {
+        sink += fn(arg);
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    s_sink = sink;
+    return elapsed;
+}
+
+static int bench_cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+void bench_group(const char *name)
+{
+    printf("\n%s\n", name);
+    printf("%-40s %10s %10s %10s %10s\n", "benchmark", "ns/op", "min ns/op", "bytes/op", "allocs/op");
+}
+
+void bench_run(const char *name, bench_fn_t fn, void *arg)
+{
+    double ns_per_op[BENCH_ROUNDS];
+
+    /* Heap usage of a single call; every call is expected to behave the same */
+    s_alloc_count = 0;
+    s_alloc_bytes = 0;
+    s_counting = true;
+    s_sink = fn(arg);
+    s_counting = false;
+    size_t allocs = s_alloc_count;
+    size_t bytes = s_alloc_bytes;
+
+    /* Grow the iteration count until one round is long enough to time */
+    uint32_t iters = 1;
+    while (iters < BENCH_MAX_ITERS && bench_round(fn, arg, iters) < BENCH_ROUND_NS) {
+        iters *= 2;
+    }
+
+    bench_round(fn, arg, iters);
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        ns_per_op[i] = (double)bench_round(fn, arg, iters) / iters;
+    }
+    qsort(ns_per_op, BENCH_ROUNDS, sizeof(double), bench_cmp_double);
+
+    if (BENCH_HEAP_STATS) {
+        printf("%-40s %10.1f %10.1f %10zu %10zu\n", name,
+               ns_per_op[BENCH_ROUNDS / 2], ns_per_op[0], bytes, allocs);
+    } else {
+        printf("%-40s %10.1f %10.1f %10s %10s\n", name,
+               ns_per_op[BENCH_ROUNDS / 2], ns_per_op[0], "-", "-");
+    }
+}
+
+void app_main(void)
+{
+    bench_json_run();
+    bench_gps_run();
+    bench_modem_run();
+    bench_geofence_run();
+    printf("\n");
+}
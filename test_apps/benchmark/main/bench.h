@@ -0,0 +1,34 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stddef.h>
+
+/**
+ * Benchmarked operation. Runs one iteration and returns a value derived
+ * from the result (e.g. the output length) so that the work cannot be
+ * optimised away.
+ */
+typedef size_t (*bench_fn_t)(void *arg);
+
+/**
+ * Run a benchmark and print one result line:
+ *
+ *   <name>  <median ns/op>  <min ns/op>  <bytes/op>  <allocs/op>
+ *
+ * The iteration count is calibrated so that one round takes at least
+ * BENCH_ROUND_NS. After a warm-up round, BENCH_ROUNDS rounds are timed and
+ * the median is reported, which keeps the numbers comparable across runs
+ * on a loaded host. bytes/op and allocs/op count heap allocations made by
+ * the operation.
+ */
+void bench_run(const char *name, bench_fn_t fn, void *arg);
+
+/** Print a group header */
+void bench_group(const char *name);
+
+void bench_json_run(void);
+void bench_gps_run(void);
+void bench_modem_run(void);
+void bench_geofence_run(void);
+
+#endif // BENCH_H
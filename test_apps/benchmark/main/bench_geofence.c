@@ -0,0 +1,90 @@
+#include <stdio.h>
+#include <math.h>
+#include "bench.h"
+#include "geofence.h"
+
+#define FENCE_COUNT     1000
+#define STAR_POINTS     10
+#define FIX_COUNT       1024
+#define M_PER_E7        (6371008.8 * M_PI / 180.0 / 1e7)
+
+static const geofence_point_t s_base = { 312304160, 1214737010 };
+
+static geofence_t s_gf;
+static geofence_point_t s_fixes[FIX_COUNT];
+static int s_next_fix;
+static uint32_t s_seed = 1;
+
+static uint32_t rnd(uint32_t n)
+{
+    s_seed = s_seed * 1664525 + 1013904223;
+    return (s_seed >> 8) % n;
+}
+
+static geofence_point_t offset(geofence_point_t base, double east_m, double north_m)
+{
+    double m_per_lon = M_PER_E7 * cos(base.lat_e7 / 1e7 * M_PI / 180);
+    geofence_point_t p = {
+        .lat_e7 = base.lat_e7 + (int32_t)lround(north_m / M_PER_E7),
+        .lon_e7 = base.lon_e7 + (int32_t)lround(east_m / m_per_lon),
+    };
+    return p;
+}
+
+static void ignore_event(const geofence_event_t *event, void *priv)
+{
+}
+
+/* 1,000 circles and 10 point star polygons over 20 x 20 km, and a drive
+ * across them at 1 Hz */
+static void make_fences(void)
+{
+    geofence_point_t star[STAR_POINTS];
+
+    geofence_init(&s_gf, FENCE_COUNT, FENCE_COUNT * STAR_POINTS, ignore_event, NULL);
+    for (int i = 0; i < FENCE_COUNT; i++) {
+        geofence_point_t c = offset(s_base, rnd(20000), rnd(20000));
+        double r = 20 + rnd(500);
+        if (i % 2) {
+            geofence_add_circle(&s_gf, i, c, r, 60000);
+            continue;
+        }
+        for (int k = 0; k < STAR_POINTS; k++) {
+            double a = k * 2 * M_PI / STAR_POINTS;
+            double rk = (k % 2) ? r / 2 : r;
+            star[k] = offset(c, rk * sin(a), rk * cos(a));
+        }
+        geofence_add_polygon(&s_gf, i, star, STAR_POINTS, 60000);
+    }
+    geofence_build_index(&s_gf);
+
+    for (int i = 0; i < FIX_COUNT; i++) {
+        s_fixes[i] = offset(s_base, i * 19.0, i * 11.0);
+    }
+}
+
+static size_t bench_update(void *arg)
+{
+    geofence_point_t p = s_fixes[s_next_fix++ % FIX_COUNT];
+    return geofence_update(&s_gf, s_next_fix * 1000LL, p);
+}
+
+/* What every fix would cost without the grid */
+static size_t bench_scan(void *arg)
+{
+    geofence_point_t p = s_fixes[s_next_fix++ % FIX_COUNT];
+    size_t inside = 0;
+    for (int i = 0; i < s_gf.fence_count; i++) {
+        inside += geofence_contains(&s_gf, &s_gf.fences[i], p);
+    }
+    return inside;
+}
+
+void bench_geofence_run(void)
+{
+    bench_group("geofence");
+    make_fences();
+    bench_run("geofence_update 1000 fences", bench_update, NULL);
+    bench_run("geofence_contains scan 1000 fences", bench_scan, NULL);
+    geofence_deinit(&s_gf);
+}
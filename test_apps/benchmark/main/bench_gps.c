@@ -0,0 +1,49 @@
+#include <stdio.h>
+#include <string.h>
+#include "bench.h"
+#include "gps_parser.h"
+
+/* Responses as read from the 4G module */
+static const char s_cgpsinfo[] = "+CGPSINFO: 3113.343286,N,12121.234064,E,250311,072809.3,44.1,0.0,0";
+static const char s_cgpsinfo_empty[] = "+CGPSINFO: ,,,,,,,,";
+static const char s_clbs[] = "+CLBS: 0,31.230416,121.473701,550,2025/01/01,08:00:00";
+
+/* One 1 Hz epoch with CONFIG_GNSS_NMEA_OUTPUT */
+static const char s_nmea_epoch[] =
+    "$GNGGA,072809.00,3113.343286,N,12121.234064,E,1,09,0.9,44.1,M,8.5,M,,*74\r\n"
+    "$GNRMC,072809.00,A,3113.343286,N,12121.234064,E,0.5,182.3,250311,,,A*43\r\n"
+    "$GNGSA,A,3,01,02,03,04,06,09,12,14,17,,,,1.5,0.9,1.2*29\r\n"
+    "$GPGSV,3,1,11,01,40,083,46,02,17,308,41,12,07,344,39,14,22,228,45*7C\r\n"
+    "$GNVTG,182.3,T,,M,0.5,N,0.9,K,A*17\r\n";
+
+static nmea_parser_t s_nmea;
+
+static size_t bench_parse_gps(void *arg)
+{
+    gps_info_t info;
+    return parse_gps_info((const char *)arg, &info) + info.valid;
+}
+
+static size_t bench_parse_lbs(void *arg)
+{
+    gps_info_t info;
+    return parse_lbs_info((const char *)arg, &info) + info.valid;
+}
+
+static size_t bench_nmea_epoch(void *arg)
+{
+    gps_info_t info;
+    nmea_parser_feed(&s_nmea, s_nmea_epoch, sizeof(s_nmea_epoch) - 1);
+    return parse_nmea_fix(nmea_parser_get_fix(&s_nmea), &info) + s_nmea.sentences;
+}
+
+void bench_gps_run(void)
+{
+    bench_group("gps_parser");
+    bench_run("parse_gps_info fix", bench_parse_gps, (void *)s_cgpsinfo);
+    bench_run("parse_gps_info no fix", bench_parse_gps, (void *)s_cgpsinfo_empty);
+    bench_run("parse_lbs_info", bench_parse_lbs, (void *)s_clbs);
+
+    nmea_parser_init(&s_nmea, NULL, NULL);
+    bench_run("nmea_parser_feed epoch (5 sentences)", bench_nmea_epoch, NULL);
+}
@@ -0,0 +1,376 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+/* Same configuration as json_parser.c, which includes jsmn the same way */
+#define JSMN_PARENT_LINKS
+#define JSMN_STRICT
+#define JSMN_STATIC
+#include <jsmn.h>
+#include "bench.h"
+#include "json_generator.h"
+#include "json_parser.h"
+#include "json_wrapper.h"
+#include "json_template.h"
+
+#define BENCH_JSON_MAX_TOKENS   64
+
+/* Payload published by mqtt_publish_data_model() */
+static data_model_t s_model = {
+    .device = {
+        .device_id = "esp32s3-7c:df:a1:00:11:22",
+        .firmware_version = "1.2.0",
+    },
+    .sensors = {
+        .temperature = 23.4f,
+        .humidity = 56.7f,
+        .light_intensity = 321.5f,
+        .valid_mask = SENSOR_CH_BIT(SENSOR_CH_TEMPERATURE) | SENSOR_CH_BIT(SENSOR_CH_HUMIDITY) |
+                      SENSOR_CH_BIT(SENSOR_CH_LIGHT),
+        .sensors_valid = true,
+    },
+    .gps = {
+        .lat_e7 = 312304160,
+        .lon_e7 = 1214737010,
+        .altitude = 44.1f,
+        .speed = 0.5f,
+        .course = 182.3f,
+        .accuracy = 4.2f,
+        .data_source = 0,
+        .gps_valid = true,
+    },
+    .timestamp = 1700000000,
+};
+
+/* Body of POST /api/mqtt/settings */
+static const char s_settings[] =
+    "{\"broker\":\"mqtt://broker.example.com:1883\",\"username\":\"device01\","
+    "\"password\":\"s3cr3t\\/pass\"}";
+
+/* Device shadow style update with every configurable field */
+static const char s_shadow[] =
+    "{\"state\":{\"desired\":{"
+    "\"report_interval\":30,\"gps_interval\":5,\"lbs_interval\":300,"
+    "\"sensor_interval\":10,\"temp_offset\":-0.5,\"hum_offset\":1.25,"
+    "\"light_gain\":1.0,\"low_power\":false,\"led\":true,"
+    "\"timezone\":\"CST-8\",\"ntp_server\":\"pool.ntp.org\","
+    "\"apn\":\"cmnet\",\"ota_check\":true,\"version\":42}},"
+    "\"version\":42,\"timestamp\":1700000000123}";
+
+typedef struct {
+    int report_interval;
+    int gps_interval;
+    int lbs_interval;
+    int sensor_interval;
+    float temp_offset;
+    float hum_offset;
+    float light_gain;
+    bool low_power;
+    bool led;
+    char timezone[16];
+    char ntp_server[32];
+    char apn[16];
+    bool ota_check;
+    int version;
+} shadow_desired_t;
+
+/* How the object members are looked up */
+typedef enum {
+    LOOKUP_LINEAR,      /* json_obj_get_*() without an index */
+    LOOKUP_INDEX,       /* json_obj_get_*() with json_obj_set_index() */
+    LOOKUP_FIELDS,      /* json_obj_get_fields() */
+} lookup_mode_t;
+
+static char s_buf[512];
+static char s_telemetry[512];
+static int s_telemetry_len;
+static json_template_t s_tpl;
+
+/* data_model.c needs the chip headers and is not built here. The model
+ * above is never written while the benchmark runs, so the snapshot that
+ * json_wrapper.c and json_template.c take is a plain copy.
+ */
+void data_model_get_sensor_data(const data_model_t *model, sensor_data_t *sensors)
+{
+    *sensors = model->sensors;
+}
+
+/* ---------------- Generator ---------------- */
+
+static size_t bench_gen_data_model(void *arg)
+{
+    json_generate_from_data_model(&s_model, s_buf, sizeof(s_buf));
+    return strlen(s_buf);
+}
+
+static size_t bench_gen_template(void *arg)
+{
+    const char *json;
+    size_t len = 0;
+    json_template_render(&s_tpl, &s_model, &json, &len);
+    return len;
+}
+
+static size_t bench_gen_set_int(void *arg)
+{
+    json_gen_str_t jstr;
+    json_gen_str_start(&jstr, s_buf, sizeof(s_buf), NULL, NULL);
+    json_gen_start_object(&jstr);
+    for (int i = 0; i < 8; i++) {
+        json_gen_obj_set_int(&jstr, "timestamp", 1700000000 + i);
+    }
+    json_gen_end_object(&jstr);
+    return json_gen_str_end(&jstr);
+}
+
+static size_t bench_gen_set_float_prec(void *arg)
+{
+    json_gen_str_t jstr;
+    json_gen_str_start(&jstr, s_buf, sizeof(s_buf), NULL, NULL);
+    json_gen_start_object(&jstr);
+    for (int i = 0; i < 8; i++) {
+        json_gen_obj_set_float_prec(&jstr, "latitude", 31.230416f + i, 6);
+    }
+    json_gen_end_object(&jstr);
+    return json_gen_str_end(&jstr);
+}
+
+static size_t bench_gen_set_fixed(void *arg)
+{
+    json_gen_str_t jstr;
+    json_gen_str_start(&jstr, s_buf, sizeof(s_buf), NULL, NULL);
+    json_gen_start_object(&jstr);
+    for (int i = 0; i < 8; i++) {
+        json_gen_obj_set_fixed(&jstr, "latitude", 312304160 + i * 10000000, 7);
+    }
+    json_gen_end_object(&jstr);
+    return json_gen_str_end(&jstr);
+}
+
+static size_t bench_gen_set_string(void *arg)
+{
+    json_gen_str_t jstr;
+    json_gen_str_start(&jstr, s_buf, sizeof(s_buf), NULL, NULL);
+    json_gen_start_object(&jstr);
+    for (int i = 0; i < 8; i++) {
+        json_gen_obj_set_string(&jstr, "name", (const char *)arg);
+    }
+    json_gen_end_object(&jstr);
+    return json_gen_str_end(&jstr);
+}
+
+/* ---------------- Parser ---------------- */
+
+static size_t bench_parse_settings(void *arg)
+{
+    lookup_mode_t mode = (lookup_mode_t)(intptr_t)arg;
+    jparse_ctx_t jctx;
+    json_tok_t tokens[BENCH_JSON_MAX_TOKENS];
+    json_obj_index_t index;
+    char broker[64], username[32], password[32];
+
+    json_parse_start_static(&jctx, s_settings, sizeof(s_settings) - 1, tokens, BENCH_JSON_MAX_TOKENS);
+    if (mode == LOOKUP_INDEX) {
+        json_obj_set_index(&jctx, &index);
+    }
+    json_obj_get_string(&jctx, "broker", broker, sizeof(broker));
+    json_obj_get_string(&jctx, "username", username, sizeof(username));
+    json_obj_get_string(&jctx, "password", password, sizeof(password));
+    json_parse_end_static(&jctx);
+    return strlen(broker) + strlen(username) + strlen(password);
+}
+
+static int shadow_get_each(jparse_ctx_t *jctx, shadow_desired_t *d)
+{
+    int ret = 0;
+    ret |= json_obj_get_int(jctx, "report_interval", &d->report_interval);
+    ret |= json_obj_get_int(jctx, "gps_interval", &d->gps_interval);
+    ret |= json_obj_get_int(jctx, "lbs_interval", &d->lbs_interval);
+    ret |= json_obj_get_int(jctx, "sensor_interval", &d->sensor_interval);
+    ret |= json_obj_get_float(jctx, "temp_offset", &d->temp_offset);
+    ret |= json_obj_get_float(jctx, "hum_offset", &d->hum_offset);
+    ret |= json_obj_get_float(jctx, "light_gain", &d->light_gain);
+    ret |= json_obj_get_bool(jctx, "low_power", &d->low_power);
+    ret |= json_obj_get_bool(jctx, "led", &d->led);
+    ret |= json_obj_get_string(jctx, "timezone", d->timezone, sizeof(d->timezone));
+    ret |= json_obj_get_string(jctx, "ntp_server", d->ntp_server, sizeof(d->ntp_server));
+    ret |= json_obj_get_string(jctx, "apn", d->apn, sizeof(d->apn));
+    ret |= json_obj_get_bool(jctx, "ota_check", &d->ota_check);
+    ret |= json_obj_get_int(jctx, "version", &d->version);
+    return ret;
+}
+
+static int shadow_get_fields(jparse_ctx_t *jctx, shadow_desired_t *d)
+{
+    const json_field_t fields[] = {
+        { "report_interval", JSON_FIELD_INT, &d->report_interval },
+        { "gps_interval", JSON_FIELD_INT, &d->gps_interval },
+        { "lbs_interval", JSON_FIELD_INT, &d->lbs_interval },
+        { "sensor_interval", JSON_FIELD_INT, &d->sensor_interval },
+        { "temp_offset", JSON_FIELD_FLOAT, &d->temp_offset },
+        { "hum_offset", JSON_FIELD_FLOAT, &d->hum_offset },
+        { "light_gain", JSON_FIELD_FLOAT, &d->light_gain },
+        { "low_power", JSON_FIELD_BOOL, &d->low_power },
+        { "led", JSON_FIELD_BOOL, &d->led },
+        { "timezone", JSON_FIELD_STRING, d->timezone, sizeof(d->timezone) },
+        { "ntp_server", JSON_FIELD_STRING, d->ntp_server, sizeof(d->ntp_server) },
+        { "apn", JSON_FIELD_STRING, d->apn, sizeof(d->apn) },
+        { "ota_check", JSON_FIELD_BOOL, &d->ota_check },
+        { "version", JSON_FIELD_INT, &d->version },
+    };
+    int n = sizeof(fields) / sizeof(fields[0]);
+    return json_obj_get_fields(jctx, fields, n) == n ? 0 : -1;
+}
+
+static size_t bench_parse_shadow(void *arg)
+{
+    lookup_mode_t mode = (lookup_mode_t)(intptr_t)arg;
+    jparse_ctx_t jctx;
+    json_tok_t tokens[BENCH_JSON_MAX_TOKENS];
+    json_obj_index_t index;
+    shadow_desired_t d;
+
+    json_parse_start_static(&jctx, s_shadow, sizeof(s_shadow) - 1, tokens, BENCH_JSON_MAX_TOKENS);
+    if (mode != LOOKUP_LINEAR) {
+        json_obj_set_index(&jctx, &index);
+    }
+    json_obj_get_object(&jctx, "state");
+    json_obj_get_object(&jctx, "desired");
+    if (mode == LOOKUP_FIELDS) {
+        shadow_get_fields(&jctx, &d);
+    } else {
+        shadow_get_each(&jctx, &d);
+    }
+    json_parse_end_static(&jctx);
+    return d.version;
+}
+
+/* json_parse_start() allocates the token array for every document */
+static size_t bench_parse_shadow_heap(void *arg)
+{
+    jparse_ctx_t jctx;
+    shadow_desired_t d;
+
+    if (json_parse_start(&jctx, s_shadow, sizeof(s_shadow) - 1) != OS_SUCCESS) {
+        return 0;
+    }
+    json_obj_get_object(&jctx, "state");
+    json_obj_get_object(&jctx, "desired");
+    shadow_get_each(&jctx, &d);
+    json_parse_end(&jctx);
+    return d.version;
+}
+
+/* ---------------- HTTP request body ---------------- */
+
+/* Same limits as modem_http_config.c */
+#define BENCH_HTTP_BODY_MAX_LEN     4096
+#define BENCH_HTTP_JSON_MAX_TOKENS  32
+
+/* Stands in for the web server's scratch buffer */
+static char s_scratch[BENCH_HTTP_BODY_MAX_LEN + 1];
+
+static size_t http_settings_fields(jparse_ctx_t *jctx)
+{
+    char broker[64], username[32], password[32];
+
+    json_obj_get_string(jctx, "broker", broker, sizeof(broker));
+    json_obj_get_string(jctx, "username", username, sizeof(username));
+    json_obj_get_string(jctx, "password", password, sizeof(password));
+    json_unescape_string(password);
+    return strlen(broker) + strlen(username) + strlen(password);
+}
+
+/* Before: the handlers allocated the body by content_len and tokenised it
+ * with json_parse_start(). memcpy() stands in for httpd_req_recv().
+ */
+static size_t bench_http_body_heap(void *arg)
+{
+    size_t len = sizeof(s_settings) - 1;
+    jparse_ctx_t jctx;
+    size_t ret = 0;
+
+    char *buf = malloc(len + 1);
+    if (buf == NULL) {
+        return 0;
+    }
+    memcpy(buf, s_settings, len);
+    buf[len] = '\0';
+    if (json_parse_start(&jctx, buf, len) == OS_SUCCESS) {
+        ret = http_settings_fields(&jctx);
+        json_parse_end(&jctx);
+    }
+    free(buf);
+    return ret;
+}
+
+/* After: http_recv_json() receives into the scratch buffer and tokenises
+ * into a token pool on the handler stack.
+ */
+static size_t bench_http_body_static(void *arg)
+{
+    size_t len = sizeof(s_settings) - 1;
+    jparse_ctx_t jctx;
+    json_tok_t tokens[BENCH_HTTP_JSON_MAX_TOKENS];
+    size_t ret = 0;
+
+    memcpy(s_scratch, s_settings, len);
+    s_scratch[len] = '\0';
+    if (json_parse_start_static(&jctx, s_scratch, len, tokens, BENCH_HTTP_JSON_MAX_TOKENS) == OS_SUCCESS) {
+        ret = http_settings_fields(&jctx);
+        json_parse_end_static(&jctx);
+    }
+    return ret;
+}
+
+/* ---------------- jsmn ---------------- */
+
+static size_t bench_jsmn_telemetry(void *arg)
+{
+    jsmn_parser parser;
+    jsmntok_t tokens[BENCH_JSON_MAX_TOKENS];
+
+    jsmn_init(&parser);
+    return jsmn_parse(&parser, s_telemetry, s_telemetry_len, tokens, BENCH_JSON_MAX_TOKENS);
+}
+
+static size_t bench_jsmn_shadow(void *arg)
+{
+    jsmn_parser parser;
+    jsmntok_t tokens[BENCH_JSON_MAX_TOKENS];
+
+    jsmn_init(&parser);
+    return jsmn_parse(&parser, s_shadow, sizeof(s_shadow) - 1, tokens, BENCH_JSON_MAX_TOKENS);
+}
+
+void bench_json_run(void)
+{
+    json_generate_from_data_model(&s_model, s_telemetry, sizeof(s_telemetry));
+    s_telemetry_len = strlen(s_telemetry);
+
+    bench_group("json_generator");
+    bench_run("json_generate_from_data_model", bench_gen_data_model, NULL);
+    bench_run("json_template_render", bench_gen_template, NULL);
+    bench_run("json_gen_obj_set_int x8", bench_gen_set_int, NULL);
+    bench_run("json_gen_obj_set_float_prec x8", bench_gen_set_float_prec, NULL);
+    bench_run("json_gen_obj_set_fixed x8", bench_gen_set_fixed, NULL);
+    bench_run("json_gen_obj_set_string x8", bench_gen_set_string, (void *)"esp32s3-7c:df:a1:00:11:22");
+    bench_run("json_gen_obj_set_string escaped x8", bench_gen_set_string, (void *)"C:\\data\\\"log\"\n");
+
+    bench_group("json_parser");
+    bench_run("settings linear", bench_parse_settings, (void *)LOOKUP_LINEAR);
+    bench_run("settings index", bench_parse_settings, (void *)LOOKUP_INDEX);
+    bench_run("shadow linear", bench_parse_shadow, (void *)LOOKUP_LINEAR);
+    bench_run("shadow index", bench_parse_shadow, (void *)LOOKUP_INDEX);
+    bench_run("shadow get_fields", bench_parse_shadow, (void *)LOOKUP_FIELDS);
+    bench_run("shadow json_parse_start", bench_parse_shadow_heap, NULL);
+
+    bench_group("http request body (POST /api/mqtt/settings)");
+    bench_run("malloc + json_parse_start", bench_http_body_heap, NULL);
+    bench_run("scratch + json_parse_start_static", bench_http_body_static, NULL);
+
+    bench_group("jsmn");
+    bench_run("jsmn_parse telemetry", bench_jsmn_telemetry, NULL);
+    bench_run("jsmn_parse shadow", bench_jsmn_shadow, NULL);
+}
@@ -0,0 +1,100 @@
+#include <stdio.h>
+#include <string.h>
+#include "bench.h"
+
+/* The response handlers are static, so the source is built into this file */
+#include "esp_modem_dce_common_commands.c"
+
+/* Response lines replayed by the command stub, NULL terminated */
+static const char *const *s_script;
+
+/* Stands in for the DTE: the scripted response is handed to the handler
+ * line by line, as the DTE receive task would do.
+ */
+esp_err_t esp_modem_dce_generic_command(esp_modem_dce_t *dce, const char *command, uint32_t timeout,
+                                        esp_modem_dce_handle_line_t handle_line, void *ctx)
+{
+    dce->state = ESP_MODEM_STATE_PROCESSING;
+    dce->handle_line = handle_line;
+    dce->handle_line_ctx = ctx;
+    for (const char *const *line = s_script; line && *line; line++) {
+        handle_line(dce, *line);
+    }
+    dce->handle_line = NULL;
+    dce->handle_line_ctx = NULL;
+    return dce->state == ESP_MODEM_STATE_SUCCESS ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t esp_modem_process_command_done(esp_modem_dce_t *dce, esp_modem_state_t state)
+{
+    dce->state = state;
+    return ESP_OK;
+}
+
+esp_err_t esp_modem_dce_handle_response_default(esp_modem_dce_t *dce, const char *line)
+{
+    if (strstr(line, MODEM_RESULT_CODE_SUCCESS)) {
+        return esp_modem_process_command_done(dce, ESP_MODEM_STATE_SUCCESS);
+    } else if (strstr(line, MODEM_RESULT_CODE_ERROR)) {
+        return esp_modem_process_command_done(dce, ESP_MODEM_STATE_FAIL);
+    }
+    return ESP_FAIL;
+}
+
+typedef struct {
+    const char *name;
+    esp_modem_dce_handle_line_t handler;
+    const char *line;
+    void *ctx;
+} bench_at_case_t;
+
+static esp_modem_dte_t s_dte;
+static esp_modem_dce_t s_dce = { .dte = &s_dte };
+static esp_modem_dce_csq_ctx_t s_csq;
+static esp_modem_dce_cbc_ctx_t s_cbc;
+static int s_pin_ready;
+static char s_string[64];
+static common_string_t s_common_str = { .command = "AT+CGMM?\r", .string = s_string, .len = sizeof(s_string) };
+
+static size_t bench_at_handler(void *arg)
+{
+    const bench_at_case_t *c = arg;
+    s_dce.handle_line_ctx = c->ctx;
+    return c->handler(&s_dce, c->line) + s_dce.state;
+}
+
+/* Full command: response line followed by the final result code */
+static size_t bench_at_csq_command(void *arg)
+{
+    static const char *const script[] = { "\r\n+CSQ: 23,99\r\n", "\r\nOK\r\n", NULL };
+    s_script = script;
+    esp_modem_dce_get_signal_quality(&s_dce, NULL, &s_csq);
+    return s_csq.rssi;
+}
+
+static size_t bench_at_cops_command(void *arg)
+{
+    static const char *const script[] = { "\r\n+COPS: 0,0,\"CHINA MOBILE\",7\r\n", "\r\nOK\r\n", NULL };
+    s_script = script;
+    esp_modem_dce_get_operator_name(&s_dce, (void *)sizeof(s_string), s_string);
+    return strlen(s_string);
+}
+
+void bench_modem_run(void)
+{
+    static const bench_at_case_t cases[] = {
+        { "handle_csq", esp_modem_dce_common_handle_csq, "\r\n+CSQ: 23,99\r\n", &s_csq },
+        { "handle_cbc", esp_modem_dce_common_handle_cbc, "\r\n+CBC: 0,85,3950\r\n", &s_cbc },
+        { "handle_cops", common_get_operator_after_mode_format, "\r\n+COPS: 0,0,\"CHINA MOBILE\",7\r\n", &s_common_str },
+        { "handle_string", common_handle_string, "\r\n+CGMM: SIMCOM_A7670C\r\n", &s_common_str },
+        { "handle_read_pin", esp_modem_dce_handle_read_pin, "\r\n+CPIN: READY\r\n", &s_pin_ready },
+        { "handle_response_default", esp_modem_dce_handle_response_default, "\r\nOK\r\n", NULL },
+    };
+
+    bench_group("esp_modem_dce_common_commands");
+    for (int i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        bench_run(cases[i].name, bench_at_handler, (void *)&cases[i]);
+    }
+    bench_run("get_signal_quality", bench_at_csq_command, NULL);
+    bench_run("get_operator_name", bench_at_cops_command, NULL);
+}
@@ -0,0 +1,55 @@
+/*
+ * Host stand-in for esp_modem_dce.h of iot_usbh_modem.
+ *
+ * The original pulls in the UART, USB host and netif drivers through
+ * esp_modem.h. Only the DCE definitions used by the AT response handlers
+ * in esp_modem_dce_common_commands.c are kept here.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include "esp_err.h"
+
+typedef struct esp_modem_dte esp_modem_dte_t;
+typedef struct esp_modem_dce esp_modem_dce_t;
+
+typedef enum {
+    ESP_MODEM_FLOW_CONTROL_NONE = 0,
+    ESP_MODEM_FLOW_CONTROL_SW,
+    ESP_MODEM_FLOW_CONTROL_HW
+} esp_modem_flow_ctrl_t;
+
+typedef struct esp_modem_dce_pdp_ctx_s {
+    size_t cid;
+    const char *type;
+    const char *apn;
+} esp_modem_dce_pdp_ctx_t;
+
+typedef enum {
+    ESP_MODEM_STATE_PROCESSING,
+    ESP_MODEM_STATE_SUCCESS,
+    ESP_MODEM_STATE_FAIL
+} esp_modem_state_t;
+
+struct esp_modem_dte {
+    esp_modem_flow_ctrl_t flow_ctrl;
+};
+
+typedef esp_err_t (*esp_modem_dce_handle_line_t)(esp_modem_dce_t *dce, const char *line);
+
+struct esp_modem_dce {
+    esp_modem_state_t state;
+    esp_modem_dte_t *dte;
+    esp_modem_dce_handle_line_t handle_line;
+    void *handle_line_ctx;
+};
+
+esp_err_t esp_modem_dce_generic_command(esp_modem_dce_t *dce, const char *command, uint32_t timeout,
+                                        esp_modem_dce_handle_line_t handle_line, void *ctx);
+esp_err_t esp_modem_process_command_done(esp_modem_dce_t *dce, esp_modem_state_t state);
+esp_err_t esp_modem_dce_handle_response_default(esp_modem_dce_t *dce, const char *line);
@@ -0,0 +1,45 @@
+/*
+ * Host stand-in for esp_modem_dce_common_commands.h of iot_usbh_modem.
+ *
+ * Keeps the result codes, the response context types and helpers used by
+ * esp_modem_dce_common_commands.c. The command timeouts come from the
+ * component Kconfig on the device and are fixed to the defaults here.
+ */
+#pragma once
+
+#include "esp_modem_dce.h"
+
+#define MODEM_RESULT_CODE_SUCCESS "OK"
+#define MODEM_RESULT_CODE_CONNECT "CONNECT"
+#define MODEM_RESULT_CODE_RING "RING"
+#define MODEM_RESULT_CODE_NO_CARRIER "NO CARRIER"
+#define MODEM_RESULT_CODE_ERROR "ERROR"
+#define MODEM_RESULT_CODE_NO_DIALTONE "NO DIALTONE"
+#define MODEM_RESULT_CODE_BUSY "BUSY"
+#define MODEM_RESULT_CODE_NO_ANSWER "NO ANSWER"
+
+#define MODEM_COMMAND_TIMEOUT_DEFAULT     2000
+#define MODEM_COMMAND_TIMEOUT_OPERATOR    6000
+#define MODEM_COMMAND_TIMEOUT_RESET       6000
+#define MODEM_COMMAND_TIMEOUT_MODE_CHANGE 10000
+#define MODEM_COMMAND_TIMEOUT_POWEROFF    1000
+
+static inline void strip_cr_lf_tail(char *str, uint32_t len)
+{
+    if (str[len - 2] == '\r') {
+        str[len - 2] = '\0';
+    } else if (str[len - 1] == '\r') {
+        str[len - 1] = '\0';
+    }
+}
+
+typedef struct esp_modem_dce_csq_ctx_s {
+    int rssi;
+    int ber;
+} esp_modem_dce_csq_ctx_t;
+
+typedef struct esp_modem_dce_cbc_ctx_s {
+    int battery_status;
+    int bcs;
+    int bcl;
+} esp_modem_dce_cbc_ctx_t;
@@ -0,0 +1,215 @@
+/*
+ * GPS trace replay.
+ *
+ * A trace is a UART capture from the GNSS module, one received line per
+ * trace line, prefixed with the time it arrived in ms:
+ *
+ *   15120 $GNGGA,072815.00,3113.824414,N,12128.429330,E,1,09,0.9,12.3,M,8.5,M,,*7E
+ *
+ * Lines starting with '#' are comments. The first pass replays the trace
+ * with its own timing and checks what came out of the GPS task, the
+ * second replays it back to back as fast as possible and reports the
+ * throughput.
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "data_model.h"
+#include "replay.h"
+
+#define BENCH_MIN_NS        1000000000ULL
+#define BENCH_MIN_PASSES    5
+
+extern const char drive_stop_start[] asm("_binary_drive_stop_log_start");
+extern const char drive_stop_end[] asm("_binary_drive_stop_log_end");
+
+/* What drive_stop.log must produce, see the comments at its top */
+#define DRIVE_STOP_LINES            895
+#define DRIVE_STOP_GNSS_FIXES       291
+#define DRIVE_STOP_END_UTC_MS       1742888010000LL
+#define DRIVE_STOP_END_LAT_E7       312358679
+#define DRIVE_STOP_END_LON_E7       1214888449
+#define DRIVE_STOP_MAX_ERROR_M      15
+/* Standing from 135 s, stop_time_ms later plus the time the fused speed
+ * takes to settle */
+#define DRIVE_STOP_STOP_MIN_MS      195000
+#define DRIVE_STOP_STOP_MAX_MS      215000
+/* Driving off at 255 s */
+#define DRIVE_STOP_START_MIN_MS     255000
+#define DRIVE_STOP_START_MAX_MS     265000
+
+static int s_failures;
+
+#define REPLAY_CHECK(cond)                                              \
+    do {                                                                \
+        if (!(cond)) {                                                  \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);      \
+            s_failures++;                                               \
+        }                                                               \
+    } while (0)
+
+typedef struct {
+    const char *next;
+    const char *end;
+} trace_reader_t;
+
+/* Next record of a trace, false at its end */
+static bool trace_next(trace_reader_t *reader, int64_t *time_ms, const char **line, size_t *len)
+{
+    while (reader->next < reader->end) {
+        const char *start = reader->next;
+        const char *eol = memchr(start, '\n', reader->end - start);
+        if (eol == NULL) {
+            eol = reader->end;
+        }
+        reader->next = eol + 1;
+        if (eol > start && eol[-1] == '\r') {
+            eol--;
+        }
+        if (eol == start || *start == '#' || *start == '\0') {
+            continue;
+        }
+
+        char *text;
+        *time_ms = strtoll(start, &text, 10);
+        if (text == start || text >= eol || *text != ' ') {
+            printf("bad trace record: %.*s\n", (int)(eol - start), start);
+            continue;
+        }
+        *line = text + 1;
+        *len = eol - *line;
+        return true;
+    }
+    return false;
+}
+
+/* Feed a whole trace, paced at speed times real time, or flat out if 0 */
+static uint32_t replay_trace(const char *start, const char *end, double speed)
+{
+    trace_reader_t reader = { .next = start, .end = end };
+    int64_t time_ms;
+    int64_t last_ms = -1;
+    const char *line;
+    size_t len;
+    uint32_t records = 0;
+
+    while (trace_next(&reader, &time_ms, &line, &len)) {
+        if (speed > 0 && last_ms >= 0 && time_ms > last_ms) {
+            vTaskDelay(pdMS_TO_TICKS((time_ms - last_ms) / speed));
+        }
+        last_ms = time_ms;
+        replay_gps_feed(time_ms, line, len);
+        records++;
+    }
+    return records;
+}
+
+static uint64_t replay_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/* Equirectangular distance, plenty for points a few km apart */
+static double replay_distance_m(int32_t lat1_e7, int32_t lon1_e7, int32_t lat2_e7, int32_t lon2_e7)
+{
+    double m_per_e7 = 6371008.8 * M_PI / 180 / 1e7;
+    double north = (double)(lat1_e7 - lat2_e7) * m_per_e7;
+    double east = (double)(lon1_e7 - lon2_e7) * m_per_e7 * cos(lat1_e7 / 1e7 * M_PI / 180);
+    return sqrt(north * north + east * east);
+}
+
+static void check_drive_stop(double speed)
+{
+    replay_gps_reset();
+    uint32_t records = replay_trace(drive_stop_start, drive_stop_end, speed);
+    const replay_result_t *result = replay_gps_result();
+
+    printf("drive_stop.log: %lu lines, %lu GNSS fixes, %lu LBS fixes, %lu checksum errors\n",
+           (unsigned long)records, (unsigned long)result->gnss_fixes, (unsigned long)result->lbs_fixes,
+           (unsigned long)result->checksum_errors);
+
+    /* Every line reached its handler, only the corrupted RMC was lost */
+    REPLAY_CHECK(records == DRIVE_STOP_LINES);
+    REPLAY_CHECK(result->lines == DRIVE_STOP_LINES);
+    REPLAY_CHECK(result->dropped_bytes == 0);
+    REPLAY_CHECK(result->checksum_errors == 1);
+    REPLAY_CHECK(result->gnss_fixes == DRIVE_STOP_GNSS_FIXES);
+    REPLAY_CHECK(result->lbs_fixes >= 1);
+    REPLAY_CHECK(result->data_errors == 0);
+
+    /* No fix at first: serving cell queried and a cell fix requested */
+    REPLAY_CHECK(strstr(result->uart_tx, "AT+CPSI?\r\n") != NULL);
+    REPLAY_CHECK(strstr(result->uart_tx, "AT+CLBS=4,,,,2\r\n") != NULL);
+
+    /* Every fix went to all consumers, GNSS fixes also to the clock */
+    REPLAY_CHECK(result->track_points == result->gnss_fixes + result->lbs_fixes);
+    REPLAY_CHECK(result->geofence_checks == result->track_points);
+    REPLAY_CHECK(result->time_syncs == result->gnss_fixes);
+
+    /* One stop and one start, each reprogramming the report interval */
+    REPLAY_CHECK(result->motion_count == 2);
+    REPLAY_CHECK(strcmp(result->motion_events[0], "stop") == 0);
+    REPLAY_CHECK(result->motion_ms[0] >= DRIVE_STOP_STOP_MIN_MS && result->motion_ms[0] <= DRIVE_STOP_STOP_MAX_MS);
+    REPLAY_CHECK(strcmp(result->motion_events[1], "start") == 0);
+    REPLAY_CHECK(result->motion_ms[1] >= DRIVE_STOP_START_MIN_MS && result->motion_ms[1] <= DRIVE_STOP_START_MAX_MS);
+#if !CONFIG_GNSS_NMEA_OUTPUT
+    const char *slow = strstr(result->uart_tx, "AT+CGPSINFO=30\r\n");
+    REPLAY_CHECK(slow != NULL);
+    REPLAY_CHECK(slow != NULL && strstr(slow, "AT+CGPSINFO=5\r\n") != NULL);
+#endif
+
+    /* The data model holds the last fused GNSS fix */
+    data_model_t *model = data_model_get_latest();
+    REPLAY_CHECK(model != NULL);
+    if (model != NULL) {
+        double error = replay_distance_m(model->gps.lat_e7, model->gps.lon_e7,
+                                         DRIVE_STOP_END_LAT_E7, DRIVE_STOP_END_LON_E7);
+        printf("final position %.1f m from truth, accuracy %.1f m\n", error, model->gps.accuracy);
+        REPLAY_CHECK(model->gps.gps_valid);
+        REPLAY_CHECK(model->gps.data_source == FROM_GNSS);
+        REPLAY_CHECK(model->gps.utc_ms == DRIVE_STOP_END_UTC_MS);
+        REPLAY_CHECK(error < DRIVE_STOP_MAX_ERROR_M);
+        REPLAY_CHECK(model->gps.lat_e7 == result->last_fix.lat_e7);
+    }
+}
+
+static void bench_drive_stop(void)
+{
+    uint32_t passes = 0;
+    uint64_t lines = 0;
+    uint64_t fixes = 0;
+    uint64_t start = replay_now_ns();
+    uint64_t elapsed;
+
+    do {
+        replay_gps_reset();
+        lines += replay_trace(drive_stop_start, drive_stop_end, 0);
+        const replay_result_t *result = replay_gps_result();
+        fixes += result->gnss_fixes + result->lbs_fixes;
+        passes++;
+        elapsed = replay_now_ns() - start;
+    } while (elapsed < BENCH_MIN_NS || passes < BENCH_MIN_PASSES);
+
+    printf("%-40s %12s %12s %12s\n", "replay", "passes", "lines/s", "us/fix");
+    printf("%-40s %12lu %12.0f %12.2f\n", "drive_stop.log", (unsigned long)passes,
+           lines * 1e9 / elapsed, elapsed / 1e3 / fixes);
+}
+
+void app_main(void)
+{
+    const char *speed = getenv("GPS_REPLAY_SPEED");
+
+    check_drive_stop(speed ? atof(speed) : 0);
+    bench_drive_stop();
+
+    printf("\n%s, %d failures\n", s_failures ? "FAILED" : "OK", s_failures);
+    exit(s_failures ? 1 : 0);
+}
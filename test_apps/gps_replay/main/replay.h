@@ -0,0 +1,46 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "gps_parser.h"
+
+#define REPLAY_TX_SIZE          1024
+#define REPLAY_MAX_MOTION       8
+
+/** What the GPS task did with a trace */
+typedef struct {
+    /** GPS_DATA_UPDATE events by source */
+    uint32_t gnss_fixes;
+    uint32_t lbs_fixes;
+    uint32_t data_errors;
+    /** Calls into the consumers of gps_event_handler */
+    uint32_t time_syncs;
+    uint32_t track_points;
+    uint32_t geofence_checks;
+    /** Last fix handed to the consumers */
+    gps_info_t last_fix;
+    /** Motion events published, with the trace time of each */
+    uint32_t motion_count;
+    char motion_events[REPLAY_MAX_MOTION][8];
+    int64_t motion_ms[REPLAY_MAX_MOTION];
+    /** Everything sent to the module */
+    char uart_tx[REPLAY_TX_SIZE];
+    size_t uart_tx_len;
+    /** Line assembler and NMEA parser counters */
+    uint32_t lines;
+    uint32_t dropped_bytes;
+    uint32_t nmea_sentences;
+    uint32_t checksum_errors;
+} replay_result_t;
+
+/** Start from a fresh GPS task state, with the data model initialised */
+void replay_gps_reset(void);
+
+/** Feed one received line at a trace time, then run the GPS events it raised */
+void replay_gps_feed(int64_t time_ms, const char *line, size_t len);
+
+/** Result since replay_gps_reset() */
+const replay_result_t *replay_gps_result(void);
+
+#endif // REPLAY_H
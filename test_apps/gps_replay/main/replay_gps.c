@@ -0,0 +1,118 @@
+/*
+ * The GPS task without its UART and task. gps.c is compiled here so that
+ * the replay can reach its static line handlers and gps_event_handler,
+ * the consumers of the GPS events are replaced by recorders.
+ */
+#include <assert.h>
+#include "gps.c"
+#include "replay.h"
+
+int64_t replay_now_us;
+
+static esp_gps_t *s_gps;
+static replay_result_t s_result;
+
+void replay_uart_tx(const char *data, size_t len)
+{
+    size_t room = sizeof(s_result.uart_tx) - 1 - s_result.uart_tx_len;
+    len = len < room ? len : room;
+    memcpy(s_result.uart_tx + s_result.uart_tx_len, data, len);
+    s_result.uart_tx_len += len;
+    s_result.uart_tx[s_result.uart_tx_len] = '\0';
+}
+
+void time_sync_on_gnss(const gps_info_t *gps_info)
+{
+    s_result.time_syncs++;
+}
+
+/* The replay runs on the host clock, which is always set */
+bool time_sync_is_valid(void)
+{
+    return true;
+}
+
+void track_upload_add(const gps_info_t *gps_info)
+{
+    s_result.track_points++;
+    s_result.last_fix = *gps_info;
+    if (gps_info->data_source == FROM_GNSS) {
+        s_result.gnss_fixes++;
+    } else {
+        s_result.lbs_fixes++;
+    }
+}
+
+void geofence_manager_on_fix(const gps_info_t *gps_info)
+{
+    s_result.geofence_checks++;
+}
+
+esp_err_t mqtt_publish_motion_event(const char *data, size_t len)
+{
+    static const char key[] = "\"event\":\"";
+    const char *event = strstr(data, key);
+    if (event == NULL || s_result.motion_count >= REPLAY_MAX_MOTION) {
+        return ESP_FAIL;
+    }
+    event += sizeof(key) - 1;
+    char *name = s_result.motion_events[s_result.motion_count];
+    size_t i = 0;
+    while (event[i] != '"' && i < sizeof(s_result.motion_events[0]) - 1) {
+        name[i] = event[i];
+        i++;
+    }
+    name[i] = '\0';
+    s_result.motion_ms[s_result.motion_count++] = replay_now_us / 1000;
+    return ESP_OK;
+}
+
+static void replay_error_handler(void *arg, esp_event_base_t base, int32_t id, void *data)
+{
+    if (id == GPS_DATA_ERROR) {
+        s_result.data_errors++;
+    }
+}
+
+void replay_gps_reset(void)
+{
+    if (s_gps == NULL) {
+        s_gps = calloc(1, sizeof(esp_gps_t));
+        assert(s_gps != NULL);
+        /* No task, the replay runs the loop after each line */
+        esp_event_loop_args_t loop_args = {
+            .queue_size = GPS_EVENT_LOOP_QUEUE_SIZE,
+            .task_name = NULL,
+        };
+        ESP_ERROR_CHECK(esp_event_loop_create(&loop_args, &s_gps->event_loop_hdl));
+        ESP_ERROR_CHECK(esp_gps_add_handler(s_gps, gps_event_handler, NULL));
+        ESP_ERROR_CHECK(esp_gps_add_handler(s_gps, replay_error_handler, NULL));
+    }
+    esp_event_loop_handle_t loop = s_gps->event_loop_hdl;
+    memset(s_gps, 0, sizeof(esp_gps_t));
+    s_gps->event_loop_hdl = loop;
+    s_gps->uart_port = UART_NUM_1;
+    esp_gps_state_init(s_gps);
+
+    memset(&s_result, 0, sizeof(s_result));
+    replay_now_us = 0;
+    data_model_init(NULL);
+}
+
+void replay_gps_feed(int64_t time_ms, const char *line, size_t len)
+{
+    replay_now_us = time_ms * 1000;
+    line_assembler_feed(&s_gps->lines, line, len);
+    line_assembler_feed(&s_gps->lines, "\r\n", 2);
+    esp_event_loop_run(s_gps->event_loop_hdl, 0);
+}
+
+const replay_result_t *replay_gps_result(void)
+{
+    const line_assembler_stats_t *stats = line_assembler_get_stats(&s_gps->lines);
+    s_result.lines = stats->lines;
+    s_result.dropped_bytes = stats->dropped_bytes;
+    s_result.nmea_sentences = s_gps->nmea.sentences;
+    s_result.checksum_errors = s_gps->nmea.checksum_errors;
+    return &s_result;
+}
@@ -0,0 +1,120 @@
+/*
+ * Host stand-in for driver/uart.h.
+ *
+ * There is no UART on the linux target. The replay feeds received data to
+ * the line assembler directly, and everything written to the module goes
+ * to replay_uart_tx() so that the AT commands can be checked.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "esp_err.h"
+
+typedef int uart_port_t;
+
+typedef enum {
+    UART_DATA_5_BITS = 0,
+    UART_DATA_6_BITS,
+    UART_DATA_7_BITS,
+    UART_DATA_8_BITS,
+} uart_word_length_t;
+
+typedef enum {
+    UART_PARITY_DISABLE = 0,
+    UART_PARITY_EVEN = 2,
+    UART_PARITY_ODD = 3,
+} uart_parity_t;
+
+typedef enum {
+    UART_STOP_BITS_1 = 1,
+    UART_STOP_BITS_1_5,
+    UART_STOP_BITS_2,
+} uart_stop_bits_t;
+
+typedef enum {
+    UART_HW_FLOWCTRL_DISABLE = 0,
+} uart_hw_flowcontrol_t;
+
+typedef enum {
+    UART_SCLK_DEFAULT = 0,
+} uart_sclk_t;
+
+typedef enum {
+    UART_DATA,
+    UART_BREAK,
+    UART_BUFFER_FULL,
+    UART_FIFO_OVF,
+    UART_FRAME_ERR,
+    UART_PARITY_ERR,
+    UART_DATA_BREAK,
+    UART_PATTERN_DET,
+} uart_event_type_t;
+
+typedef struct {
+    uart_event_type_t type;
+    size_t size;
+    bool timeout_flag;
+} uart_event_t;
+
+typedef struct {
+    int baud_rate;
+    uart_word_length_t data_bits;
+    uart_parity_t parity;
+    uart_stop_bits_t stop_bits;
+    uart_hw_flowcontrol_t flow_ctrl;
+    uart_sclk_t source_clk;
+} uart_config_t;
+
+#define UART_NUM_1          1
+#define UART_PIN_NO_CHANGE  (-1)
+
+/** Defined by the replay, records what the GPS task sends to the module */
+void replay_uart_tx(const char *data, size_t len);
+
+static inline int uart_tx_chars(uart_port_t uart_num, const char *buffer, uint32_t len)
+{
+    replay_uart_tx(buffer, len);
+    return (int)len;
+}
+
+static inline int uart_read_bytes(uart_port_t uart_num, void *buf, uint32_t length, TickType_t ticks_to_wait)
+{
+    return 0;
+}
+
+static inline esp_err_t uart_get_buffered_data_len(uart_port_t uart_num, size_t *size)
+{
+    *size = 0;
+    return ESP_OK;
+}
+
+static inline esp_err_t uart_flush(uart_port_t uart_num)
+{
+    return ESP_OK;
+}
+
+static inline esp_err_t uart_driver_install(uart_port_t uart_num, int rx_buffer_size, int tx_buffer_size,
+                                            int queue_size, QueueHandle_t *uart_queue, int intr_alloc_flags)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+static inline esp_err_t uart_driver_delete(uart_port_t uart_num)
+{
+    return ESP_OK;
+}
+
+static inline esp_err_t uart_param_config(uart_port_t uart_num, const uart_config_t *uart_config)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+static inline esp_err_t uart_set_pin(uart_port_t uart_num, int tx_io_num, int rx_io_num,
+                                     int rts_io_num, int cts_io_num)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
@@ -0,0 +1,22 @@
+/*
+ * Host stand-in for esp_mac.h, used by data_model.c for the device ID.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include "esp_err.h"
+
+typedef enum {
+    ESP_MAC_WIFI_STA,
+    ESP_MAC_WIFI_SOFTAP,
+    ESP_MAC_BT,
+    ESP_MAC_ETH,
+} esp_mac_type_t;
+
+static inline esp_err_t esp_read_mac(uint8_t *mac, esp_mac_type_t type)
+{
+    static const uint8_t replay_mac[6] = { 0x02, 0x00, 0x00, 0x12, 0x34, 0x56 };
+    memcpy(mac, replay_mac, sizeof(replay_mac));
+    return ESP_OK;
+}
@@ -0,0 +1,19 @@
+/*
+ * Host stand-in for esp_rom_crc.h, used by data_model.c for the RTC state.
+ * Same polynomial and conventions as the ROM function.
+ */
+#pragma once
+
+#include <stdint.h>
+
+static inline uint32_t esp_rom_crc32_le(uint32_t crc, uint8_t const *buf, uint32_t len)
+{
+    crc = ~crc;
+    while (len--) {
+        crc ^= *buf++;
+        for (int i = 0; i < 8; i++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
@@ -0,0 +1,19 @@
+/*
+ * Host stand-in for esp_timer.h.
+ *
+ * The GPS task takes its monotonic time from esp_timer_get_time(). In the
+ * replay that is the time stamp of the trace line being fed, so no-fix
+ * rate limits, the LBS scheduler and the motion detector see the timing of
+ * the capture however fast it is replayed.
+ */
+#pragma once
+
+#include <stdint.h>
+
+/** Trace clock, in us, set by the replay before each line */
+extern int64_t replay_now_us;
+
+static inline int64_t esp_timer_get_time(void)
+{
+    return replay_now_us;
+}
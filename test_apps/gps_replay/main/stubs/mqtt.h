@@ -0,0 +1,10 @@
+/*
+ * Host stand-in for the application's mqtt.h. Only the motion event
+ * publisher is used by gps.c, the replay records the events.
+ */
+#pragma once
+
+#include <stddef.h>
+#include "esp_err.h"
+
+esp_err_t mqtt_publish_motion_event(const char *data, size_t len);